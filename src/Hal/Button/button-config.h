@@ -61,4 +61,10 @@
  */
 #define BUTTON_INTERRUPT_ENABLE							1
 
+/* if BUTTON_EXPANDER_PINS_ENABLED = 1, the buttons pins can be expander pins
+ * EXP_PIN(byte, bit) too, the EXPANDER driver must be initialized and synced
+ * by the application, expander pins support BUTTON_NO_PULL only and have no interrupts
+ */
+#define BUTTON_EXPANDER_PINS_ENABLED					0
+
 #endif /* __BUTTON_CONFIG_H__ */
@@ -34,6 +34,28 @@
 
 #endif /* BUTTON_INTERRUPT_ENABLE == 1 */
 
+#if BUTTON_EXPANDER_PINS_ENABLED == 1
+
+/* For using expander pins */
+#include "../Expander/expander.h"
+
+#endif /* BUTTON_EXPANDER_PINS_ENABLED == 1 */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* pins functions, they accept expander pins if enabled */
+#if BUTTON_EXPANDER_PINS_ENABLED == 1
+#define BUTTON_PIN_INIT(pin)							EXP_dioPinInit(pin, PIN_INPUT)
+#define BUTTON_CONTROL_PULL(pin, pull)					EXP_dioControlPinInternalPull(pin, pull)
+#define BUTTON_READ_PIN(pin)							EXP_dioReadPin(pin)
+#else
+#define BUTTON_PIN_INIT(pin)							DIO_pinInit(pin, PIN_INPUT)
+#define BUTTON_CONTROL_PULL(pin, pull)					DIO_controlPinInternalPull(pin, pull)
+#define BUTTON_READ_PIN(pin)							DIO_readPin(pin)
+#endif /* BUTTON_EXPANDER_PINS_ENABLED == 1 */
+
 /*******************************************************************************
  *                      	   Global Variables		                           *
  *******************************************************************************/
@@ -61,10 +83,10 @@ static ST_Button g_buttons[BUTTONS_USED_COUNT];
 void BUTTON_init(void)
 {
 	/* init button pin as input */
-	DIO_pinInit(BUTTON_PIN, PIN_INPUT);
+	BUTTON_PIN_INIT(BUTTON_PIN);
 
 	/* control internal pull of the button pin */
-	DIO_controlPinInternalPull(BUTTON_PIN, BUTTON_INTERNAL_PULL);
+	BUTTON_CONTROL_PULL(BUTTON_PIN, BUTTON_INTERNAL_PULL);
 }
 
 /*
@@ -81,13 +103,13 @@ uint8_t BUTTON_read(void)
 #if BUTTON_CHECK_DEBOUNCE_ENABLED == 1
 
 	/* check if button is pressed for first time */
-	if(DIO_readPin(BUTTON_PIN) ^ BUTTON_CONNECTION)
+	if(BUTTON_READ_PIN(BUTTON_PIN) ^ BUTTON_CONNECTION)
 	{
 		/* delay for some time */
 		TIMER_DELAY_MS(BUTTON_CHECK_DEBOUNCE_DELAY_MS);
 
 		/* check if button is pressed for second time */
-		if (DIO_readPin(BUTTON_PIN) ^ BUTTON_CONNECTION)
+		if (BUTTON_READ_PIN(BUTTON_PIN) ^ BUTTON_CONNECTION)
 		{
 			return BUTTON_PRESSED;
 		}
@@ -97,7 +119,7 @@ uint8_t BUTTON_read(void)
 #else
 
 	/* the pin value ^ with the button connection gives the pressed state */
-	return DIO_readPin(BUTTON_PIN) ^ BUTTON_CONNECTION;
+	return BUTTON_READ_PIN(BUTTON_PIN) ^ BUTTON_CONNECTION;
 
 #endif /* BUTTON_CHECK_DEBOUNCE_ENABLED */
 
@@ -180,10 +202,10 @@ void BUTTON_init(const ST_ButtonConfig * a_buttons)
 		g_buttons[loopCounter].connection = a_buttons[loopCounter].connection;
 
 		/* init pins as input */
-		DIO_pinInit(g_buttons[loopCounter].pin, PIN_INPUT);
+		BUTTON_PIN_INIT(g_buttons[loopCounter].pin);
 
 		/* control internal pull */
-		DIO_controlPinInternalPull(g_buttons[loopCounter].pin, a_buttons[loopCounter].pull);
+		BUTTON_CONTROL_PULL(g_buttons[loopCounter].pin, a_buttons[loopCounter].pull);
 	}
 }
 
@@ -204,13 +226,13 @@ uint8_t BUTTON_read(uint8_t a_buttonIndex)
 #if BUTTON_CHECK_DEBOUNCE_ENABLED == 1
 
 		/* check if button is pressed for first time */
-		if(DIO_readPin(g_buttons[a_buttonIndex].pin) ^ g_buttons[a_buttonIndex].connection)
+		if(BUTTON_READ_PIN(g_buttons[a_buttonIndex].pin) ^ g_buttons[a_buttonIndex].connection)
 		{
 			/* delay for some time */
 			TIMER_DELAY_MS(BUTTON_CHECK_DEBOUNCE_DELAY_MS);
 
 			/* check if button is pressed for second time */
-			if (DIO_readPin(g_buttons[a_buttonIndex].pin) ^ g_buttons[a_buttonIndex].connection)
+			if (BUTTON_READ_PIN(g_buttons[a_buttonIndex].pin) ^ g_buttons[a_buttonIndex].connection)
 			{
 				return BUTTON_PRESSED;
 			}
@@ -220,7 +242,7 @@ uint8_t BUTTON_read(uint8_t a_buttonIndex)
 #else
 
 		/* the pin value ^ with the button connection gives the pressed state */
-		return DIO_readPin(g_buttons[a_buttonIndex].pin) ^ g_buttons[a_buttonIndex].connection;
+		return BUTTON_READ_PIN(g_buttons[a_buttonIndex].pin) ^ g_buttons[a_buttonIndex].connection;
 
 #endif /* BUTTON_CHECK_DEBOUNCE_ENABLED */
 
@@ -33,4 +33,28 @@
 
 #endif /* BUZZERS_USED_COUNT == 1 */
 
+/* if BUZZER_TONE_ENABLED = 1, BUZZER_tone() and the melody player sound the buzzers
+ * at exact frequencies by toggling the OCx pins from the timers in ctc mode, without
+ * using the cpu while sounding.
+ * The tones are available only for buzzers on OC0, OC1A or OC2, each one owns the
+ * timer of its pin (TIMER_0, TIMER_1 or TIMER_2), so it mustn't be DELAY_TIMER
+ * or used by another module. Note that OC1A (PD5) is on the lcd data bus PD4..PD7
+ * and timer 1 is used by the icu and the stepper
+ */
+#define BUZZER_TONE_ENABLED						0
+
+#if BUZZER_TONE_ENABLED == 1
+
+/* period of calling BUZZER_tick() in ms, i.e. from a scheduler task,
+ * notes durations are rounded to it
+ */
+#define BUZZER_TICK_MS							10
+
+#endif /* BUZZER_TONE_ENABLED == 1 */
+
+/* making sure F_CPU is defined */
+#ifndef F_CPU
+#define F_CPU									1000000UL
+#endif /* F_CPU */
+
 #endif /* __BUZZER_CONFIG_H__ */
@@ -20,6 +20,142 @@
 /* for using the DIO module */
 #include "../../Mcal/Dio/dio.h"
 
+/* For using the OCx pins */
+#include "../../Mcal/Mcu/mcu.h"
+
+#if BUZZER_TONE_ENABLED == 1
+
+/* For generating the tones */
+#include "../../Mcal/Timer/timer.h"
+
+#if BUZZERS_USED_COUNT == 1 && BUZZER_PIN != OC0 && BUZZER_PIN != OC1A && BUZZER_PIN != OC2
+#error "BUZZER_TONE_ENABLED requires BUZZER_PIN to be OC0, OC1A or OC2"
+#endif
+
+#if BUZZERS_USED_COUNT == 1 && ((BUZZER_PIN == OC0 && DELAY_TIMER == TIMER_0) || \
+		(BUZZER_PIN == OC1A && DELAY_TIMER == TIMER_1) || (BUZZER_PIN == OC2 && DELAY_TIMER == TIMER_2))
+#error "the timer of BUZZER_PIN is used as DELAY_TIMER"
+#endif
+
+/* For checking whether timer 1 is owned by the ICU driver */
+#include "../../Mcal/Icu/icu-config.h"
+
+#if BUZZERS_USED_COUNT == 1 && BUZZER_PIN == OC1A && ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+#error "BUZZER_PIN = OC1A requires ICU_TIMESTAMP_EXTENSION_ENABLED = 0, timer 1 is used by the ICU"
+#endif
+
+/*******************************************************************************
+ *                                Macros                                       *
+ *******************************************************************************/
+
+/* gets the pin of a buzzer by its index */
+#if BUZZERS_USED_COUNT == 1
+#define BUZZER_PIN_OF(index)				BUZZER_PIN
+#else
+#define BUZZER_PIN_OF(index)				(g_buzzersPins[index])
+#endif /* BUZZERS_USED_COUNT == 1 */
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: BUZZER_setTone
+ * [Function Description]: sets the timer of the buzzer pin to toggle it at a frequency,
+ * 						   or disconnects the pin from the timer and drives it low
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer, OC0, OC1A or OC2
+ * [in]: uint16_t a_frequency
+ * 		 frequency in Hz, 0 to silence the buzzer
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if the pin isn't OC0, OC1A or OC2
+ */
+static uint8_t BUZZER_setTone(uint8_t a_buzzerPin, uint16_t a_frequency);
+
+/*
+ * [Function Name]: BUZZER_toneIndex
+ * [Function Description]: stops the melody of a buzzer and sounds it at a frequency
+ * [Args]:
+ * [in]: uint8_t a_buzzerIndex
+ * 		 buzzer index, 0 if BUZZERS_USED_COUNT = 1
+ * [in]: uint16_t a_frequency
+ * 		 frequency in Hz, 0 to silence the buzzer
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if the buzzer isn't on OC0, OC1A or OC2
+ */
+static uint8_t BUZZER_toneIndex(uint8_t a_buzzerIndex, uint16_t a_frequency);
+
+/*
+ * [Function Name]: BUZZER_playMelodyIndex
+ * [Function Description]: starts playing a melody on a buzzer, same as BUZZER_playMelody()
+ * [Args]:
+ * [in]: uint8_t a_buzzerIndex
+ * 		 buzzer index, 0 if BUZZERS_USED_COUNT = 1
+ * [in]: FLASH_CONST ST_BuzzerNote * a_melody
+ * 		 notes of the melody, ended by a note with 0 duration
+ * [in]: uint8_t a_playsCount
+ * 		 times to play the melody, BUZZER_MELODY_LOOP to repeat it till it's stopped
+ * [in]: uint8_t a_priority
+ * 		 priority of the melody, 0 is the highest priority
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR
+ */
+static uint8_t BUZZER_playMelodyIndex(uint8_t a_buzzerIndex, FLASH_CONST ST_BuzzerNote * a_melody, uint8_t a_playsCount, uint8_t a_priority);
+
+/*
+ * [Function Name]: BUZZER_playNote
+ * [Function Description]: sounds the current note of the melody of a buzzer, at the end of
+ * 						   the melody it starts it again or stops it depending on its plays count
+ * [Args]:
+ * [in]: uint8_t a_buzzerIndex
+ * 		 buzzer index, 0 if BUZZERS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void BUZZER_playNote(uint8_t a_buzzerIndex);
+
+#if BUZZERS_USED_COUNT > 1
+
+/*
+ * [Function Name]: BUZZER_getIndex
+ * [Function Description]: gets the index of a buzzer by its pin
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer
+ * [Return]: uint8_t
+ * 			 buzzer index or BUZZERS_USED_COUNT if the pin isn't a buzzer
+ */
+static uint8_t BUZZER_getIndex(uint8_t a_buzzerPin);
+
+#endif /* BUZZERS_USED_COUNT > 1 */
+
+/*******************************************************************************
+ *                      	   Global Variables		                           *
+ *******************************************************************************/
+
+/* prescalers of timer 0 and timer 1 as shifts, from TIMER_x_PRESCALER_1 */
+static FLASH_CONST uint8_t g_prescalersShifts[] = {0, 3, 6, 8, 10};
+
+/* prescalers of timer 2 as shifts, from TIMER_2_PRESCALER_1 */
+static FLASH_CONST uint8_t g_timer2PrescalersShifts[] = {0, 3, 5, 6, 7, 8, 10};
+
+#if BUZZERS_USED_COUNT > 1
+
+/* pins of the buzzers passed to BUZZER_init() */
+static uint8_t g_buzzersPins[BUZZERS_USED_COUNT];
+
+#endif /* BUZZERS_USED_COUNT > 1 */
+
+/* state of the melody of each buzzer */
+static volatile uint8_t g_isMelodyPlaying[BUZZERS_USED_COUNT];
+static FLASH_CONST ST_BuzzerNote * g_melodies[BUZZERS_USED_COUNT];
+static uint16_t g_notesIndices[BUZZERS_USED_COUNT];
+static uint16_t g_noteTicksLeft[BUZZERS_USED_COUNT];
+static uint8_t g_playsLeft[BUZZERS_USED_COUNT];
+static uint8_t g_melodiesPriorities[BUZZERS_USED_COUNT];
+
+#endif /* BUZZER_TONE_ENABLED == 1 */
+
 /*******************************************************************************
  *                          Functions Definition	                           *
  *******************************************************************************/
@@ -83,6 +219,9 @@ void BUZZER_init(const uint8_t * a_buzzerPins)
 	for(loopCounter = 0; loopCounter < BUZZERS_USED_COUNT; loopCounter++)
 	{
 		DIO_pinInit(a_buzzerPins[loopCounter], PIN_OUTPUT);
+#if BUZZER_TONE_ENABLED == 1
+		g_buzzersPins[loopCounter] = a_buzzerPins[loopCounter];
+#endif /* BUZZER_TONE_ENABLED == 1 */
 	}
 }
 
@@ -115,3 +254,419 @@ void BUZZER_off(uint8_t a_buzzerPin)
 }
 
 #endif /* BUZZERS_USED_COUNT == 1 */
+
+#if BUZZER_TONE_ENABLED == 1
+
+#if BUZZERS_USED_COUNT == 1
+
+/*
+ * [Function Name]: BUZZER_tone
+ * [Function Description]: sounds the buzzer at a frequency till it's changed, the pin is
+ * 						   toggled by the timer so the cpu isn't used while sounding.
+ * 						   It stops the playing melody, BUZZER_on() and BUZZER_off() can't
+ * 						   be used while sounding
+ * [Args]:
+ * [in]: uint16_t a_frequency
+ * 		 frequency in Hz, 0 to silence the buzzer
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if the buzzer isn't on OC0, OC1A or OC2
+ */
+uint8_t BUZZER_tone(uint16_t a_frequency)
+{
+	return BUZZER_toneIndex(0, a_frequency);
+}
+
+/*
+ * [Function Name]: BUZZER_playMelody
+ * [Function Description]: starts playing a melody from BUZZER_tick(), it interrupts the
+ * 						   playing melody if it doesn't have a higher priority
+ * [Args]:
+ * [in]: FLASH_CONST ST_BuzzerNote * a_melody
+ * 		 notes of the melody, ended by a note with 0 duration
+ * [in]: uint8_t a_playsCount
+ * 		 times to play the melody, BUZZER_MELODY_LOOP to repeat it till it's stopped
+ * [in]: uint8_t a_priority
+ * 		 priority of the melody, 0 is the highest priority
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if a melody with a higher priority is
+ * 			 playing or the buzzer isn't on OC0, OC1A or OC2
+ */
+uint8_t BUZZER_playMelody(FLASH_CONST ST_BuzzerNote * a_melody, uint8_t a_playsCount, uint8_t a_priority)
+{
+	return BUZZER_playMelodyIndex(0, a_melody, a_playsCount, a_priority);
+}
+
+/*
+ * [Function Name]: BUZZER_stopMelody
+ * [Function Description]: stops the playing melody and silences the buzzer
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void BUZZER_stopMelody(void)
+{
+	BUZZER_toneIndex(0, 0);
+}
+
+/*
+ * [Function Name]: BUZZER_isPlaying
+ * [Function Description]: checks if a melody is playing
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if a melody is playing, FALSE otherwise
+ */
+uint8_t BUZZER_isPlaying(void)
+{
+	return g_isMelodyPlaying[0];
+}
+
+#else
+
+/*
+ * [Function Name]: BUZZER_tone
+ * [Function Description]: sounds the buzzer at a frequency till it's changed, the pin is
+ * 						   toggled by the timer so the cpu isn't used while sounding.
+ * 						   It stops the playing melody, BUZZER_on() and BUZZER_off() can't
+ * 						   be used while sounding
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer, OC0, OC1A or OC2
+ * [in]: uint16_t a_frequency
+ * 		 frequency in Hz, 0 to silence the buzzer
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if the pin isn't an initialized buzzer
+ * 			 on OC0, OC1A or OC2
+ */
+uint8_t BUZZER_tone(uint8_t a_buzzerPin, uint16_t a_frequency)
+{
+	uint8_t index = BUZZER_getIndex(a_buzzerPin);
+
+	if(index == BUZZERS_USED_COUNT)
+	{
+		return BUZZER_ERROR;
+	}
+	return BUZZER_toneIndex(index, a_frequency);
+}
+
+/*
+ * [Function Name]: BUZZER_playMelody
+ * [Function Description]: starts playing a melody from BUZZER_tick(), it interrupts the
+ * 						   playing melody of the buzzer if it doesn't have a higher priority
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer, OC0, OC1A or OC2
+ * [in]: FLASH_CONST ST_BuzzerNote * a_melody
+ * 		 notes of the melody, ended by a note with 0 duration
+ * [in]: uint8_t a_playsCount
+ * 		 times to play the melody, BUZZER_MELODY_LOOP to repeat it till it's stopped
+ * [in]: uint8_t a_priority
+ * 		 priority of the melody, 0 is the highest priority
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if a melody with a higher priority is
+ * 			 playing or the pin isn't an initialized buzzer on OC0, OC1A or OC2
+ */
+uint8_t BUZZER_playMelody(uint8_t a_buzzerPin, FLASH_CONST ST_BuzzerNote * a_melody, uint8_t a_playsCount, uint8_t a_priority)
+{
+	uint8_t index = BUZZER_getIndex(a_buzzerPin);
+
+	if(index == BUZZERS_USED_COUNT)
+	{
+		return BUZZER_ERROR;
+	}
+	return BUZZER_playMelodyIndex(index, a_melody, a_playsCount, a_priority);
+}
+
+/*
+ * [Function Name]: BUZZER_stopMelody
+ * [Function Description]: stops the playing melody and silences the buzzer
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer
+ * [Return]: void
+ */
+void BUZZER_stopMelody(uint8_t a_buzzerPin)
+{
+	uint8_t index = BUZZER_getIndex(a_buzzerPin);
+
+	if(index < BUZZERS_USED_COUNT)
+	{
+		BUZZER_toneIndex(index, 0);
+	}
+}
+
+/*
+ * [Function Name]: BUZZER_isPlaying
+ * [Function Description]: checks if a melody is playing
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer
+ * [Return]: uint8_t
+ * 			 TRUE if a melody is playing, FALSE otherwise
+ */
+uint8_t BUZZER_isPlaying(uint8_t a_buzzerPin)
+{
+	uint8_t index = BUZZER_getIndex(a_buzzerPin);
+
+	if(index == BUZZERS_USED_COUNT)
+	{
+		return FALSE;
+	}
+	return g_isMelodyPlaying[index];
+}
+
+#endif /* BUZZERS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: BUZZER_tick
+ * [Function Description]: plays the next notes of the melodies, it must be called every
+ * 						   BUZZER_TICK_MS, i.e. from a scheduler task or a timer handler.
+ * 						   It only changes the timers when a note ends
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void BUZZER_tick(void)
+{
+	uint8_t loopCounter;
+	uint8_t sreg;
+
+	for(loopCounter = 0; loopCounter < BUZZERS_USED_COUNT; loopCounter ++)
+	{
+		/* the melody can be changed from an interrupt or the main code */
+		ENTER_CRITICAL_SECTION(sreg);
+		if(g_isMelodyPlaying[loopCounter] == TRUE)
+		{
+			g_noteTicksLeft[loopCounter] --;
+			if(g_noteTicksLeft[loopCounter] == 0)
+			{
+				g_notesIndices[loopCounter] ++;
+				BUZZER_playNote(loopCounter);
+			}
+		}
+		EXIT_CRITICAL_SECTION(sreg);
+	}
+}
+
+/*
+ * [Function Name]: BUZZER_setTone
+ * [Function Description]: sets the timer of the buzzer pin to toggle it at a frequency,
+ * 						   or disconnects the pin from the timer and drives it low
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer, OC0, OC1A or OC2
+ * [in]: uint16_t a_frequency
+ * 		 frequency in Hz, 0 to silence the buzzer
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if the pin isn't OC0, OC1A or OC2
+ */
+static uint8_t BUZZER_setTone(uint8_t a_buzzerPin, uint16_t a_frequency)
+{
+	TIMER_config timerConfig = {TIMER_0, TIMER_0_CTC, TIMER_0_PRESCALER_1, 1, NULL};
+	FLASH_CONST uint8_t * prescalersShifts = g_prescalersShifts;
+	uint8_t prescalersCount = sizeof(g_prescalersShifts);
+	uint32_t maxTicks = TIMER_0_MAX_COUNT + 1UL;
+	uint32_t ticks = maxTicks;
+	uint8_t loopCounter;
+
+	switch(a_buzzerPin)
+	{
+	case OC0:
+		timerConfig.mode = (a_frequency == 0) ? TIMER_0_CTC : TIMER_0_CTC_TOGGLE_OC0;
+		break;
+	case OC1A:
+		timerConfig.timer = TIMER_1;
+		timerConfig.mode = (a_frequency == 0) ? TIMER_1_CTC : TIMER_1_CTC_TOGGLE_OC1A;
+		maxTicks = TIMER_1_MAX_COUNT + 1UL;
+		break;
+	case OC2:
+		timerConfig.timer = TIMER_2;
+		timerConfig.mode = (a_frequency == 0) ? TIMER_2_CTC : TIMER_2_CTC_TOGGLE_OC2;
+		prescalersShifts = g_timer2PrescalersShifts;
+		prescalersCount = sizeof(g_timer2PrescalersShifts);
+		break;
+	default:
+		return BUZZER_ERROR;
+	}
+
+	if(a_frequency == 0)
+	{
+		/* the timer is stopped in ctc mode without the pin, so it's driven by DIO */
+		TIMER_init(&timerConfig);
+		DIO_writePin(a_buzzerPin, LOW);
+		return BUZZER_SUCCESS;
+	}
+
+	/* the pin toggles on each compare match, so the period is half the tone period,
+	 * the lowest prescaler that fits it in the timer gives the most accurate frequency
+	 */
+	for(loopCounter = 0; loopCounter < prescalersCount; loopCounter ++)
+	{
+		ticks = ((F_CPU >> prescalersShifts[loopCounter]) + a_frequency) / (2UL * a_frequency);
+		if(ticks <= maxTicks)
+		{
+			break;
+		}
+	}
+
+	/* the lowest possible frequency */
+	if(loopCounter == prescalersCount)
+	{
+		loopCounter --;
+		ticks = maxTicks;
+	}
+	else if(ticks == 0)
+	{
+		ticks = 1;
+	}
+
+	/* prescalers of all timers start from 1 */
+	timerConfig.prescaler = TIMER_0_PRESCALER_1 + loopCounter;
+	timerConfig.ticks = ticks;
+
+	TIMER_init(&timerConfig);
+	TIMER_start(timerConfig.timer);
+
+	return BUZZER_SUCCESS;
+}
+
+/*
+ * [Function Name]: BUZZER_toneIndex
+ * [Function Description]: stops the melody of a buzzer and sounds it at a frequency
+ * [Args]:
+ * [in]: uint8_t a_buzzerIndex
+ * 		 buzzer index, 0 if BUZZERS_USED_COUNT = 1
+ * [in]: uint16_t a_frequency
+ * 		 frequency in Hz, 0 to silence the buzzer
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if the buzzer isn't on OC0, OC1A or OC2
+ */
+static uint8_t BUZZER_toneIndex(uint8_t a_buzzerIndex, uint16_t a_frequency)
+{
+	uint8_t result;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	g_isMelodyPlaying[a_buzzerIndex] = FALSE;
+	result = BUZZER_setTone(BUZZER_PIN_OF(a_buzzerIndex), a_frequency);
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return result;
+}
+
+/*
+ * [Function Name]: BUZZER_playMelodyIndex
+ * [Function Description]: starts playing a melody on a buzzer, same as BUZZER_playMelody()
+ * [Args]:
+ * [in]: uint8_t a_buzzerIndex
+ * 		 buzzer index, 0 if BUZZERS_USED_COUNT = 1
+ * [in]: FLASH_CONST ST_BuzzerNote * a_melody
+ * 		 notes of the melody, ended by a note with 0 duration
+ * [in]: uint8_t a_playsCount
+ * 		 times to play the melody, BUZZER_MELODY_LOOP to repeat it till it's stopped
+ * [in]: uint8_t a_priority
+ * 		 priority of the melody, 0 is the highest priority
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR
+ */
+static uint8_t BUZZER_playMelodyIndex(uint8_t a_buzzerIndex, FLASH_CONST ST_BuzzerNote * a_melody, uint8_t a_playsCount, uint8_t a_priority)
+{
+	uint8_t pin = BUZZER_PIN_OF(a_buzzerIndex);
+	uint8_t sreg;
+
+	if(a_melody == NULL || (pin != OC0 && pin != OC1A && pin != OC2))
+	{
+		return BUZZER_ERROR;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+
+	/* a melody with a higher priority isn't interrupted */
+	if(g_isMelodyPlaying[a_buzzerIndex] == TRUE && a_priority > g_melodiesPriorities[a_buzzerIndex])
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return BUZZER_ERROR;
+	}
+
+	g_melodies[a_buzzerIndex] = a_melody;
+	g_notesIndices[a_buzzerIndex] = 0;
+	g_playsLeft[a_buzzerIndex] = a_playsCount;
+	g_melodiesPriorities[a_buzzerIndex] = a_priority;
+	g_isMelodyPlaying[a_buzzerIndex] = TRUE;
+	BUZZER_playNote(a_buzzerIndex);
+
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return BUZZER_SUCCESS;
+}
+
+/*
+ * [Function Name]: BUZZER_playNote
+ * [Function Description]: sounds the current note of the melody of a buzzer, at the end of
+ * 						   the melody it starts it again or stops it depending on its plays count
+ * [Args]:
+ * [in]: uint8_t a_buzzerIndex
+ * 		 buzzer index, 0 if BUZZERS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void BUZZER_playNote(uint8_t a_buzzerIndex)
+{
+	FLASH_CONST ST_BuzzerNote * note = &g_melodies[a_buzzerIndex][g_notesIndices[a_buzzerIndex]];
+	uint16_t durationMs = note->durationMs;
+
+	if(durationMs == 0)
+	{
+		/* an empty melody or the last play, BUZZER_MELODY_LOOP never reaches 0 */
+		if(g_notesIndices[a_buzzerIndex] == 0 || g_playsLeft[a_buzzerIndex] == 1)
+		{
+			g_isMelodyPlaying[a_buzzerIndex] = FALSE;
+			BUZZER_setTone(BUZZER_PIN_OF(a_buzzerIndex), 0);
+			return;
+		}
+		if(g_playsLeft[a_buzzerIndex] != BUZZER_MELODY_LOOP)
+		{
+			g_playsLeft[a_buzzerIndex] --;
+		}
+		g_notesIndices[a_buzzerIndex] = 0;
+		note = g_melodies[a_buzzerIndex];
+		durationMs = note->durationMs;
+	}
+
+	BUZZER_setTone(BUZZER_PIN_OF(a_buzzerIndex), note->frequency);
+
+	/* the duration rounded to ticks, at least one tick */
+	g_noteTicksLeft[a_buzzerIndex] = (durationMs + BUZZER_TICK_MS / 2) / BUZZER_TICK_MS;
+	if(g_noteTicksLeft[a_buzzerIndex] == 0)
+	{
+		g_noteTicksLeft[a_buzzerIndex] = 1;
+	}
+}
+
+#if BUZZERS_USED_COUNT > 1
+
+/*
+ * [Function Name]: BUZZER_getIndex
+ * [Function Description]: gets the index of a buzzer by its pin
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer
+ * [Return]: uint8_t
+ * 			 buzzer index or BUZZERS_USED_COUNT if the pin isn't a buzzer
+ */
+static uint8_t BUZZER_getIndex(uint8_t a_buzzerPin)
+{
+	uint8_t loopCounter;
+
+	for(loopCounter = 0; loopCounter < BUZZERS_USED_COUNT; loopCounter ++)
+	{
+		if(g_buzzersPins[loopCounter] == a_buzzerPin)
+		{
+			break;
+		}
+	}
+	return loopCounter;
+}
+
+#endif /* BUZZERS_USED_COUNT > 1 */
+
+#endif /* BUZZER_TONE_ENABLED == 1 */
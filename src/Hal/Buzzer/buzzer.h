@@ -34,6 +34,39 @@
 #define BUZZER_ON			 			 1
 #define BUZZER_OFF			 			 0
 
+#if BUZZER_TONE_ENABLED == 1
+
+/* results of the tone and melody functions */
+#define BUZZER_SUCCESS			 		 1
+#define BUZZER_ERROR			 		 0
+
+/* plays count to repeat a melody till it's stopped */
+#define BUZZER_MELODY_LOOP			 	 0
+
+/* frequency of a rest note */
+#define BUZZER_NOTE_REST			 	 0
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+/*
+ * [Struct Name]: ST_BuzzerNote
+ * [Struct Description]: contains a note of a melody, a melody is an array of notes
+ * 						 declared with FLASH_CONST and ended by a note with 0 duration
+ */
+typedef struct
+{
+	/* frequency of the note in Hz, BUZZER_NOTE_REST for silence */
+	uint16_t frequency;
+
+	/* duration of the note in ms, 0 ends the melody */
+	uint16_t durationMs;
+
+}ST_BuzzerNote;
+
+#endif /* BUZZER_TONE_ENABLED == 1 */
+
 /*******************************************************************************
  *                           Function Prototypes                               *
  *******************************************************************************/
@@ -119,4 +152,134 @@ void BUZZER_off(uint8_t a_buzzerPin);
 
 #endif /* BUZZERS_USED_COUNT == 1 */
 
+/************** BUZZER tones ****************/
+
+#if BUZZER_TONE_ENABLED == 1
+
+#if BUZZERS_USED_COUNT == 1
+
+/*
+ * [Function Name]: BUZZER_tone
+ * [Function Description]: sounds the buzzer at a frequency till it's changed, the pin is
+ * 						   toggled by the timer so the cpu isn't used while sounding.
+ * 						   It stops the playing melody, BUZZER_on() and BUZZER_off() can't
+ * 						   be used while sounding
+ * [Args]:
+ * [in]: uint16_t a_frequency
+ * 		 frequency in Hz, 0 to silence the buzzer
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if the buzzer isn't on OC0, OC1A or OC2
+ */
+uint8_t BUZZER_tone(uint16_t a_frequency);
+
+/*
+ * [Function Name]: BUZZER_playMelody
+ * [Function Description]: starts playing a melody from BUZZER_tick(), it interrupts the
+ * 						   playing melody if it doesn't have a higher priority
+ * [Args]:
+ * [in]: FLASH_CONST ST_BuzzerNote * a_melody
+ * 		 notes of the melody, ended by a note with 0 duration
+ * [in]: uint8_t a_playsCount
+ * 		 times to play the melody, BUZZER_MELODY_LOOP to repeat it till it's stopped
+ * [in]: uint8_t a_priority
+ * 		 priority of the melody, 0 is the highest priority
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if a melody with a higher priority is
+ * 			 playing or the buzzer isn't on OC0, OC1A or OC2
+ */
+uint8_t BUZZER_playMelody(FLASH_CONST ST_BuzzerNote * a_melody, uint8_t a_playsCount, uint8_t a_priority);
+
+/*
+ * [Function Name]: BUZZER_stopMelody
+ * [Function Description]: stops the playing melody and silences the buzzer
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void BUZZER_stopMelody(void);
+
+/*
+ * [Function Name]: BUZZER_isPlaying
+ * [Function Description]: checks if a melody is playing
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if a melody is playing, FALSE otherwise
+ */
+uint8_t BUZZER_isPlaying(void);
+
+#else
+
+/*
+ * [Function Name]: BUZZER_tone
+ * [Function Description]: sounds the buzzer at a frequency till it's changed, the pin is
+ * 						   toggled by the timer so the cpu isn't used while sounding.
+ * 						   It stops the playing melody, BUZZER_on() and BUZZER_off() can't
+ * 						   be used while sounding
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer, OC0, OC1A or OC2
+ * [in]: uint16_t a_frequency
+ * 		 frequency in Hz, 0 to silence the buzzer
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if the pin isn't an initialized buzzer
+ * 			 on OC0, OC1A or OC2
+ */
+uint8_t BUZZER_tone(uint8_t a_buzzerPin, uint16_t a_frequency);
+
+/*
+ * [Function Name]: BUZZER_playMelody
+ * [Function Description]: starts playing a melody from BUZZER_tick(), it interrupts the
+ * 						   playing melody of the buzzer if it doesn't have a higher priority
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer, OC0, OC1A or OC2
+ * [in]: FLASH_CONST ST_BuzzerNote * a_melody
+ * 		 notes of the melody, ended by a note with 0 duration
+ * [in]: uint8_t a_playsCount
+ * 		 times to play the melody, BUZZER_MELODY_LOOP to repeat it till it's stopped
+ * [in]: uint8_t a_priority
+ * 		 priority of the melody, 0 is the highest priority
+ * [Return]: uint8_t
+ * 			 BUZZER_SUCCESS or BUZZER_ERROR if a melody with a higher priority is
+ * 			 playing or the pin isn't an initialized buzzer on OC0, OC1A or OC2
+ */
+uint8_t BUZZER_playMelody(uint8_t a_buzzerPin, FLASH_CONST ST_BuzzerNote * a_melody, uint8_t a_playsCount, uint8_t a_priority);
+
+/*
+ * [Function Name]: BUZZER_stopMelody
+ * [Function Description]: stops the playing melody and silences the buzzer
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer
+ * [Return]: void
+ */
+void BUZZER_stopMelody(uint8_t a_buzzerPin);
+
+/*
+ * [Function Name]: BUZZER_isPlaying
+ * [Function Description]: checks if a melody is playing
+ * [Args]:
+ * [in]: uint8_t a_buzzerPin
+ * 		 pin of the buzzer
+ * [Return]: uint8_t
+ * 			 TRUE if a melody is playing, FALSE otherwise
+ */
+uint8_t BUZZER_isPlaying(uint8_t a_buzzerPin);
+
+#endif /* BUZZERS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: BUZZER_tick
+ * [Function Description]: plays the next notes of the melodies, it must be called every
+ * 						   BUZZER_TICK_MS, i.e. from a scheduler task or a timer handler.
+ * 						   It only changes the timers when a note ends
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void BUZZER_tick(void);
+
+#endif /* BUZZER_TONE_ENABLED == 1 */
+
 #endif /* __BUZZER_H__ */
@@ -48,4 +48,145 @@
 
 #endif /* DCMOTORS_USED_COUNT == 1 */
 
+/* if DCMOTOR_SPEED_CONTROL_ENABLED = 1, DCMOTOR_setSpeedRpm() keeps each motor at
+ * a target speed, the speed is measured from a tach pulse (or one encoder channel)
+ * on an external interrupt pin and a PID controller updates the pwm duty cycle
+ * every control period.
+ * It requires DCMOTOR_ENABLE_PIN_IS_CONNECTED = 1 with a pwm enable pin, and up to
+ * 3 motors as each motor uses one of INT0, INT1 and INT2
+ */
+#define DCMOTOR_SPEED_CONTROL_ENABLED				1
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+
+#if DCMOTORS_USED_COUNT == 1
+
+/* the external interrupt pin the tach output of the motor is connected to,
+ * available only if DCMOTORS_USED_COUNT = 1
+ */
+#define DCMOTOR_TACH_PIN							PD2
+
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+/* tach pulses in one revolution of the motor shaft.
+ * The measured speed resolution is 60000 / (DCMOTOR_TACH_PULSES_PER_REV * DCMOTOR_CONTROL_PERIOD_MS)
+ * rpm, i.e. 15 rpm with the default config
+ */
+#define DCMOTOR_TACH_PULSES_PER_REV					200
+
+/* if DCMOTOR_CONTROL_TIMER_ENABLED = 1, the controller runs from a timer interrupt,
+ * otherwise DCMOTOR_speedControlUpdate() must be called every DCMOTOR_CONTROL_PERIOD_MS
+ * by the application, i.e. from a scheduler task. It's disabled by default as TIMER_0
+ * is the scheduler timer
+ */
+#define DCMOTOR_CONTROL_TIMER_ENABLED				0
+
+#if DCMOTOR_CONTROL_TIMER_ENABLED == 1
+
+/* the timer used for the control period, its mode and prescaler, see timer.h.
+ * It mustn't be the timer of the pwm enable pins
+ */
+#define DCMOTOR_CONTROL_TIMER						TIMER_0
+#define DCMOTOR_CONTROL_TIMER_MODE					TIMER_0_CTC
+#define DCMOTOR_CONTROL_TIMER_PRESCALER				TIMER_0_PRESCALER_1024
+
+/* the division value of DCMOTOR_CONTROL_TIMER_PRESCALER */
+#define DCMOTOR_CONTROL_PRESCALER_VALUE				1024
+
+#endif /* DCMOTOR_CONTROL_TIMER_ENABLED == 1 */
+
+/* the control period in ms */
+#define DCMOTOR_CONTROL_PERIOD_MS					20
+
+/* PID gains in 1/256 duty percent per rpm of error, the integral gain is per
+ * control period and the derivative gain is per rpm change in one control period
+ */
+#define DCMOTOR_KP_Q8								20
+#define DCMOTOR_KI_Q8								4
+#define DCMOTOR_KD_Q8								0
+
+/* maximum change of the duty cycle in one control period in percent,
+ * limits the current when starting or changing the target speed
+ */
+#define DCMOTOR_MAX_DUTY_STEP						5
+
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+
+/* if DCMOTOR_RAMP_ENABLED = 1, DCMOTOR_moveTo() changes the duty cycle gradually by an
+ * acceleration profile, executed from DCMOTOR_rampTick() which must be called every
+ * DCMOTOR_RAMP_TICK_MS by the application, i.e. from a scheduler task.
+ * It requires DCMOTOR_ENABLE_PIN_IS_CONNECTED = 1 with a pwm enable pin
+ */
+#define DCMOTOR_RAMP_ENABLED						1
+
+#if DCMOTOR_RAMP_ENABLED == 1
+
+/* the period DCMOTOR_rampTick() is called at in ms */
+#define DCMOTOR_RAMP_TICK_MS						10
+
+/* if DCMOTOR_RAMP_S_CURVE = 1, the duty cycle follows an s-curve, the acceleration
+ * starts and ends at 0 and its peak is 1.5 the acceleration passed to DCMOTOR_moveTo().
+ * Otherwise the profile is trapezoidal, i.e. the acceleration is constant
+ */
+#define DCMOTOR_RAMP_S_CURVE						0
+
+/* the time both bridge inputs are kept low after ramping down to 0 before
+ * reversing the direction, so the motor slows down before the reverse voltage is applied
+ */
+#define DCMOTOR_DEAD_TIME_MS						100
+
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
+/* if DCMOTOR_CURRENT_SENSE_ENABLED = 1, the current of each motor is measured from a shunt
+ * on an adc pin. The conversions are auto triggered by the overflow of the pwm timer of
+ * the enable pins, i.e. at the start of the on phase of the fast pwm, and the sample is
+ * held 2 adc clocks after the trigger (16 us with the adc clock of 125KHz). If the on
+ * phase is shorter than that, at a low duty cycle, the sample lands in the off phase and
+ * reads less than the motor current. Each trigger converts one motor, so each motor is sampled every
+ * DCMOTORS_USED_COUNT pwm periods, and the motor is cut off from the adc interrupt of
+ * the first sample above DCMOTOR_OVERCURRENT_MILLI_AMP.
+ * The adc must be initialized with ADC_INTERRUPT_ON, the adc callback is set by
+ * DCMOTOR_currentSenseInit() so it and the other adc read functions mustn't be used by
+ * the application. It requires DCMOTOR_ENABLE_PIN_IS_CONNECTED = 1 with pwm enable pins
+ * on the same timer
+ */
+#define DCMOTOR_CURRENT_SENSE_ENABLED				1
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+
+#if DCMOTORS_USED_COUNT == 1
+
+/* the adc pin the shunt voltage is connected to,
+ * available only if DCMOTORS_USED_COUNT = 1
+ */
+#define DCMOTOR_CURRENT_PIN							PA1
+
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+/* the overflow of the pwm timer of the enable pins:
+ * ADC_ATC_FREE_TIMER_0_OVF for PWM0, or ADC_ATC_FREE_TIMER_1_OVF for PWM1A and PWM1B
+ */
+#define DCMOTOR_CURRENT_TRIGGER						ADC_ATC_FREE_TIMER_1_OVF
+
+/* the shunt resistance in milli ohm and the gain of the amplifier between
+ * the shunt and the adc pin, 1 if there is no amplifier
+ */
+#define DCMOTOR_SHUNT_MILLI_OHM						100
+#define DCMOTOR_CURRENT_SENSE_GAIN					10
+
+/* 2^DCMOTOR_CURRENT_WINDOW_SHIFT samples are averaged for each average and rms
+ * current, from 0 to 6
+ */
+#define DCMOTOR_CURRENT_WINDOW_SHIFT				4
+
+/* the current that cuts off the motor, its adc value must be less than 1023 */
+#define DCMOTOR_OVERCURRENT_MILLI_AMP				3000
+
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
+/* making sure F_CPU is defined */
+#ifndef F_CPU
+#define F_CPU										1000000UL
+#endif /* F_CPU */
+
 #endif /* __DC_MOTOR_CONFIG_H__ */
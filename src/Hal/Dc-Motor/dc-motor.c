@@ -27,6 +27,251 @@
 
 #endif /* DCMOTOR_ENABLE_PIN_IS_CONNECTED == 1 */
 
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+
+/* For counting the tach pulses */
+#include "../../Mcal/External-Interrupt/external-interrupt.h"
+
+#if DCMOTOR_CONTROL_TIMER_ENABLED == 1
+
+/* for using the control timer */
+#include "../../Mcal/Timer/timer.h"
+
+#endif /* DCMOTOR_CONTROL_TIMER_ENABLED == 1 */
+
+#if DCMOTOR_ENABLE_PIN_IS_CONNECTED == 0
+#error "DCMOTOR_SPEED_CONTROL_ENABLED requires DCMOTOR_ENABLE_PIN_IS_CONNECTED = 1"
+#endif
+
+#if DCMOTORS_USED_COUNT > 3
+#error "DCMOTOR_SPEED_CONTROL_ENABLED supports up to 3 motors, one for each external interrupt"
+#endif
+
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+
+#if DCMOTOR_RAMP_ENABLED == 1 && DCMOTOR_ENABLE_PIN_IS_CONNECTED == 0
+#error "DCMOTOR_RAMP_ENABLED requires DCMOTOR_ENABLE_PIN_IS_CONNECTED = 1"
+#endif
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+
+/* For sampling the shunt voltage */
+#include "../../Mcal/Adc/adc.h"
+
+/* For the square root of the rms current */
+#include "../../Lib/math-utils.h"
+
+#if DCMOTOR_ENABLE_PIN_IS_CONNECTED == 0
+#error "DCMOTOR_CURRENT_SENSE_ENABLED requires DCMOTOR_ENABLE_PIN_IS_CONNECTED = 1"
+#endif
+
+#if DCMOTOR_CURRENT_WINDOW_SHIFT > 6
+#error "DCMOTOR_CURRENT_WINDOW_SHIFT must be from 0 to 6"
+#endif
+
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* maximum duty cycle with 8 fraction bits */
+#define DCMOTOR_MAX_DUTY_Q8							((int32_t)100 << 8)
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+
+/* maximum duty cycle change in one control period with 8 fraction bits */
+#define DCMOTOR_MAX_DUTY_STEP_Q8					((int32_t)DCMOTOR_MAX_DUTY_STEP << 8)
+
+/* rpm = pulses * DCMOTOR_RPM_PER_PULSE_NUM / DCMOTOR_RPM_PER_PULSE_DEN */
+#define DCMOTOR_RPM_PER_PULSE_NUM					60000UL
+#define DCMOTOR_RPM_PER_PULSE_DEN					((uint32_t)DCMOTOR_TACH_PULSES_PER_REV * DCMOTOR_CONTROL_PERIOD_MS)
+
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+
+#if DCMOTOR_RAMP_ENABLED == 1
+
+/* states of the ramp of each motor */
+#define DCMOTOR_RAMP_IDLE							0
+#define DCMOTOR_RAMP_RUNNING						1
+#define DCMOTOR_RAMP_DEAD_TIME						2
+
+/* DCMOTOR_DEAD_TIME_MS in ramp ticks, rounded up */
+#define DCMOTOR_DEAD_TIME_TICKS						((DCMOTOR_DEAD_TIME_MS + DCMOTOR_RAMP_TICK_MS - 1) / DCMOTOR_RAMP_TICK_MS)
+
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+
+/* the reference voltage of the adc in mv */
+#define DCMOTOR_REF_MILLI_VOLT						((uint32_t)(ADC_REF_VOLT_VALUE * 1000UL))
+
+/* the denominator of converting adc values to mA, mA = value * ref / (1024 * shunt * gain) */
+#define DCMOTOR_CURRENT_DIVISOR						((uint64_t)(ADC_MAXIMUM_VALUE + 1) * DCMOTOR_SHUNT_MILLI_OHM * DCMOTOR_CURRENT_SENSE_GAIN)
+
+/* DCMOTOR_OVERCURRENT_MILLI_AMP in adc values */
+#define DCMOTOR_OVERCURRENT_VALUE					((uint16_t)(((uint64_t)DCMOTOR_OVERCURRENT_MILLI_AMP * DCMOTOR_CURRENT_DIVISOR) \
+															/ (DCMOTOR_REF_MILLI_VOLT * 1000UL)))
+
+/* samples in the averaging window */
+#define DCMOTOR_CURRENT_WINDOW_SAMPLES				(1 << DCMOTOR_CURRENT_WINDOW_SHIFT)
+
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
+/*******************************************************************************
+ *                                Macros                                       *
+ *******************************************************************************/
+
+/* pins and start function of the motor with the passed index */
+#if DCMOTORS_USED_COUNT == 1
+#define DCMOTOR_PIN1_OF(index)						DCMOTOR_PIN1
+#define DCMOTOR_PIN2_OF(index)						DCMOTOR_PIN2
+#define DCMOTOR_ENABLE_PIN_OF(index)				DCMOTOR_ENABLE_PIN
+#define DCMOTOR_TACH_PIN_OF(index)					DCMOTOR_TACH_PIN
+#define DCMOTOR_CURRENT_PIN_OF(index)				DCMOTOR_CURRENT_PIN
+#define DCMOTOR_START(index, direction, speed)		DCMOTOR_start(direction, speed)
+#define DCMOTOR_STOP(index)							DCMOTOR_stop()
+#else
+#define DCMOTOR_PIN1_OF(index)						(g_dcMotors[index].pin1)
+#define DCMOTOR_PIN2_OF(index)						(g_dcMotors[index].pin2)
+#define DCMOTOR_ENABLE_PIN_OF(index)				(g_dcMotors[index].enablePin)
+#define DCMOTOR_TACH_PIN_OF(index)					(g_dcMotors[index].tachPin)
+#define DCMOTOR_CURRENT_PIN_OF(index)				(g_dcMotors[index].currentPin)
+#define DCMOTOR_START(index, direction, speed)		DCMOTOR_start(index, direction, speed)
+#define DCMOTOR_STOP(index)							DCMOTOR_stop(index)
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+
+/*
+ * [Function Name]: DCMOTOR_speedControlInit
+ * [Function Description]: enables the tach interrupts of all motors and starts the
+ * 						   control timer, the motors aren't controlled till
+ * 						   DCMOTOR_setSpeedRpm() is called
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void DCMOTOR_speedControlInit(void);
+
+/*
+ * [Function Name]: DCMOTOR_setSpeed
+ * [Function Description]: sets the target speed of a motor, same as DCMOTOR_setSpeedRpm()
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [in]: int16_t a_rpm
+ * 		 target speed, positive for forward, negative for reverse and 0 to stop the motor
+ * [Return]: void
+ */
+static void DCMOTOR_setSpeed(uint8_t a_dcMotorIndex, int16_t a_rpm);
+
+/*
+ * [Function Name]: DCMOTOR_tachXHandler
+ * [Function Description]: called from the external interrupt of the tach pin of motor X
+ * 						   on each pulse to count it
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void DCMOTOR_tach0Handler(void);
+#if DCMOTORS_USED_COUNT > 1
+static void DCMOTOR_tach1Handler(void);
+#endif /* DCMOTORS_USED_COUNT > 1 */
+#if DCMOTORS_USED_COUNT > 2
+static void DCMOTOR_tach2Handler(void);
+#endif /* DCMOTORS_USED_COUNT > 2 */
+
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+
+#if DCMOTOR_RAMP_ENABLED == 1
+
+/*
+ * [Function Name]: DCMOTOR_moveToIndex
+ * [Function Description]: starts the ramp of a motor, same as DCMOTOR_moveTo()
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [in]: int8_t a_speedPercent
+ * 		 target duty cycle from -100 to 100, negative for reverse, 0 to stop the motor
+ * [in]: uint8_t a_acceleration
+ * 		 duty cycle change per second in percent, 0 to change it in one tick
+ * [Return]: void
+ */
+static void DCMOTOR_moveToIndex(uint8_t a_dcMotorIndex, int8_t a_speedPercent, uint8_t a_acceleration);
+
+/*
+ * [Function Name]: DCMOTOR_brakeIndex
+ * [Function Description]: brakes a motor, same as DCMOTOR_brake()
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void DCMOTOR_brakeIndex(uint8_t a_dcMotorIndex);
+
+/*
+ * [Function Name]: DCMOTOR_rampStartSegment
+ * [Function Description]: starts ramping a motor from its current duty cycle to the passed one,
+ * 						   the segment time is calculated from the motor acceleration
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [in]: int16_t a_targetDutyQ8
+ * 		 duty cycle at the end of the segment with 8 fraction bits, negative for reverse
+ * [Return]: void
+ */
+static void DCMOTOR_rampStartSegment(uint8_t a_dcMotorIndex, int16_t a_targetDutyQ8);
+
+/*
+ * [Function Name]: DCMOTOR_writeOutput
+ * [Function Description]: writes the direction pins and the pwm duty cycle of a motor,
+ * 						   both bridge inputs are low (coasting) at 0 duty cycle
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [in]: int16_t a_dutyQ8
+ * 		 duty cycle with 8 fraction bits, negative for reverse
+ * [Return]: void
+ */
+static void DCMOTOR_writeOutput(uint8_t a_dcMotorIndex, int16_t a_dutyQ8);
+
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+
+/*
+ * [Function Name]: DCMOTOR_currentSampled
+ * [Function Description]: called from the adc interrupt with each current sample, it cuts
+ * 						   off the motor on an overcurrent, accumulates the sample and
+ * 						   selects the channel of the next motor for the next trigger
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void DCMOTOR_currentSampled(void);
+
+/*
+ * [Function Name]: DCMOTOR_getCurrentIndex
+ * [Function Description]: gets the currents of a motor, same as DCMOTOR_getCurrent()
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [out]: uint16_t * a_averageMilliAmp
+ * 		  pointer to store the average current in mA in
+ * [out]: uint16_t * a_rmsMilliAmp
+ * 		  pointer to store the rms current in mA in
+ * [Return]: uint8_t
+ * 			 TRUE if the currents are measured, FALSE if no window is complete yet
+ */
+static uint8_t DCMOTOR_getCurrentIndex(uint8_t a_dcMotorIndex, uint16_t * a_averageMilliAmp, uint16_t * a_rmsMilliAmp);
+
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
 /*******************************************************************************
  *                      	   Global Variables		                           *
  *******************************************************************************/
@@ -38,6 +283,86 @@ static ST_DCMOTOR g_dcMotors[DCMOTORS_USED_COUNT];
 
 #endif /* DCMOTORS_USED_COUNT != 1 */
 
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+
+/* the tach interrupt handler of each motor */
+static void (* const g_tachHandlers[DCMOTORS_USED_COUNT])(void) = {
+		DCMOTOR_tach0Handler,
+#if DCMOTORS_USED_COUNT > 1
+		DCMOTOR_tach1Handler,
+#endif /* DCMOTORS_USED_COUNT > 1 */
+#if DCMOTORS_USED_COUNT > 2
+		DCMOTOR_tach2Handler,
+#endif /* DCMOTORS_USED_COUNT > 2 */
+};
+
+/* tach pulses counted in the current control period */
+static volatile uint16_t g_tachPulses[DCMOTORS_USED_COUNT];
+
+/* speeds measured in the last control period */
+static volatile uint16_t g_measuredRpm[DCMOTORS_USED_COUNT];
+
+/* set while the motor is controlled by DCMOTOR_setSpeedRpm() */
+static volatile uint8_t g_isSpeedControlled[DCMOTORS_USED_COUNT];
+
+/* target speeds and directions of the controlled motors */
+static volatile uint16_t g_targetRpm[DCMOTORS_USED_COUNT];
+static EN_DcMotorDirection g_targetDirection[DCMOTORS_USED_COUNT];
+
+/* controller state, the integral term and the duty cycle have 8 fraction bits */
+static int32_t g_integralQ8[DCMOTORS_USED_COUNT];
+static int32_t g_dutyQ8[DCMOTORS_USED_COUNT];
+static uint16_t g_previousRpm[DCMOTORS_USED_COUNT];
+
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+
+#if DCMOTOR_RAMP_ENABLED == 1
+
+/* ramp state of each motor, DCMOTOR_RAMP_IDLE, RUNNING or DEAD_TIME */
+static volatile uint8_t g_rampState[DCMOTORS_USED_COUNT];
+
+/* duty cycles applied to the motors with 8 fraction bits, negative for reverse */
+static int16_t g_currentDutyQ8[DCMOTORS_USED_COUNT];
+
+/* duty cycles at the start and the end of the current segment, and the final target
+ * which differs from the segment end only while reversing
+ */
+static int16_t g_rampStartQ8[DCMOTORS_USED_COUNT];
+static int16_t g_rampEndQ8[DCMOTORS_USED_COUNT];
+static int16_t g_finalTargetQ8[DCMOTORS_USED_COUNT];
+
+/* ticks of the current segment (or the dead time) and the ticks elapsed in it */
+static uint16_t g_rampTicks[DCMOTORS_USED_COUNT];
+static uint16_t g_rampElapsedTicks[DCMOTORS_USED_COUNT];
+
+/* acceleration of each motor in percent per second */
+static uint8_t g_rampAcceleration[DCMOTORS_USED_COUNT];
+
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+
+/* set when the motor is cut off by an overcurrent */
+static volatile uint8_t g_isOvercurrent[DCMOTORS_USED_COUNT];
+
+/* index of the motor being sampled */
+static uint8_t g_senseIndex;
+
+/* sums of the samples and their squares in the current window */
+static uint16_t g_senseSums[DCMOTORS_USED_COUNT];
+static uint32_t g_senseSquaresSums[DCMOTORS_USED_COUNT];
+static uint8_t g_senseSamplesCount[DCMOTORS_USED_COUNT];
+
+/* sums of the last complete window, and set after the first window */
+static volatile uint16_t g_currentSums[DCMOTORS_USED_COUNT];
+static volatile uint32_t g_currentSquaresSums[DCMOTORS_USED_COUNT];
+static volatile uint8_t g_isCurrentMeasured[DCMOTORS_USED_COUNT];
+
+/* function called after cutting off a motor */
+static void (* volatile g_overcurrentCallBack)(uint8_t a_dcMotorIndex) = NULL;
+
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
 /*******************************************************************************
  *                          Functions Definition	                           *
  *******************************************************************************/
@@ -61,6 +386,10 @@ void DCMOTOR_init(void)
 	DIO_pinInit(DCMOTOR_ENABLE_PIN, PIN_OUTPUT);
 
 #endif /* DCMOTOR_ENABLE_PIN_IS_CONNECTED == 1 */
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+	DCMOTOR_speedControlInit();
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
 }
 
 /*
@@ -75,6 +404,34 @@ void DCMOTOR_init(void)
  */
 void DCMOTOR_start(EN_DcMotorDirection a_direction, uint8_t a_speedPercent)
 {
+	uint8_t sreg;
+
+	/* the adc interrupt can't cut off the motor between the check and the writes */
+	ENTER_CRITICAL_SECTION(sreg);
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+	/* the motor is cut off till the overcurrent is cleared */
+	if(g_isOvercurrent[0] == TRUE)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return;
+	}
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+	/* the speed is set directly, stop the controller */
+	g_isSpeedControlled[0] = FALSE;
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+#if DCMOTOR_RAMP_ENABLED == 1
+	/* cancel the ramp, the next one starts from this speed */
+	g_rampState[0] = DCMOTOR_RAMP_IDLE;
+	if(a_speedPercent <= 100)
+	{
+		g_currentDutyQ8[0] = (a_direction == DCMOTOR_REVERSE) ? \
+				-((int16_t)a_speedPercent << 8) : ((int16_t)a_speedPercent << 8);
+	}
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
 	switch(a_direction)
 	{
 	case DCMOTOR_FORWARD:
@@ -88,12 +445,14 @@ void DCMOTOR_start(EN_DcMotorDirection a_direction, uint8_t a_speedPercent)
 		DIO_writePin(DCMOTOR_PIN2, HIGH);
 		break;
 	default:
+		EXIT_CRITICAL_SECTION(sreg);
 		return;
 	}
 #if DCMOTOR_ENABLE_PIN_IS_CONNECTED == 1
 	/* check if the input speed is greater than 100 */
 	if(a_speedPercent > 100)
 	{
+		EXIT_CRITICAL_SECTION(sreg);
 		return;
 	}
 	/* check if enable pin is connected to a pin that supports pwm */
@@ -103,6 +462,8 @@ void DCMOTOR_start(EN_DcMotorDirection a_direction, uint8_t a_speedPercent)
 		DIO_writePin(DCMOTOR_ENABLE_PIN, HIGH);
 	}
 #endif /* DCMOTOR_ENABLE_PIN_IS_CONNECTED == 1 */
+
+	EXIT_CRITICAL_SECTION(sreg);
 }
 
 /*
@@ -114,6 +475,14 @@ void DCMOTOR_start(EN_DcMotorDirection a_direction, uint8_t a_speedPercent)
  */
 void DCMOTOR_stop(void)
 {
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+	g_isSpeedControlled[0] = FALSE;
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+#if DCMOTOR_RAMP_ENABLED == 1
+	g_rampState[0] = DCMOTOR_RAMP_IDLE;
+	g_currentDutyQ8[0] = 0;
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
 	/* write low to both pins to stop the motor */
 	DIO_writePin(DCMOTOR_PIN1, LOW);
 	DIO_writePin(DCMOTOR_PIN2, LOW);
@@ -162,6 +531,9 @@ void DCMOTOR_init(const ST_DCMOTOR * a_dcMotors)
 
 	}
 
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+	DCMOTOR_speedControlInit();
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
 }
 
 /*
@@ -178,8 +550,36 @@ void DCMOTOR_init(const ST_DCMOTOR * a_dcMotors)
  */
 void DCMOTOR_start(uint8_t a_dcMotorIndex, EN_DcMotorDirection a_direction, uint8_t a_speedPercent)
 {
+	uint8_t sreg;
+
 	if(a_dcMotorIndex < DCMOTORS_USED_COUNT)
 	{
+		/* the adc interrupt can't cut off the motor between the check and the writes */
+		ENTER_CRITICAL_SECTION(sreg);
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+		/* the motor is cut off till the overcurrent is cleared */
+		if(g_isOvercurrent[a_dcMotorIndex] == TRUE)
+		{
+			EXIT_CRITICAL_SECTION(sreg);
+			return;
+		}
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+		/* the speed is set directly, stop the controller */
+		g_isSpeedControlled[a_dcMotorIndex] = FALSE;
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+#if DCMOTOR_RAMP_ENABLED == 1
+		/* cancel the ramp, the next one starts from this speed */
+		g_rampState[a_dcMotorIndex] = DCMOTOR_RAMP_IDLE;
+		if(a_speedPercent <= 100)
+		{
+			g_currentDutyQ8[a_dcMotorIndex] = (a_direction == DCMOTOR_REVERSE) ? \
+					-((int16_t)a_speedPercent << 8) : ((int16_t)a_speedPercent << 8);
+		}
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
 		switch(a_direction)
 		{
 		case DCMOTOR_FORWARD:
@@ -193,12 +593,14 @@ void DCMOTOR_start(uint8_t a_dcMotorIndex, EN_DcMotorDirection a_direction, uint
 			DIO_writePin(g_dcMotors[a_dcMotorIndex].pin2, HIGH);
 			break;
 		default:
+			EXIT_CRITICAL_SECTION(sreg);
 			return;
 		}
 #if DCMOTOR_ENABLE_PIN_IS_CONNECTED == 1
 		/* check if the input speed is greater than 100 */
 		if(a_speedPercent > 100)
 		{
+			EXIT_CRITICAL_SECTION(sreg);
 			return;
 		}
 		/* check if enable pin is connected to a pin that supports pwm */
@@ -208,6 +610,8 @@ void DCMOTOR_start(uint8_t a_dcMotorIndex, EN_DcMotorDirection a_direction, uint
 			DIO_writePin(g_dcMotors[a_dcMotorIndex].enablePin, HIGH);
 		}
 #endif /* DCMOTOR_ENABLE_PIN_IS_CONNECTED == 1 */
+
+		EXIT_CRITICAL_SECTION(sreg);
 	}
 }
 
@@ -223,6 +627,14 @@ void DCMOTOR_stop(uint8_t a_dcMotorIndex)
 {
 	if(a_dcMotorIndex < DCMOTORS_USED_COUNT)
 	{
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+		g_isSpeedControlled[a_dcMotorIndex] = FALSE;
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+#if DCMOTOR_RAMP_ENABLED == 1
+		g_rampState[a_dcMotorIndex] = DCMOTOR_RAMP_IDLE;
+		g_currentDutyQ8[a_dcMotorIndex] = 0;
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
 		/* write low to both pins to stop the motor */
 		DIO_writePin(g_dcMotors[a_dcMotorIndex].pin1, LOW);
 		DIO_writePin(g_dcMotors[a_dcMotorIndex].pin2, LOW);
@@ -239,3 +651,913 @@ void DCMOTOR_stop(uint8_t a_dcMotorIndex)
 }
 
 #endif /* DCMOTORS_USED_COUNT == 1 */
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+
+#if DCMOTORS_USED_COUNT == 1
+
+/*
+ * [Function Name]: DCMOTOR_setSpeedRpm
+ * [Function Description]: keeps the motor at the given speed by the PID controller,
+ * 						   DCMOTOR_start() and DCMOTOR_stop() stop the controller.
+ * 						   Global interrupts must be enabled
+ * [Args]:
+ * [in]: int16_t a_rpm
+ * 		 target speed, positive for forward, negative for reverse and 0 to stop the motor
+ * [Return]: void
+ */
+void DCMOTOR_setSpeedRpm(int16_t a_rpm)
+{
+	DCMOTOR_setSpeed(0, a_rpm);
+}
+
+/*
+ * [Function Name]: DCMOTOR_getSpeedRpm
+ * [Function Description]: gets the speed measured in the last control period
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 speed in rpm, it's always positive as the tach doesn't give the direction
+ */
+uint16_t DCMOTOR_getSpeedRpm(void)
+{
+	uint16_t rpm;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	rpm = g_measuredRpm[0];
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return rpm;
+}
+
+#else
+
+/*
+ * [Function Name]: DCMOTOR_setSpeedRpm
+ * [Function Description]: keeps the motor at the given speed by the PID controller,
+ * 						   DCMOTOR_start() and DCMOTOR_stop() stop the controller.
+ * 						   Global interrupts must be enabled
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [in]: int16_t a_rpm
+ * 		 target speed, positive for forward, negative for reverse and 0 to stop the motor
+ * [Return]: void
+ */
+void DCMOTOR_setSpeedRpm(uint8_t a_dcMotorIndex, int16_t a_rpm)
+{
+	if(a_dcMotorIndex < DCMOTORS_USED_COUNT)
+	{
+		DCMOTOR_setSpeed(a_dcMotorIndex, a_rpm);
+	}
+}
+
+/*
+ * [Function Name]: DCMOTOR_getSpeedRpm
+ * [Function Description]: gets the speed measured in the last control period
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: uint16_t
+ * 			 speed in rpm, it's always positive as the tach doesn't give the direction
+ */
+uint16_t DCMOTOR_getSpeedRpm(uint8_t a_dcMotorIndex)
+{
+	uint16_t rpm = 0;
+	uint8_t sreg;
+
+	if(a_dcMotorIndex < DCMOTORS_USED_COUNT)
+	{
+		ENTER_CRITICAL_SECTION(sreg);
+		rpm = g_measuredRpm[a_dcMotorIndex];
+		EXIT_CRITICAL_SECTION(sreg);
+	}
+
+	return rpm;
+}
+
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: DCMOTOR_speedControlUpdate
+ * [Function Description]: measures the speed of the controlled motors and updates their
+ * 						   duty cycles, it's called from the timer interrupt every
+ * 						   DCMOTOR_CONTROL_PERIOD_MS if DCMOTOR_CONTROL_TIMER_ENABLED = 1,
+ * 						   or by the application at the same period otherwise
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void DCMOTOR_speedControlUpdate(void)
+{
+	uint8_t loopCounter;
+	uint8_t sreg;
+	uint16_t pulses;
+	uint32_t rpm;
+	int32_t error, proportional, integral, derivative, duty;
+
+	for(loopCounter = 0; loopCounter < DCMOTORS_USED_COUNT; loopCounter ++)
+	{
+		ENTER_CRITICAL_SECTION(sreg);
+		pulses = g_tachPulses[loopCounter];
+		g_tachPulses[loopCounter] = 0;
+		EXIT_CRITICAL_SECTION(sreg);
+
+		/* speed from the pulses counted in the last period */
+		rpm = (uint32_t)pulses * DCMOTOR_RPM_PER_PULSE_NUM / DCMOTOR_RPM_PER_PULSE_DEN;
+		if(rpm > 0xFFFF)
+		{
+			rpm = 0xFFFF;
+		}
+		g_measuredRpm[loopCounter] = (uint16_t)rpm;
+
+		if(g_isSpeedControlled[loopCounter] == FALSE)
+		{
+			continue;
+		}
+
+		error = (int32_t)g_targetRpm[loopCounter] - (int32_t)rpm;
+		proportional = (int32_t)DCMOTOR_KP_Q8 * error;
+
+		/* derivative on the measurement, so changing the target doesn't kick the output */
+		derivative = (int32_t)DCMOTOR_KD_Q8 * ((int32_t)g_previousRpm[loopCounter] - (int32_t)rpm);
+		g_previousRpm[loopCounter] = (uint16_t)rpm;
+
+		integral = g_integralQ8[loopCounter] + (int32_t)DCMOTOR_KI_Q8 * error;
+		if(integral > DCMOTOR_MAX_DUTY_Q8)
+		{
+			integral = DCMOTOR_MAX_DUTY_Q8;
+		}
+		else if(integral < 0)
+		{
+			integral = 0;
+		}
+
+		duty = proportional + integral + derivative;
+
+		/* anti-windup, the integral isn't updated while the output is saturated
+		 * in the direction of the error
+		 */
+		if(!((duty > DCMOTOR_MAX_DUTY_Q8 && error > 0) || (duty < 0 && error < 0)))
+		{
+			g_integralQ8[loopCounter] = integral;
+		}
+
+		if(duty > DCMOTOR_MAX_DUTY_Q8)
+		{
+			duty = DCMOTOR_MAX_DUTY_Q8;
+		}
+		else if(duty < 0)
+		{
+			duty = 0;
+		}
+
+		/* slew limit of the output */
+		if(duty > g_dutyQ8[loopCounter] + DCMOTOR_MAX_DUTY_STEP_Q8)
+		{
+			duty = g_dutyQ8[loopCounter] + DCMOTOR_MAX_DUTY_STEP_Q8;
+		}
+		else if(duty < g_dutyQ8[loopCounter] - DCMOTOR_MAX_DUTY_STEP_Q8)
+		{
+			duty = g_dutyQ8[loopCounter] - DCMOTOR_MAX_DUTY_STEP_Q8;
+		}
+		g_dutyQ8[loopCounter] = duty;
+
+#if DCMOTOR_RAMP_ENABLED == 1
+		/* a ramp started later starts from the controller output */
+		g_currentDutyQ8[loopCounter] = (g_targetDirection[loopCounter] == DCMOTOR_REVERSE) ? \
+				-(int16_t)duty : (int16_t)duty;
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
+		/* round to the nearest percent */
+		PWM_enable(DCMOTOR_ENABLE_PIN_OF(loopCounter), (uint8_t)((duty + 128) >> 8));
+	}
+}
+
+/*
+ * [Function Name]: DCMOTOR_speedControlInit
+ * [Function Description]: enables the tach interrupts of all motors and starts the
+ * 						   control timer, the motors aren't controlled till
+ * 						   DCMOTOR_setSpeedRpm() is called
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void DCMOTOR_speedControlInit(void)
+{
+	uint8_t loopCounter;
+
+#if DCMOTOR_CONTROL_TIMER_ENABLED == 1
+	TIMER_config timerConfig = {
+			DCMOTOR_CONTROL_TIMER,
+			DCMOTOR_CONTROL_TIMER_MODE,
+			DCMOTOR_CONTROL_TIMER_PRESCALER,
+			TIME_MS_TO_TICKS(DCMOTOR_CONTROL_PRESCALER_VALUE, DCMOTOR_CONTROL_PERIOD_MS),
+			DCMOTOR_speedControlUpdate
+	};
+#endif /* DCMOTOR_CONTROL_TIMER_ENABLED == 1 */
+
+	for(loopCounter = 0; loopCounter < DCMOTORS_USED_COUNT; loopCounter ++)
+	{
+		g_isSpeedControlled[loopCounter] = FALSE;
+		g_tachPulses[loopCounter] = 0;
+		g_measuredRpm[loopCounter] = 0;
+
+		EXT_INT_enable(DCMOTOR_TACH_PIN_OF(loopCounter), EXT_INT_RISING_EDGE, g_tachHandlers[loopCounter]);
+	}
+
+#if DCMOTOR_CONTROL_TIMER_ENABLED == 1
+	TIMER_init(&timerConfig);
+	TIMER_start(DCMOTOR_CONTROL_TIMER);
+#endif /* DCMOTOR_CONTROL_TIMER_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: DCMOTOR_setSpeed
+ * [Function Description]: sets the target speed of a motor, same as DCMOTOR_setSpeedRpm()
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [in]: int16_t a_rpm
+ * 		 target speed, positive for forward, negative for reverse and 0 to stop the motor
+ * [Return]: void
+ */
+static void DCMOTOR_setSpeed(uint8_t a_dcMotorIndex, int16_t a_rpm)
+{
+	EN_DcMotorDirection direction = (a_rpm > 0) ? DCMOTOR_FORWARD : DCMOTOR_REVERSE;
+	uint16_t targetRpm = (a_rpm > 0) ? (uint16_t)a_rpm : (uint16_t)(-(int32_t)a_rpm);
+	uint8_t sreg;
+
+	if(a_rpm == 0)
+	{
+		DCMOTOR_STOP(a_dcMotorIndex);
+		return;
+	}
+
+	/* the adc interrupt can't cut off the motor between the check and the writes */
+	ENTER_CRITICAL_SECTION(sreg);
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+	if(g_isOvercurrent[a_dcMotorIndex] == TRUE)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return;
+	}
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
+	/* starting or reversing the motor, the output ramps up from 0 */
+	if(g_isSpeedControlled[a_dcMotorIndex] == FALSE || g_targetDirection[a_dcMotorIndex] != direction)
+	{
+		DCMOTOR_START(a_dcMotorIndex, direction, 0);
+
+		g_targetDirection[a_dcMotorIndex] = direction;
+		g_integralQ8[a_dcMotorIndex] = 0;
+		g_dutyQ8[a_dcMotorIndex] = 0;
+		g_previousRpm[a_dcMotorIndex] = g_measuredRpm[a_dcMotorIndex];
+		g_isSpeedControlled[a_dcMotorIndex] = TRUE;
+	}
+	g_targetRpm[a_dcMotorIndex] = targetRpm;
+
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: DCMOTOR_tachXHandler
+ * [Function Description]: called from the external interrupt of the tach pin of motor X
+ * 						   on each pulse to count it
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void DCMOTOR_tach0Handler(void)
+{
+	g_tachPulses[0] ++;
+}
+
+#if DCMOTORS_USED_COUNT > 1
+static void DCMOTOR_tach1Handler(void)
+{
+	g_tachPulses[1] ++;
+}
+#endif /* DCMOTORS_USED_COUNT > 1 */
+
+#if DCMOTORS_USED_COUNT > 2
+static void DCMOTOR_tach2Handler(void)
+{
+	g_tachPulses[2] ++;
+}
+#endif /* DCMOTORS_USED_COUNT > 2 */
+
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+
+#if DCMOTOR_RAMP_ENABLED == 1
+
+#if DCMOTORS_USED_COUNT == 1
+
+/*
+ * [Function Name]: DCMOTOR_moveTo
+ * [Function Description]: ramps the motor from its current duty cycle to the given one
+ * 						   without waiting, reversing ramps down to 0 and waits
+ * 						   DCMOTOR_DEAD_TIME_MS first. DCMOTOR_start(), DCMOTOR_stop()
+ * 						   and DCMOTOR_brake() cancel the ramp
+ * [Args]:
+ * [in]: int8_t a_speedPercent
+ * 		 target duty cycle from -100 to 100, negative for reverse, 0 to stop the motor
+ * [in]: uint8_t a_acceleration
+ * 		 duty cycle change per second in percent, 0 to change it in one tick
+ * [Return]: void
+ */
+void DCMOTOR_moveTo(int8_t a_speedPercent, uint8_t a_acceleration)
+{
+	DCMOTOR_moveToIndex(0, a_speedPercent, a_acceleration);
+}
+
+/*
+ * [Function Name]: DCMOTOR_isTargetReached
+ * [Function Description]: checks if the ramp of the last DCMOTOR_moveTo() is done
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if the target is reached, FALSE if still ramping
+ */
+uint8_t DCMOTOR_isTargetReached(void)
+{
+	return (g_rampState[0] == DCMOTOR_RAMP_IDLE);
+}
+
+/*
+ * [Function Name]: DCMOTOR_brake
+ * [Function Description]: stops the motor actively by shorting it, both bridge inputs
+ * 						   and the enable pin are high
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void DCMOTOR_brake(void)
+{
+	DCMOTOR_brakeIndex(0);
+}
+
+#else
+
+/*
+ * [Function Name]: DCMOTOR_moveTo
+ * [Function Description]: ramps the motor from its current duty cycle to the given one
+ * 						   without waiting, reversing ramps down to 0 and waits
+ * 						   DCMOTOR_DEAD_TIME_MS first. DCMOTOR_start(), DCMOTOR_stop()
+ * 						   and DCMOTOR_brake() cancel the ramp
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [in]: int8_t a_speedPercent
+ * 		 target duty cycle from -100 to 100, negative for reverse, 0 to stop the motor
+ * [in]: uint8_t a_acceleration
+ * 		 duty cycle change per second in percent, 0 to change it in one tick
+ * [Return]: void
+ */
+void DCMOTOR_moveTo(uint8_t a_dcMotorIndex, int8_t a_speedPercent, uint8_t a_acceleration)
+{
+	if(a_dcMotorIndex < DCMOTORS_USED_COUNT)
+	{
+		DCMOTOR_moveToIndex(a_dcMotorIndex, a_speedPercent, a_acceleration);
+	}
+}
+
+/*
+ * [Function Name]: DCMOTOR_isTargetReached
+ * [Function Description]: checks if the ramp of the last DCMOTOR_moveTo() is done
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: uint8_t
+ * 			 TRUE if the target is reached, FALSE if still ramping
+ */
+uint8_t DCMOTOR_isTargetReached(uint8_t a_dcMotorIndex)
+{
+	if(a_dcMotorIndex >= DCMOTORS_USED_COUNT)
+	{
+		return TRUE;
+	}
+	return (g_rampState[a_dcMotorIndex] == DCMOTOR_RAMP_IDLE);
+}
+
+/*
+ * [Function Name]: DCMOTOR_brake
+ * [Function Description]: stops the motor actively by shorting it, both bridge inputs
+ * 						   and the enable pin are high
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: void
+ */
+void DCMOTOR_brake(uint8_t a_dcMotorIndex)
+{
+	if(a_dcMotorIndex < DCMOTORS_USED_COUNT)
+	{
+		DCMOTOR_brakeIndex(a_dcMotorIndex);
+	}
+}
+
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: DCMOTOR_rampTick
+ * [Function Description]: moves the ramping motors one step along their profiles,
+ * 						   it must be called every DCMOTOR_RAMP_TICK_MS
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void DCMOTOR_rampTick(void)
+{
+	uint8_t loopCounter;
+	uint8_t sreg;
+	int32_t progress;
+	int16_t duty;
+
+	for(loopCounter = 0; loopCounter < DCMOTORS_USED_COUNT; loopCounter ++)
+	{
+		ENTER_CRITICAL_SECTION(sreg);
+
+		if(g_rampState[loopCounter] == DCMOTOR_RAMP_DEAD_TIME)
+		{
+			g_rampElapsedTicks[loopCounter] ++;
+			if(g_rampElapsedTicks[loopCounter] >= g_rampTicks[loopCounter])
+			{
+				/* the motor slowed down, ramp up in the new direction */
+				DCMOTOR_rampStartSegment(loopCounter, g_finalTargetQ8[loopCounter]);
+			}
+		}
+		else if(g_rampState[loopCounter] == DCMOTOR_RAMP_RUNNING)
+		{
+			g_rampElapsedTicks[loopCounter] ++;
+
+			if(g_rampElapsedTicks[loopCounter] >= g_rampTicks[loopCounter])
+			{
+				duty = g_rampEndQ8[loopCounter];
+			}
+			else
+			{
+				/* progress in the segment from 0 to 256 */
+				progress = ((int32_t)g_rampElapsedTicks[loopCounter] << 8) / g_rampTicks[loopCounter];
+
+#if DCMOTOR_RAMP_S_CURVE == 1
+				/* smoothstep, 3x^2 - 2x^3 */
+				progress = (progress * progress * (768 - 2 * progress)) >> 16;
+#endif /* DCMOTOR_RAMP_S_CURVE == 1 */
+
+				duty = g_rampStartQ8[loopCounter] + \
+						(int16_t)(((int32_t)(g_rampEndQ8[loopCounter] - g_rampStartQ8[loopCounter]) * progress) / 256);
+			}
+
+			g_currentDutyQ8[loopCounter] = duty;
+			DCMOTOR_writeOutput(loopCounter, duty);
+
+			if(g_rampElapsedTicks[loopCounter] >= g_rampTicks[loopCounter])
+			{
+				if(g_rampEndQ8[loopCounter] != g_finalTargetQ8[loopCounter])
+				{
+					/* ramped down to 0 for reversing, coast for the dead time */
+					g_rampState[loopCounter] = DCMOTOR_RAMP_DEAD_TIME;
+					g_rampTicks[loopCounter] = DCMOTOR_DEAD_TIME_TICKS;
+					g_rampElapsedTicks[loopCounter] = 0;
+				}
+				else
+				{
+					g_rampState[loopCounter] = DCMOTOR_RAMP_IDLE;
+				}
+			}
+		}
+
+		EXIT_CRITICAL_SECTION(sreg);
+	}
+}
+
+/*
+ * [Function Name]: DCMOTOR_moveToIndex
+ * [Function Description]: starts the ramp of a motor, same as DCMOTOR_moveTo()
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [in]: int8_t a_speedPercent
+ * 		 target duty cycle from -100 to 100, negative for reverse, 0 to stop the motor
+ * [in]: uint8_t a_acceleration
+ * 		 duty cycle change per second in percent, 0 to change it in one tick
+ * [Return]: void
+ */
+static void DCMOTOR_moveToIndex(uint8_t a_dcMotorIndex, int8_t a_speedPercent, uint8_t a_acceleration)
+{
+	int16_t targetQ8 = (int16_t)a_speedPercent * 256;
+	int16_t currentQ8;
+	uint8_t sreg;
+
+	if(a_speedPercent > 100 || a_speedPercent < -100)
+	{
+		return;
+	}
+
+	/* the adc interrupt can't cut off the motor between the check and the writes */
+	ENTER_CRITICAL_SECTION(sreg);
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+	if(g_isOvercurrent[a_dcMotorIndex] == TRUE)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return;
+	}
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+	/* the duty cycle is set by the ramp, stop the controller */
+	g_isSpeedControlled[a_dcMotorIndex] = FALSE;
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+
+	currentQ8 = g_currentDutyQ8[a_dcMotorIndex];
+	g_finalTargetQ8[a_dcMotorIndex] = targetQ8;
+	g_rampAcceleration[a_dcMotorIndex] = a_acceleration;
+
+	if(g_rampState[a_dcMotorIndex] == DCMOTOR_RAMP_DEAD_TIME)
+	{
+		/* the dead time completes first, then the ramp goes to the new target */
+	}
+	else if((currentQ8 > 0 && targetQ8 < 0) || (currentQ8 < 0 && targetQ8 > 0))
+	{
+		/* reversing, ramp down to 0 first */
+		DCMOTOR_rampStartSegment(a_dcMotorIndex, 0);
+	}
+	else
+	{
+		DCMOTOR_rampStartSegment(a_dcMotorIndex, targetQ8);
+	}
+
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: DCMOTOR_brakeIndex
+ * [Function Description]: brakes a motor, same as DCMOTOR_brake()
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void DCMOTOR_brakeIndex(uint8_t a_dcMotorIndex)
+{
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+	g_isSpeedControlled[a_dcMotorIndex] = FALSE;
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+	g_rampState[a_dcMotorIndex] = DCMOTOR_RAMP_IDLE;
+	g_currentDutyQ8[a_dcMotorIndex] = 0;
+
+	/* both inputs high short the motor through the bridge */
+	DIO_writePin(DCMOTOR_PIN1_OF(a_dcMotorIndex), HIGH);
+	DIO_writePin(DCMOTOR_PIN2_OF(a_dcMotorIndex), HIGH);
+
+	/* check if enable pin is connected to a pin that supports pwm */
+	if(PWM_enable(DCMOTOR_ENABLE_PIN_OF(a_dcMotorIndex), 100) == PWM_ERROR)
+	{
+		/* write high if pwm is not supported on enable pin */
+		DIO_writePin(DCMOTOR_ENABLE_PIN_OF(a_dcMotorIndex), HIGH);
+	}
+
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: DCMOTOR_rampStartSegment
+ * [Function Description]: starts ramping a motor from its current duty cycle to the passed one,
+ * 						   the segment time is calculated from the motor acceleration
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [in]: int16_t a_targetDutyQ8
+ * 		 duty cycle at the end of the segment with 8 fraction bits, negative for reverse
+ * [Return]: void
+ */
+static void DCMOTOR_rampStartSegment(uint8_t a_dcMotorIndex, int16_t a_targetDutyQ8)
+{
+	int32_t change = (int32_t)a_targetDutyQ8 - g_currentDutyQ8[a_dcMotorIndex];
+	uint32_t changePerTick;
+	uint32_t ticks = 1;
+
+	if(change < 0)
+	{
+		change = -change;
+	}
+
+	if(g_rampAcceleration[a_dcMotorIndex] != 0)
+	{
+		/* ticks = change / (acceleration * tick time), rounded up */
+		changePerTick = (uint32_t)g_rampAcceleration[a_dcMotorIndex] * 256UL * DCMOTOR_RAMP_TICK_MS;
+		ticks = ((uint32_t)change * 1000UL + changePerTick - 1) / changePerTick;
+		if(ticks == 0)
+		{
+			ticks = 1;
+		}
+	}
+
+	g_rampStartQ8[a_dcMotorIndex] = g_currentDutyQ8[a_dcMotorIndex];
+	g_rampEndQ8[a_dcMotorIndex] = a_targetDutyQ8;
+	g_rampTicks[a_dcMotorIndex] = (uint16_t)ticks;
+	g_rampElapsedTicks[a_dcMotorIndex] = 0;
+	g_rampState[a_dcMotorIndex] = DCMOTOR_RAMP_RUNNING;
+}
+
+/*
+ * [Function Name]: DCMOTOR_writeOutput
+ * [Function Description]: writes the direction pins and the pwm duty cycle of a motor,
+ * 						   both bridge inputs are low (coasting) at 0 duty cycle
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [in]: int16_t a_dutyQ8
+ * 		 duty cycle with 8 fraction bits, negative for reverse
+ * [Return]: void
+ */
+static void DCMOTOR_writeOutput(uint8_t a_dcMotorIndex, int16_t a_dutyQ8)
+{
+	uint8_t percent;
+
+	if(a_dutyQ8 > 0)
+	{
+		DIO_writePin(DCMOTOR_PIN1_OF(a_dcMotorIndex), HIGH);
+		DIO_writePin(DCMOTOR_PIN2_OF(a_dcMotorIndex), LOW);
+		percent = (uint8_t)((a_dutyQ8 + 128) >> 8);
+	}
+	else if(a_dutyQ8 < 0)
+	{
+		DIO_writePin(DCMOTOR_PIN1_OF(a_dcMotorIndex), LOW);
+		DIO_writePin(DCMOTOR_PIN2_OF(a_dcMotorIndex), HIGH);
+		percent = (uint8_t)((-a_dutyQ8 + 128) >> 8);
+	}
+	else
+	{
+		DIO_writePin(DCMOTOR_PIN1_OF(a_dcMotorIndex), LOW);
+		DIO_writePin(DCMOTOR_PIN2_OF(a_dcMotorIndex), LOW);
+		percent = 0;
+	}
+
+	/* check if enable pin is connected to a pin that supports pwm */
+	if(PWM_enable(DCMOTOR_ENABLE_PIN_OF(a_dcMotorIndex), percent) == PWM_ERROR)
+	{
+		/* write high if pwm is not supported on enable pin */
+		DIO_writePin(DCMOTOR_ENABLE_PIN_OF(a_dcMotorIndex), (percent != 0) ? HIGH : LOW);
+	}
+}
+
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+
+/*
+ * [Function Name]: DCMOTOR_currentSenseInit
+ * [Function Description]: starts sampling the motors currents on the pwm timer overflow,
+ * 						   it must be called after DCMOTOR_init() and ADC_init().
+ * 						   Global interrupts must be enabled
+ * [Args]:
+ * [in]: void (* volatile a_ptrToCallBack)(uint8_t a_dcMotorIndex)
+ * 		 function called from the adc interrupt with the motor index (0 if
+ * 		 DCMOTORS_USED_COUNT = 1) after the motor is cut off, can be NULL
+ * [Return]: void
+ */
+void DCMOTOR_currentSenseInit(void (* volatile a_ptrToCallBack)(uint8_t a_dcMotorIndex))
+{
+	uint8_t loopCounter;
+
+	ADC_disableAutoTriggerSource();
+
+	for(loopCounter = 0; loopCounter < DCMOTORS_USED_COUNT; loopCounter ++)
+	{
+		g_isOvercurrent[loopCounter] = FALSE;
+		g_senseSums[loopCounter] = 0;
+		g_senseSquaresSums[loopCounter] = 0;
+		g_senseSamplesCount[loopCounter] = 0;
+		g_isCurrentMeasured[loopCounter] = FALSE;
+	}
+	g_senseIndex = 0;
+	g_overcurrentCallBack = a_ptrToCallBack;
+
+	ADC_setCallBack(DCMOTOR_currentSampled);
+	ADC_selectChannel(DCMOTOR_CURRENT_PIN_OF(0));
+	ADC_enableAutoTriggerSource(DCMOTOR_CURRENT_TRIGGER);
+}
+
+#if DCMOTORS_USED_COUNT == 1
+
+/*
+ * [Function Name]: DCMOTOR_getCurrent
+ * [Function Description]: gets the average and the rms currents of the last
+ * 						   2^DCMOTOR_CURRENT_WINDOW_SHIFT samples
+ * [Args]:
+ * [out]: uint16_t * a_averageMilliAmp
+ * 		  pointer to store the average current in mA in
+ * [out]: uint16_t * a_rmsMilliAmp
+ * 		  pointer to store the rms current in mA in
+ * [Return]: uint8_t
+ * 			 TRUE if the currents are measured, FALSE if no window is complete yet
+ */
+uint8_t DCMOTOR_getCurrent(uint16_t * a_averageMilliAmp, uint16_t * a_rmsMilliAmp)
+{
+	return DCMOTOR_getCurrentIndex(0, a_averageMilliAmp, a_rmsMilliAmp);
+}
+
+/*
+ * [Function Name]: DCMOTOR_isOvercurrent
+ * [Function Description]: checks if the motor is cut off by an overcurrent, the motor
+ * 						   can't be started till DCMOTOR_clearOvercurrent() is called
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if the motor is cut off, FALSE otherwise
+ */
+uint8_t DCMOTOR_isOvercurrent(void)
+{
+	return g_isOvercurrent[0];
+}
+
+/*
+ * [Function Name]: DCMOTOR_clearOvercurrent
+ * [Function Description]: allows starting the motor again after an overcurrent,
+ * 						   the motor stays stopped
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void DCMOTOR_clearOvercurrent(void)
+{
+	g_isOvercurrent[0] = FALSE;
+}
+
+#else
+
+/*
+ * [Function Name]: DCMOTOR_getCurrent
+ * [Function Description]: gets the average and the rms currents of the last
+ * 						   2^DCMOTOR_CURRENT_WINDOW_SHIFT samples
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [out]: uint16_t * a_averageMilliAmp
+ * 		  pointer to store the average current in mA in
+ * [out]: uint16_t * a_rmsMilliAmp
+ * 		  pointer to store the rms current in mA in
+ * [Return]: uint8_t
+ * 			 TRUE if the currents are measured, FALSE if no window is complete yet
+ * 			 or the index is out of the array
+ */
+uint8_t DCMOTOR_getCurrent(uint8_t a_dcMotorIndex, uint16_t * a_averageMilliAmp, uint16_t * a_rmsMilliAmp)
+{
+	if(a_dcMotorIndex >= DCMOTORS_USED_COUNT)
+	{
+		return FALSE;
+	}
+	return DCMOTOR_getCurrentIndex(a_dcMotorIndex, a_averageMilliAmp, a_rmsMilliAmp);
+}
+
+/*
+ * [Function Name]: DCMOTOR_isOvercurrent
+ * [Function Description]: checks if the motor is cut off by an overcurrent, the motor
+ * 						   can't be started till DCMOTOR_clearOvercurrent() is called
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: uint8_t
+ * 			 TRUE if the motor is cut off, FALSE otherwise
+ */
+uint8_t DCMOTOR_isOvercurrent(uint8_t a_dcMotorIndex)
+{
+	if(a_dcMotorIndex >= DCMOTORS_USED_COUNT)
+	{
+		return FALSE;
+	}
+	return g_isOvercurrent[a_dcMotorIndex];
+}
+
+/*
+ * [Function Name]: DCMOTOR_clearOvercurrent
+ * [Function Description]: allows starting the motor again after an overcurrent,
+ * 						   the motor stays stopped
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: void
+ */
+void DCMOTOR_clearOvercurrent(uint8_t a_dcMotorIndex)
+{
+	if(a_dcMotorIndex < DCMOTORS_USED_COUNT)
+	{
+		g_isOvercurrent[a_dcMotorIndex] = FALSE;
+	}
+}
+
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: DCMOTOR_currentSampled
+ * [Function Description]: called from the adc interrupt with each current sample, it cuts
+ * 						   off the motor on an overcurrent, accumulates the sample and
+ * 						   selects the channel of the next motor for the next trigger
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void DCMOTOR_currentSampled(void)
+{
+	uint8_t index = g_senseIndex;
+	uint16_t sample = g_adcResult;
+
+	if(sample > DCMOTOR_OVERCURRENT_VALUE && g_isOvercurrent[index] == FALSE)
+	{
+		/* cut off the bridge first, then stop the modules driving it */
+		PWM_disable(DCMOTOR_ENABLE_PIN_OF(index));
+		DIO_writePin(DCMOTOR_ENABLE_PIN_OF(index), LOW);
+		DIO_writePin(DCMOTOR_PIN1_OF(index), LOW);
+		DIO_writePin(DCMOTOR_PIN2_OF(index), LOW);
+
+		g_isOvercurrent[index] = TRUE;
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+		g_isSpeedControlled[index] = FALSE;
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+#if DCMOTOR_RAMP_ENABLED == 1
+		g_rampState[index] = DCMOTOR_RAMP_IDLE;
+		g_currentDutyQ8[index] = 0;
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
+		if(g_overcurrentCallBack != NULL)
+		{
+			(*g_overcurrentCallBack)(index);
+		}
+	}
+
+	g_senseSums[index] += sample;
+	g_senseSquaresSums[index] += (uint32_t)sample * sample;
+	g_senseSamplesCount[index] ++;
+
+	if(g_senseSamplesCount[index] == DCMOTOR_CURRENT_WINDOW_SAMPLES)
+	{
+		g_currentSums[index] = g_senseSums[index];
+		g_currentSquaresSums[index] = g_senseSquaresSums[index];
+		g_isCurrentMeasured[index] = TRUE;
+
+		g_senseSums[index] = 0;
+		g_senseSquaresSums[index] = 0;
+		g_senseSamplesCount[index] = 0;
+	}
+
+	/* the next trigger converts the next motor */
+	index ++;
+	if(index == DCMOTORS_USED_COUNT)
+	{
+		index = 0;
+	}
+	g_senseIndex = index;
+	ADC_selectChannel(DCMOTOR_CURRENT_PIN_OF(index));
+}
+
+/*
+ * [Function Name]: DCMOTOR_getCurrentIndex
+ * [Function Description]: gets the currents of a motor, same as DCMOTOR_getCurrent()
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, 0 if DCMOTORS_USED_COUNT = 1
+ * [out]: uint16_t * a_averageMilliAmp
+ * 		  pointer to store the average current in mA in
+ * [out]: uint16_t * a_rmsMilliAmp
+ * 		  pointer to store the rms current in mA in
+ * [Return]: uint8_t
+ * 			 TRUE if the currents are measured, FALSE if no window is complete yet
+ */
+static uint8_t DCMOTOR_getCurrentIndex(uint8_t a_dcMotorIndex, uint16_t * a_averageMilliAmp, uint16_t * a_rmsMilliAmp)
+{
+	uint16_t sum;
+	uint32_t squaresSum;
+	uint16_t rmsValueQ4;
+	uint8_t sreg;
+
+	if(g_isCurrentMeasured[a_dcMotorIndex] == FALSE)
+	{
+		return FALSE;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+	sum = g_currentSums[a_dcMotorIndex];
+	squaresSum = g_currentSquaresSums[a_dcMotorIndex];
+	EXIT_CRITICAL_SECTION(sreg);
+
+	*a_averageMilliAmp = (uint16_t)(((uint64_t)sum * DCMOTOR_REF_MILLI_VOLT * 1000UL) \
+			/ (DCMOTOR_CURRENT_DIVISOR << DCMOTOR_CURRENT_WINDOW_SHIFT));
+
+	/* rms value = sqrt(mean of the squares), with 4 fraction bits */
+	rmsValueQ4 = MATH_squareRoot((squaresSum >> DCMOTOR_CURRENT_WINDOW_SHIFT) << 8);
+	*a_rmsMilliAmp = (uint16_t)(((uint64_t)rmsValueQ4 * DCMOTOR_REF_MILLI_VOLT * 1000UL) \
+			/ (DCMOTOR_CURRENT_DIVISOR << 4));
+
+	return TRUE;
+}
+
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
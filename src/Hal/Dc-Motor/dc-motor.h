@@ -45,7 +45,9 @@ typedef enum
 /*
  * [Struct Name]: ST_DCMOTOR
  * [Struct Description]: contains motor pins connection
- * 						 pin1, pin2 and enable pin (if ENABLE_PIN_IS_CONNECTED == 1 only)
+ * 						 pin1, pin2, enable pin (if ENABLE_PIN_IS_CONNECTED == 1 only)
+ * 						 tach pin (if SPEED_CONTROL_ENABLED == 1 only)
+ * 						 and current pin (if CURRENT_SENSE_ENABLED == 1 only)
  */
 typedef struct
 {
@@ -54,6 +56,14 @@ typedef struct
 #if DCMOTOR_ENABLE_PIN_IS_CONNECTED == 1
 	uint8_t enablePin;
 #endif /* DCMOTOR_ENABLE_PIN_IS_CONNECTED */
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+	/* external interrupt pin of the tach output, each motor must use a different one */
+	uint8_t tachPin;
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+	/* adc pin of the shunt voltage */
+	uint8_t currentPin;
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
 }ST_DCMOTOR;
 
 #endif /* DCMOTORS_USED_COUNT != 1 */
@@ -131,4 +141,265 @@ void DCMOTOR_stop(uint8_t a_dcMotorIndex);
 
 #endif /* DCMOTORS_USED_COUNT == 1 */
 
+#if DCMOTOR_SPEED_CONTROL_ENABLED == 1
+
+#if DCMOTORS_USED_COUNT == 1
+
+/*
+ * [Function Name]: DCMOTOR_setSpeedRpm
+ * [Function Description]: keeps the motor at the given speed by the PID controller,
+ * 						   DCMOTOR_start() and DCMOTOR_stop() stop the controller.
+ * 						   Global interrupts must be enabled
+ * [Args]:
+ * [in]: int16_t a_rpm
+ * 		 target speed, positive for forward, negative for reverse and 0 to stop the motor
+ * [Return]: void
+ */
+void DCMOTOR_setSpeedRpm(int16_t a_rpm);
+
+/*
+ * [Function Name]: DCMOTOR_getSpeedRpm
+ * [Function Description]: gets the speed measured in the last control period
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 speed in rpm, it's always positive as the tach doesn't give the direction
+ */
+uint16_t DCMOTOR_getSpeedRpm(void);
+
+#else
+
+/*
+ * [Function Name]: DCMOTOR_setSpeedRpm
+ * [Function Description]: keeps the motor at the given speed by the PID controller,
+ * 						   DCMOTOR_start() and DCMOTOR_stop() stop the controller.
+ * 						   Global interrupts must be enabled
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [in]: int16_t a_rpm
+ * 		 target speed, positive for forward, negative for reverse and 0 to stop the motor
+ * [Return]: void
+ */
+void DCMOTOR_setSpeedRpm(uint8_t a_dcMotorIndex, int16_t a_rpm);
+
+/*
+ * [Function Name]: DCMOTOR_getSpeedRpm
+ * [Function Description]: gets the speed measured in the last control period
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: uint16_t
+ * 			 speed in rpm, it's always positive as the tach doesn't give the direction
+ */
+uint16_t DCMOTOR_getSpeedRpm(uint8_t a_dcMotorIndex);
+
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: DCMOTOR_speedControlUpdate
+ * [Function Description]: measures the speed of the controlled motors and updates their
+ * 						   duty cycles, it's called from the timer interrupt every
+ * 						   DCMOTOR_CONTROL_PERIOD_MS if DCMOTOR_CONTROL_TIMER_ENABLED = 1,
+ * 						   or by the application at the same period otherwise
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void DCMOTOR_speedControlUpdate(void);
+
+#endif /* DCMOTOR_SPEED_CONTROL_ENABLED == 1 */
+
+#if DCMOTOR_RAMP_ENABLED == 1
+
+#if DCMOTORS_USED_COUNT == 1
+
+/*
+ * [Function Name]: DCMOTOR_moveTo
+ * [Function Description]: ramps the motor from its current duty cycle to the given one
+ * 						   without waiting, reversing ramps down to 0 and waits
+ * 						   DCMOTOR_DEAD_TIME_MS first. DCMOTOR_start(), DCMOTOR_stop()
+ * 						   and DCMOTOR_brake() cancel the ramp
+ * [Args]:
+ * [in]: int8_t a_speedPercent
+ * 		 target duty cycle from -100 to 100, negative for reverse, 0 to stop the motor
+ * [in]: uint8_t a_acceleration
+ * 		 duty cycle change per second in percent, 0 to change it in one tick
+ * [Return]: void
+ */
+void DCMOTOR_moveTo(int8_t a_speedPercent, uint8_t a_acceleration);
+
+/*
+ * [Function Name]: DCMOTOR_isTargetReached
+ * [Function Description]: checks if the ramp of the last DCMOTOR_moveTo() is done
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if the target is reached, FALSE if still ramping
+ */
+uint8_t DCMOTOR_isTargetReached(void);
+
+/*
+ * [Function Name]: DCMOTOR_brake
+ * [Function Description]: stops the motor actively by shorting it, both bridge inputs
+ * 						   and the enable pin are high
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void DCMOTOR_brake(void);
+
+#else
+
+/*
+ * [Function Name]: DCMOTOR_moveTo
+ * [Function Description]: ramps the motor from its current duty cycle to the given one
+ * 						   without waiting, reversing ramps down to 0 and waits
+ * 						   DCMOTOR_DEAD_TIME_MS first. DCMOTOR_start(), DCMOTOR_stop()
+ * 						   and DCMOTOR_brake() cancel the ramp
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [in]: int8_t a_speedPercent
+ * 		 target duty cycle from -100 to 100, negative for reverse, 0 to stop the motor
+ * [in]: uint8_t a_acceleration
+ * 		 duty cycle change per second in percent, 0 to change it in one tick
+ * [Return]: void
+ */
+void DCMOTOR_moveTo(uint8_t a_dcMotorIndex, int8_t a_speedPercent, uint8_t a_acceleration);
+
+/*
+ * [Function Name]: DCMOTOR_isTargetReached
+ * [Function Description]: checks if the ramp of the last DCMOTOR_moveTo() is done
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: uint8_t
+ * 			 TRUE if the target is reached, FALSE if still ramping
+ */
+uint8_t DCMOTOR_isTargetReached(uint8_t a_dcMotorIndex);
+
+/*
+ * [Function Name]: DCMOTOR_brake
+ * [Function Description]: stops the motor actively by shorting it, both bridge inputs
+ * 						   and the enable pin are high
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: void
+ */
+void DCMOTOR_brake(uint8_t a_dcMotorIndex);
+
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: DCMOTOR_rampTick
+ * [Function Description]: moves the ramping motors one step along their profiles,
+ * 						   it must be called every DCMOTOR_RAMP_TICK_MS
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void DCMOTOR_rampTick(void);
+
+#endif /* DCMOTOR_RAMP_ENABLED == 1 */
+
+#if DCMOTOR_CURRENT_SENSE_ENABLED == 1
+
+/*
+ * [Function Name]: DCMOTOR_currentSenseInit
+ * [Function Description]: starts sampling the motors currents on the pwm timer overflow,
+ * 						   it must be called after DCMOTOR_init() and ADC_init().
+ * 						   Global interrupts must be enabled
+ * [Args]:
+ * [in]: void (* volatile a_ptrToCallBack)(uint8_t a_dcMotorIndex)
+ * 		 function called from the adc interrupt with the motor index (0 if
+ * 		 DCMOTORS_USED_COUNT = 1) after the motor is cut off, can be NULL
+ * [Return]: void
+ */
+void DCMOTOR_currentSenseInit(void (* volatile a_ptrToCallBack)(uint8_t a_dcMotorIndex));
+
+#if DCMOTORS_USED_COUNT == 1
+
+/*
+ * [Function Name]: DCMOTOR_getCurrent
+ * [Function Description]: gets the average and the rms currents of the last
+ * 						   2^DCMOTOR_CURRENT_WINDOW_SHIFT samples
+ * [Args]:
+ * [out]: uint16_t * a_averageMilliAmp
+ * 		  pointer to store the average current in mA in
+ * [out]: uint16_t * a_rmsMilliAmp
+ * 		  pointer to store the rms current in mA in
+ * [Return]: uint8_t
+ * 			 TRUE if the currents are measured, FALSE if no window is complete yet
+ */
+uint8_t DCMOTOR_getCurrent(uint16_t * a_averageMilliAmp, uint16_t * a_rmsMilliAmp);
+
+/*
+ * [Function Name]: DCMOTOR_isOvercurrent
+ * [Function Description]: checks if the motor is cut off by an overcurrent, the motor
+ * 						   can't be started till DCMOTOR_clearOvercurrent() is called
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if the motor is cut off, FALSE otherwise
+ */
+uint8_t DCMOTOR_isOvercurrent(void);
+
+/*
+ * [Function Name]: DCMOTOR_clearOvercurrent
+ * [Function Description]: allows starting the motor again after an overcurrent,
+ * 						   the motor stays stopped
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void DCMOTOR_clearOvercurrent(void);
+
+#else
+
+/*
+ * [Function Name]: DCMOTOR_getCurrent
+ * [Function Description]: gets the average and the rms currents of the last
+ * 						   2^DCMOTOR_CURRENT_WINDOW_SHIFT samples
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [out]: uint16_t * a_averageMilliAmp
+ * 		  pointer to store the average current in mA in
+ * [out]: uint16_t * a_rmsMilliAmp
+ * 		  pointer to store the rms current in mA in
+ * [Return]: uint8_t
+ * 			 TRUE if the currents are measured, FALSE if no window is complete yet
+ * 			 or the index is out of the array
+ */
+uint8_t DCMOTOR_getCurrent(uint8_t a_dcMotorIndex, uint16_t * a_averageMilliAmp, uint16_t * a_rmsMilliAmp);
+
+/*
+ * [Function Name]: DCMOTOR_isOvercurrent
+ * [Function Description]: checks if the motor is cut off by an overcurrent, the motor
+ * 						   can't be started till DCMOTOR_clearOvercurrent() is called
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: uint8_t
+ * 			 TRUE if the motor is cut off, FALSE otherwise
+ */
+uint8_t DCMOTOR_isOvercurrent(uint8_t a_dcMotorIndex);
+
+/*
+ * [Function Name]: DCMOTOR_clearOvercurrent
+ * [Function Description]: allows starting the motor again after an overcurrent,
+ * 						   the motor stays stopped
+ * [Args]:
+ * [in]: uint8_t a_motorIndex
+ * 		 motor index, same index used in initializing the motors array
+ * [Return]: void
+ */
+void DCMOTOR_clearOvercurrent(uint8_t a_dcMotorIndex);
+
+#endif /* DCMOTORS_USED_COUNT == 1 */
+
+#endif /* DCMOTOR_CURRENT_SENSE_ENABLED == 1 */
+
 #endif /* __DC_MOTOR_H__ */
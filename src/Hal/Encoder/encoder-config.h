@@ -0,0 +1,50 @@
+/******************************************************************************
+ *
+ * Module: ENCODER
+ *
+ * File Name: encoder-config.h
+ *
+ * Description: Config file for the quadrature ENCODER driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __ENCODER_CONFIG_H__
+#define __ENCODER_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* the pins of channels A and B of the encoder,
+ * they must be the INT0 and INT1 pins, as both edges of each channel
+ * are needed (EXT_INT_ANY_CHANGE), and they must be on the same port
+ */
+#define ENCODER_A_PIN								PD2
+#define ENCODER_B_PIN								PD3
+
+/* if ENCODER_PULL_UP_ENABLED = 1, the internal pull ups of the pins are enabled
+ * for open collector encoders and mechanical knobs
+ */
+#define ENCODER_PULL_UP_ENABLED						1
+
+/* if ENCODER_VELOCITY_ENABLED = 1, the edges are timestamped with the
+ * free running timer 1 count of the ICU driver to estimate the velocity,
+ * the ICU driver must be initialized by the application with
+ * ICU_TIMESTAMP_EXTENSION_ENABLED = 1
+ */
+#define ENCODER_VELOCITY_ENABLED					1
+
+/* the timer 1 prescaler used in Icu_init(), 1, 8, 64, 256 or 1024 */
+#define ENCODER_TIMER_PRESCALER						8
+
+/* the velocity is reported as 0 if no edge occurs in this time in ms */
+#define ENCODER_VELOCITY_TIMEOUT_MS					200
+
+/* making sure F_CPU is defined */
+#ifndef F_CPU
+#define F_CPU										1000000UL
+#endif /* F_CPU */
+
+#endif /* __ENCODER_CONFIG_H__ */
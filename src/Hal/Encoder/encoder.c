@@ -0,0 +1,312 @@
+/******************************************************************************
+ *
+ * Module: ENCODER
+ *
+ * File Name: encoder.c
+ *
+ * Description: Source file for the quadrature ENCODER driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "encoder.h"
+
+/* For using DIO functions */
+#include "../../Mcal/Dio/dio.h"
+
+/* For using external interrupts */
+#include "../../Mcal/External-Interrupt/external-interrupt.h"
+
+#if ENCODER_VELOCITY_ENABLED == 1
+
+/* For using timer 1 timestamps */
+#include "../../Mcal/Icu/icu.h"
+
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 0
+#error "ENCODER_VELOCITY_ENABLED requires ICU_TIMESTAMP_EXTENSION_ENABLED = 1"
+#endif
+
+#endif /* ENCODER_VELOCITY_ENABLED == 1 */
+
+#if EXT_INT0_DEFERRED == 1 || EXT_INT1_DEFERRED == 1
+#error "ENCODER driver requires INT0 and INT1 not to be deferred, the pins must be read in the ISR"
+#endif
+
+#if GET_PORT_NO(ENCODER_A_PIN) != GET_PORT_NO(ENCODER_B_PIN)
+#error "ENCODER_A_PIN and ENCODER_B_PIN must be on the same port"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* marks the transitions where both channels changed */
+#define ENCODER_INVALID_TRANSITION				2
+
+/* timer 1 ticks per second */
+#define ENCODER_TIMER_FREQUENCY					(F_CPU / ENCODER_TIMER_PRESCALER)
+
+/* ENCODER_VELOCITY_TIMEOUT_MS in timer 1 ticks */
+#define ENCODER_VELOCITY_TIMEOUT_TICKS			((ENCODER_TIMER_FREQUENCY / 1000UL) * ENCODER_VELOCITY_TIMEOUT_MS)
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* position change of each transition, indexed by (previous state << 2) | new state
+ * where state = (A << 1) | B, stored in flash */
+static FLASH_CONST int8_t g_transitionTable[16] = {
+		 0, +1, -1, ENCODER_INVALID_TRANSITION,
+		-1,  0, ENCODER_INVALID_TRANSITION, +1,
+		+1, ENCODER_INVALID_TRANSITION,  0, -1,
+		ENCODER_INVALID_TRANSITION, -1, +1,  0
+};
+
+/* last state of the channels */
+static uint8_t g_state = 0;
+
+/* position in counts */
+static volatile int32_t g_position = 0;
+
+/* number of invalid transitions */
+static volatile uint16_t g_invalidTransitionsCount = 0;
+
+#if ENCODER_VELOCITY_ENABLED == 1
+
+/* timestamp of the last edge */
+static volatile uint32_t g_lastEdgeTimestamp = 0;
+
+/* ticks between the last two edges, 0 if unknown */
+static volatile uint32_t g_edgeInterval = 0;
+
+/* direction of the last edge, +1 or -1 */
+static volatile int8_t g_direction = 0;
+
+#endif /* ENCODER_VELOCITY_ENABLED == 1 */
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: ENCODER_readState
+ * [Function Description]: reads both channels with one port read
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 state of the channels, (A << 1) | B
+ */
+static uint8_t ENCODER_readState(void);
+
+/*
+ * [Function Name]: ENCODER_edgeProcessing
+ * [Function Description]: callback of both channels interrupts, decodes
+ * 						   the transition and updates the position
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void ENCODER_edgeProcessing(void);
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: ENCODER_init
+ * [Function Description]: initializes the encoder, both channels generate
+ * 						   interrupts on any change and each edge is decoded
+ * 						   as one count (x4 decoding)
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 ENCODER_SUCCESS or ENCODER_ERROR if the pins don't support
+ * 			 any change interrupts
+ */
+uint8_t ENCODER_init(void)
+{
+	g_position = 0;
+	g_invalidTransitionsCount = 0;
+
+#if ENCODER_VELOCITY_ENABLED == 1
+	g_edgeInterval = 0;
+	g_direction = 0;
+#endif /* ENCODER_VELOCITY_ENABLED == 1 */
+
+	if(EXT_INT_enable(ENCODER_A_PIN, EXT_INT_ANY_CHANGE, ENCODER_edgeProcessing) == EXT_INT_FAILURE
+			|| EXT_INT_enable(ENCODER_B_PIN, EXT_INT_ANY_CHANGE, ENCODER_edgeProcessing) == EXT_INT_FAILURE)
+	{
+		return ENCODER_ERROR;
+	}
+
+#if ENCODER_PULL_UP_ENABLED == 1
+	DIO_controlPinInternalPull(ENCODER_A_PIN, DIO_PULL_UP);
+	DIO_controlPinInternalPull(ENCODER_B_PIN, DIO_PULL_UP);
+#endif /* ENCODER_PULL_UP_ENABLED == 1 */
+
+	g_state = ENCODER_readState();
+
+	return ENCODER_SUCCESS;
+}
+
+/*
+ * [Function Name]: ENCODER_getPosition
+ * [Function Description]: returns the position in counts, read atomically
+ * [Args]:
+ * [in]: void
+ * [Return]: int32_t
+ * 			 the position
+ */
+int32_t ENCODER_getPosition(void)
+{
+	int32_t position;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	position = g_position;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return position;
+}
+
+/*
+ * [Function Name]: ENCODER_setPosition
+ * [Function Description]: sets the position in counts, i.e. for homing
+ * [Args]:
+ * [in]: int32_t a_position
+ * 		 the new position
+ * [Return]: void
+ */
+void ENCODER_setPosition(int32_t a_position)
+{
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	g_position = a_position;
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: ENCODER_getInvalidTransitionsCount
+ * [Function Description]: returns number of invalid transitions (both channels
+ * 						   changed at once), they mean missed edges or noise
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 number of invalid transitions
+ */
+uint16_t ENCODER_getInvalidTransitionsCount(void)
+{
+	uint16_t invalidTransitionsCount;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	invalidTransitionsCount = g_invalidTransitionsCount;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return invalidTransitionsCount;
+}
+
+#if ENCODER_VELOCITY_ENABLED == 1
+
+/*
+ * [Function Name]: ENCODER_getVelocity
+ * [Function Description]: estimates the velocity from the time between the
+ * 						   last two edges, it decreases if the next edge is late
+ * 						   and it's 0 after ENCODER_VELOCITY_TIMEOUT_MS without edges
+ * [Args]:
+ * [in]: void
+ * [Return]: int32_t
+ * 			 velocity in counts per second, negative in the reverse direction
+ */
+int32_t ENCODER_getVelocity(void)
+{
+	uint32_t lastEdgeTimestamp, edgeInterval, elapsed;
+	int8_t direction;
+	int32_t velocity;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	lastEdgeTimestamp = g_lastEdgeTimestamp;
+	edgeInterval = g_edgeInterval;
+	direction = g_direction;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	elapsed = Icu_getTimestamp() - lastEdgeTimestamp;
+	if(edgeInterval == 0 || elapsed > ENCODER_VELOCITY_TIMEOUT_TICKS)
+	{
+		return 0;
+	}
+
+	/* the next edge is late, so the velocity is at most one count per elapsed time */
+	if(elapsed > edgeInterval)
+	{
+		edgeInterval = elapsed;
+	}
+
+	velocity = (int32_t)(ENCODER_TIMER_FREQUENCY / edgeInterval);
+	return (direction < 0) ? -velocity : velocity;
+}
+
+#endif /* ENCODER_VELOCITY_ENABLED == 1 */
+
+/*
+ * [Function Name]: ENCODER_readState
+ * [Function Description]: reads both channels with one port read
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 state of the channels, (A << 1) | B
+ */
+static uint8_t ENCODER_readState(void)
+{
+	uint8_t portValue = DIO_readPort(GET_PORT_NO(ENCODER_A_PIN));
+
+	return (GET_BIT(portValue, GET_PIN_NO(ENCODER_A_PIN)) << 1) | GET_BIT(portValue, GET_PIN_NO(ENCODER_B_PIN));
+}
+
+/*
+ * [Function Name]: ENCODER_edgeProcessing
+ * [Function Description]: callback of both channels interrupts, decodes
+ * 						   the transition and updates the position
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void ENCODER_edgeProcessing(void)
+{
+	uint8_t state = ENCODER_readState();
+	int8_t step = g_transitionTable[(g_state << 2) | state];
+
+#if ENCODER_VELOCITY_ENABLED == 1
+	uint32_t timestamp;
+#endif /* ENCODER_VELOCITY_ENABLED == 1 */
+
+	g_state = state;
+
+	if(step == ENCODER_INVALID_TRANSITION)
+	{
+		g_invalidTransitionsCount ++;
+	}
+	else if(step != 0)
+	{
+		g_position += step;
+
+#if ENCODER_VELOCITY_ENABLED == 1
+
+		timestamp = Icu_getTimestamp();
+
+		/* the interval is unknown when the direction changes */
+		g_edgeInterval = (step == g_direction) ? timestamp - g_lastEdgeTimestamp : 0;
+		g_lastEdgeTimestamp = timestamp;
+		g_direction = step;
+
+#endif /* ENCODER_VELOCITY_ENABLED == 1 */
+	}
+}
@@ -0,0 +1,101 @@
+/******************************************************************************
+ *
+ * Module: ENCODER
+ *
+ * File Name: encoder.h
+ *
+ * Description: Header file for the quadrature ENCODER driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __ENCODER_H__
+#define __ENCODER_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module config file */
+#include "encoder-config.h"
+
+/* for using std types */
+#include "../../Lib/types.h"
+
+/* For using common defines and macros */
+#include "../../Lib/common.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* encoder init states */
+#define ENCODER_SUCCESS								1
+#define ENCODER_ERROR								0
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: ENCODER_init
+ * [Function Description]: initializes the encoder, both channels generate
+ * 						   interrupts on any change and each edge is decoded
+ * 						   as one count (x4 decoding)
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 ENCODER_SUCCESS or ENCODER_ERROR if the pins don't support
+ * 			 any change interrupts
+ */
+uint8_t ENCODER_init(void);
+
+/*
+ * [Function Name]: ENCODER_getPosition
+ * [Function Description]: returns the position in counts, read atomically
+ * [Args]:
+ * [in]: void
+ * [Return]: int32_t
+ * 			 the position
+ */
+int32_t ENCODER_getPosition(void);
+
+/*
+ * [Function Name]: ENCODER_setPosition
+ * [Function Description]: sets the position in counts, i.e. for homing
+ * [Args]:
+ * [in]: int32_t a_position
+ * 		 the new position
+ * [Return]: void
+ */
+void ENCODER_setPosition(int32_t a_position);
+
+/*
+ * [Function Name]: ENCODER_getInvalidTransitionsCount
+ * [Function Description]: returns number of invalid transitions (both channels
+ * 						   changed at once), they mean missed edges or noise
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 number of invalid transitions
+ */
+uint16_t ENCODER_getInvalidTransitionsCount(void);
+
+#if ENCODER_VELOCITY_ENABLED == 1
+
+/*
+ * [Function Name]: ENCODER_getVelocity
+ * [Function Description]: estimates the velocity from the time between the
+ * 						   last two edges, it decreases if the next edge is late
+ * 						   and it's 0 after ENCODER_VELOCITY_TIMEOUT_MS without edges
+ * [Args]:
+ * [in]: void
+ * [Return]: int32_t
+ * 			 velocity in counts per second, negative in the reverse direction
+ */
+int32_t ENCODER_getVelocity(void);
+
+#endif /* ENCODER_VELOCITY_ENABLED == 1 */
+
+#endif /* __ENCODER_H__ */
@@ -0,0 +1,72 @@
+/******************************************************************************
+ *
+ * Module: EXPANDER
+ *
+ * File Name: expander-config.h
+ *
+ * Description: Config file for the shift registers port EXPANDER driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __EXPANDER_CONFIG_H__
+#define __EXPANDER_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* number of 74HC595 output registers in the chain connected to MOSI,
+ * and number of 74HC165 input registers in the chain connected to MISO,
+ * each can be from 0 to 16
+ */
+#define EXP_OUTPUT_BYTES_COUNT						2
+#define EXP_INPUT_BYTES_COUNT						1
+
+/* the pin connected to RCLK of the 74HC595 chain,
+ * the outputs are latched when it goes high after each sync
+ */
+#define EXP_LATCH_PIN								PB1
+
+#if EXP_INPUT_BYTES_COUNT > 0
+
+/* the pin connected to SH/LD of the 74HC165 chain,
+ * it's pulsed low before each sync to load the inputs.
+ * Note that the 74HC165 doesn't release MISO, a buffer is needed
+ * if other spi devices are connected
+ */
+#define EXP_LOAD_PIN								PB0
+
+#endif /* EXP_INPUT_BYTES_COUNT > 0 */
+
+/* spi clock of the registers, one of EN_SpiClockRate */
+#define EXP_CLOCK_RATE								SPI_CLOCK_4
+
+/* if EXP_AUTO_REFRESH_ENABLED = 1, EXP_sync() is called periodically
+ * from a timer interrupt, so writes and reads are applied without
+ * calling EXP_sync() from the application
+ */
+#define EXP_AUTO_REFRESH_ENABLED					0
+
+#if EXP_AUTO_REFRESH_ENABLED == 1
+
+/* the timer used for the refresh, its mode and prescaler, see timer.h */
+#define EXP_AUTO_REFRESH_TIMER						TIMER_0
+#define EXP_AUTO_REFRESH_TIMER_MODE					TIMER_0_CTC
+#define EXP_AUTO_REFRESH_TIMER_PRESCALER			TIMER_0_PRESCALER_1024
+
+/* the division value of EXP_AUTO_REFRESH_TIMER_PRESCALER */
+#define EXP_AUTO_REFRESH_PRESCALER_VALUE			1024
+
+/* the refresh period in ms */
+#define EXP_AUTO_REFRESH_PERIOD_MS					10
+
+#endif /* EXP_AUTO_REFRESH_ENABLED == 1 */
+
+/* making sure F_CPU is defined */
+#ifndef F_CPU
+#define F_CPU										1000000UL
+#endif /* F_CPU */
+
+#endif /* __EXPANDER_CONFIG_H__ */
@@ -0,0 +1,548 @@
+/******************************************************************************
+ *
+ * Module: EXPANDER
+ *
+ * File Name: expander.c
+ *
+ * Description: Source file for the shift registers port EXPANDER driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "expander.h"
+
+/* For using the spi transactions queue */
+#include "../../Mcal/Spi/spi.h"
+
+#if EXP_AUTO_REFRESH_ENABLED == 1
+
+/* For using the refresh timer */
+#include "../../Mcal/Timer/timer.h"
+
+#endif /* EXP_AUTO_REFRESH_ENABLED == 1 */
+
+#if SPI_TRANSACTION_QUEUE_ENABLED == 0
+#error "EXPANDER driver requires SPI_TRANSACTION_QUEUE_ENABLED = 1"
+#endif
+
+#if EXP_OUTPUT_BYTES_COUNT > 16 || EXP_INPUT_BYTES_COUNT > 16
+#error "EXP_OUTPUT_BYTES_COUNT and EXP_INPUT_BYTES_COUNT must be from 0 to 16"
+#endif
+
+#if EXP_OUTPUT_BYTES_COUNT == 0 && EXP_INPUT_BYTES_COUNT == 0
+#error "EXPANDER driver requires at least one output or input register"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* number of bytes shifted by each sync, it fills both chains */
+#if EXP_OUTPUT_BYTES_COUNT > EXP_INPUT_BYTES_COUNT
+#define EXP_SYNC_LENGTH								EXP_OUTPUT_BYTES_COUNT
+#else
+#define EXP_SYNC_LENGTH								EXP_INPUT_BYTES_COUNT
+#endif
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* the output registers, the chip select is the latch pin
+ * so the outputs are latched when the burst ends
+ */
+static const ST_SpiDevice g_latchDevice = {
+		EXP_LATCH_PIN,
+		SPI_CLOCK_NOT_INVERTED_LEADING_EDGE,
+		EXP_CLOCK_RATE,
+		SPI_MSB_FIRST
+};
+
+/* shadow image of the outputs in the order they are shifted out, the first
+ * bytes are only shifted through when the input chain is longer, the output
+ * register n is at index EXP_SYNC_LENGTH - 1 - n
+ */
+static uint8_t g_outputsImage[EXP_SYNC_LENGTH];
+
+/* bytes received by the running sync */
+static uint8_t g_receiveBuffer[EXP_SYNC_LENGTH];
+
+/* burst of each sync */
+static ST_SpiTransaction g_syncTransaction;
+
+#if EXP_INPUT_BYTES_COUNT > 0
+
+/* the input registers load, the chip select is the load pin
+ * so the inputs are loaded while a byte is sent, then the load
+ * pin goes high to shift them in the burst
+ */
+static const ST_SpiDevice g_loadDevice = {
+		EXP_LOAD_PIN,
+		SPI_CLOCK_NOT_INVERTED_LEADING_EDGE,
+		EXP_CLOCK_RATE,
+		SPI_MSB_FIRST
+};
+
+/* loads the inputs before each burst */
+static ST_SpiTransaction g_loadTransaction;
+
+/* inputs loaded by the last sync, the input register n is at index n */
+static volatile uint8_t g_inputsImage[EXP_INPUT_BYTES_COUNT];
+
+#endif /* EXP_INPUT_BYTES_COUNT > 0 */
+
+/* TRUE while a sync is queued or running */
+static volatile uint8_t g_isSyncing = FALSE;
+
+/* TRUE if a sync is requested while another one is running */
+static volatile uint8_t g_isSyncPending = FALSE;
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: EXP_startSync
+ * [Function Description]: queues the transactions of one sync together,
+ * 						   must be called with interrupts disabled
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 EXP_SUCCESS or EXP_BUSY if the spi queue has no place
+ */
+static uint8_t EXP_startSync(void);
+
+/*
+ * [Function Name]: EXP_syncDone
+ * [Function Description]: callback of the sync burst, publishes the inputs
+ * 						   and starts the pending sync if any
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void EXP_syncDone(void);
+
+#if EXP_AUTO_REFRESH_ENABLED == 1
+
+/*
+ * [Function Name]: EXP_refreshProcessing
+ * [Function Description]: callback of the refresh timer, starts a sync
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void EXP_refreshProcessing(void);
+
+#endif /* EXP_AUTO_REFRESH_ENABLED == 1 */
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: EXP_init
+ * [Function Description]: initializes the spi as master and the latch and load pins,
+ * 						   clears all outputs and starts the first sync.
+ * 						   The syncs run from the spi interrupt, so global
+ * 						   interrupts must be enabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void EXP_init(void)
+{
+	uint8_t loopCounter;
+	ST_SpiMasterConfig spiConfig = {
+			SPI_MSB_FIRST,
+			SPI_CLOCK_NOT_INVERTED_LEADING_EDGE,
+			SPI_INTERRUPT_ENABLED,
+			EXP_CLOCK_RATE
+	};
+
+#if EXP_AUTO_REFRESH_ENABLED == 1
+	TIMER_config timerConfig = {
+			EXP_AUTO_REFRESH_TIMER,
+			EXP_AUTO_REFRESH_TIMER_MODE,
+			EXP_AUTO_REFRESH_TIMER_PRESCALER,
+			TIME_MS_TO_TICKS(EXP_AUTO_REFRESH_PRESCALER_VALUE, EXP_AUTO_REFRESH_PERIOD_MS),
+			EXP_refreshProcessing
+	};
+#endif /* EXP_AUTO_REFRESH_ENABLED == 1 */
+
+	SPI_initMaster(&spiConfig);
+	SPI_initDevice(&g_latchDevice);
+
+	for(loopCounter = 0; loopCounter < EXP_SYNC_LENGTH; loopCounter ++)
+	{
+		g_outputsImage[loopCounter] = 0;
+	}
+
+	g_syncTransaction.device = &g_latchDevice;
+	g_syncTransaction.txData = g_outputsImage;
+	g_syncTransaction.rxData = g_receiveBuffer;
+	g_syncTransaction.length = EXP_SYNC_LENGTH;
+	g_syncTransaction.holdChipSelect = FALSE;
+	g_syncTransaction.callBack = EXP_syncDone;
+
+#if EXP_INPUT_BYTES_COUNT > 0
+
+	SPI_initDevice(&g_loadDevice);
+
+	for(loopCounter = 0; loopCounter < EXP_INPUT_BYTES_COUNT; loopCounter ++)
+	{
+		g_inputsImage[loopCounter] = 0;
+	}
+
+	g_loadTransaction.device = &g_loadDevice;
+	g_loadTransaction.txData = NULL;
+	g_loadTransaction.rxData = NULL;
+	g_loadTransaction.length = 1;
+	g_loadTransaction.holdChipSelect = FALSE;
+	g_loadTransaction.callBack = NULL;
+
+#endif /* EXP_INPUT_BYTES_COUNT > 0 */
+
+	g_isSyncing = FALSE;
+	g_isSyncPending = FALSE;
+
+	EXP_sync();
+
+#if EXP_AUTO_REFRESH_ENABLED == 1
+	TIMER_init(&timerConfig);
+	TIMER_start(EXP_AUTO_REFRESH_TIMER);
+#endif /* EXP_AUTO_REFRESH_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: EXP_writePin
+ * [Function Description]: writes a value to an output pin in the shadow image,
+ * 						   it's applied to the registers by the next sync
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 expander output pin, EXP_PIN(byte, bit)
+ * [in]: uint8_t a_value
+ * 		 HIGH or LOW
+ * [Return]: void
+ */
+void EXP_writePin(uint8_t a_pin, uint8_t a_value)
+{
+	uint8_t byte = GET_EXP_BYTE_NO(a_pin);
+	uint8_t sreg;
+
+	if(byte >= EXP_OUTPUT_BYTES_COUNT)
+	{
+		return;
+	}
+
+	/* the image may be written from interrupts too */
+	ENTER_CRITICAL_SECTION(sreg);
+	COPY_BITS(g_outputsImage[EXP_SYNC_LENGTH - 1 - byte], 0x01, (a_value != LOW), GET_EXP_BIT_NO(a_pin));
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: EXP_togglePin
+ * [Function Description]: toggles an output pin in the shadow image
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 expander output pin, EXP_PIN(byte, bit)
+ * [Return]: void
+ */
+void EXP_togglePin(uint8_t a_pin)
+{
+	uint8_t byte = GET_EXP_BYTE_NO(a_pin);
+	uint8_t sreg;
+
+	if(byte >= EXP_OUTPUT_BYTES_COUNT)
+	{
+		return;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+	TOGGLE_BIT(g_outputsImage[EXP_SYNC_LENGTH - 1 - byte], GET_EXP_BIT_NO(a_pin));
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: EXP_readPin
+ * [Function Description]: reads an input pin as loaded by the last sync
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 expander input pin, EXP_PIN(byte, bit)
+ * [Return]: uint8_t
+ * 			 HIGH or LOW
+ */
+uint8_t EXP_readPin(uint8_t a_pin)
+{
+	return GET_BIT(EXP_readByte(GET_EXP_BYTE_NO(a_pin)), GET_EXP_BIT_NO(a_pin));
+}
+
+/*
+ * [Function Name]: EXP_writeByte
+ * [Function Description]: writes all the 8 outputs of a register in the shadow image
+ * [Args]:
+ * [in]: uint8_t a_byte
+ * 		 register index in the output chain
+ * [in]: uint8_t a_value
+ * 		 value of the outputs
+ * [Return]: void
+ */
+void EXP_writeByte(uint8_t a_byte, uint8_t a_value)
+{
+	if(a_byte < EXP_OUTPUT_BYTES_COUNT)
+	{
+		g_outputsImage[EXP_SYNC_LENGTH - 1 - a_byte] = a_value;
+	}
+}
+
+/*
+ * [Function Name]: EXP_readByte
+ * [Function Description]: reads all the 8 inputs of a register as loaded by the last sync
+ * [Args]:
+ * [in]: uint8_t a_byte
+ * 		 register index in the input chain
+ * [Return]: uint8_t
+ * 			 value of the inputs
+ */
+uint8_t EXP_readByte(uint8_t a_byte)
+{
+#if EXP_INPUT_BYTES_COUNT > 0
+	if(a_byte < EXP_INPUT_BYTES_COUNT)
+	{
+		return g_inputsImage[a_byte];
+	}
+#endif /* EXP_INPUT_BYTES_COUNT > 0 */
+
+	return 0;
+}
+
+/*
+ * [Function Name]: EXP_sync
+ * [Function Description]: shifts the whole output image out and the inputs in
+ * 						   with one spi burst, then latches the outputs.
+ * 						   If a sync is running, another one starts after it, or with
+ * 						   the next EXP_sync() call if the spi queue is full then
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 EXP_SUCCESS or EXP_BUSY if the spi queue has no place
+ */
+uint8_t EXP_sync(void)
+{
+	uint8_t result = EXP_SUCCESS;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	if(g_isSyncing == TRUE)
+	{
+		/* the running burst may have sent the old image */
+		g_isSyncPending = TRUE;
+	}
+	else
+	{
+		result = EXP_startSync();
+	}
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return result;
+}
+
+/*
+ * [Function Name]: EXP_isBusy
+ * [Function Description]: checks if a sync is running or waiting
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t EXP_isBusy(void)
+{
+	return (g_isSyncing == TRUE || g_isSyncPending == TRUE) ? TRUE : FALSE;
+}
+
+/*
+ * [Function Name]: EXP_dioPinInit
+ * [Function Description]: same as DIO_pinInit() but accepts expander pins too,
+ * 						   they have fixed directions so nothing is done for them
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [in]: DIO_PinDirectionType a_direction
+ * 		 the pin direction
+ * [Return]: void
+ */
+void EXP_dioPinInit(uint8_t a_pin, DIO_PinDirectionType a_direction)
+{
+	if(!IS_EXP_PIN(a_pin))
+	{
+		DIO_pinInit(a_pin, a_direction);
+	}
+}
+
+/*
+ * [Function Name]: EXP_dioWritePin
+ * [Function Description]: same as DIO_writePin() but accepts expander pins too
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [in]: uint8_t a_value
+ * 		 HIGH or LOW
+ * [Return]: void
+ */
+void EXP_dioWritePin(uint8_t a_pin, uint8_t a_value)
+{
+	if(IS_EXP_PIN(a_pin))
+	{
+		EXP_writePin(a_pin, a_value);
+	}
+	else
+	{
+		DIO_writePin(a_pin, a_value);
+	}
+}
+
+/*
+ * [Function Name]: EXP_dioTogglePin
+ * [Function Description]: same as DIO_togglePin() but accepts expander pins too
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [Return]: void
+ */
+void EXP_dioTogglePin(uint8_t a_pin)
+{
+	if(IS_EXP_PIN(a_pin))
+	{
+		EXP_togglePin(a_pin);
+	}
+	else
+	{
+		DIO_togglePin(a_pin);
+	}
+}
+
+/*
+ * [Function Name]: EXP_dioReadPin
+ * [Function Description]: same as DIO_readPin() but accepts expander pins too
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [Return]: uint8_t
+ * 			 HIGH or LOW
+ */
+uint8_t EXP_dioReadPin(uint8_t a_pin)
+{
+	if(IS_EXP_PIN(a_pin))
+	{
+		return EXP_readPin(a_pin);
+	}
+	return DIO_readPin(a_pin);
+}
+
+/*
+ * [Function Name]: EXP_dioControlPinInternalPull
+ * [Function Description]: same as DIO_controlPinInternalPull() but accepts
+ * 						   expander pins too, they have no internal pull
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [in]: DIO_InternalPullOptions a_pull
+ * 		 the pull option
+ * [Return]: uint8_t
+ * 			 returns DIO_INTERNAL_PULL_SUPPORTED or DIO_INTERNAL_PULL_NOT_SUPPORTED,
+ * 			 expander pins support DIO_NO_PULL only
+ */
+uint8_t EXP_dioControlPinInternalPull(uint8_t a_pin, DIO_InternalPullOptions a_pull)
+{
+	if(IS_EXP_PIN(a_pin))
+	{
+		return (a_pull == DIO_NO_PULL) ? DIO_INTERNAL_PULL_SUPPORTED : DIO_INTERNAL_PULL_NOT_SUPPORTED;
+	}
+	return DIO_controlPinInternalPull(a_pin, a_pull);
+}
+
+/*
+ * [Function Name]: EXP_startSync
+ * [Function Description]: queues the transactions of one sync together,
+ * 						   must be called with interrupts disabled
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 EXP_SUCCESS or EXP_BUSY if the spi queue has no place
+ */
+static uint8_t EXP_startSync(void)
+{
+#if EXP_INPUT_BYTES_COUNT > 0
+
+	if(SPI_getFreeTransactionsCount() < 2)
+	{
+		return EXP_BUSY;
+	}
+
+	/* the load byte is shifted into the outputs too, the burst pushes it out */
+	SPI_queueTransaction(&g_loadTransaction);
+
+#endif /* EXP_INPUT_BYTES_COUNT > 0 */
+
+	if(SPI_queueTransaction(&g_syncTransaction) == SPI_TRANSACTION_QUEUE_FULL)
+	{
+		return EXP_BUSY;
+	}
+
+	g_isSyncing = TRUE;
+	g_isSyncPending = FALSE;
+
+	return EXP_SUCCESS;
+}
+
+/*
+ * [Function Name]: EXP_syncDone
+ * [Function Description]: callback of the sync burst, publishes the inputs
+ * 						   and starts the pending sync if any
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void EXP_syncDone(void)
+{
+#if EXP_INPUT_BYTES_COUNT > 0
+	uint8_t loopCounter;
+
+	/* the register nearest to MISO is received first */
+	for(loopCounter = 0; loopCounter < EXP_INPUT_BYTES_COUNT; loopCounter ++)
+	{
+		g_inputsImage[loopCounter] = g_receiveBuffer[loopCounter];
+	}
+#endif /* EXP_INPUT_BYTES_COUNT > 0 */
+
+	g_isSyncing = FALSE;
+
+	if(g_isSyncPending == TRUE && EXP_startSync() == EXP_BUSY)
+	{
+		/* the spi queue is full, the sync stays pending and it's started
+		 * by the next EXP_sync() call or refresh tick */
+		g_isSyncPending = TRUE;
+	}
+}
+
+#if EXP_AUTO_REFRESH_ENABLED == 1
+
+/*
+ * [Function Name]: EXP_refreshProcessing
+ * [Function Description]: callback of the refresh timer, starts a sync
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void EXP_refreshProcessing(void)
+{
+	EXP_sync();
+}
+
+#endif /* EXP_AUTO_REFRESH_ENABLED == 1 */
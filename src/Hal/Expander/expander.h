@@ -0,0 +1,214 @@
+/******************************************************************************
+ *
+ * Module: EXPANDER
+ *
+ * File Name: expander.h
+ *
+ * Description: Header file for the shift registers port EXPANDER driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __EXPANDER_H__
+#define __EXPANDER_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module config file */
+#include "expander-config.h"
+
+/* for using std types */
+#include "../../Lib/types.h"
+
+/* For using common defines and macros */
+#include "../../Lib/common.h"
+
+/* For using pins directions */
+#include "../../Mcal/Dio/dio.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* returned from EXP_sync() */
+#define EXP_SUCCESS									1
+#define EXP_BUSY									0
+
+/*******************************************************************************
+ *                                Macros                                       *
+ *******************************************************************************/
+
+/* expander pin number of a bit in a register, used like the mcu pins (PA0, ...).
+ * byte 0 is the register nearest to the mcu in each chain, the output and
+ * input chains are numbered separately
+ */
+#define EXP_PIN(byte, bit)							(0x80 | ((byte) << 3) | (bit))
+
+/* checks if a pin number is an expander pin */
+#define IS_EXP_PIN(pin)								(((pin) & 0x80) != 0)
+
+/* gets the register and the bit of an expander pin */
+#define GET_EXP_BYTE_NO(pin)						(((pin) >> 3) & 0x0F)
+#define GET_EXP_BIT_NO(pin)							((pin) & 0x07)
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: EXP_init
+ * [Function Description]: initializes the spi as master and the latch and load pins,
+ * 						   clears all outputs and starts the first sync.
+ * 						   The syncs run from the spi interrupt, so global
+ * 						   interrupts must be enabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void EXP_init(void);
+
+/*
+ * [Function Name]: EXP_writePin
+ * [Function Description]: writes a value to an output pin in the shadow image,
+ * 						   it's applied to the registers by the next sync
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 expander output pin, EXP_PIN(byte, bit)
+ * [in]: uint8_t a_value
+ * 		 HIGH or LOW
+ * [Return]: void
+ */
+void EXP_writePin(uint8_t a_pin, uint8_t a_value);
+
+/*
+ * [Function Name]: EXP_togglePin
+ * [Function Description]: toggles an output pin in the shadow image
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 expander output pin, EXP_PIN(byte, bit)
+ * [Return]: void
+ */
+void EXP_togglePin(uint8_t a_pin);
+
+/*
+ * [Function Name]: EXP_readPin
+ * [Function Description]: reads an input pin as loaded by the last sync
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 expander input pin, EXP_PIN(byte, bit)
+ * [Return]: uint8_t
+ * 			 HIGH or LOW
+ */
+uint8_t EXP_readPin(uint8_t a_pin);
+
+/*
+ * [Function Name]: EXP_writeByte
+ * [Function Description]: writes all the 8 outputs of a register in the shadow image
+ * [Args]:
+ * [in]: uint8_t a_byte
+ * 		 register index in the output chain
+ * [in]: uint8_t a_value
+ * 		 value of the outputs
+ * [Return]: void
+ */
+void EXP_writeByte(uint8_t a_byte, uint8_t a_value);
+
+/*
+ * [Function Name]: EXP_readByte
+ * [Function Description]: reads all the 8 inputs of a register as loaded by the last sync
+ * [Args]:
+ * [in]: uint8_t a_byte
+ * 		 register index in the input chain
+ * [Return]: uint8_t
+ * 			 value of the inputs
+ */
+uint8_t EXP_readByte(uint8_t a_byte);
+
+/*
+ * [Function Name]: EXP_sync
+ * [Function Description]: shifts the whole output image out and the inputs in
+ * 						   with one spi burst, then latches the outputs.
+ * 						   If a sync is running, another one starts after it, or with
+ * 						   the next EXP_sync() call if the spi queue is full then
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 EXP_SUCCESS or EXP_BUSY if the spi queue has no place
+ */
+uint8_t EXP_sync(void);
+
+/*
+ * [Function Name]: EXP_isBusy
+ * [Function Description]: checks if a sync is running or waiting
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t EXP_isBusy(void);
+
+/*
+ * [Function Name]: EXP_dioPinInit
+ * [Function Description]: same as DIO_pinInit() but accepts expander pins too,
+ * 						   they have fixed directions so nothing is done for them
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [in]: DIO_PinDirectionType a_direction
+ * 		 the pin direction
+ * [Return]: void
+ */
+void EXP_dioPinInit(uint8_t a_pin, DIO_PinDirectionType a_direction);
+
+/*
+ * [Function Name]: EXP_dioWritePin
+ * [Function Description]: same as DIO_writePin() but accepts expander pins too
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [in]: uint8_t a_value
+ * 		 HIGH or LOW
+ * [Return]: void
+ */
+void EXP_dioWritePin(uint8_t a_pin, uint8_t a_value);
+
+/*
+ * [Function Name]: EXP_dioTogglePin
+ * [Function Description]: same as DIO_togglePin() but accepts expander pins too
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [Return]: void
+ */
+void EXP_dioTogglePin(uint8_t a_pin);
+
+/*
+ * [Function Name]: EXP_dioReadPin
+ * [Function Description]: same as DIO_readPin() but accepts expander pins too
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [Return]: uint8_t
+ * 			 HIGH or LOW
+ */
+uint8_t EXP_dioReadPin(uint8_t a_pin);
+
+/*
+ * [Function Name]: EXP_dioControlPinInternalPull
+ * [Function Description]: same as DIO_controlPinInternalPull() but accepts
+ * 						   expander pins too, they have no internal pull
+ * [Args]:
+ * [in]: uint8_t a_pin
+ * 		 mcu or expander pin
+ * [in]: DIO_InternalPullOptions a_pull
+ * 		 the pull option
+ * [Return]: uint8_t
+ * 			 returns DIO_INTERNAL_PULL_SUPPORTED or DIO_INTERNAL_PULL_NOT_SUPPORTED,
+ * 			 expander pins support DIO_NO_PULL only
+ */
+uint8_t EXP_dioControlPinInternalPull(uint8_t a_pin, DIO_InternalPullOptions a_pull);
+
+#endif /* __EXPANDER_H__ */
@@ -26,4 +26,58 @@
 /* temperature corresponding to the maximum voltage value LM35_MAX_VOLT_VALUE */
 #define LM35_MAX_TEMPERATURE    					 150
 
+/* if LM35_SERVICE_ENABLED = 1, the sensors are sampled in the background through
+ * the adc interrupt, the samples are filtered and the temperatures are read by
+ * LM35_getTemperatureCentiC() without waiting.
+ * The service sets the adc callback, so the adc must be initialized with
+ * ADC_INTERRUPT_ON and the callback mustn't be used by the application
+ */
+#define LM35_SERVICE_ENABLED						 1
+
+#if LM35_SERVICE_ENABLED == 1
+
+/* number of the sensors sampled by the service */
+#define LM35_SERVICE_SENSORS_COUNT					 2
+
+/* if LM35_SERVICE_TIMER_ENABLED = 1, the sampling is triggered from a timer interrupt,
+ * otherwise LM35_serviceTrigger() must be called periodically by the application,
+ * i.e. from a scheduler task. It's disabled by default as TIMER_0 is the scheduler timer
+ */
+#define LM35_SERVICE_TIMER_ENABLED					 0
+
+#if LM35_SERVICE_TIMER_ENABLED == 1
+
+/* the timer used for the sampling, its mode and prescaler, see timer.h */
+#define LM35_SERVICE_TIMER							 TIMER_0
+#define LM35_SERVICE_TIMER_MODE						 TIMER_0_CTC
+#define LM35_SERVICE_TIMER_PRESCALER				 TIMER_0_PRESCALER_1024
+
+/* the division value of LM35_SERVICE_TIMER_PRESCALER */
+#define LM35_SERVICE_PRESCALER_VALUE				 1024
+
+/* the sampling period of all the sensors in ms */
+#define LM35_SERVICE_PERIOD_MS						 100
+
+#endif /* LM35_SERVICE_TIMER_ENABLED == 1 */
+
+/* the exponential moving average filter weight of the new sample is 1 / 2^LM35_FILTER_SHIFT,
+ * from 0 (no filter) to 6
+ */
+#define LM35_FILTER_SHIFT							 3
+
+/* the sensor output voltage per degree */
+#define LM35_MILLI_VOLT_PER_DEGREE					 10
+
+/* the voltage read at 0 degree, it's more than 0 if the sensor ground is raised
+ * by diodes to measure negative temperatures with a single-ended channel
+ */
+#define LM35_ZERO_OFFSET_MILLI_VOLT					 0
+
+#endif /* LM35_SERVICE_ENABLED == 1 */
+
+/* making sure F_CPU is defined */
+#ifndef F_CPU
+#define F_CPU										 1000000UL
+#endif /* F_CPU */
+
 #endif /* __LM35_CONFIG_H__ */
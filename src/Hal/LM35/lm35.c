@@ -20,6 +20,62 @@
 /* for using ADC module */
 #include "../../Mcal/Adc/adc.h"
 
+#if LM35_SERVICE_ENABLED == 1 && LM35_SERVICE_TIMER_ENABLED == 1
+
+/* for using the sampling timer */
+#include "../../Mcal/Timer/timer.h"
+
+#endif /* LM35_SERVICE_ENABLED == 1 && LM35_SERVICE_TIMER_ENABLED == 1 */
+
+#if LM35_SERVICE_ENABLED == 1
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#if LM35_FILTER_SHIFT > 6
+#error "LM35_FILTER_SHIFT must be from 0 to 6"
+#endif
+
+/* fraction bits of the filtered adc values, 10 bits + 6 bits fit in 16 bits */
+#define LM35_FILTER_FRACTION_BITS					6
+
+/* the reference voltage of the adc in mv */
+#define LM35_REF_MILLI_VOLT							((uint32_t)(ADC_REF_VOLT_VALUE * 1000UL))
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: LM35_conversionDone
+ * [Function Description]: called from the adc interrupt when a sensor conversion is done,
+ * 						   it filters the sample and starts converting the next sensor
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void LM35_conversionDone(void);
+
+/*******************************************************************************
+ *                      	   Global Variables		                           *
+ *******************************************************************************/
+
+/* the adc pins of the sensors */
+static uint8_t g_sensorsPins[LM35_SERVICE_SENSORS_COUNT];
+
+/* filtered adc values of the sensors with LM35_FILTER_FRACTION_BITS fraction bits */
+static volatile uint16_t g_filteredValues[LM35_SERVICE_SENSORS_COUNT];
+
+/* set after the first sample of each sensor */
+static volatile uint8_t g_isSensorSampled[LM35_SERVICE_SENSORS_COUNT];
+
+/* index of the sensor being converted, and set while the sensors are being sampled */
+static uint8_t g_sensorIndex;
+static volatile uint8_t g_isSampling = FALSE;
+
+#endif /* LM35_SERVICE_ENABLED == 1 */
+
 /*******************************************************************************
  *                          Functions Definition	                           *
  *******************************************************************************/
@@ -44,3 +100,163 @@ uint8_t LM35_getTemperature(void)
 
 	return temp_value;
 }
+
+#if LM35_SERVICE_ENABLED == 1
+
+/*
+ * [Function Name]: LM35_serviceInit
+ * [Function Description]: starts sampling the sensors in the background, each trigger
+ * 						   converts the sensors one after another from the adc interrupt.
+ * 						   Global interrupts must be enabled
+ * [Args]:
+ * [in]: const uint8_t * a_pins
+ * 		 array of LM35_SERVICE_SENSORS_COUNT adc pins the sensors are connected to
+ * [Return]: void
+ */
+void LM35_serviceInit(const uint8_t * a_pins)
+{
+	uint8_t loopCounter;
+
+#if LM35_SERVICE_TIMER_ENABLED == 1
+	TIMER_config timerConfig = {
+			LM35_SERVICE_TIMER,
+			LM35_SERVICE_TIMER_MODE,
+			LM35_SERVICE_TIMER_PRESCALER,
+			TIME_MS_TO_TICKS(LM35_SERVICE_PRESCALER_VALUE, LM35_SERVICE_PERIOD_MS),
+			LM35_serviceTrigger
+	};
+#endif /* LM35_SERVICE_TIMER_ENABLED == 1 */
+
+	for(loopCounter = 0; loopCounter < LM35_SERVICE_SENSORS_COUNT; loopCounter ++)
+	{
+		g_sensorsPins[loopCounter] = a_pins[loopCounter];
+		g_isSensorSampled[loopCounter] = FALSE;
+	}
+	g_isSampling = FALSE;
+
+	ADC_setCallBack(LM35_conversionDone);
+
+	/* the first samples are taken directly */
+	LM35_serviceTrigger();
+
+#if LM35_SERVICE_TIMER_ENABLED == 1
+	TIMER_init(&timerConfig);
+	TIMER_start(LM35_SERVICE_TIMER);
+#endif /* LM35_SERVICE_TIMER_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: LM35_serviceTrigger
+ * [Function Description]: starts sampling all the sensors, it's called from the timer
+ * 						   interrupt if LM35_SERVICE_TIMER_ENABLED = 1 or periodically by
+ * 						   the application otherwise. It's ignored if the previous
+ * 						   sampling isn't done yet
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void LM35_serviceTrigger(void)
+{
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+
+	if(g_isSampling == FALSE)
+	{
+		g_isSampling = TRUE;
+		g_sensorIndex = 0;
+		ADC_readChannelInterrupt(g_sensorsPins[0]);
+	}
+
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: LM35_getTemperatureCentiC
+ * [Function Description]: gets the filtered temperature of a sensor without waiting
+ * [Args]:
+ * [in]: uint8_t a_sensorIndex
+ * 		 index of the sensor in the pins array
+ * [Return]: int16_t
+ * 			 temperature in 0.01 degree, or LM35_NO_TEMPERATURE if the sensor isn't
+ * 			 sampled yet, the index is out of the array or the reading is above
+ * 			 LM35_MAX_TEMPERATURE, i.e. an open or shorted input
+ */
+int16_t LM35_getTemperatureCentiC(uint8_t a_sensorIndex)
+{
+	uint16_t filteredValue;
+	int32_t centiDegrees;
+	uint8_t sreg;
+
+	if(a_sensorIndex >= LM35_SERVICE_SENSORS_COUNT || g_isSensorSampled[a_sensorIndex] == FALSE)
+	{
+		return LM35_NO_TEMPERATURE;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+	filteredValue = g_filteredValues[a_sensorIndex];
+	EXIT_CRITICAL_SECTION(sreg);
+
+	/* voltage = value * reference / 1024, the value has 6 fraction bits */
+	centiDegrees = (int32_t)((((uint64_t)filteredValue * LM35_REF_MILLI_VOLT * 100UL) / LM35_MILLI_VOLT_PER_DEGREE) \
+			>> (10 + LM35_FILTER_FRACTION_BITS));
+	centiDegrees -= ((int32_t)LM35_ZERO_OFFSET_MILLI_VOLT * 100L) / LM35_MILLI_VOLT_PER_DEGREE;
+
+	/* near the adc full scale it would overflow int16_t and read as negative */
+	if(centiDegrees > (int32_t)LM35_MAX_TEMPERATURE * 100L)
+	{
+		return LM35_NO_TEMPERATURE;
+	}
+
+	return (int16_t)centiDegrees;
+}
+
+/*
+ * [Function Name]: LM35_conversionDone
+ * [Function Description]: called from the adc interrupt when a sensor conversion is done,
+ * 						   it filters the sample and starts converting the next sensor
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void LM35_conversionDone(void)
+{
+	uint16_t sample, filteredValue;
+
+	if(g_isSampling == FALSE)
+	{
+		return;
+	}
+
+	sample = g_adcResult << LM35_FILTER_FRACTION_BITS;
+	filteredValue = g_filteredValues[g_sensorIndex];
+
+	if(g_isSensorSampled[g_sensorIndex] == FALSE)
+	{
+		/* the filter starts from the first sample */
+		filteredValue = sample;
+		g_isSensorSampled[g_sensorIndex] = TRUE;
+	}
+	else if(sample >= filteredValue)
+	{
+		filteredValue += (sample - filteredValue) >> LM35_FILTER_SHIFT;
+	}
+	else
+	{
+		filteredValue -= (filteredValue - sample) >> LM35_FILTER_SHIFT;
+	}
+	g_filteredValues[g_sensorIndex] = filteredValue;
+
+	/* convert the next sensor */
+	g_sensorIndex ++;
+	if(g_sensorIndex < LM35_SERVICE_SENSORS_COUNT)
+	{
+		ADC_readChannelInterrupt(g_sensorsPins[g_sensorIndex]);
+	}
+	else
+	{
+		g_isSampling = FALSE;
+	}
+}
+
+#endif /* LM35_SERVICE_ENABLED == 1 */
@@ -26,6 +26,17 @@
 /* For using common defines and macros */
 #include "../../Lib/common.h"
 
+#if LM35_SERVICE_ENABLED == 1
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* returned by LM35_getTemperatureCentiC() if the sensor isn't sampled yet */
+#define LM35_NO_TEMPERATURE							(-32767 - 1)
+
+#endif /* LM35_SERVICE_ENABLED == 1 */
+
 /*******************************************************************************
  *                           Function Prototypes                               *
  *******************************************************************************/
@@ -40,4 +51,45 @@
  */
 uint8_t LM35_getTemperature(void);
 
+#if LM35_SERVICE_ENABLED == 1
+
+/*
+ * [Function Name]: LM35_serviceInit
+ * [Function Description]: starts sampling the sensors in the background, each trigger
+ * 						   converts the sensors one after another from the adc interrupt.
+ * 						   Global interrupts must be enabled
+ * [Args]:
+ * [in]: const uint8_t * a_pins
+ * 		 array of LM35_SERVICE_SENSORS_COUNT adc pins the sensors are connected to
+ * [Return]: void
+ */
+void LM35_serviceInit(const uint8_t * a_pins);
+
+/*
+ * [Function Name]: LM35_serviceTrigger
+ * [Function Description]: starts sampling all the sensors, it's called from the timer
+ * 						   interrupt if LM35_SERVICE_TIMER_ENABLED = 1 or periodically by
+ * 						   the application otherwise. It's ignored if the previous
+ * 						   sampling isn't done yet
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void LM35_serviceTrigger(void);
+
+/*
+ * [Function Name]: LM35_getTemperatureCentiC
+ * [Function Description]: gets the filtered temperature of a sensor without waiting
+ * [Args]:
+ * [in]: uint8_t a_sensorIndex
+ * 		 index of the sensor in the pins array
+ * [Return]: int16_t
+ * 			 temperature in 0.01 degree, or LM35_NO_TEMPERATURE if the sensor isn't
+ * 			 sampled yet, the index is out of the array or the reading is above
+ * 			 LM35_MAX_TEMPERATURE, i.e. an open or shorted input
+ */
+int16_t LM35_getTemperatureCentiC(uint8_t a_sensorIndex);
+
+#endif /* LM35_SERVICE_ENABLED == 1 */
+
 #endif /* __LM35_H__ */
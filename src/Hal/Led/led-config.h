@@ -51,4 +51,24 @@
  */
 #define LED_INITIAL_STATE					LED_OFF
 
+/* if LED_EXPANDER_PINS_ENABLED = 1, the leds pins can be expander pins
+ * EXP_PIN(byte, bit) too, the EXPANDER driver must be initialized and synced
+ * by the application, LED_dim() turns expander pins fully on or off
+ */
+#define LED_EXPANDER_PINS_ENABLED			0
+
+/* if LED_EFFECTS_ENABLED = 1, the leds can run effects (patterns, blinking, blink
+ * codes, heartbeat and breathing) advanced by LED_effectsTick() without blocking
+ */
+#define LED_EFFECTS_ENABLED					1
+
+#if LED_EFFECTS_ENABLED == 1
+
+/* period of calling LED_effectsTick() in ms, i.e. from a scheduler task,
+ * the effects times are rounded to it
+ */
+#define LED_EFFECTS_TICK_MS					10
+
+#endif /* LED_EFFECTS_ENABLED == 1 */
+
 #endif /* __LED_CONFIG_H__ */
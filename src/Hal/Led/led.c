@@ -25,8 +25,202 @@
 /* For using pwm for controlling led brightness */
 #include "../../Mcal/Pwm/pwm.h"
 
+/* For using the pwm pins */
+#include "../../Mcal/Mcu/mcu.h"
+
 #endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
 
+#if LED_EXPANDER_PINS_ENABLED == 1
+
+/* For using expander pins */
+#include "../Expander/expander.h"
+
+#endif /* LED_EXPANDER_PINS_ENABLED == 1 */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* pins functions, they accept expander pins if enabled */
+#if LED_EXPANDER_PINS_ENABLED == 1
+#define LED_PIN_INIT(pin)					EXP_dioPinInit(pin, PIN_OUTPUT)
+#define LED_WRITE_PIN(pin, value)			EXP_dioWritePin(pin, value)
+#define LED_TOGGLE_PIN(pin)					EXP_dioTogglePin(pin)
+#else
+#define LED_PIN_INIT(pin)					DIO_pinInit(pin, PIN_OUTPUT)
+#define LED_WRITE_PIN(pin, value)			DIO_writePin(pin, value)
+#define LED_TOGGLE_PIN(pin)					DIO_togglePin(pin)
+#endif /* LED_EXPANDER_PINS_ENABLED == 1 */
+
+#if LED_EFFECTS_ENABLED == 1
+
+/* effects of the leds */
+#define LED_EFFECT_NONE						0
+#define LED_EFFECT_PATTERN					1
+#define LED_EFFECT_BREATHE					2
+
+/* last written state before writing the first step of a pattern */
+#define LED_STATE_UNKNOWN					0xFF
+
+/* the msb of a pattern, it's the state of the current step */
+#define LED_PATTERN_STEP_MASK				0x80000000UL
+
+/*******************************************************************************
+ *                                Macros                                       *
+ *******************************************************************************/
+
+/* converts a time in ms to effects ticks, rounded to the nearest tick */
+#define LED_MS_TO_TICKS(time)				(((uint32_t)(time) + LED_EFFECTS_TICK_MS / 2) / LED_EFFECTS_TICK_MS)
+
+/* gets the pin of a led by its index */
+#if LEDS_USED_COUNT == 1
+#define LED_PIN_OF(index)					LED_PIN
+#else
+#define LED_PIN_OF(index)					(g_leds[index].pin)
+#endif /* LEDS_USED_COUNT == 1 */
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: LED_startPattern
+ * [Function Description]: starts repeating a pattern on a led and shows its first step
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint32_t a_bits
+ * 		 state of the led in each step, the first step is the msb
+ * [in]: uint8_t a_stepsCount
+ * 		 number of steps, from 1 to LED_PATTERN_MAX_STEPS
+ * [in]: uint16_t a_stepTicks
+ * 		 duration of each step in ticks, at least 1
+ * [Return]: void
+ */
+static void LED_startPattern(uint8_t a_ledIndex, uint32_t a_bits, uint8_t a_stepsCount, uint16_t a_stepTicks);
+
+/*
+ * [Function Name]: LED_playPatternIndex
+ * [Function Description]: repeats a pattern on a led, same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: FLASH_CONST ST_LedPattern * a_pattern
+ * 		 pattern to repeat
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR
+ */
+static uint8_t LED_playPatternIndex(uint8_t a_ledIndex, FLASH_CONST ST_LedPattern * a_pattern);
+
+/*
+ * [Function Name]: LED_blinkIndex
+ * [Function Description]: blinks a led, same as LED_blink()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint16_t a_periodMs
+ * 		 period of a blink in ms
+ * [in]: uint8_t a_dutyPercent
+ * 		 percentage of the period the led is on (from 0 to 100)
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR
+ */
+static uint8_t LED_blinkIndex(uint8_t a_ledIndex, uint16_t a_periodMs, uint8_t a_dutyPercent);
+
+/*
+ * [Function Name]: LED_blinkCodeIndex
+ * [Function Description]: blinks a led a number of times then pauses, same as LED_blinkCode()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint8_t a_count
+ * 		 number of blinks
+ * [in]: uint16_t a_blinkMs
+ * 		 on time and off time of each blink in ms
+ * [in]: uint16_t a_pauseMs
+ * 		 time after the blinks in ms
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR
+ */
+static uint8_t LED_blinkCodeIndex(uint8_t a_ledIndex, uint8_t a_count, uint16_t a_blinkMs, uint16_t a_pauseMs);
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+
+/*
+ * [Function Name]: LED_breatheIndex
+ * [Function Description]: fades a led in and out, same as LED_breathe()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint16_t a_periodMs
+ * 		 period of a breath in ms
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period is too short or the pin doesn't support pwm
+ */
+static uint8_t LED_breatheIndex(uint8_t a_ledIndex, uint16_t a_periodMs);
+
+/*
+ * [Function Name]: LED_breatheStep
+ * [Function Description]: sets the brightness of a breathing led from its phase,
+ * 						   squared so the fading looks linear
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void LED_breatheStep(uint8_t a_ledIndex);
+
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+/*
+ * [Function Name]: LED_setEffect
+ * [Function Description]: adds a led to the active leds if it has no effect, or stops
+ * 						   its pwm if it's breathing, then sets its effect.
+ * 						   It must be called with global interrupts disabled
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint8_t a_effect
+ * 		 LED_EFFECT_PATTERN or LED_EFFECT_BREATHE
+ * [Return]: void
+ */
+static void LED_setEffect(uint8_t a_ledIndex, uint8_t a_effect);
+
+/*
+ * [Function Name]: LED_stopEffectIndex
+ * [Function Description]: stops the effect of a led and turns it off
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void LED_stopEffectIndex(uint8_t a_ledIndex);
+
+/*
+ * [Function Name]: LED_showStep
+ * [Function Description]: shows the current step of the pattern of a led, the pin
+ * 						   is written only if the state changes
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void LED_showStep(uint8_t a_ledIndex);
+
+/*
+ * [Function Name]: LED_write
+ * [Function Description]: turns a led on or off
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint8_t a_state
+ * 		 LED_ON or LED_OFF
+ * [Return]: void
+ */
+static void LED_write(uint8_t a_ledIndex, uint8_t a_state);
+
+#endif /* LED_EFFECTS_ENABLED == 1 */
+
 /*******************************************************************************
  *                      	   Global Variables		                           *
  *******************************************************************************/
@@ -38,6 +232,37 @@ static ST_Led g_leds[LEDS_USED_COUNT];
 
 #endif /* LEDS_USED_COUNT != 1 */
 
+#if LED_EFFECTS_ENABLED == 1
+
+/* two short blinks every second */
+static FLASH_CONST ST_LedPattern g_heartbeatPattern = {0xA0000000UL, 10, 100};
+
+/* indices of the leds running effects, so the tick visits only them */
+static uint8_t g_activeLeds[LEDS_USED_COUNT];
+static uint8_t g_activeLedsCount = 0;
+
+/* effect of each led */
+static uint8_t g_ledsEffects[LEDS_USED_COUNT];
+
+/* state of the pattern of each led, the remaining bits are shifted left every step */
+static uint32_t g_patternsBits[LEDS_USED_COUNT];
+static uint32_t g_remainingBits[LEDS_USED_COUNT];
+static uint8_t g_patternsStepsCounts[LEDS_USED_COUNT];
+static uint8_t g_stepsLeft[LEDS_USED_COUNT];
+static uint16_t g_stepsTicks[LEDS_USED_COUNT];
+static uint16_t g_ticksLeft[LEDS_USED_COUNT];
+static uint8_t g_ledsStates[LEDS_USED_COUNT];
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+
+/* period and current tick of the breath of each led */
+static uint16_t g_breathePeriods[LEDS_USED_COUNT];
+static uint16_t g_breathePhases[LEDS_USED_COUNT];
+
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+#endif /* LED_EFFECTS_ENABLED == 1 */
+
 /*******************************************************************************
  *                          Functions Definition	                           *
  *******************************************************************************/
@@ -53,7 +278,7 @@ static ST_Led g_leds[LEDS_USED_COUNT];
  */
 void LED_init(void)
 {
-	DIO_pinInit(LED_PIN, PIN_OUTPUT);
+	LED_PIN_INIT(LED_PIN);
 
 #if LED_INITIAL_STATE == LED_ON
 
@@ -75,7 +300,7 @@ void LED_init(void)
  */
 void LED_on(void)
 {
-	DIO_writePin(LED_PIN, LED_LOGIC);
+	LED_WRITE_PIN(LED_PIN, LED_LOGIC);
 }
 
 /*
@@ -87,7 +312,7 @@ void LED_on(void)
  */
 void LED_off(void)
 {
-	DIO_writePin(LED_PIN, !LED_LOGIC);
+	LED_WRITE_PIN(LED_PIN, !LED_LOGIC);
 }
 
 /*
@@ -99,7 +324,7 @@ void LED_off(void)
  */
 void LED_toggle(void)
 {
-	DIO_togglePin(LED_PIN);
+	LED_TOGGLE_PIN(LED_PIN);
 }
 
 #if PWM_FOR_DIMMING_SUPPORTED == 1
@@ -124,7 +349,7 @@ void LED_dim(uint8_t a_brightness)
 	if(PWM_enable(LED_PIN, a_brightness) == PWM_ERROR)
 	{
 		/* write high if pwm is not supported on the pin */
-		DIO_writePin(LED_PIN, HIGH);
+		LED_WRITE_PIN(LED_PIN, HIGH);
 	}
 
 #else
@@ -133,7 +358,7 @@ void LED_dim(uint8_t a_brightness)
 	if(PWM_enable(LED_PIN, 100 - a_brightness) == PWM_ERROR)
 	{
 		/* write high if pwm is not supported on the pin */
-		DIO_writePin(LED_PIN, LOW);
+		LED_WRITE_PIN(LED_PIN, LOW);
 	}
 
 
@@ -160,7 +385,7 @@ void LED_init(const ST_Led * a_leds)
 	{
 		/* copy values from a_leds to g_leds */
 		g_leds[loopCounter] = a_leds[loopCounter];
-		DIO_pinInit(g_leds[loopCounter].pin, PIN_OUTPUT);
+		LED_PIN_INIT(g_leds[loopCounter].pin);
 
 #if LED_INITIAL_STATE == LED_ON
 
@@ -187,7 +412,7 @@ void LED_on(uint8_t a_ledIndex)
 {
 	if(a_ledIndex < LEDS_USED_COUNT)
 	{
-		DIO_writePin(g_leds[a_ledIndex].pin, g_leds[a_ledIndex].logic);
+		LED_WRITE_PIN(g_leds[a_ledIndex].pin, g_leds[a_ledIndex].logic);
 	}
 }
 
@@ -203,7 +428,7 @@ void LED_off(uint8_t a_ledIndex)
 {
 	if(a_ledIndex < LEDS_USED_COUNT)
 	{
-		DIO_writePin(g_leds[a_ledIndex].pin, !g_leds[a_ledIndex].logic);
+		LED_WRITE_PIN(g_leds[a_ledIndex].pin, !g_leds[a_ledIndex].logic);
 	}
 }
 
@@ -219,7 +444,7 @@ void LED_toggle(uint8_t a_ledIndex)
 {
 	if(a_ledIndex < LEDS_USED_COUNT)
 	{
-		DIO_togglePin(g_leds[a_ledIndex].pin);
+		LED_TOGGLE_PIN(g_leds[a_ledIndex].pin);
 	}
 }
 
@@ -247,7 +472,7 @@ void LED_dim(uint8_t a_ledIndex, uint8_t a_brightness)
 		if(PWM_enable(g_leds[a_ledIndex].pin, a_brightness) == PWM_ERROR)
 		{
 			/* write high if pwm is not supported on the pin */
-			DIO_writePin(g_leds[a_ledIndex].pin, HIGH);
+			LED_WRITE_PIN(g_leds[a_ledIndex].pin, HIGH);
 		}
 	}
 	else
@@ -257,7 +482,7 @@ void LED_dim(uint8_t a_ledIndex, uint8_t a_brightness)
 		if(PWM_enable(g_leds[a_ledIndex].pin, 100 - a_brightness) == PWM_ERROR)
 		{
 			/* write high if pwm is not supported on the pin */
-			DIO_writePin(g_leds[a_ledIndex].pin, LOW);
+			LED_WRITE_PIN(g_leds[a_ledIndex].pin, LOW);
 		}
 	}
 }
@@ -265,3 +490,635 @@ void LED_dim(uint8_t a_ledIndex, uint8_t a_brightness)
 #endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
 
 #endif /* LEDS_USED_COUNT == 1 */
+
+#if LED_EFFECTS_ENABLED == 1
+
+#if LEDS_USED_COUNT == 1
+
+/*
+ * [Function Name]: LED_playPattern
+ * [Function Description]: repeats a pattern on the led till the effect is stopped, the
+ * 						   first step is shown directly. LED_on(), LED_off(), LED_toggle()
+ * 						   and LED_dim() can't be used till LED_stopEffect() is called
+ * [Args]:
+ * [in]: FLASH_CONST ST_LedPattern * a_pattern
+ * 		 pattern to repeat
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the pattern steps count is invalid
+ */
+uint8_t LED_playPattern(FLASH_CONST ST_LedPattern * a_pattern)
+{
+	return LED_playPatternIndex(0, a_pattern);
+}
+
+/*
+ * [Function Name]: LED_blink
+ * [Function Description]: blinks the led till the effect is stopped, same as LED_playPattern()
+ * [Args]:
+ * [in]: uint16_t a_periodMs
+ * 		 period of a blink in ms, at least LED_EFFECTS_TICK_MS
+ * [in]: uint8_t a_dutyPercent
+ * 		 percentage of the period the led is on (from 0 to 100)
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period or the duty is invalid
+ */
+uint8_t LED_blink(uint16_t a_periodMs, uint8_t a_dutyPercent)
+{
+	return LED_blinkIndex(0, a_periodMs, a_dutyPercent);
+}
+
+/*
+ * [Function Name]: LED_blinkCode
+ * [Function Description]: blinks the led a number of times then pauses, repeated till the
+ * 						   effect is stopped, i.e. to show error codes. Same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_count
+ * 		 number of blinks, at least 1
+ * [in]: uint16_t a_blinkMs
+ * 		 on time and off time of each blink in ms
+ * [in]: uint16_t a_pauseMs
+ * 		 time after the blinks in ms, the blinks and the pause must fit in
+ * 		 LED_PATTERN_MAX_STEPS steps of a_blinkMs
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if they don't fit in a pattern
+ */
+uint8_t LED_blinkCode(uint8_t a_count, uint16_t a_blinkMs, uint16_t a_pauseMs)
+{
+	return LED_blinkCodeIndex(0, a_count, a_blinkMs, a_pauseMs);
+}
+
+/*
+ * [Function Name]: LED_heartbeat
+ * [Function Description]: blinks the led twice every second till the effect is stopped,
+ * 						   same as LED_playPattern()
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void LED_heartbeat(void)
+{
+	LED_playPatternIndex(0, &g_heartbeatPattern);
+}
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+
+/*
+ * [Function Name]: LED_breathe
+ * [Function Description]: fades the led in and out with LED_dim() every tick till the effect
+ * 						   is stopped. The led pin must be PWM0, PWM1A, PWM1B or PWM2
+ * [Args]:
+ * [in]: uint16_t a_periodMs
+ * 		 period of a breath in ms, at least 2 * LED_EFFECTS_TICK_MS
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period is too short or the pin doesn't support pwm
+ */
+uint8_t LED_breathe(uint16_t a_periodMs)
+{
+	return LED_breatheIndex(0, a_periodMs);
+}
+
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+/*
+ * [Function Name]: LED_stopEffect
+ * [Function Description]: stops the effect of the led and turns it off
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void LED_stopEffect(void)
+{
+	LED_stopEffectIndex(0);
+}
+
+#else
+
+/*
+ * [Function Name]: LED_playPattern
+ * [Function Description]: repeats a pattern on the led till the effect is stopped, the
+ * 						   first step is shown directly. LED_on(), LED_off(), LED_toggle()
+ * 						   and LED_dim() can't be used till LED_stopEffect() is called
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [in]: FLASH_CONST ST_LedPattern * a_pattern
+ * 		 pattern to repeat
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the pattern steps count or the index is invalid
+ */
+uint8_t LED_playPattern(uint8_t a_ledIndex, FLASH_CONST ST_LedPattern * a_pattern)
+{
+	if(a_ledIndex >= LEDS_USED_COUNT)
+	{
+		return LED_ERROR;
+	}
+	return LED_playPatternIndex(a_ledIndex, a_pattern);
+}
+
+/*
+ * [Function Name]: LED_blink
+ * [Function Description]: blinks the led till the effect is stopped, same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [in]: uint16_t a_periodMs
+ * 		 period of a blink in ms, at least LED_EFFECTS_TICK_MS
+ * [in]: uint8_t a_dutyPercent
+ * 		 percentage of the period the led is on (from 0 to 100)
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period, the duty or the index is invalid
+ */
+uint8_t LED_blink(uint8_t a_ledIndex, uint16_t a_periodMs, uint8_t a_dutyPercent)
+{
+	if(a_ledIndex >= LEDS_USED_COUNT)
+	{
+		return LED_ERROR;
+	}
+	return LED_blinkIndex(a_ledIndex, a_periodMs, a_dutyPercent);
+}
+
+/*
+ * [Function Name]: LED_blinkCode
+ * [Function Description]: blinks the led a number of times then pauses, repeated till the
+ * 						   effect is stopped, i.e. to show error codes. Same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [in]: uint8_t a_count
+ * 		 number of blinks, at least 1
+ * [in]: uint16_t a_blinkMs
+ * 		 on time and off time of each blink in ms
+ * [in]: uint16_t a_pauseMs
+ * 		 time after the blinks in ms, the blinks and the pause must fit in
+ * 		 LED_PATTERN_MAX_STEPS steps of a_blinkMs
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if they don't fit in a pattern or the index is invalid
+ */
+uint8_t LED_blinkCode(uint8_t a_ledIndex, uint8_t a_count, uint16_t a_blinkMs, uint16_t a_pauseMs)
+{
+	if(a_ledIndex >= LEDS_USED_COUNT)
+	{
+		return LED_ERROR;
+	}
+	return LED_blinkCodeIndex(a_ledIndex, a_count, a_blinkMs, a_pauseMs);
+}
+
+/*
+ * [Function Name]: LED_heartbeat
+ * [Function Description]: blinks the led twice every second till the effect is stopped,
+ * 						   same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [Return]: void
+ */
+void LED_heartbeat(uint8_t a_ledIndex)
+{
+	if(a_ledIndex < LEDS_USED_COUNT)
+	{
+		LED_playPatternIndex(a_ledIndex, &g_heartbeatPattern);
+	}
+}
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+
+/*
+ * [Function Name]: LED_breathe
+ * [Function Description]: fades the led in and out with LED_dim() every tick till the effect
+ * 						   is stopped. The led pin must be PWM0, PWM1A, PWM1B or PWM2
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [in]: uint16_t a_periodMs
+ * 		 period of a breath in ms, at least 2 * LED_EFFECTS_TICK_MS
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period is too short, the pin doesn't
+ * 			 support pwm or the index is invalid
+ */
+uint8_t LED_breathe(uint8_t a_ledIndex, uint16_t a_periodMs)
+{
+	if(a_ledIndex >= LEDS_USED_COUNT)
+	{
+		return LED_ERROR;
+	}
+	return LED_breatheIndex(a_ledIndex, a_periodMs);
+}
+
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+/*
+ * [Function Name]: LED_stopEffect
+ * [Function Description]: stops the effect of the led and turns it off
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [Return]: void
+ */
+void LED_stopEffect(uint8_t a_ledIndex)
+{
+	if(a_ledIndex < LEDS_USED_COUNT)
+	{
+		LED_stopEffectIndex(a_ledIndex);
+	}
+}
+
+#endif /* LEDS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: LED_effectsTick
+ * [Function Description]: advances the effects of the leds, it must be called every
+ * 						   LED_EFFECTS_TICK_MS, i.e. from a scheduler task or a timer handler.
+ * 						   Only the leds running effects are visited, and the patterns pins
+ * 						   are written only when their state changes
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void LED_effectsTick(void)
+{
+	uint8_t loopCounter;
+	uint8_t index;
+	uint8_t sreg;
+
+	/* the effects can be changed from an interrupt or the main code */
+	ENTER_CRITICAL_SECTION(sreg);
+	for(loopCounter = 0; loopCounter < g_activeLedsCount; loopCounter ++)
+	{
+		index = g_activeLeds[loopCounter];
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+		if(g_ledsEffects[index] == LED_EFFECT_BREATHE)
+		{
+			g_breathePhases[index] ++;
+			if(g_breathePhases[index] == g_breathePeriods[index])
+			{
+				g_breathePhases[index] = 0;
+			}
+			LED_breatheStep(index);
+			continue;
+		}
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+		g_ticksLeft[index] --;
+		if(g_ticksLeft[index] == 0)
+		{
+			g_ticksLeft[index] = g_stepsTicks[index];
+
+			/* repeat the pattern after its last step */
+			g_stepsLeft[index] --;
+			if(g_stepsLeft[index] == 0)
+			{
+				g_stepsLeft[index] = g_patternsStepsCounts[index];
+				g_remainingBits[index] = g_patternsBits[index];
+			}
+			LED_showStep(index);
+		}
+	}
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: LED_startPattern
+ * [Function Description]: starts repeating a pattern on a led and shows its first step
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint32_t a_bits
+ * 		 state of the led in each step, the first step is the msb
+ * [in]: uint8_t a_stepsCount
+ * 		 number of steps, from 1 to LED_PATTERN_MAX_STEPS
+ * [in]: uint16_t a_stepTicks
+ * 		 duration of each step in ticks, at least 1
+ * [Return]: void
+ */
+static void LED_startPattern(uint8_t a_ledIndex, uint32_t a_bits, uint8_t a_stepsCount, uint16_t a_stepTicks)
+{
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	LED_setEffect(a_ledIndex, LED_EFFECT_PATTERN);
+
+	g_patternsBits[a_ledIndex] = a_bits;
+	g_remainingBits[a_ledIndex] = a_bits;
+	g_patternsStepsCounts[a_ledIndex] = a_stepsCount;
+	g_stepsLeft[a_ledIndex] = a_stepsCount;
+	g_stepsTicks[a_ledIndex] = a_stepTicks;
+	g_ticksLeft[a_ledIndex] = a_stepTicks;
+
+	/* the first step is always written */
+	g_ledsStates[a_ledIndex] = LED_STATE_UNKNOWN;
+	LED_showStep(a_ledIndex);
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: LED_playPatternIndex
+ * [Function Description]: repeats a pattern on a led, same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: FLASH_CONST ST_LedPattern * a_pattern
+ * 		 pattern to repeat
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR
+ */
+static uint8_t LED_playPatternIndex(uint8_t a_ledIndex, FLASH_CONST ST_LedPattern * a_pattern)
+{
+	uint8_t stepsCount = a_pattern->stepsCount;
+	uint32_t stepTicks = LED_MS_TO_TICKS(a_pattern->stepMs);
+
+	if(stepsCount == 0 || stepsCount > LED_PATTERN_MAX_STEPS)
+	{
+		return LED_ERROR;
+	}
+	if(stepTicks == 0)
+	{
+		stepTicks = 1;
+	}
+
+	LED_startPattern(a_ledIndex, a_pattern->bits, stepsCount, stepTicks);
+
+	return LED_SUCCESS;
+}
+
+/*
+ * [Function Name]: LED_blinkIndex
+ * [Function Description]: blinks a led, same as LED_blink()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint16_t a_periodMs
+ * 		 period of a blink in ms
+ * [in]: uint8_t a_dutyPercent
+ * 		 percentage of the period the led is on (from 0 to 100)
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR
+ */
+static uint8_t LED_blinkIndex(uint8_t a_ledIndex, uint16_t a_periodMs, uint8_t a_dutyPercent)
+{
+	uint16_t periodTicks = LED_MS_TO_TICKS(a_periodMs);
+	uint16_t stepTicks;
+	uint8_t stepsCount, onStepsCount;
+	uint32_t bits = 0;
+
+	if(periodTicks == 0 || a_dutyPercent > 100)
+	{
+		return LED_ERROR;
+	}
+
+	/* the period is divided into the most steps that fit in a pattern */
+	stepTicks = (periodTicks + LED_PATTERN_MAX_STEPS - 1) / LED_PATTERN_MAX_STEPS;
+	stepsCount = periodTicks / stepTicks;
+	onStepsCount = ((uint16_t)stepsCount * a_dutyPercent + 50) / 100;
+
+	if(onStepsCount != 0)
+	{
+		bits = 0xFFFFFFFFUL << (LED_PATTERN_MAX_STEPS - onStepsCount);
+	}
+
+	LED_startPattern(a_ledIndex, bits, stepsCount, stepTicks);
+
+	return LED_SUCCESS;
+}
+
+/*
+ * [Function Name]: LED_blinkCodeIndex
+ * [Function Description]: blinks a led a number of times then pauses, same as LED_blinkCode()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint8_t a_count
+ * 		 number of blinks
+ * [in]: uint16_t a_blinkMs
+ * 		 on time and off time of each blink in ms
+ * [in]: uint16_t a_pauseMs
+ * 		 time after the blinks in ms
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR
+ */
+static uint8_t LED_blinkCodeIndex(uint8_t a_ledIndex, uint8_t a_count, uint16_t a_blinkMs, uint16_t a_pauseMs)
+{
+	uint32_t stepTicks = LED_MS_TO_TICKS(a_blinkMs);
+	uint16_t stepsCount;
+	uint32_t bits = 0;
+	uint8_t loopCounter;
+
+	if(a_count == 0 || a_blinkMs == 0)
+	{
+		return LED_ERROR;
+	}
+
+	/* on and off steps for each blink, then the pause steps */
+	stepsCount = 2 * (uint16_t)a_count + ((uint32_t)a_pauseMs + a_blinkMs / 2) / a_blinkMs;
+	if(stepsCount > LED_PATTERN_MAX_STEPS)
+	{
+		return LED_ERROR;
+	}
+	if(stepTicks == 0)
+	{
+		stepTicks = 1;
+	}
+
+	for(loopCounter = 0; loopCounter < a_count; loopCounter ++)
+	{
+		bits |= LED_PATTERN_STEP_MASK >> (2 * loopCounter);
+	}
+
+	LED_startPattern(a_ledIndex, bits, stepsCount, stepTicks);
+
+	return LED_SUCCESS;
+}
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+
+/*
+ * [Function Name]: LED_breatheIndex
+ * [Function Description]: fades a led in and out, same as LED_breathe()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint16_t a_periodMs
+ * 		 period of a breath in ms
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period is too short or the pin doesn't support pwm
+ */
+static uint8_t LED_breatheIndex(uint8_t a_ledIndex, uint16_t a_periodMs)
+{
+	uint16_t periodTicks = LED_MS_TO_TICKS(a_periodMs);
+	uint8_t sreg;
+
+	if(periodTicks < 2)
+	{
+		return LED_ERROR;
+	}
+
+	/* the led would stay fully on on other pins */
+	if(LED_PIN_OF(a_ledIndex) != PWM0 && LED_PIN_OF(a_ledIndex) != PWM1A && \
+			LED_PIN_OF(a_ledIndex) != PWM1B && LED_PIN_OF(a_ledIndex) != PWM2)
+	{
+		return LED_ERROR;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+	LED_setEffect(a_ledIndex, LED_EFFECT_BREATHE);
+	g_breathePeriods[a_ledIndex] = periodTicks;
+	g_breathePhases[a_ledIndex] = 0;
+	LED_breatheStep(a_ledIndex);
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return LED_SUCCESS;
+}
+
+/*
+ * [Function Name]: LED_breatheStep
+ * [Function Description]: sets the brightness of a breathing led from its phase,
+ * 						   squared so the fading looks linear
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void LED_breatheStep(uint8_t a_ledIndex)
+{
+	/* from 0 to 100 in the first half of the period and back to 0 in the second */
+	uint16_t level = ((uint32_t)g_breathePhases[a_ledIndex] * 200) / g_breathePeriods[a_ledIndex];
+
+	if(level > 100)
+	{
+		level = 200 - level;
+	}
+
+#if LEDS_USED_COUNT == 1
+	LED_dim(level * level / 100);
+#else
+	LED_dim(a_ledIndex, level * level / 100);
+#endif /* LEDS_USED_COUNT == 1 */
+}
+
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+/*
+ * [Function Name]: LED_setEffect
+ * [Function Description]: adds a led to the active leds if it has no effect, or stops
+ * 						   its pwm if it's breathing, then sets its effect.
+ * 						   It must be called with global interrupts disabled
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint8_t a_effect
+ * 		 LED_EFFECT_PATTERN or LED_EFFECT_BREATHE
+ * [Return]: void
+ */
+static void LED_setEffect(uint8_t a_ledIndex, uint8_t a_effect)
+{
+	if(g_ledsEffects[a_ledIndex] == LED_EFFECT_NONE)
+	{
+		g_activeLeds[g_activeLedsCount] = a_ledIndex;
+		g_activeLedsCount ++;
+	}
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+	else if(g_ledsEffects[a_ledIndex] == LED_EFFECT_BREATHE && a_effect != LED_EFFECT_BREATHE)
+	{
+		PWM_disable(LED_PIN_OF(a_ledIndex));
+	}
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+	g_ledsEffects[a_ledIndex] = a_effect;
+}
+
+/*
+ * [Function Name]: LED_stopEffectIndex
+ * [Function Description]: stops the effect of a led and turns it off
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void LED_stopEffectIndex(uint8_t a_ledIndex)
+{
+	uint8_t loopCounter;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	if(g_ledsEffects[a_ledIndex] != LED_EFFECT_NONE)
+	{
+		/* the last active led takes the place of the stopped one */
+		for(loopCounter = 0; loopCounter < g_activeLedsCount; loopCounter ++)
+		{
+			if(g_activeLeds[loopCounter] == a_ledIndex)
+			{
+				g_activeLedsCount --;
+				g_activeLeds[loopCounter] = g_activeLeds[g_activeLedsCount];
+				break;
+			}
+		}
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+		if(g_ledsEffects[a_ledIndex] == LED_EFFECT_BREATHE)
+		{
+			PWM_disable(LED_PIN_OF(a_ledIndex));
+		}
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+		g_ledsEffects[a_ledIndex] = LED_EFFECT_NONE;
+		LED_write(a_ledIndex, LED_OFF);
+	}
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: LED_showStep
+ * [Function Description]: shows the current step of the pattern of a led, the pin
+ * 						   is written only if the state changes
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [Return]: void
+ */
+static void LED_showStep(uint8_t a_ledIndex)
+{
+	uint8_t state = (g_remainingBits[a_ledIndex] & LED_PATTERN_STEP_MASK) ? LED_ON : LED_OFF;
+
+	g_remainingBits[a_ledIndex] <<= 1;
+
+	if(state != g_ledsStates[a_ledIndex])
+	{
+		g_ledsStates[a_ledIndex] = state;
+		LED_write(a_ledIndex, state);
+	}
+}
+
+/*
+ * [Function Name]: LED_write
+ * [Function Description]: turns a led on or off
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, 0 if LEDS_USED_COUNT = 1
+ * [in]: uint8_t a_state
+ * 		 LED_ON or LED_OFF
+ * [Return]: void
+ */
+static void LED_write(uint8_t a_ledIndex, uint8_t a_state)
+{
+#if LEDS_USED_COUNT == 1
+	if(a_state == LED_ON)
+	{
+		LED_on();
+	}
+	else
+	{
+		LED_off();
+	}
+#else
+	if(a_state == LED_ON)
+	{
+		LED_on(a_ledIndex);
+	}
+	else
+	{
+		LED_off(a_ledIndex);
+	}
+#endif /* LEDS_USED_COUNT == 1 */
+}
+
+#endif /* LED_EFFECTS_ENABLED == 1 */
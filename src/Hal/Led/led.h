@@ -34,6 +34,17 @@
 #define LED_ON			 			 1
 #define LED_OFF			 			 0
 
+#if LED_EFFECTS_ENABLED == 1
+
+/* results of the effects functions */
+#define LED_SUCCESS			 		 1
+#define LED_ERROR			 		 0
+
+/* max steps in a pattern, one bit for each step */
+#define LED_PATTERN_MAX_STEPS		 32
+
+#endif /* LED_EFFECTS_ENABLED == 1 */
+
 /*******************************************************************************
  *                             Types Declaration                               *
  *******************************************************************************/
@@ -65,6 +76,28 @@ typedef struct
 
 #endif /* LEDS_USED_COUNT != 1 */
 
+#if LED_EFFECTS_ENABLED == 1
+
+/*
+ * [Struct Name]: ST_LedPattern
+ * [Struct Description]: contains a pattern of led states repeated till it's stopped,
+ * 						 patterns are declared with FLASH_CONST so they are stored in flash
+ */
+typedef struct
+{
+	/* state of the led in each step, 1 for on, the first step is the msb */
+	uint32_t bits;
+
+	/* number of steps, from 1 to LED_PATTERN_MAX_STEPS */
+	uint8_t stepsCount;
+
+	/* duration of each step in ms, rounded to LED_EFFECTS_TICK_MS */
+	uint16_t stepMs;
+
+}ST_LedPattern;
+
+#endif /* LED_EFFECTS_ENABLED == 1 */
+
 /*******************************************************************************
  *                           Function Prototypes                               *
  *******************************************************************************/
@@ -211,4 +244,195 @@ void LED_dim(uint8_t a_ledIndex, uint8_t a_brightness);
 
 #endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
 
+/************** LED effects ****************/
+
+#if LED_EFFECTS_ENABLED == 1
+
+#if LEDS_USED_COUNT == 1
+
+/*
+ * [Function Name]: LED_playPattern
+ * [Function Description]: repeats a pattern on the led till the effect is stopped, the
+ * 						   first step is shown directly. LED_on(), LED_off(), LED_toggle()
+ * 						   and LED_dim() can't be used till LED_stopEffect() is called
+ * [Args]:
+ * [in]: FLASH_CONST ST_LedPattern * a_pattern
+ * 		 pattern to repeat
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the pattern steps count is invalid
+ */
+uint8_t LED_playPattern(FLASH_CONST ST_LedPattern * a_pattern);
+
+/*
+ * [Function Name]: LED_blink
+ * [Function Description]: blinks the led till the effect is stopped, same as LED_playPattern()
+ * [Args]:
+ * [in]: uint16_t a_periodMs
+ * 		 period of a blink in ms, at least LED_EFFECTS_TICK_MS
+ * [in]: uint8_t a_dutyPercent
+ * 		 percentage of the period the led is on (from 0 to 100)
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period or the duty is invalid
+ */
+uint8_t LED_blink(uint16_t a_periodMs, uint8_t a_dutyPercent);
+
+/*
+ * [Function Name]: LED_blinkCode
+ * [Function Description]: blinks the led a number of times then pauses, repeated till the
+ * 						   effect is stopped, i.e. to show error codes. Same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_count
+ * 		 number of blinks, at least 1
+ * [in]: uint16_t a_blinkMs
+ * 		 on time and off time of each blink in ms
+ * [in]: uint16_t a_pauseMs
+ * 		 time after the blinks in ms, the blinks and the pause must fit in
+ * 		 LED_PATTERN_MAX_STEPS steps of a_blinkMs
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if they don't fit in a pattern
+ */
+uint8_t LED_blinkCode(uint8_t a_count, uint16_t a_blinkMs, uint16_t a_pauseMs);
+
+/*
+ * [Function Name]: LED_heartbeat
+ * [Function Description]: blinks the led twice every second till the effect is stopped,
+ * 						   same as LED_playPattern()
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void LED_heartbeat(void);
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+
+/*
+ * [Function Name]: LED_breathe
+ * [Function Description]: fades the led in and out with LED_dim() every tick till the effect
+ * 						   is stopped. The led pin must be PWM0, PWM1A, PWM1B or PWM2
+ * [Args]:
+ * [in]: uint16_t a_periodMs
+ * 		 period of a breath in ms, at least 2 * LED_EFFECTS_TICK_MS
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period is too short or the pin doesn't support pwm
+ */
+uint8_t LED_breathe(uint16_t a_periodMs);
+
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+/*
+ * [Function Name]: LED_stopEffect
+ * [Function Description]: stops the effect of the led and turns it off
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void LED_stopEffect(void);
+
+#else
+
+/*
+ * [Function Name]: LED_playPattern
+ * [Function Description]: repeats a pattern on the led till the effect is stopped, the
+ * 						   first step is shown directly. LED_on(), LED_off(), LED_toggle()
+ * 						   and LED_dim() can't be used till LED_stopEffect() is called
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [in]: FLASH_CONST ST_LedPattern * a_pattern
+ * 		 pattern to repeat
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the pattern steps count or the index is invalid
+ */
+uint8_t LED_playPattern(uint8_t a_ledIndex, FLASH_CONST ST_LedPattern * a_pattern);
+
+/*
+ * [Function Name]: LED_blink
+ * [Function Description]: blinks the led till the effect is stopped, same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [in]: uint16_t a_periodMs
+ * 		 period of a blink in ms, at least LED_EFFECTS_TICK_MS
+ * [in]: uint8_t a_dutyPercent
+ * 		 percentage of the period the led is on (from 0 to 100)
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period, the duty or the index is invalid
+ */
+uint8_t LED_blink(uint8_t a_ledIndex, uint16_t a_periodMs, uint8_t a_dutyPercent);
+
+/*
+ * [Function Name]: LED_blinkCode
+ * [Function Description]: blinks the led a number of times then pauses, repeated till the
+ * 						   effect is stopped, i.e. to show error codes. Same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [in]: uint8_t a_count
+ * 		 number of blinks, at least 1
+ * [in]: uint16_t a_blinkMs
+ * 		 on time and off time of each blink in ms
+ * [in]: uint16_t a_pauseMs
+ * 		 time after the blinks in ms, the blinks and the pause must fit in
+ * 		 LED_PATTERN_MAX_STEPS steps of a_blinkMs
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if they don't fit in a pattern or the index is invalid
+ */
+uint8_t LED_blinkCode(uint8_t a_ledIndex, uint8_t a_count, uint16_t a_blinkMs, uint16_t a_pauseMs);
+
+/*
+ * [Function Name]: LED_heartbeat
+ * [Function Description]: blinks the led twice every second till the effect is stopped,
+ * 						   same as LED_playPattern()
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [Return]: void
+ */
+void LED_heartbeat(uint8_t a_ledIndex);
+
+#if PWM_FOR_DIMMING_SUPPORTED == 1
+
+/*
+ * [Function Name]: LED_breathe
+ * [Function Description]: fades the led in and out with LED_dim() every tick till the effect
+ * 						   is stopped. The led pin must be PWM0, PWM1A, PWM1B or PWM2
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [in]: uint16_t a_periodMs
+ * 		 period of a breath in ms, at least 2 * LED_EFFECTS_TICK_MS
+ * [Return]: uint8_t
+ * 			 LED_SUCCESS or LED_ERROR if the period is too short, the pin doesn't
+ * 			 support pwm or the index is invalid
+ */
+uint8_t LED_breathe(uint8_t a_ledIndex, uint16_t a_periodMs);
+
+#endif /* PWM_FOR_DIMMING_SUPPORTED == 1 */
+
+/*
+ * [Function Name]: LED_stopEffect
+ * [Function Description]: stops the effect of the led and turns it off
+ * [Args]:
+ * [in]: uint8_t a_ledIndex
+ * 		 led index, same index used in initializing the leds array
+ * [Return]: void
+ */
+void LED_stopEffect(uint8_t a_ledIndex);
+
+#endif /* LEDS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: LED_effectsTick
+ * [Function Description]: advances the effects of the leds, it must be called every
+ * 						   LED_EFFECTS_TICK_MS, i.e. from a scheduler task or a timer handler.
+ * 						   Only the leds running effects are visited, and the patterns pins
+ * 						   are written only when their state changes
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void LED_effectsTick(void);
+
+#endif /* LED_EFFECTS_ENABLED == 1 */
+
 #endif /* __LED_H__ */
@@ -0,0 +1,66 @@
+/******************************************************************************
+ *
+ * Module: NOR FLASH
+ *
+ * File Name: nor-flash-config.h
+ *
+ * Description: Config file for the SPI NOR FLASH (25 series) driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __NOR_FLASH_CONFIG_H__
+#define __NOR_FLASH_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* the chip select pin of the flash */
+#define NOR_FLASH_CS_PIN							PB4
+
+/* spi clock of the flash, one of EN_SpiClockRate */
+#define NOR_FLASH_CLOCK_RATE						SPI_CLOCK_2
+
+/* page program size and the smallest erasable sector size of the flash */
+#define NOR_FLASH_PAGE_SIZE							256UL
+#define NOR_FLASH_SECTOR_SIZE						4096UL
+
+/* the region used by the append only log, both must be multiples
+ * of NOR_FLASH_SECTOR_SIZE
+ */
+#define NOR_FLASH_LOG_START_ADDRESS					0x000000UL
+#define NOR_FLASH_LOG_SIZE							0x010000UL
+
+/* while a program or an erase runs, the status register is read once each
+ * NOR_FLASH_pollTick() call. If NOR_FLASH_POLL_TIMER_ENABLED = 1, it's called
+ * periodically from a timer interrupt, otherwise the application must call it
+ * periodically, for example from a scheduler task, or the programs, erases and
+ * log appends never end. It's disabled by default as TIMER_0 is the scheduler timer
+ */
+#define NOR_FLASH_POLL_TIMER_ENABLED				0
+
+#if NOR_FLASH_POLL_TIMER_ENABLED == 1
+
+/* the timer used for the polls, its mode and prescaler, see timer.h */
+#define NOR_FLASH_POLL_TIMER						TIMER_0
+#define NOR_FLASH_POLL_TIMER_MODE					TIMER_0_CTC
+#define NOR_FLASH_POLL_TIMER_PRESCALER				TIMER_0_PRESCALER_64
+
+/* the division value of NOR_FLASH_POLL_TIMER_PRESCALER */
+#define NOR_FLASH_POLL_PRESCALER_VALUE				64
+
+/* the poll period in ms, a page program takes about 1 ms and
+ * a sector erase tens of ms
+ */
+#define NOR_FLASH_POLL_PERIOD_MS					1
+
+#endif /* NOR_FLASH_POLL_TIMER_ENABLED == 1 */
+
+/* making sure F_CPU is defined */
+#ifndef F_CPU
+#define F_CPU										1000000UL
+#endif /* F_CPU */
+
+#endif /* __NOR_FLASH_CONFIG_H__ */
@@ -0,0 +1,935 @@
+/******************************************************************************
+ *
+ * Module: NOR FLASH
+ *
+ * File Name: nor-flash.c
+ *
+ * Description: Source file for the SPI NOR FLASH (25 series) driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "nor-flash.h"
+
+/* For using the spi transactions queue */
+#include "../../Mcal/Spi/spi.h"
+
+#if NOR_FLASH_POLL_TIMER_ENABLED == 1
+
+/* For using the poll timer */
+#include "../../Mcal/Timer/timer.h"
+
+#endif /* NOR_FLASH_POLL_TIMER_ENABLED == 1 */
+
+#if SPI_TRANSACTION_QUEUE_ENABLED == 0
+#error "NOR FLASH driver requires SPI_TRANSACTION_QUEUE_ENABLED = 1"
+#endif
+
+/* a page program queues 4 transactions at once */
+#if SPI_TRANSACTION_QUEUE_SIZE < 8
+#error "NOR FLASH driver requires SPI_TRANSACTION_QUEUE_SIZE >= 8"
+#endif
+
+#if (NOR_FLASH_LOG_START_ADDRESS % NOR_FLASH_SECTOR_SIZE) != 0 || (NOR_FLASH_LOG_SIZE % NOR_FLASH_SECTOR_SIZE) != 0 \
+	|| NOR_FLASH_LOG_SIZE == 0
+#error "NOR_FLASH_LOG_START_ADDRESS and NOR_FLASH_LOG_SIZE must be multiples of NOR_FLASH_SECTOR_SIZE"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* flash commands */
+#define NOR_FLASH_CMD_WRITE_ENABLE					0x06
+#define NOR_FLASH_CMD_READ_STATUS					0x05
+#define NOR_FLASH_CMD_FAST_READ						0x0B
+#define NOR_FLASH_CMD_PAGE_PROGRAM					0x02
+#define NOR_FLASH_CMD_SECTOR_ERASE					0x20
+#define NOR_FLASH_CMD_JEDEC_ID						0x9F
+
+/* write in progress bit of the status register */
+#define NOR_FLASH_STATUS_WIP						0
+
+/* command byte + 3 address bytes */
+#define NOR_FLASH_COMMAND_LENGTH					4
+
+/* the fast read needs a dummy byte after the address */
+#define NOR_FLASH_FAST_READ_COMMAND_LENGTH			5
+
+/* the log end address */
+#define NOR_FLASH_LOG_END_ADDRESS					(NOR_FLASH_LOG_START_ADDRESS + NOR_FLASH_LOG_SIZE)
+
+/* the log pages are checked in chunks of this size, so no page sized buffer is needed */
+#define NOR_FLASH_LOG_SCAN_CHUNK_SIZE				16
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* the flash settings, applied by the spi queue before each transaction */
+static const ST_SpiDevice g_device = {
+		NOR_FLASH_CS_PIN,
+		SPI_CLOCK_NOT_INVERTED_LEADING_EDGE,
+		NOR_FLASH_CLOCK_RATE,
+		SPI_MSB_FIRST
+};
+
+static const uint8_t g_writeEnableCommand[1] = {NOR_FLASH_CMD_WRITE_ENABLE};
+
+static const uint8_t g_readStatusCommand[2] = {NOR_FLASH_CMD_READ_STATUS, SPI_DEFAULT_DATA_VALUE};
+
+static const uint8_t g_jedecIdCommand[4] = {NOR_FLASH_CMD_JEDEC_ID, SPI_DEFAULT_DATA_VALUE, SPI_DEFAULT_DATA_VALUE, SPI_DEFAULT_DATA_VALUE};
+
+/* command and address bytes of the running operation */
+static uint8_t g_commandBuffer[NOR_FLASH_FAST_READ_COMMAND_LENGTH];
+
+/* received bytes of the status and JEDEC id commands */
+static uint8_t g_responseBuffer[4];
+
+/* transactions of the running operation, queued back to back */
+static ST_SpiTransaction g_writeEnableTransaction;
+static ST_SpiTransaction g_commandTransaction;
+static ST_SpiTransaction g_dataTransaction;
+static ST_SpiTransaction g_statusTransaction;
+
+/* TRUE when the flash was busy at the last status read and the next
+ * read waits for NOR_FLASH_pollTick() */
+static volatile uint8_t g_isPollPending = FALSE;
+
+/* TRUE while an operation is running */
+static volatile uint8_t g_isBusy = FALSE;
+
+/* result of the last operation */
+static volatile uint8_t g_result = NOR_FLASH_SUCCESS;
+
+/* called when the running operation is done */
+static void (* volatile g_callBack)(uint8_t a_result) = NULL;
+
+/* address where the next log data is written */
+static volatile uint32_t g_logAddress = NOR_FLASH_LOG_START_ADDRESS;
+
+/* the log sectors before this address are erased and ready */
+static uint32_t g_logErasedAddress = NOR_FLASH_LOG_START_ADDRESS;
+
+/* remaining data of the running append */
+static const uint8_t * g_logData = NULL;
+static uint16_t g_logRemaining = 0;
+
+/* bytes programmed by the running append step, 0 if it's an erase */
+static uint16_t g_logStepLength = 0;
+
+/* called when the running append is done */
+static void (* volatile g_logCallBack)(uint8_t a_result) = NULL;
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: NOR_FLASH_setCommand
+ * [Function Description]: fills the command buffer with a command and a 24 bit address
+ * [Args]:
+ * [in]: uint8_t a_command
+ * 		 the command
+ * [in]: uint32_t a_address
+ * 		 the address
+ * [Return]: void
+ */
+static void NOR_FLASH_setCommand(uint8_t a_command, uint32_t a_address);
+
+/*
+ * [Function Name]: NOR_FLASH_startProgram
+ * [Function Description]: queues write enable, program command, data and the first
+ * 						   status read together
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 address to program
+ * [in]: const uint8_t * a_data
+ * 		 data to program
+ * [in]: uint16_t a_length
+ * 		 number of bytes
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS or NOR_FLASH_BUSY if the spi queue has no place
+ */
+static uint8_t NOR_FLASH_startProgram(uint32_t a_address, const uint8_t * a_data, uint16_t a_length);
+
+/*
+ * [Function Name]: NOR_FLASH_startErase
+ * [Function Description]: queues write enable, erase command and the first
+ * 						   status read together
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 any address in the sector
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS or NOR_FLASH_BUSY if the spi queue has no place
+ */
+static uint8_t NOR_FLASH_startErase(uint32_t a_address);
+
+/*
+ * [Function Name]: NOR_FLASH_statusProcessing
+ * [Function Description]: callback of the status read, leaves the next read to
+ * 						   NOR_FLASH_pollTick() while the flash is busy, otherwise
+ * 						   ends the operation
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void NOR_FLASH_statusProcessing(void);
+
+/*
+ * [Function Name]: NOR_FLASH_readDone
+ * [Function Description]: callback of the read data transaction
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void NOR_FLASH_readDone(void);
+
+/*
+ * [Function Name]: NOR_FLASH_operationDone
+ * [Function Description]: ends the running operation and calls its callback
+ * [Args]:
+ * [in]: uint8_t a_result
+ * 		 NOR_FLASH_SUCCESS or NOR_FLASH_ERROR
+ * [Return]: void
+ */
+static void NOR_FLASH_operationDone(uint8_t a_result);
+
+/*
+ * [Function Name]: NOR_FLASH_waitOperation
+ * [Function Description]: waits till the running operation is done, the status
+ * 						   is polled from here so it doesn't wait for the poll tick
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 result of the operation
+ */
+static uint8_t NOR_FLASH_waitOperation(void);
+
+/*
+ * [Function Name]: NOR_FLASH_isPageErased
+ * [Function Description]: checks if all the bytes of a page are 0xFF, waits till done
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 address of the page
+ * [Return]: uint8_t
+ * 			 TRUE if erased, FALSE otherwise
+ */
+static uint8_t NOR_FLASH_isPageErased(uint32_t a_address);
+
+/*
+ * [Function Name]: NOR_FLASH_logNextStep
+ * [Function Description]: erases the next sector if the log reached it, otherwise
+ * 						   programs the next chunk of the append till the page end
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS or NOR_FLASH_BUSY if the spi queue has no place
+ */
+static uint8_t NOR_FLASH_logNextStep(void);
+
+/*
+ * [Function Name]: NOR_FLASH_logStepDone
+ * [Function Description]: callback of each append step, starts the next step
+ * 						   or ends the append
+ * [Args]:
+ * [in]: uint8_t a_result
+ * 		 result of the step
+ * [Return]: void
+ */
+static void NOR_FLASH_logStepDone(uint8_t a_result);
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: NOR_FLASH_init
+ * [Function Description]: initializes the spi as master and the flash chip select,
+ * 						   the flash settings are applied before each transaction
+ * 						   so the bus can be shared with other spi devices
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void NOR_FLASH_init(void)
+{
+	ST_SpiMasterConfig spiConfig = {
+			SPI_MSB_FIRST,
+			SPI_CLOCK_NOT_INVERTED_LEADING_EDGE,
+			SPI_INTERRUPT_ENABLED,
+			NOR_FLASH_CLOCK_RATE
+	};
+
+#if NOR_FLASH_POLL_TIMER_ENABLED == 1
+	TIMER_config timerConfig = {
+			NOR_FLASH_POLL_TIMER,
+			NOR_FLASH_POLL_TIMER_MODE,
+			NOR_FLASH_POLL_TIMER_PRESCALER,
+			TIME_MS_TO_TICKS(NOR_FLASH_POLL_PRESCALER_VALUE, NOR_FLASH_POLL_PERIOD_MS),
+			NOR_FLASH_pollTick
+	};
+#endif /* NOR_FLASH_POLL_TIMER_ENABLED == 1 */
+
+	SPI_initMaster(&spiConfig);
+	SPI_initDevice(&g_device);
+
+	g_writeEnableTransaction.device = &g_device;
+	g_writeEnableTransaction.txData = g_writeEnableCommand;
+	g_writeEnableTransaction.rxData = NULL;
+	g_writeEnableTransaction.length = 1;
+	g_writeEnableTransaction.holdChipSelect = FALSE;
+	g_writeEnableTransaction.callBack = NULL;
+
+	g_commandTransaction.device = &g_device;
+	g_commandTransaction.txData = g_commandBuffer;
+	g_commandTransaction.rxData = NULL;
+
+	g_dataTransaction.device = &g_device;
+	g_dataTransaction.holdChipSelect = FALSE;
+
+	g_statusTransaction.device = &g_device;
+	g_statusTransaction.txData = g_readStatusCommand;
+	g_statusTransaction.rxData = g_responseBuffer;
+	g_statusTransaction.length = 2;
+	g_statusTransaction.holdChipSelect = FALSE;
+	g_statusTransaction.callBack = NOR_FLASH_statusProcessing;
+
+	g_isBusy = FALSE;
+	g_isPollPending = FALSE;
+
+#if NOR_FLASH_POLL_TIMER_ENABLED == 1
+	TIMER_init(&timerConfig);
+	TIMER_start(NOR_FLASH_POLL_TIMER);
+#endif /* NOR_FLASH_POLL_TIMER_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: NOR_FLASH_readJedecId
+ * [Function Description]: reads the JEDEC id of the flash, waits till it's read
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 manufacturer id << 16 | memory type << 8 | capacity,
+ * 			 or 0 if an operation is running
+ */
+uint32_t NOR_FLASH_readJedecId(void)
+{
+	if(g_isBusy == TRUE)
+	{
+		return 0;
+	}
+
+	g_isBusy = TRUE;
+	g_callBack = NULL;
+
+	g_commandTransaction.txData = g_jedecIdCommand;
+	g_commandTransaction.rxData = g_responseBuffer;
+	g_commandTransaction.length = 4;
+	g_commandTransaction.holdChipSelect = FALSE;
+	g_commandTransaction.callBack = NOR_FLASH_readDone;
+
+	if(SPI_queueTransaction(&g_commandTransaction) == SPI_TRANSACTION_QUEUE_FULL)
+	{
+		g_commandTransaction.txData = g_commandBuffer;
+		g_commandTransaction.rxData = NULL;
+		g_isBusy = FALSE;
+		return 0;
+	}
+
+	NOR_FLASH_waitOperation();
+
+	g_commandTransaction.txData = g_commandBuffer;
+	g_commandTransaction.rxData = NULL;
+
+	return ((uint32_t)g_responseBuffer[1] << 16) | ((uint32_t)g_responseBuffer[2] << 8) | g_responseBuffer[3];
+}
+
+/*
+ * [Function Name]: NOR_FLASH_read
+ * [Function Description]: starts a fast read of a block of any length from any address,
+ * 						   the data is streamed directly into the buffer by the spi
+ * 						   interrupt and the callback is called when it's done
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 address to read from
+ * [out]: uint8_t * a_buffer
+ * 		  array to store the data in, it must stay valid till the callback
+ * [in]: uint16_t a_length
+ * 		 number of bytes to read, greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_result)
+ * 		 function called from the spi interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS if started, NOR_FLASH_BUSY or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_read(uint32_t a_address, uint8_t * a_buffer, uint16_t a_length, void (* volatile a_ptrToCallback)(uint8_t a_result))
+{
+	uint8_t sreg;
+
+	if(a_buffer == NULL || a_length == 0)
+	{
+		return NOR_FLASH_ERROR;
+	}
+	if(g_isBusy == TRUE)
+	{
+		return NOR_FLASH_BUSY;
+	}
+
+	NOR_FLASH_setCommand(NOR_FLASH_CMD_FAST_READ, a_address);
+	g_commandBuffer[4] = SPI_DEFAULT_DATA_VALUE;
+	g_commandTransaction.length = NOR_FLASH_FAST_READ_COMMAND_LENGTH;
+	g_commandTransaction.holdChipSelect = TRUE;
+	g_commandTransaction.callBack = NULL;
+
+	g_dataTransaction.txData = NULL;
+	g_dataTransaction.rxData = a_buffer;
+	g_dataTransaction.length = a_length;
+	g_dataTransaction.callBack = NOR_FLASH_readDone;
+
+	/* both transactions are queued together, so nothing runs between them */
+	ENTER_CRITICAL_SECTION(sreg);
+	if(SPI_getFreeTransactionsCount() < 2)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return NOR_FLASH_BUSY;
+	}
+
+	g_isBusy = TRUE;
+	g_callBack = a_ptrToCallback;
+	SPI_queueTransaction(&g_commandTransaction);
+	SPI_queueTransaction(&g_dataTransaction);
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return NOR_FLASH_SUCCESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_programPage
+ * [Function Description]: starts programming data within one page, the status register
+ * 						   is polled by NOR_FLASH_pollTick() till the program ends, then
+ * 						   the callback is called. The bytes must be erased before
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 address to program
+ * [in]: const uint8_t * a_data
+ * 		 data to program, it must stay valid till the callback
+ * [in]: uint16_t a_length
+ * 		 number of bytes, greater than 0 and not crossing a page boundary
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_result)
+ * 		 function called from the spi interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS if started, NOR_FLASH_BUSY or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_programPage(uint32_t a_address, const uint8_t * a_data, uint16_t a_length, void (* volatile a_ptrToCallback)(uint8_t a_result))
+{
+	/* the flash wraps to the page start instead of crossing the boundary */
+	if(a_data == NULL || a_length == 0 || (a_address % NOR_FLASH_PAGE_SIZE) + a_length > NOR_FLASH_PAGE_SIZE)
+	{
+		return NOR_FLASH_ERROR;
+	}
+	if(g_isBusy == TRUE)
+	{
+		return NOR_FLASH_BUSY;
+	}
+
+	g_isBusy = TRUE;
+	g_callBack = a_ptrToCallback;
+
+	if(NOR_FLASH_startProgram(a_address, a_data, a_length) == NOR_FLASH_BUSY)
+	{
+		g_isBusy = FALSE;
+		return NOR_FLASH_BUSY;
+	}
+
+	return NOR_FLASH_SUCCESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_eraseSector
+ * [Function Description]: starts erasing the sector containing the address, the status
+ * 						   register is polled by NOR_FLASH_pollTick() till the erase ends,
+ * 						   then the callback is called
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 any address in the sector
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_result)
+ * 		 function called from the spi interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS if started, NOR_FLASH_BUSY or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_eraseSector(uint32_t a_address, void (* volatile a_ptrToCallback)(uint8_t a_result))
+{
+	if(g_isBusy == TRUE)
+	{
+		return NOR_FLASH_BUSY;
+	}
+
+	g_isBusy = TRUE;
+	g_callBack = a_ptrToCallback;
+
+	if(NOR_FLASH_startErase(a_address) == NOR_FLASH_BUSY)
+	{
+		g_isBusy = FALSE;
+		return NOR_FLASH_BUSY;
+	}
+
+	return NOR_FLASH_SUCCESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_isBusy
+ * [Function Description]: checks if an operation is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t NOR_FLASH_isBusy(void)
+{
+	return g_isBusy;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_pollTick
+ * [Function Description]: reads the status register again if the running program or
+ * 						   erase is still in progress, it's called periodically from
+ * 						   the poll timer if NOR_FLASH_POLL_TIMER_ENABLED = 1, otherwise
+ * 						   it must be called periodically by the application
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void NOR_FLASH_pollTick(void)
+{
+	uint8_t sreg;
+
+	/* the read can't end before the flag is cleared, and if the spi queue
+	 * is full the poll stays pending for the next tick */
+	ENTER_CRITICAL_SECTION(sreg);
+	if(g_isPollPending == TRUE && SPI_queueTransaction(&g_statusTransaction) == SPI_TRANSACTION_QUEUED)
+	{
+		g_isPollPending = FALSE;
+	}
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: NOR_FLASH_logInit
+ * [Function Description]: finds the end of the log to resume appending after a reset,
+ * 						   the log continues from the first unused page, so the rest
+ * 						   of a partially written page is skipped. Waits till done
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS or NOR_FLASH_BUSY
+ */
+uint8_t NOR_FLASH_logInit(void)
+{
+	uint16_t firstPage = 0;
+	uint16_t lastPage = NOR_FLASH_LOG_SIZE / NOR_FLASH_PAGE_SIZE;
+	uint16_t middlePage;
+
+	if(g_isBusy == TRUE)
+	{
+		return NOR_FLASH_BUSY;
+	}
+
+	/* the log is written in order, so the used pages are followed only by
+	 * erased ones and the first erased page is found by a binary search */
+	while(firstPage < lastPage)
+	{
+		middlePage = firstPage + (lastPage - firstPage) / 2;
+		if(NOR_FLASH_isPageErased(NOR_FLASH_LOG_START_ADDRESS + (uint32_t)middlePage * NOR_FLASH_PAGE_SIZE) == TRUE)
+		{
+			lastPage = middlePage;
+		}
+		else
+		{
+			firstPage = middlePage + 1;
+		}
+	}
+
+	g_logAddress = NOR_FLASH_LOG_START_ADDRESS + (uint32_t)firstPage * NOR_FLASH_PAGE_SIZE;
+
+	/* the sector of the log end is erased, a sector start is erased again before use */
+	g_logErasedAddress = (g_logAddress + NOR_FLASH_SECTOR_SIZE - 1) / NOR_FLASH_SECTOR_SIZE * NOR_FLASH_SECTOR_SIZE;
+
+	return NOR_FLASH_SUCCESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_logAppend
+ * [Function Description]: starts appending data to the log, it's split at the page
+ * 						   boundaries and each sector is erased when the log enters it
+ * [Args]:
+ * [in]: const uint8_t * a_data
+ * 		 data to append, it must stay valid till the callback
+ * [in]: uint16_t a_length
+ * 		 number of bytes, greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_result)
+ * 		 function called from the spi interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS if started, NOR_FLASH_BUSY, NOR_FLASH_LOG_FULL
+ * 			 or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_logAppend(const uint8_t * a_data, uint16_t a_length, void (* volatile a_ptrToCallback)(uint8_t a_result))
+{
+	if(a_data == NULL || a_length == 0)
+	{
+		return NOR_FLASH_ERROR;
+	}
+	if(g_isBusy == TRUE)
+	{
+		return NOR_FLASH_BUSY;
+	}
+	if(g_logAddress + a_length > NOR_FLASH_LOG_END_ADDRESS)
+	{
+		return NOR_FLASH_LOG_FULL;
+	}
+
+	g_isBusy = TRUE;
+	g_callBack = NOR_FLASH_logStepDone;
+	g_logCallBack = a_ptrToCallback;
+	g_logData = a_data;
+	g_logRemaining = a_length;
+
+	if(NOR_FLASH_logNextStep() == NOR_FLASH_BUSY)
+	{
+		g_isBusy = FALSE;
+		return NOR_FLASH_BUSY;
+	}
+
+	return NOR_FLASH_SUCCESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_logGetSize
+ * [Function Description]: returns the number of bytes from the log start to its end,
+ * 						   including the skipped bytes of resumed pages
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 used size of the log
+ */
+uint32_t NOR_FLASH_logGetSize(void)
+{
+	uint32_t logAddress;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	logAddress = g_logAddress;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return logAddress - NOR_FLASH_LOG_START_ADDRESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_logClear
+ * [Function Description]: erases all the log sectors and starts the log from the
+ * 						   beginning, waits till done
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS, NOR_FLASH_BUSY or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_logClear(void)
+{
+	uint32_t address;
+	uint8_t result;
+
+	for(address = NOR_FLASH_LOG_START_ADDRESS; address < NOR_FLASH_LOG_END_ADDRESS; address += NOR_FLASH_SECTOR_SIZE)
+	{
+		result = NOR_FLASH_eraseSector(address, NULL);
+		if(result != NOR_FLASH_SUCCESS)
+		{
+			return result;
+		}
+		if(NOR_FLASH_waitOperation() != NOR_FLASH_SUCCESS)
+		{
+			return NOR_FLASH_ERROR;
+		}
+	}
+
+	g_logAddress = NOR_FLASH_LOG_START_ADDRESS;
+	g_logErasedAddress = NOR_FLASH_LOG_END_ADDRESS;
+
+	return NOR_FLASH_SUCCESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_setCommand
+ * [Function Description]: fills the command buffer with a command and a 24 bit address
+ * [Args]:
+ * [in]: uint8_t a_command
+ * 		 the command
+ * [in]: uint32_t a_address
+ * 		 the address
+ * [Return]: void
+ */
+static void NOR_FLASH_setCommand(uint8_t a_command, uint32_t a_address)
+{
+	g_commandBuffer[0] = a_command;
+	g_commandBuffer[1] = (uint8_t)(a_address >> 16);
+	g_commandBuffer[2] = (uint8_t)(a_address >> 8);
+	g_commandBuffer[3] = (uint8_t)a_address;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_startProgram
+ * [Function Description]: queues write enable, program command, data and the first
+ * 						   status read together
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 address to program
+ * [in]: const uint8_t * a_data
+ * 		 data to program
+ * [in]: uint16_t a_length
+ * 		 number of bytes
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS or NOR_FLASH_BUSY if the spi queue has no place
+ */
+static uint8_t NOR_FLASH_startProgram(uint32_t a_address, const uint8_t * a_data, uint16_t a_length)
+{
+	uint8_t sreg;
+
+	NOR_FLASH_setCommand(NOR_FLASH_CMD_PAGE_PROGRAM, a_address);
+	g_commandTransaction.length = NOR_FLASH_COMMAND_LENGTH;
+	g_commandTransaction.holdChipSelect = TRUE;
+	g_commandTransaction.callBack = NULL;
+
+	g_dataTransaction.txData = a_data;
+	g_dataTransaction.rxData = NULL;
+	g_dataTransaction.length = a_length;
+	g_dataTransaction.callBack = NULL;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	if(SPI_getFreeTransactionsCount() < 4)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return NOR_FLASH_BUSY;
+	}
+
+	SPI_queueTransaction(&g_writeEnableTransaction);
+	SPI_queueTransaction(&g_commandTransaction);
+	SPI_queueTransaction(&g_dataTransaction);
+	SPI_queueTransaction(&g_statusTransaction);
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return NOR_FLASH_SUCCESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_startErase
+ * [Function Description]: queues write enable, erase command and the first
+ * 						   status read together
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 any address in the sector
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS or NOR_FLASH_BUSY if the spi queue has no place
+ */
+static uint8_t NOR_FLASH_startErase(uint32_t a_address)
+{
+	uint8_t sreg;
+
+	NOR_FLASH_setCommand(NOR_FLASH_CMD_SECTOR_ERASE, a_address);
+	g_commandTransaction.length = NOR_FLASH_COMMAND_LENGTH;
+	g_commandTransaction.holdChipSelect = FALSE;
+	g_commandTransaction.callBack = NULL;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	if(SPI_getFreeTransactionsCount() < 3)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return NOR_FLASH_BUSY;
+	}
+
+	SPI_queueTransaction(&g_writeEnableTransaction);
+	SPI_queueTransaction(&g_commandTransaction);
+	SPI_queueTransaction(&g_statusTransaction);
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return NOR_FLASH_SUCCESS;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_statusProcessing
+ * [Function Description]: callback of the status read, leaves the next read to
+ * 						   NOR_FLASH_pollTick() while the flash is busy, otherwise
+ * 						   ends the operation
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void NOR_FLASH_statusProcessing(void)
+{
+	if(GET_BIT(g_responseBuffer[1], NOR_FLASH_STATUS_WIP) == 0)
+	{
+		NOR_FLASH_operationDone(NOR_FLASH_SUCCESS);
+	}
+	else
+	{
+		/* not queued again from here, or the bus would be kept busy
+		 * polling from the interrupt till the program or erase ends */
+		g_isPollPending = TRUE;
+	}
+}
+
+/*
+ * [Function Name]: NOR_FLASH_readDone
+ * [Function Description]: callback of the read data transaction
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void NOR_FLASH_readDone(void)
+{
+	NOR_FLASH_operationDone(NOR_FLASH_SUCCESS);
+}
+
+/*
+ * [Function Name]: NOR_FLASH_operationDone
+ * [Function Description]: ends the running operation and calls its callback
+ * [Args]:
+ * [in]: uint8_t a_result
+ * 		 NOR_FLASH_SUCCESS or NOR_FLASH_ERROR
+ * [Return]: void
+ */
+static void NOR_FLASH_operationDone(uint8_t a_result)
+{
+	g_result = a_result;
+
+	/* the callback may start another operation */
+	g_isBusy = FALSE;
+
+	if(g_callBack != NULL)
+	{
+		(*g_callBack)(a_result);
+	}
+}
+
+/*
+ * [Function Name]: NOR_FLASH_waitOperation
+ * [Function Description]: waits till the running operation is done, the status
+ * 						   is polled from here so it doesn't wait for the poll tick
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 result of the operation
+ */
+static uint8_t NOR_FLASH_waitOperation(void)
+{
+	while(g_isBusy == TRUE)
+	{
+		NOR_FLASH_pollTick();
+	}
+
+	return g_result;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_isPageErased
+ * [Function Description]: checks if all the bytes of a page are 0xFF, waits till done
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 address of the page
+ * [Return]: uint8_t
+ * 			 TRUE if erased, FALSE otherwise
+ */
+static uint8_t NOR_FLASH_isPageErased(uint32_t a_address)
+{
+	uint8_t chunk[NOR_FLASH_LOG_SCAN_CHUNK_SIZE];
+	uint16_t offset;
+	uint8_t i;
+
+	for(offset = 0; offset < NOR_FLASH_PAGE_SIZE; offset += NOR_FLASH_LOG_SCAN_CHUNK_SIZE)
+	{
+		/* waits for a place in the spi queue shared with the other devices */
+		while(NOR_FLASH_read(a_address + offset, chunk, NOR_FLASH_LOG_SCAN_CHUNK_SIZE, NULL) != NOR_FLASH_SUCCESS);
+		NOR_FLASH_waitOperation();
+
+		for(i = 0; i < NOR_FLASH_LOG_SCAN_CHUNK_SIZE; i++)
+		{
+			if(chunk[i] != 0xFF)
+			{
+				return FALSE;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+/*
+ * [Function Name]: NOR_FLASH_logNextStep
+ * [Function Description]: erases the next sector if the log reached it, otherwise
+ * 						   programs the next chunk of the append till the page end
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS or NOR_FLASH_BUSY if the spi queue has no place
+ */
+static uint8_t NOR_FLASH_logNextStep(void)
+{
+	uint16_t pageRemaining;
+
+	if(g_logAddress == g_logErasedAddress)
+	{
+		g_logStepLength = 0;
+		return NOR_FLASH_startErase(g_logAddress);
+	}
+
+	pageRemaining = NOR_FLASH_PAGE_SIZE - (g_logAddress % NOR_FLASH_PAGE_SIZE);
+	g_logStepLength = (g_logRemaining < pageRemaining) ? g_logRemaining : pageRemaining;
+
+	return NOR_FLASH_startProgram(g_logAddress, g_logData, g_logStepLength);
+}
+
+/*
+ * [Function Name]: NOR_FLASH_logStepDone
+ * [Function Description]: callback of each append step, starts the next step
+ * 						   or ends the append
+ * [Args]:
+ * [in]: uint8_t a_result
+ * 		 result of the step
+ * [Return]: void
+ */
+static void NOR_FLASH_logStepDone(uint8_t a_result)
+{
+	if(a_result == NOR_FLASH_SUCCESS)
+	{
+		if(g_logStepLength == 0)
+		{
+			g_logErasedAddress += NOR_FLASH_SECTOR_SIZE;
+		}
+		else
+		{
+			g_logAddress += g_logStepLength;
+			g_logData += g_logStepLength;
+			g_logRemaining -= g_logStepLength;
+		}
+
+		if(g_logRemaining > 0)
+		{
+			g_isBusy = TRUE;
+			if(NOR_FLASH_logNextStep() == NOR_FLASH_SUCCESS)
+			{
+				return;
+			}
+			g_isBusy = FALSE;
+			a_result = NOR_FLASH_ERROR;
+		}
+	}
+
+	g_result = a_result;
+	if(g_logCallBack != NULL)
+	{
+		(*g_logCallBack)(a_result);
+	}
+}
@@ -0,0 +1,197 @@
+/******************************************************************************
+ *
+ * Module: NOR FLASH
+ *
+ * File Name: nor-flash.h
+ *
+ * Description: Header file for the SPI NOR FLASH (25 series) driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __NOR_FLASH_H__
+#define __NOR_FLASH_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module config file */
+#include "nor-flash-config.h"
+
+/* for using std types */
+#include "../../Lib/types.h"
+
+/* For using common defines and macros */
+#include "../../Lib/common.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* results of the flash functions and operations */
+#define NOR_FLASH_SUCCESS							1
+#define NOR_FLASH_ERROR								0
+
+/* returned if an operation is running */
+#define NOR_FLASH_BUSY								2
+
+/* returned from NOR_FLASH_logAppend() if the data doesn't fit in the log */
+#define NOR_FLASH_LOG_FULL							3
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: NOR_FLASH_init
+ * [Function Description]: initializes the spi as master and the flash chip select,
+ * 						   the flash settings are applied before each transaction
+ * 						   so the bus can be shared with other spi devices
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void NOR_FLASH_init(void);
+
+/*
+ * [Function Name]: NOR_FLASH_readJedecId
+ * [Function Description]: reads the JEDEC id of the flash, waits till it's read
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 manufacturer id << 16 | memory type << 8 | capacity,
+ * 			 or 0 if an operation is running
+ */
+uint32_t NOR_FLASH_readJedecId(void);
+
+/*
+ * [Function Name]: NOR_FLASH_read
+ * [Function Description]: starts a fast read of a block of any length from any address,
+ * 						   the data is streamed directly into the buffer by the spi
+ * 						   interrupt and the callback is called when it's done
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 address to read from
+ * [out]: uint8_t * a_buffer
+ * 		  array to store the data in, it must stay valid till the callback
+ * [in]: uint16_t a_length
+ * 		 number of bytes to read, greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_result)
+ * 		 function called from the spi interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS if started, NOR_FLASH_BUSY or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_read(uint32_t a_address, uint8_t * a_buffer, uint16_t a_length, void (* volatile a_ptrToCallback)(uint8_t a_result));
+
+/*
+ * [Function Name]: NOR_FLASH_programPage
+ * [Function Description]: starts programming data within one page, the status register
+ * 						   is polled by NOR_FLASH_pollTick() till the program ends, then
+ * 						   the callback is called. The bytes must be erased before
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 address to program
+ * [in]: const uint8_t * a_data
+ * 		 data to program, it must stay valid till the callback
+ * [in]: uint16_t a_length
+ * 		 number of bytes, greater than 0 and not crossing a page boundary
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_result)
+ * 		 function called from the spi interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS if started, NOR_FLASH_BUSY or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_programPage(uint32_t a_address, const uint8_t * a_data, uint16_t a_length, void (* volatile a_ptrToCallback)(uint8_t a_result));
+
+/*
+ * [Function Name]: NOR_FLASH_eraseSector
+ * [Function Description]: starts erasing the sector containing the address, the status
+ * 						   register is polled by NOR_FLASH_pollTick() till the erase ends,
+ * 						   then the callback is called
+ * [Args]:
+ * [in]: uint32_t a_address
+ * 		 any address in the sector
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_result)
+ * 		 function called from the spi interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS if started, NOR_FLASH_BUSY or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_eraseSector(uint32_t a_address, void (* volatile a_ptrToCallback)(uint8_t a_result));
+
+/*
+ * [Function Name]: NOR_FLASH_isBusy
+ * [Function Description]: checks if an operation is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t NOR_FLASH_isBusy(void);
+
+/*
+ * [Function Name]: NOR_FLASH_pollTick
+ * [Function Description]: reads the status register again if the running program or
+ * 						   erase is still in progress, it's called periodically from
+ * 						   the poll timer if NOR_FLASH_POLL_TIMER_ENABLED = 1, otherwise
+ * 						   it must be called periodically by the application
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void NOR_FLASH_pollTick(void);
+
+/*
+ * [Function Name]: NOR_FLASH_logInit
+ * [Function Description]: finds the end of the log to resume appending after a reset,
+ * 						   the log continues from the first unused page, so the rest
+ * 						   of a partially written page is skipped. It blocks the caller
+ * 						   till all the pages of the search are read, so it must not
+ * 						   be called from an interrupt
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS or NOR_FLASH_BUSY
+ */
+uint8_t NOR_FLASH_logInit(void);
+
+/*
+ * [Function Name]: NOR_FLASH_logAppend
+ * [Function Description]: starts appending data to the log, it's split at the page
+ * 						   boundaries and each sector is erased when the log enters it
+ * [Args]:
+ * [in]: const uint8_t * a_data
+ * 		 data to append, it must stay valid till the callback
+ * [in]: uint16_t a_length
+ * 		 number of bytes, greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_result)
+ * 		 function called from the spi interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS if started, NOR_FLASH_BUSY, NOR_FLASH_LOG_FULL
+ * 			 or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_logAppend(const uint8_t * a_data, uint16_t a_length, void (* volatile a_ptrToCallback)(uint8_t a_result));
+
+/*
+ * [Function Name]: NOR_FLASH_logGetSize
+ * [Function Description]: returns the number of bytes from the log start to its end,
+ * 						   including the skipped bytes of resumed pages
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 used size of the log
+ */
+uint32_t NOR_FLASH_logGetSize(void);
+
+/*
+ * [Function Name]: NOR_FLASH_logClear
+ * [Function Description]: erases all the log sectors and starts the log from the
+ * 						   beginning, waits till done
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 NOR_FLASH_SUCCESS, NOR_FLASH_BUSY or NOR_FLASH_ERROR
+ */
+uint8_t NOR_FLASH_logClear(void);
+
+#endif /* __NOR_FLASH_H__ */
@@ -49,4 +49,11 @@
 
 #endif /* SEGMENTS_USE_SINGLE_PORT == TRUE */
 
+/* if SEGMENTS_EXPANDER_PINS_ENABLED = 1, the data pins and the enable pins
+ * can be expander pins EXP_PIN(byte, bit) too, SEGMENTS_USE_SINGLE_PORT must be FALSE
+ * to use them as data pins. The EXPANDER driver must be initialized and synced
+ * by the application
+ */
+#define SEGMENTS_EXPANDER_PINS_ENABLED					0
+
 #endif /* __SEVEN_SEGMENT_CONFIG_H__ */
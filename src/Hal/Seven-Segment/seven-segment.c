@@ -20,6 +20,26 @@
 /* For using dio functions for pins */
 #include "../../Mcal/Dio/dio.h"
 
+#if SEGMENTS_EXPANDER_PINS_ENABLED == 1
+
+/* For using expander pins */
+#include "../Expander/expander.h"
+
+#endif /* SEGMENTS_EXPANDER_PINS_ENABLED == 1 */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* pins functions, they accept expander pins if enabled */
+#if SEGMENTS_EXPANDER_PINS_ENABLED == 1
+#define SEGMENTS_PIN_INIT(pin)							EXP_dioPinInit(pin, PIN_OUTPUT)
+#define SEGMENTS_WRITE_PIN(pin, value)					EXP_dioWritePin(pin, value)
+#else
+#define SEGMENTS_PIN_INIT(pin)							DIO_pinInit(pin, PIN_OUTPUT)
+#define SEGMENTS_WRITE_PIN(pin, value)					DIO_writePin(pin, value)
+#endif /* SEGMENTS_EXPANDER_PINS_ENABLED == 1 */
+
 /*******************************************************************************
  *                      	   Global Variables		                           *
  *******************************************************************************/
@@ -51,10 +71,10 @@ void SEVEN_SEGMENT_init(uint8_t * a_enablePins)
 
 #else
 
-	DIO_pinInit(SEVENT_SEGMENT_D0, PIN_OUTPUT);
-	DIO_pinInit(SEVENT_SEGMENT_D1, PIN_OUTPUT);
-	DIO_pinInit(SEVENT_SEGMENT_D2, PIN_OUTPUT);
-	DIO_pinInit(SEVENT_SEGMENT_D3, PIN_OUTPUT);
+	SEGMENTS_PIN_INIT(SEVENT_SEGMENT_D0);
+	SEGMENTS_PIN_INIT(SEVENT_SEGMENT_D1);
+	SEGMENTS_PIN_INIT(SEVENT_SEGMENT_D2);
+	SEGMENTS_PIN_INIT(SEVENT_SEGMENT_D3);
 
 #endif /* SEGMENTS_USE_SINGLE_PORT == TRUE */
 
@@ -64,7 +84,7 @@ void SEVEN_SEGMENT_init(uint8_t * a_enablePins)
 		g_sevenSegmentEnables[loopCounter] = a_enablePins[loopCounter];
 
 		/*  init enable pins as output */
-		DIO_pinInit(g_sevenSegmentEnables[loopCounter], PIN_OUTPUT);
+		SEGMENTS_PIN_INIT(g_sevenSegmentEnables[loopCounter]);
 	}
 	SEVEN_SEGMENT_clearAll();
 }
@@ -94,15 +114,15 @@ void SEVEN_SEGMENT_write(uint8_t a_enablePinIndex, uint8_t a_data)
 
 #else
 
-		DIO_writePin(SEVENT_SEGMENT_D0, GET_BIT(a_data, 0));
-		DIO_writePin(SEVENT_SEGMENT_D1, GET_BIT(a_data, 1));
-		DIO_writePin(SEVENT_SEGMENT_D2, GET_BIT(a_data, 2));
-		DIO_writePin(SEVENT_SEGMENT_D3, GET_BIT(a_data, 3));
+		SEGMENTS_WRITE_PIN(SEVENT_SEGMENT_D0, GET_BIT(a_data, 0));
+		SEGMENTS_WRITE_PIN(SEVENT_SEGMENT_D1, GET_BIT(a_data, 1));
+		SEGMENTS_WRITE_PIN(SEVENT_SEGMENT_D2, GET_BIT(a_data, 2));
+		SEGMENTS_WRITE_PIN(SEVENT_SEGMENT_D3, GET_BIT(a_data, 3));
 
 #endif /* SEGMENTS_USE_SINGLE_PORT == TRUE */
 
 		/* write high to the selected enable pin */
-		DIO_writePin(g_sevenSegmentEnables[a_enablePinIndex], HIGH);
+		SEGMENTS_WRITE_PIN(g_sevenSegmentEnables[a_enablePinIndex], HIGH);
 	}
 }
 
@@ -120,6 +140,6 @@ void SEVEN_SEGMENT_clearAll(void)
 	for(loopCounter = 0; loopCounter < SEGMENTS_USED_COUNT; loopCounter ++)
 	{
 		/* write zeros to all enable pins */
-		DIO_writePin(g_sevenSegmentEnables[loopCounter], LOW);
+		SEGMENTS_WRITE_PIN(g_sevenSegmentEnables[loopCounter], LOW);
 	}
 }
@@ -0,0 +1,57 @@
+/******************************************************************************
+ *
+ * Module: STEPPER
+ *
+ * File Name: stepper-config.h
+ *
+ * Description: Config file for the STEPPER motors driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __STEPPER_CONFIG_H__
+#define __STEPPER_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* if STEPPER_ENABLED = 1, the stepper driver is built. It owns timer 1, so it can't be
+ * used with the icu timestamp extension or compare scheduler, and it's disabled by
+ * default as the icu and the ultrasonic driver use them
+ */
+#define STEPPER_ENABLED								0
+
+#if STEPPER_ENABLED == 1
+
+/* number of axes in the axes table passed to STEPPER_init(), from 1 to 8.
+ * The axes of a move step together by a bresenham line, the axis with the most
+ * steps leads and the others step between its steps
+ */
+#define STEPPER_AXES_COUNT							2
+
+/* the prescaler of timer 1 used for the step pulses, see timer.h.
+ * Timer 1 is used in ctc mode, so it mustn't be used by any other module (icu, pwm 1).
+ * The slowest speed is (F_CPU / STEPPER_PRESCALER_VALUE / 65535) steps per second,
+ * i.e. 31 steps per second with prescaler 8 at 16MHz
+ */
+#define STEPPER_TIMER_PRESCALER						TIMER_1_PRESCALER_8
+
+/* the division value of STEPPER_TIMER_PRESCALER */
+#define STEPPER_PRESCALER_VALUE						8
+
+/* if STEPPER_UNIPOLAR_HALF_STEP = 1, the unipolar coils are driven by the half step
+ * sequence (8 steps per coils cycle), otherwise by the full step sequence with two
+ * coils on (4 steps per coils cycle)
+ */
+#define STEPPER_UNIPOLAR_HALF_STEP					0
+
+#endif /* STEPPER_ENABLED == 1 */
+
+/* making sure F_CPU is defined */
+#ifndef F_CPU
+#define F_CPU										1000000UL
+#endif /* F_CPU */
+
+#endif /* __STEPPER_CONFIG_H__ */
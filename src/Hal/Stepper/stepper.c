@@ -0,0 +1,497 @@
+/******************************************************************************
+ *
+ * Module: STEPPER
+ *
+ * File Name: stepper.c
+ *
+ * Description: Source file for the STEPPER motors driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "stepper.h"
+
+/* For using DIO functions */
+#include "../../Mcal/Dio/dio.h"
+
+#if STEPPER_ENABLED == 1
+
+/* for using the step timer */
+#include "../../Mcal/Timer/timer.h"
+
+/* For the square root of the first step period */
+#include "../../Lib/math-utils.h"
+
+/* For checking whether timer 1 is owned by the ICU driver */
+#include "../../Mcal/Icu/icu-config.h"
+
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1 || ICU_COMPARE_SCHEDULER_ENABLED == 1
+#error "STEPPER driver requires ICU_TIMESTAMP_EXTENSION_ENABLED = 0 and ICU_COMPARE_SCHEDULER_ENABLED = 0, timer 1 is used by the ICU"
+#endif
+
+#if STEPPER_AXES_COUNT < 1 || STEPPER_AXES_COUNT > 8
+#error "STEPPER_AXES_COUNT must be from 1 to 8"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* the longest step period in timer ticks with 8 fraction bits */
+#define STEPPER_MAX_PERIOD_Q8						((uint32_t)TIMER_1_MAX_COUNT << 8)
+
+/* length of the unipolar coils sequence */
+#if STEPPER_UNIPOLAR_HALF_STEP == 1
+#define STEPPER_SEQUENCE_LENGTH						8
+#else
+#define STEPPER_SEQUENCE_LENGTH						4
+#endif /* STEPPER_UNIPOLAR_HALF_STEP == 1 */
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: STEPPER_stepHandler
+ * [Function Description]: called from the timer 1 compare interrupt, steps the axes
+ * 						   due in this step of the leading axis and sets the period
+ * 						   of the next step
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void STEPPER_stepHandler(void);
+
+/*
+ * [Function Name]: STEPPER_writeCoils
+ * [Function Description]: energizes the coils of a unipolar axis for its current phase
+ * [Args]:
+ * [in]: uint8_t a_axisIndex
+ * 		 index of the axis in the axes table
+ * [Return]: void
+ */
+static void STEPPER_writeCoils(uint8_t a_axisIndex);
+
+/*******************************************************************************
+ *                      	   Global Variables		                           *
+ *******************************************************************************/
+
+/* the unipolar coils patterns, bit 0 is the first coil pin */
+#if STEPPER_UNIPOLAR_HALF_STEP == 1
+static const uint8_t g_coilsSequence[STEPPER_SEQUENCE_LENGTH] = {
+		0b0001, 0b0011, 0b0010, 0b0110, 0b0100, 0b1100, 0b1000, 0b1001
+};
+#else
+static const uint8_t g_coilsSequence[STEPPER_SEQUENCE_LENGTH] = {
+		0b0011, 0b0110, 0b1100, 0b1001
+};
+#endif /* STEPPER_UNIPOLAR_HALF_STEP == 1 */
+
+/* the axes table */
+static ST_StepperAxis g_axes[STEPPER_AXES_COUNT];
+
+/* positions of the axes in steps */
+static volatile int32_t g_positions[STEPPER_AXES_COUNT];
+
+/* current unipolar sequence phase of each axis */
+static uint8_t g_coilsPhases[STEPPER_AXES_COUNT];
+
+/* steps of each axis in the running move, their directions (1 or -1)
+ * and the bresenham errors
+ */
+static uint32_t g_axesSteps[STEPPER_AXES_COUNT];
+static int8_t g_directions[STEPPER_AXES_COUNT];
+static int32_t g_bresenhamErrors[STEPPER_AXES_COUNT];
+
+/* steps of the leading axis, the steps done of them and the last steps
+ * where the motion decelerates
+ */
+static uint32_t g_totalSteps;
+static uint32_t g_stepsDone;
+static uint32_t g_decelerationSteps;
+
+/* the current and the minimum (cruise) step periods in timer ticks with 8 fraction bits,
+ * and the acceleration step counter of the Austin approximation
+ */
+static uint32_t g_periodQ8;
+static uint32_t g_minPeriodQ8;
+static uint32_t g_accelerationCounter;
+
+/* set while a move is running */
+static volatile uint8_t g_isBusy = FALSE;
+
+/* function called when a move is completed */
+static void (* volatile g_ptrToCallBack)(void) = NULL;
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: STEPPER_init
+ * [Function Description]: copies the axes table and initializes their pins
+ * [Args]:
+ * [in]: const ST_StepperAxis * a_axes
+ * 		 array of STEPPER_AXES_COUNT axes
+ * [Return]: void
+ */
+void STEPPER_init(const ST_StepperAxis * a_axes)
+{
+	uint8_t loopCounter, pinsCounter;
+
+	/* timer 1 isn't touched till the first move, it may be used by another module */
+	g_isBusy = FALSE;
+
+	for(loopCounter = 0; loopCounter < STEPPER_AXES_COUNT; loopCounter ++)
+	{
+		g_axes[loopCounter] = a_axes[loopCounter];
+		g_positions[loopCounter] = 0;
+		g_coilsPhases[loopCounter] = 0;
+
+		if(g_axes[loopCounter].driver == STEPPER_STEP_DIR)
+		{
+			DIO_pinInit(g_axes[loopCounter].pins[0], PIN_OUTPUT);
+			DIO_pinInit(g_axes[loopCounter].pins[1], PIN_OUTPUT);
+			DIO_writePin(g_axes[loopCounter].pins[0], LOW);
+		}
+		else
+		{
+			for(pinsCounter = 0; pinsCounter < 4; pinsCounter ++)
+			{
+				DIO_pinInit(g_axes[loopCounter].pins[pinsCounter], PIN_OUTPUT);
+			}
+
+			/* hold the motor at the first phase */
+			STEPPER_writeCoils(loopCounter);
+		}
+	}
+}
+
+/*
+ * [Function Name]: STEPPER_move
+ * [Function Description]: starts moving the axes without waiting, the step pulses are
+ * 						   generated from the timer 1 compare interrupt and its period is
+ * 						   updated every step by the David Austin approximation of a
+ * 						   trapezoidal profile, so no square roots are calculated while
+ * 						   moving. Speeds up to 10000 steps per second are supported at 16MHz.
+ * 						   Global interrupts must be enabled. If all the steps are 0, nothing
+ * 						   is started and the completion callback isn't called
+ * [Args]:
+ * [in]: const int32_t * a_steps
+ * 		 array of STEPPER_AXES_COUNT relative steps, negative to move in the reverse direction
+ * [in]: uint16_t a_maxSpeed
+ * 		 speed of the leading axis in the middle of the move in steps per second
+ * [in]: uint16_t a_acceleration
+ * 		 acceleration and deceleration of the leading axis in steps per second squared,
+ * 		 0 to move at a_maxSpeed from the first step
+ * [Return]: uint8_t
+ * 			 STEPPER_SUCCESS or STEPPER_ERROR if a move is running or a_maxSpeed is 0
+ */
+uint8_t STEPPER_move(const int32_t * a_steps, uint16_t a_maxSpeed, uint16_t a_acceleration)
+{
+	uint8_t loopCounter;
+	uint32_t accelerationSteps;
+	uint16_t squareRootQ4;
+	TIMER_config timerConfig = {
+			TIMER_1,
+			TIMER_1_CTC,
+			STEPPER_TIMER_PRESCALER,
+			0,
+			STEPPER_stepHandler
+	};
+
+	if(g_isBusy == TRUE || a_maxSpeed == 0)
+	{
+		return STEPPER_ERROR;
+	}
+
+	/* the leading axis has the most steps */
+	g_totalSteps = 0;
+	for(loopCounter = 0; loopCounter < STEPPER_AXES_COUNT; loopCounter ++)
+	{
+		if(a_steps[loopCounter] < 0)
+		{
+			g_axesSteps[loopCounter] = (uint32_t)(-a_steps[loopCounter]);
+			g_directions[loopCounter] = -1;
+		}
+		else
+		{
+			g_axesSteps[loopCounter] = (uint32_t)a_steps[loopCounter];
+			g_directions[loopCounter] = 1;
+		}
+
+		if(g_axesSteps[loopCounter] > g_totalSteps)
+		{
+			g_totalSteps = g_axesSteps[loopCounter];
+		}
+
+		if(g_axes[loopCounter].driver == STEPPER_STEP_DIR)
+		{
+			DIO_writePin(g_axes[loopCounter].pins[1], (g_directions[loopCounter] > 0) ? HIGH : LOW);
+		}
+	}
+
+	if(g_totalSteps == 0)
+	{
+		return STEPPER_SUCCESS;
+	}
+
+	for(loopCounter = 0; loopCounter < STEPPER_AXES_COUNT; loopCounter ++)
+	{
+		g_bresenhamErrors[loopCounter] = (int32_t)(g_totalSteps / 2);
+	}
+	g_stepsDone = 0;
+	g_accelerationCounter = 0;
+
+	/* cruise period = timer frequency / speed */
+	g_minPeriodQ8 = (uint32_t)(((uint64_t)STEPPER_TIMER_FREQUENCY << 8) / a_maxSpeed);
+	if(g_minPeriodQ8 > STEPPER_MAX_PERIOD_Q8)
+	{
+		g_minPeriodQ8 = STEPPER_MAX_PERIOD_Q8;
+	}
+
+	g_periodQ8 = g_minPeriodQ8;
+	g_decelerationSteps = 0;
+
+	if(a_acceleration != 0)
+	{
+		/* first period c0 = 0.676 * f * sqrt(2 / a) = 0.956 * f / sqrt(a),
+		 * the square root is calculated with 4 fraction bits
+		 */
+		squareRootQ4 = MATH_squareRoot((uint32_t)a_acceleration << 8);
+		g_periodQ8 = (uint32_t)(((uint64_t)STEPPER_TIMER_FREQUENCY * 9560UL * 16UL * 256UL) / (10000UL * squareRootQ4));
+		if(g_periodQ8 > STEPPER_MAX_PERIOD_Q8)
+		{
+			g_periodQ8 = STEPPER_MAX_PERIOD_Q8;
+		}
+
+		if(g_periodQ8 > g_minPeriodQ8)
+		{
+			/* steps to reach the cruise speed = v^2 / 2a, a triangle profile
+			 * if the move is shorter than accelerating and decelerating
+			 */
+			accelerationSteps = ((uint32_t)a_maxSpeed * a_maxSpeed) / (2UL * a_acceleration);
+			if(accelerationSteps == 0)
+			{
+				accelerationSteps = 1;
+			}
+			g_decelerationSteps = (accelerationSteps < g_totalSteps / 2) ? accelerationSteps : (g_totalSteps / 2);
+		}
+		else
+		{
+			/* the speed is reached from the first step */
+			g_periodQ8 = g_minPeriodQ8;
+		}
+	}
+
+	timerConfig.ticks = g_periodQ8 >> 8;
+	g_isBusy = TRUE;
+	TIMER_init(&timerConfig);
+	TIMER_start(TIMER_1);
+
+	return STEPPER_SUCCESS;
+}
+
+/*
+ * [Function Name]: STEPPER_stop
+ * [Function Description]: stops the running move directly without decelerating,
+ * 						   the completion callback isn't called
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void STEPPER_stop(void)
+{
+	TIMER_stop(TIMER_1);
+	g_isBusy = FALSE;
+}
+
+/*
+ * [Function Name]: STEPPER_isBusy
+ * [Function Description]: checks if a move is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if a move is running, FALSE otherwise
+ */
+uint8_t STEPPER_isBusy(void)
+{
+	return g_isBusy;
+}
+
+/*
+ * [Function Name]: STEPPER_getPosition
+ * [Function Description]: gets the position of an axis in steps
+ * [Args]:
+ * [in]: uint8_t a_axisIndex
+ * 		 index of the axis in the axes table
+ * [Return]: int32_t
+ * 			 steps from the zero position, 0 if the index is out of the table
+ */
+int32_t STEPPER_getPosition(uint8_t a_axisIndex)
+{
+	int32_t position;
+	uint8_t sreg;
+
+	if(a_axisIndex >= STEPPER_AXES_COUNT)
+	{
+		return 0;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+	position = g_positions[a_axisIndex];
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return position;
+}
+
+/*
+ * [Function Name]: STEPPER_setPosition
+ * [Function Description]: sets the current position of an axis, i.e. after homing
+ * [Args]:
+ * [in]: uint8_t a_axisIndex
+ * 		 index of the axis in the axes table
+ * [in]: int32_t a_position
+ * 		 the new position in steps
+ * [Return]: void
+ */
+void STEPPER_setPosition(uint8_t a_axisIndex, int32_t a_position)
+{
+	uint8_t sreg;
+
+	if(a_axisIndex < STEPPER_AXES_COUNT)
+	{
+		ENTER_CRITICAL_SECTION(sreg);
+		g_positions[a_axisIndex] = a_position;
+		EXIT_CRITICAL_SECTION(sreg);
+	}
+}
+
+/*
+ * [Function Name]: STEPPER_setCallBack
+ * [Function Description]: sets the function called from the timer interrupt when a move
+ * 						   is completed, it can start the next move
+ * [Args]:
+ * [in]: void (* a_ptrToCallBack)(void)
+ * 		 the completion function, NULL to remove it
+ * [Return]: void
+ */
+void STEPPER_setCallBack(void (* volatile a_ptrToCallBack)(void))
+{
+	g_ptrToCallBack = a_ptrToCallBack;
+}
+
+/*
+ * [Function Name]: STEPPER_stepHandler
+ * [Function Description]: called from the timer 1 compare interrupt, steps the axes
+ * 						   due in this step of the leading axis and sets the period
+ * 						   of the next step
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void STEPPER_stepHandler(void)
+{
+	uint8_t loopCounter;
+	uint8_t steppedAxes = 0;
+	uint32_t remainingSteps;
+
+	/* bresenham, the leading axis steps every time */
+	for(loopCounter = 0; loopCounter < STEPPER_AXES_COUNT; loopCounter ++)
+	{
+		g_bresenhamErrors[loopCounter] -= (int32_t)g_axesSteps[loopCounter];
+		if(g_bresenhamErrors[loopCounter] < 0)
+		{
+			g_bresenhamErrors[loopCounter] += (int32_t)g_totalSteps;
+			g_positions[loopCounter] += g_directions[loopCounter];
+
+			if(g_axes[loopCounter].driver == STEPPER_STEP_DIR)
+			{
+				/* the pulse ends after calculating the next period */
+				DIO_writePin(g_axes[loopCounter].pins[0], HIGH);
+				steppedAxes |= (1 << loopCounter);
+			}
+			else
+			{
+				g_coilsPhases[loopCounter] = (uint8_t)(g_coilsPhases[loopCounter] + g_directions[loopCounter]) \
+						& (STEPPER_SEQUENCE_LENGTH - 1);
+				STEPPER_writeCoils(loopCounter);
+			}
+		}
+	}
+
+	g_stepsDone ++;
+	remainingSteps = g_totalSteps - g_stepsDone;
+
+	if(remainingSteps == 0)
+	{
+		TIMER_stop(TIMER_1);
+	}
+	else
+	{
+		/* Austin: c(n) = c(n-1) - 2 c(n-1) / (4n + 1), n counts down to -1 while decelerating */
+		if(remainingSteps <= g_decelerationSteps)
+		{
+			g_periodQ8 += (2 * g_periodQ8) / (4 * remainingSteps - 1);
+			if(g_periodQ8 > STEPPER_MAX_PERIOD_Q8)
+			{
+				g_periodQ8 = STEPPER_MAX_PERIOD_Q8;
+			}
+		}
+		else if(g_periodQ8 > g_minPeriodQ8)
+		{
+			g_accelerationCounter ++;
+			g_periodQ8 -= (2 * g_periodQ8) / (4 * g_accelerationCounter + 1);
+			if(g_periodQ8 < g_minPeriodQ8)
+			{
+				g_periodQ8 = g_minPeriodQ8;
+			}
+		}
+
+		TIMER_setCtcTicks(TIMER_1, (uint16_t)(g_periodQ8 >> 8));
+	}
+
+	for(loopCounter = 0; loopCounter < STEPPER_AXES_COUNT; loopCounter ++)
+	{
+		if(steppedAxes & (1 << loopCounter))
+		{
+			DIO_writePin(g_axes[loopCounter].pins[0], LOW);
+		}
+	}
+
+	if(remainingSteps == 0)
+	{
+		g_isBusy = FALSE;
+		if(g_ptrToCallBack != NULL)
+		{
+			(*g_ptrToCallBack)();
+		}
+	}
+}
+
+/*
+ * [Function Name]: STEPPER_writeCoils
+ * [Function Description]: energizes the coils of a unipolar axis for its current phase
+ * [Args]:
+ * [in]: uint8_t a_axisIndex
+ * 		 index of the axis in the axes table
+ * [Return]: void
+ */
+static void STEPPER_writeCoils(uint8_t a_axisIndex)
+{
+	uint8_t pinsCounter;
+	uint8_t pattern = g_coilsSequence[g_coilsPhases[a_axisIndex]];
+
+	for(pinsCounter = 0; pinsCounter < 4; pinsCounter ++)
+	{
+		DIO_writePin(g_axes[a_axisIndex].pins[pinsCounter], ((pattern >> pinsCounter) & 1) ? HIGH : LOW);
+	}
+}
+
+#endif /* STEPPER_ENABLED == 1 */
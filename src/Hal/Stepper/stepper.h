@@ -0,0 +1,166 @@
+/******************************************************************************
+ *
+ * Module: STEPPER
+ *
+ * File Name: stepper.h
+ *
+ * Description: Header file for the STEPPER motors driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __STEPPER_H__
+#define __STEPPER_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module config file */
+#include "stepper-config.h"
+
+/* For using std types */
+#include "../../Lib/types.h"
+
+/* For using common defines and macros */
+#include "../../Lib/common.h"
+
+#if STEPPER_ENABLED == 1
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* results of the stepper functions */
+#define STEPPER_SUCCESS								1
+#define STEPPER_ERROR								0
+
+/* timer 1 ticks per second */
+#define STEPPER_TIMER_FREQUENCY						(F_CPU / STEPPER_PRESCALER_VALUE)
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+/*
+ * [Enum Name]: EN_StepperDriver
+ * [Enum Description]: contains the ways the motor of an axis is driven
+ */
+typedef enum
+{
+	/* a driver ic with step and direction inputs, i.e. A4988 or DRV8825 */
+	STEPPER_STEP_DIR,
+
+	/* 4 unipolar coils driven through transistors, i.e. ULN2003 */
+	STEPPER_UNIPOLAR
+}EN_StepperDriver;
+
+/*
+ * [Struct Name]: ST_StepperAxis
+ * [Struct Description]: contains the configuration of an axis
+ */
+typedef struct
+{
+	/* how the motor is driven */
+	EN_StepperDriver driver;
+
+	/* STEPPER_STEP_DIR: the step pin then the direction pin, the others are not used.
+	 * STEPPER_UNIPOLAR: the 4 coils pins in the order they are energized
+	 */
+	uint8_t pins[4];
+}ST_StepperAxis;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: STEPPER_init
+ * [Function Description]: copies the axes table and initializes their pins
+ * [Args]:
+ * [in]: const ST_StepperAxis * a_axes
+ * 		 array of STEPPER_AXES_COUNT axes
+ * [Return]: void
+ */
+void STEPPER_init(const ST_StepperAxis * a_axes);
+
+/*
+ * [Function Name]: STEPPER_move
+ * [Function Description]: starts moving the axes without waiting, the step pulses are
+ * 						   generated from the timer 1 compare interrupt and its period is
+ * 						   updated every step by the David Austin approximation of a
+ * 						   trapezoidal profile, so no square roots are calculated while
+ * 						   moving. Speeds up to 10000 steps per second are supported at 16MHz.
+ * 						   Global interrupts must be enabled. If all the steps are 0, nothing
+ * 						   is started and the completion callback isn't called
+ * [Args]:
+ * [in]: const int32_t * a_steps
+ * 		 array of STEPPER_AXES_COUNT relative steps, negative to move in the reverse direction
+ * [in]: uint16_t a_maxSpeed
+ * 		 speed of the leading axis in the middle of the move in steps per second
+ * [in]: uint16_t a_acceleration
+ * 		 acceleration and deceleration of the leading axis in steps per second squared,
+ * 		 0 to move at a_maxSpeed from the first step
+ * [Return]: uint8_t
+ * 			 STEPPER_SUCCESS or STEPPER_ERROR if a move is running or a_maxSpeed is 0
+ */
+uint8_t STEPPER_move(const int32_t * a_steps, uint16_t a_maxSpeed, uint16_t a_acceleration);
+
+/*
+ * [Function Name]: STEPPER_stop
+ * [Function Description]: stops the running move directly without decelerating,
+ * 						   the completion callback isn't called
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void STEPPER_stop(void);
+
+/*
+ * [Function Name]: STEPPER_isBusy
+ * [Function Description]: checks if a move is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if a move is running, FALSE otherwise
+ */
+uint8_t STEPPER_isBusy(void);
+
+/*
+ * [Function Name]: STEPPER_getPosition
+ * [Function Description]: gets the position of an axis in steps
+ * [Args]:
+ * [in]: uint8_t a_axisIndex
+ * 		 index of the axis in the axes table
+ * [Return]: int32_t
+ * 			 steps from the zero position, 0 if the index is out of the table
+ */
+int32_t STEPPER_getPosition(uint8_t a_axisIndex);
+
+/*
+ * [Function Name]: STEPPER_setPosition
+ * [Function Description]: sets the current position of an axis, i.e. after homing
+ * [Args]:
+ * [in]: uint8_t a_axisIndex
+ * 		 index of the axis in the axes table
+ * [in]: int32_t a_position
+ * 		 the new position in steps
+ * [Return]: void
+ */
+void STEPPER_setPosition(uint8_t a_axisIndex, int32_t a_position);
+
+/*
+ * [Function Name]: STEPPER_setCallBack
+ * [Function Description]: sets the function called from the timer interrupt when a move
+ * 						   is completed, it can start the next move
+ * [Args]:
+ * [in]: void (* a_ptrToCallBack)(void)
+ * 		 the completion function, NULL to remove it
+ * [Return]: void
+ */
+void STEPPER_setCallBack(void (* volatile a_ptrToCallBack)(void));
+
+#endif /* STEPPER_ENABLED == 1 */
+
+#endif /* __STEPPER_H__ */
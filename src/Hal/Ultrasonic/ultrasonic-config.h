@@ -17,18 +17,62 @@
  *                                Definitions                                  *
  *******************************************************************************/
 
-/* it's a value minused from the distance, used for calibration
- * it can be positive or negative */
-#define ULTRASONIC_CALIBRATION_VALUE				-1
+/* number of ultrasonic sensors used in the project, all of them share
+ * the single ICU pin, their echo signals are connected to it through a mux
+ * or ORed together (one diode for each) as only one sensor is triggered at a time.
+ * If ULTRASONICS_USED_COUNT = 1, the functions will not require the sensor index
+ * so the sensor config must be set below
+ */
+#define ULTRASONICS_USED_COUNT						1
+
+#if ULTRASONICS_USED_COUNT == 1
 
-/* the trigger pin of the ultrasonic */
+/* the trigger pin of the ultrasonic
+ * available only if ULTRASONICS_USED_COUNT = 1
+ */
 #define ULTRASONIC_TRIGGER_PIN						PB5
 
+#else
+
+/* if ULTRASONIC_MUX_ENABLED = 1, the echo signals are connected to the ICU pin
+ * through a mux and the muxChannel of the sensor is selected before triggering it,
+ * if ULTRASONIC_MUX_ENABLED = 0, the echo signals are ORed together
+ */
+#define ULTRASONIC_MUX_ENABLED						0
+
+/* the mux select pins, the first pin is the least significant bit
+ * of the mux channel, used only if ULTRASONIC_MUX_ENABLED = 1
+ */
+#define ULTRASONIC_MUX_SELECT_PINS_COUNT			2
+#define ULTRASONIC_MUX_SELECT_PINS					{PC0, PC1}
+
+/* time in us between the end of a measurement and triggering the next sensor
+ * in the round robin, to let the echoes of the previous sensor die out
+ */
+#define ULTRASONIC_ROUND_ROBIN_GAP_US				10000UL
+
+#endif /* ULTRASONICS_USED_COUNT == 1 */
+
 /* the echo pin of the ultrasonic
  * this pin must have ICU supported on it
  */
 #define ULTRASONIC_ECHO_PIN							PD6
 
+/* it's a value minused from the distance in mm, used for calibration
+ * it can be positive or negative */
+#define ULTRASONIC_CALIBRATION_VALUE_MM				-10
+
+/* time in us to wait for the echo pulse to end after the trigger pulse,
+ * the distance is reported as ULTRASONIC_OUT_OF_RANGE then.
+ * 25000 us covers about 4.3 m, must fit in 65535 ICU ticks
+ */
+#define ULTRASONIC_ECHO_TIMEOUT_US					25000UL
+
+/* if ULTRASONIC_MEDIAN_FILTER_ENABLED = 1, the reported distance of each sensor
+ * is the median of its last 3 measurements to reject single wrong echoes
+ */
+#define ULTRASONIC_MEDIAN_FILTER_ENABLED			1
+
 /* making sure F_CPU is defined */
 #ifndef F_CPU
 #define F_CPU										(1000000U)
@@ -1,10 +1,10 @@
 /******************************************************************************
  *
- * Module: LCD
+ * Module: ULTRASONIC
  *
- * File Name: lcd.c
+ * File Name: ultrasonic.c
  *
- * Description: Source file for the LCD driver
+ * Description: Source file for the ULTRASONIC driver
  *
  * Author: Kirollos Ashraf
  *
@@ -20,48 +20,185 @@
 /* for using DIO functions */
 #include "../../Mcal/Dio/dio.h"
 
-/* For using delay function */
-#include "../../Mcal/Timer/timer.h"
-
 /* For using ICU function */
 #include "../../Mcal/Icu/icu.h"
 
+#if ICU_COMPARE_SCHEDULER_ENABLED == 0
+#error "ULTRASONIC driver requires ICU_COMPARE_SCHEDULER_ENABLED = 1"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* converts a time in us to ICU ticks, rounded up */
+#define ULTRASONIC_US_TO_TICKS(us)			\
+		((((us) * (F_CPU / 1000UL)) / 1000UL + ULTRASONIC_ICU_PRESCALER - 1) / ULTRASONIC_ICU_PRESCALER)
+
+/* trigger pulse of 10us or more, one more tick as the current tick is partially elapsed */
+#define ULTRASONIC_TRIGGER_TICKS			(ULTRASONIC_US_TO_TICKS(10UL) + 1)
+
+/* echo timeout in ICU ticks */
+#define ULTRASONIC_ECHO_TIMEOUT_TICKS		ULTRASONIC_US_TO_TICKS(ULTRASONIC_ECHO_TIMEOUT_US)
+
+/* mm for each ICU tick in Q16 fixed point,
+ * distance = ticks * prescaler / F_CPU * (speed of sound / 2) */
+#define ULTRASONIC_MM_PER_TICK_Q16			\
+		((ULTRASONIC_ICU_PRESCALER * (ULTRASONIC_SOUND_SPEED_MM_DIV_2 / 100UL) * 65536UL \
+		+ F_CPU / 200UL) / (F_CPU / 100UL))
+
+#if ULTRASONIC_ECHO_TIMEOUT_TICKS > 0xFFFF
+#error "ULTRASONIC_ECHO_TIMEOUT_US is too long for 16-bit ICU ticks at this F_CPU"
+#endif
+
+#if ULTRASONIC_ECHO_TIMEOUT_TICKS * ULTRASONIC_MM_PER_TICK_Q16 > 0xFFFFFFFF
+#error "ULTRASONIC_ECHO_TIMEOUT_US is too long for 32-bit distance calculation"
+#endif
+
+/* ultrasonic driver states */
+#define ULTRASONIC_IDLE						0
+#define ULTRASONIC_TRIGGERING				1
+#define ULTRASONIC_WAIT_RISING				2
+#define ULTRASONIC_WAIT_FALLING				3
+#define ULTRASONIC_ROUND_ROBIN_GAP			4
+
+#if ULTRASONICS_USED_COUNT == 1
+#define ULTRASONIC_TRIGGER_PIN_OF(index)	ULTRASONIC_TRIGGER_PIN
+#else
+#define ULTRASONIC_TRIGGER_PIN_OF(index)	g_ultrasonics[index].triggerPin
+#endif /* ULTRASONICS_USED_COUNT == 1 */
+
 /*******************************************************************************
  *                     		   Global Variables	                       	       *
  *******************************************************************************/
 
-/* global variable carrying the number of edges
- * if 0 => the next edge is the rising one
- * if 1 => the next edge is the falling edge
- * if 2 => indication that there's new pulseWidth value to read (new data flag)
- */
-static volatile uint8_t g_edgeNumber = 0;
+/* current state of the driver, changed by the ICU interrupts
+ * except from ULTRASONIC_IDLE */
+static volatile uint8_t g_state = ULTRASONIC_IDLE;
+
+/* index of the sensor being measured */
+static volatile uint8_t g_currentIndex = 0;
+
+/* ICU value of the echo rising edge */
+static uint16_t g_echoStart = 0;
+
+/* last distances in mm */
+static volatile uint16_t g_distancesMm[ULTRASONICS_USED_COUNT];
 
-/* global variable carrying the icu value, the pulse width */
-static volatile uint16_t g_pulseWidth = 0;
+#if ULTRASONIC_MEDIAN_FILTER_ENABLED == 1
+
+/* last 3 raw distances of each sensor and the number of stored ones */
+static uint16_t g_history[ULTRASONICS_USED_COUNT][3];
+static uint8_t g_historyCount[ULTRASONICS_USED_COUNT];
+static uint8_t g_historyIndex[ULTRASONICS_USED_COUNT];
+
+#endif /* ULTRASONIC_MEDIAN_FILTER_ENABLED == 1 */
+
+#if ULTRASONICS_USED_COUNT == 1
+
+/* Global variables to hold the address of the call back function */
+static void (* volatile g_callBackPtr)(uint16_t a_distanceMm) = NULL;
+
+#else
+
+/* array holding the initialized sensors */
+static ST_UltrasonicConfig g_ultrasonics[ULTRASONICS_USED_COUNT];
+
+/* Global variables to hold the address of the call back function */
+static void (* volatile g_callBackPtr)(uint8_t a_ultrasonicIndex, uint16_t a_distanceMm) = NULL;
+
+/* TRUE while the round robin is running */
+static volatile uint8_t g_roundRobinEnabled = FALSE;
+
+/* ICU ticks left of the round robin gap, it may be longer than one compare */
+static uint32_t g_gapTicksLeft = 0;
+
+#if ULTRASONIC_MUX_ENABLED == 1
+
+/* mux select pins */
+static const uint8_t g_muxSelectPins[ULTRASONIC_MUX_SELECT_PINS_COUNT] = ULTRASONIC_MUX_SELECT_PINS;
+
+#endif /* ULTRASONIC_MUX_ENABLED == 1 */
+
+#endif /* ULTRASONICS_USED_COUNT == 1 */
 
 /*******************************************************************************
  *                      Static Functions Prototypes	                           *
  *******************************************************************************/
 
+/*
+ * [Function Name]: ULTRASONIC_commonInit
+ * [Function Description]: initializes the ICU driver and its callbacks
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void ULTRASONIC_commonInit(void);
+
 /*
  * [Function Name]: ULTRASONIC_trigger
- * [Function Description]: Send the Trigger pulse to the ultrasonic.
+ * [Function Description]: starts the trigger pulse of a sensor, it's ended
+ * 						   by the next compare event
+ * [Args]:
+ * [in]: uint8_t a_ultrasonicIndex
+ * 		 sensor index
+ * [Return]: void
+ */
+static void ULTRASONIC_trigger(uint8_t a_ultrasonicIndex);
+
+/*
+ * [Function Name]: ULTRASONIC_edgeProcessing
+ * [Function Description]: 1. callback for the icu capture interrupt.
+ * 						   2. calculates the high time for the echo signal
  * [Args]:
  * [in]: void
  * [Return]: void
  */
-static void ULTRASONIC_trigger(void);
+static void ULTRASONIC_edgeProcessing(void);
+
+/*
+ * [Function Name]: ULTRASONIC_compareProcessing
+ * [Function Description]: callback for the icu compare events, ends the trigger
+ * 						   pulse, handles the echo timeout and the round robin gap
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void ULTRASONIC_compareProcessing(void);
+
+/*
+ * [Function Name]: ULTRASONIC_finish
+ * [Function Description]: stores the result of the measurement, calls the callback
+ * 						   and starts the round robin gap if enabled
+ * [Args]:
+ * [in]: uint16_t a_distanceMm
+ * 		 measured distance in mm or ULTRASONIC_OUT_OF_RANGE
+ * [Return]: void
+ */
+static void ULTRASONIC_finish(uint16_t a_distanceMm);
+
+/*
+ * [Function Name]: ULTRASONIC_toCm
+ * [Function Description]: converts a distance in mm to cm, rounded
+ * [Args]:
+ * [in]: uint16_t a_distanceMm
+ * 		 distance in mm or ULTRASONIC_OUT_OF_RANGE
+ * [Return]: uint16_t
+ * 			 distance in cm or ULTRASONIC_OUT_OF_RANGE
+ */
+static uint16_t ULTRASONIC_toCm(uint16_t a_distanceMm);
 
 /*******************************************************************************
  *                          Functions Definition	                           *
  *******************************************************************************/
 
+#if ULTRASONICS_USED_COUNT == 1
+
 /*
  * [Function Name]: ULTRASONIC_init
  * [Function Description]: initializes the ultrasonic sensor
  * 						   1. Initialize the ICU driver.
- * 						   2. Setup the ICU call back function
+ * 						   2. Setup the ICU call back functions
  * 						   3. Setup the direction for the trigger pin.
  * [Args]:
  * [in]: void
@@ -69,101 +206,525 @@ static void ULTRASONIC_trigger(void);
  */
 void ULTRASONIC_init(void)
 {
+	ULTRASONIC_commonInit();
+
+	/* set the trigger pin as output */
+	DIO_pinInit(ULTRASONIC_TRIGGER_PIN, PIN_OUTPUT);
+	DIO_writePin(ULTRASONIC_TRIGGER_PIN, LOW);
+}
+
+/*
+ * [Function Name]: ULTRASONIC_setCallBack
+ * [Function Description]: sets the function called from the ICU interrupts
+ * 						   when a measurement is done
+ * [Args]:
+ * [in]: void (* volatile a_ptrToHandler)(uint16_t a_distanceMm)
+ * 		 pointer to callback function, gets the distance in mm
+ * 		 or ULTRASONIC_OUT_OF_RANGE
+ * [Return]: void
+ */
+void ULTRASONIC_setCallBack(void (* volatile a_ptrToHandler)(uint16_t a_distanceMm))
+{
+	g_callBackPtr = a_ptrToHandler;
+}
+
+/*
+ * [Function Name]: ULTRASONIC_startRanging
+ * [Function Description]: starts a measurement without waiting for it,
+ * 						   the trigger pulse and the echo timeout are timed by
+ * 						   the ICU compare events
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 ULTRASONIC_SUCCESS or ULTRASONIC_BUSY if a measurement is running
+ */
+uint8_t ULTRASONIC_startRanging(void)
+{
+	if(g_state != ULTRASONIC_IDLE)
+	{
+		return ULTRASONIC_BUSY;
+	}
+	ULTRASONIC_trigger(0);
+	return ULTRASONIC_SUCCESS;
+}
+
+/*
+ * [Function Name]: ULTRASONIC_getDistanceMm
+ * [Function Description]: returns the distance of the last finished measurement
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 distance in mm or ULTRASONIC_OUT_OF_RANGE
+ */
+uint16_t ULTRASONIC_getDistanceMm(void)
+{
+	return g_distancesMm[0];
+}
+
+/*
+ * [Function Name]: ULTRASONIC_readDistance
+ * [Function Description]: 1. Send the trigger pulse
+ * 						   2. Wait for the measurement, at most ULTRASONIC_ECHO_TIMEOUT_US
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 distance in cm or ULTRASONIC_OUT_OF_RANGE
+ */
+uint16_t ULTRASONIC_readDistance(void)
+{
+	/* wait for any running measurement, then start a new one */
+	while(ULTRASONIC_startRanging() == ULTRASONIC_BUSY);
+
+	/* the echo timeout bounds the wait */
+	while(g_state != ULTRASONIC_IDLE);
+
+	return ULTRASONIC_toCm(g_distancesMm[0]);
+}
+
+#else
+
+/*
+ * [Function Name]: ULTRASONIC_init
+ * [Function Description]: initializes the ultrasonic sensors
+ * 						   1. Initialize the ICU driver.
+ * 						   2. Setup the ICU call back functions
+ * 						   3. Setup the direction for the trigger and mux pins.
+ * [Args]:
+ * [in]: const ST_UltrasonicConfig * a_ultrasonics
+ * 		 array of ultrasonics config structures to init
+ * [Return]: void
+ */
+void ULTRASONIC_init(const ST_UltrasonicConfig * a_ultrasonics)
+{
+	uint8_t loopCounter;
+
+	ULTRASONIC_commonInit();
+
+	for(loopCounter = 0; loopCounter < ULTRASONICS_USED_COUNT; loopCounter ++)
+	{
+		/* copy values from a_ultrasonics to g_ultrasonics */
+		g_ultrasonics[loopCounter].triggerPin = a_ultrasonics[loopCounter].triggerPin;
+		g_ultrasonics[loopCounter].muxChannel = a_ultrasonics[loopCounter].muxChannel;
+
+		/* set the trigger pin as output */
+		DIO_pinInit(g_ultrasonics[loopCounter].triggerPin, PIN_OUTPUT);
+		DIO_writePin(g_ultrasonics[loopCounter].triggerPin, LOW);
+	}
+
+#if ULTRASONIC_MUX_ENABLED == 1
+
+	/* set the mux select pins as outputs */
+	for(loopCounter = 0; loopCounter < ULTRASONIC_MUX_SELECT_PINS_COUNT; loopCounter ++)
+	{
+		DIO_pinInit(g_muxSelectPins[loopCounter], PIN_OUTPUT);
+	}
+
+#endif /* ULTRASONIC_MUX_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: ULTRASONIC_setCallBack
+ * [Function Description]: sets the function called from the ICU interrupts
+ * 						   when a measurement is done
+ * [Args]:
+ * [in]: void (* volatile a_ptrToHandler)(uint8_t a_ultrasonicIndex, uint16_t a_distanceMm)
+ * 		 pointer to callback function, gets the sensor index and the distance
+ * 		 in mm or ULTRASONIC_OUT_OF_RANGE
+ * [Return]: void
+ */
+void ULTRASONIC_setCallBack(void (* volatile a_ptrToHandler)(uint8_t a_ultrasonicIndex, uint16_t a_distanceMm))
+{
+	g_callBackPtr = a_ptrToHandler;
+}
+
+/*
+ * [Function Name]: ULTRASONIC_startRanging
+ * [Function Description]: starts a measurement without waiting for it,
+ * 						   the trigger pulse and the echo timeout are timed by
+ * 						   the ICU compare events
+ * [Args]:
+ * [in]: uint8_t a_ultrasonicIndex
+ * 		 sensor index, same index used in initializing the ultrasonics array
+ * [Return]: uint8_t
+ * 			 ULTRASONIC_SUCCESS or ULTRASONIC_BUSY if a measurement is running
+ */
+uint8_t ULTRASONIC_startRanging(uint8_t a_ultrasonicIndex)
+{
+	if(a_ultrasonicIndex >= ULTRASONICS_USED_COUNT || g_state != ULTRASONIC_IDLE)
+	{
+		return ULTRASONIC_BUSY;
+	}
+	ULTRASONIC_trigger(a_ultrasonicIndex);
+	return ULTRASONIC_SUCCESS;
+}
+
+/*
+ * [Function Name]: ULTRASONIC_startRoundRobin
+ * [Function Description]: measures all sensors one after the other continuously,
+ * 						   with ULTRASONIC_ROUND_ROBIN_GAP_US between them.
+ * 						   Read the distances with ULTRASONIC_getDistanceMm()
+ * 						   or get them in the callback
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 ULTRASONIC_SUCCESS or ULTRASONIC_BUSY if a measurement is running
+ */
+uint8_t ULTRASONIC_startRoundRobin(void)
+{
+	if(g_state != ULTRASONIC_IDLE)
+	{
+		return ULTRASONIC_BUSY;
+	}
+	g_roundRobinEnabled = TRUE;
+	ULTRASONIC_trigger(0);
+	return ULTRASONIC_SUCCESS;
+}
+
+/*
+ * [Function Name]: ULTRASONIC_stopRoundRobin
+ * [Function Description]: stops the round robin after the running measurement
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void ULTRASONIC_stopRoundRobin(void)
+{
+	g_roundRobinEnabled = FALSE;
+}
+
+/*
+ * [Function Name]: ULTRASONIC_getDistanceMm
+ * [Function Description]: returns the distance of the last finished measurement
+ * [Args]:
+ * [in]: uint8_t a_ultrasonicIndex
+ * 		 sensor index, same index used in initializing the ultrasonics array
+ * [Return]: uint16_t
+ * 			 distance in mm or ULTRASONIC_OUT_OF_RANGE
+ */
+uint16_t ULTRASONIC_getDistanceMm(uint8_t a_ultrasonicIndex)
+{
+	if(a_ultrasonicIndex >= ULTRASONICS_USED_COUNT)
+	{
+		return ULTRASONIC_OUT_OF_RANGE;
+	}
+	return g_distancesMm[a_ultrasonicIndex];
+}
+
+/*
+ * [Function Name]: ULTRASONIC_readDistance
+ * [Function Description]: 1. Send the trigger pulse
+ * 						   2. Wait for the measurement, at most ULTRASONIC_ECHO_TIMEOUT_US
+ * 						   if the round robin is running, the last distance is returned
+ * [Args]:
+ * [in]: uint8_t a_ultrasonicIndex
+ * 		 sensor index, same index used in initializing the ultrasonics array
+ * [Return]: uint16_t
+ * 			 distance in cm or ULTRASONIC_OUT_OF_RANGE
+ */
+uint16_t ULTRASONIC_readDistance(uint8_t a_ultrasonicIndex)
+{
+	if(a_ultrasonicIndex >= ULTRASONICS_USED_COUNT)
+	{
+		return ULTRASONIC_OUT_OF_RANGE;
+	}
+
+	if(g_roundRobinEnabled == FALSE)
+	{
+		/* wait for any running measurement, then start a new one */
+		while(ULTRASONIC_startRanging(a_ultrasonicIndex) == ULTRASONIC_BUSY);
+
+		/* the echo timeout bounds the wait */
+		while(g_state != ULTRASONIC_IDLE);
+	}
+
+	return ULTRASONIC_toCm(g_distancesMm[a_ultrasonicIndex]);
+}
+
+#endif /* ULTRASONICS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: ULTRASONIC_isBusy
+ * [Function Description]: checks if a measurement or the round robin is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t ULTRASONIC_isBusy(void)
+{
+	return g_state != ULTRASONIC_IDLE;
+}
+
+/*
+ * [Function Name]: ULTRASONIC_commonInit
+ * [Function Description]: initializes the ICU driver and its callbacks
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void ULTRASONIC_commonInit(void)
+{
+	uint8_t loopCounter;
 
 	/* configure the icu module
 	 * 1. clock = F_CPU / 8
 	 * 2. edge = Rising edge
+	 * 3. captures are read by the callback
 	 */
 	ST_IcuConfig icuConfig = {
-			ICU_PRESCALER_8, ICU_RISING_EDGE
+			ICU_PRESCALER_8, ICU_RISING_EDGE, ICU_CALLBACK_MODE
 	};
 	Icu_init(&icuConfig);
 
-	/* set icu callback function */
+	/* set icu callback functions */
 	Icu_setCallBack(ULTRASONIC_edgeProcessing);
+	Icu_setCompareCallBack(ULTRASONIC_compareProcessing);
 
-	/* set the trigger pin as output */
-	DIO_pinInit(ULTRASONIC_TRIGGER_PIN, PIN_OUTPUT);
+	g_state = ULTRASONIC_IDLE;
+	for(loopCounter = 0; loopCounter < ULTRASONICS_USED_COUNT; loopCounter ++)
+	{
+		g_distancesMm[loopCounter] = ULTRASONIC_OUT_OF_RANGE;
+
+#if ULTRASONIC_MEDIAN_FILTER_ENABLED == 1
+		g_historyCount[loopCounter] = 0;
+		g_historyIndex[loopCounter] = 0;
+#endif /* ULTRASONIC_MEDIAN_FILTER_ENABLED == 1 */
+	}
 }
 
 /*
- * [Function Name]: ULTRASONIC_readDistance
- * [Function Description]: 1. Send the trigger pulse
- * 						   2. Start the measurements by the ICU
+ * [Function Name]: ULTRASONIC_trigger
+ * [Function Description]: starts the trigger pulse of a sensor, it's ended
+ * 						   by the next compare event
  * [Args]:
- * [in]: void
+ * [in]: uint8_t a_ultrasonicIndex
+ * 		 sensor index
  * [Return]: void
  */
-uint16_t ULTRASONIC_readDistance(void)
+static void ULTRASONIC_trigger(uint8_t a_ultrasonicIndex)
 {
-	uint16_t distance;
+#if ULTRASONICS_USED_COUNT != 1 && ULTRASONIC_MUX_ENABLED == 1
 
-	/* trigger the ultrasonic */
-	ULTRASONIC_trigger();
+	uint8_t loopCounter;
 
-	/* wait till pulse is sent and recieved */
-	while(g_edgeNumber != 2);
+	/* route the echo of the sensor to the ICU pin */
+	for(loopCounter = 0; loopCounter < ULTRASONIC_MUX_SELECT_PINS_COUNT; loopCounter ++)
+	{
+		DIO_writePin(g_muxSelectPins[loopCounter], GET_BIT(g_ultrasonics[a_ultrasonicIndex].muxChannel, loopCounter));
+	}
 
-	/* make g_edgeNumber = 0 for next calls of the functions */
-	g_edgeNumber = 0;
+#endif /* ULTRASONICS_USED_COUNT != 1 && ULTRASONIC_MUX_ENABLED == 1 */
 
-	/* calculate the distance */
-	distance = (uint16_t)(g_pulseWidth / (F_CPU / ((float64_t)ULTRASONIC_SOUND_SPEED_CM_DIV_2 * ULTRASONIC_ICU_PRESCALER)));
+	g_currentIndex = a_ultrasonicIndex;
+	g_state = ULTRASONIC_TRIGGERING;
 
-	/* subtract the calibration value only in case that the result is not negative */
-	if((int32_t)distance - ULTRASONIC_CALIBRATION_VALUE > 0)
-	{
-		return distance - ULTRASONIC_CALIBRATION_VALUE;
-	}
-	return  distance;
+	/* send high pulse for 10us or more */
+	DIO_writePin(ULTRASONIC_TRIGGER_PIN_OF(a_ultrasonicIndex), HIGH);
+	Icu_scheduleCompare(ULTRASONIC_TRIGGER_TICKS);
 }
 
 /*
  * [Function Name]: ULTRASONIC_edgeProcessing
- * [Function Description]: 1. callback for the icu driver.
+ * [Function Description]: 1. callback for the icu capture interrupt.
  * 						   2. calculates the high time for the echo signal
  * [Args]:
  * [in]: void
  * [Return]: void
  */
-void ULTRASONIC_edgeProcessing(void)
+static void ULTRASONIC_edgeProcessing(void)
 {
-	/* if 0 then the rising edge is captured */
-	if(g_edgeNumber == 0)
+	uint16_t echoTicks;
+
+	if(g_state == ULTRASONIC_WAIT_RISING)
 	{
-		/* clear the timer value */
-		Icu_clearTimerValue();
+		/* store the start of the echo pulse, the timer keeps running
+		 * so the compare events aren't affected */
+		g_echoStart = Icu_getInputCaptureValue();
 
-		/* wait for nest falling edge */
+		/* wait for next falling edge */
 		Icu_setEdgeDetectionType(ICU_FALLING_EDGE);
-
-		/* increase edge number */
-		g_edgeNumber ++;
+		g_state = ULTRASONIC_WAIT_FALLING;
 	}
-	else if(g_edgeNumber == 1)
+	else if(g_state == ULTRASONIC_WAIT_FALLING)
 	{
-		/* read ICU value */
-		g_pulseWidth = Icu_getInputCaptureValue();
+		/* the 16-bit difference is right even if the timer overflowed,
+		 * as the echo timeout is less than 65536 ticks */
+		echoTicks = Icu_getInputCaptureValue() - g_echoStart;
 
-		/* wait for next rising edge */
+		/* the echo ended, cancel its timeout */
+		Icu_cancelCompare();
 		Icu_setEdgeDetectionType(ICU_RISING_EDGE);
 
-		/* make edge count = 2 to indicate data is available */
-		g_edgeNumber = 2;
+		ULTRASONIC_finish((uint16_t)(((uint32_t)echoTicks * ULTRASONIC_MM_PER_TICK_Q16) >> 16));
 	}
 }
 
 /*
- * [Function Name]: ULTRASONIC_trigger
- * [Function Description]: Send the Trigger pulse to the ultrasonic.
+ * [Function Name]: ULTRASONIC_compareProcessing
+ * [Function Description]: callback for the icu compare events, ends the trigger
+ * 						   pulse, handles the echo timeout and the round robin gap
  * [Args]:
  * [in]: void
  * [Return]: void
  */
-static void ULTRASONIC_trigger(void)
+static void ULTRASONIC_compareProcessing(void)
 {
-	/* send high pulse for 10us or more */
-	DIO_writePin(ULTRASONIC_TRIGGER_PIN, HIGH);
-	TIMER_DELAY_MS(1);
-	DIO_writePin(ULTRASONIC_TRIGGER_PIN, LOW);
+	switch(g_state)
+	{
+	case ULTRASONIC_TRIGGERING:
+
+		/* end the trigger pulse and wait for the echo */
+		DIO_writePin(ULTRASONIC_TRIGGER_PIN_OF(g_currentIndex), LOW);
+		Icu_setEdgeDetectionType(ICU_RISING_EDGE);
+		g_state = ULTRASONIC_WAIT_RISING;
+		Icu_scheduleCompare(ULTRASONIC_ECHO_TIMEOUT_TICKS);
+		break;
+
+	case ULTRASONIC_WAIT_RISING:
+	case ULTRASONIC_WAIT_FALLING:
+
+		/* no echo or it's too long */
+		Icu_setEdgeDetectionType(ICU_RISING_EDGE);
+		ULTRASONIC_finish(ULTRASONIC_OUT_OF_RANGE);
+		break;
+
+#if ULTRASONICS_USED_COUNT != 1
+
+	case ULTRASONIC_ROUND_ROBIN_GAP:
+
+		if(g_gapTicksLeft > 0)
+		{
+			/* the gap may be longer than one compare */
+			if(g_gapTicksLeft > 0xFFFF)
+			{
+				g_gapTicksLeft -= 0xFFFF;
+				Icu_scheduleCompare(0xFFFF);
+			}
+			else
+			{
+				Icu_scheduleCompare((uint16_t)g_gapTicksLeft);
+				g_gapTicksLeft = 0;
+			}
+		}
+		else if(g_roundRobinEnabled == TRUE)
+		{
+			/* trigger the next sensor */
+			ULTRASONIC_trigger((g_currentIndex + 1) % ULTRASONICS_USED_COUNT);
+		}
+		else
+		{
+			g_state = ULTRASONIC_IDLE;
+		}
+		break;
+
+#endif /* ULTRASONICS_USED_COUNT != 1 */
+
+	default:
+		break;
+	}
+}
+
+/*
+ * [Function Name]: ULTRASONIC_finish
+ * [Function Description]: stores the result of the measurement, calls the callback
+ * 						   and starts the round robin gap if enabled
+ * [Args]:
+ * [in]: uint16_t a_distanceMm
+ * 		 measured distance in mm or ULTRASONIC_OUT_OF_RANGE
+ * [Return]: void
+ */
+static void ULTRASONIC_finish(uint16_t a_distanceMm)
+{
+	uint8_t index = g_currentIndex;
+
+#if ULTRASONIC_MEDIAN_FILTER_ENABLED == 1
+
+	uint16_t first, second, third, temp;
+
+#endif /* ULTRASONIC_MEDIAN_FILTER_ENABLED == 1 */
+
+	/* subtract the calibration value only in case that the result is not negative */
+	if(a_distanceMm != ULTRASONIC_OUT_OF_RANGE && (int32_t)a_distanceMm - ULTRASONIC_CALIBRATION_VALUE_MM > 0)
+	{
+		a_distanceMm -= ULTRASONIC_CALIBRATION_VALUE_MM;
+	}
+
+#if ULTRASONIC_MEDIAN_FILTER_ENABLED == 1
+
+	g_history[index][g_historyIndex[index]] = a_distanceMm;
+	g_historyIndex[index] = (g_historyIndex[index] + 1) % 3;
+	if(g_historyCount[index] < 3)
+	{
+		g_historyCount[index] ++;
+	}
+	else
+	{
+		/* median of the last 3 distances */
+		first = g_history[index][0];
+		second = g_history[index][1];
+		third = g_history[index][2];
+		if(first > second)
+		{
+			temp = first;
+			first = second;
+			second = temp;
+		}
+		if(second > third)
+		{
+			second = third;
+		}
+		a_distanceMm = (first > second) ? first : second;
+	}
+
+#endif /* ULTRASONIC_MEDIAN_FILTER_ENABLED == 1 */
+
+	g_distancesMm[index] = a_distanceMm;
+
+#if ULTRASONICS_USED_COUNT == 1
+
+	g_state = ULTRASONIC_IDLE;
+
+	if(g_callBackPtr != NULL)
+	{
+		(*g_callBackPtr)(a_distanceMm);
+	}
+
+#else
+
+	if(g_roundRobinEnabled == TRUE)
+	{
+		/* let the echoes die before triggering the next sensor */
+		g_gapTicksLeft = ULTRASONIC_US_TO_TICKS(ULTRASONIC_ROUND_ROBIN_GAP_US);
+		g_state = ULTRASONIC_ROUND_ROBIN_GAP;
+		ULTRASONIC_compareProcessing();
+	}
+	else
+	{
+		g_state = ULTRASONIC_IDLE;
+	}
+
+	if(g_callBackPtr != NULL)
+	{
+		(*g_callBackPtr)(index, a_distanceMm);
+	}
+
+#endif /* ULTRASONICS_USED_COUNT == 1 */
+}
+
+/*
+ * [Function Name]: ULTRASONIC_toCm
+ * [Function Description]: converts a distance in mm to cm, rounded
+ * [Args]:
+ * [in]: uint16_t a_distanceMm
+ * 		 distance in mm or ULTRASONIC_OUT_OF_RANGE
+ * [Return]: uint16_t
+ * 			 distance in cm or ULTRASONIC_OUT_OF_RANGE
+ */
+static uint16_t ULTRASONIC_toCm(uint16_t a_distanceMm)
+{
+	if(a_distanceMm == ULTRASONIC_OUT_OF_RANGE)
+	{
+		return ULTRASONIC_OUT_OF_RANGE;
+	}
+	return (a_distanceMm + 5) / 10;
 }
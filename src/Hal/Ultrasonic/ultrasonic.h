@@ -33,18 +33,50 @@
 /* used precaler for the ultrasonic */
 #define ULTRASONIC_ICU_PRESCALER					8
 
-/* the speed of sound divided by 2 */
-#define ULTRASONIC_SOUND_SPEED_CM_DIV_2				17150
+/* the speed of sound in mm/s divided by 2 */
+#define ULTRASONIC_SOUND_SPEED_MM_DIV_2				171500UL
+
+/* distance reported if no echo ends within ULTRASONIC_ECHO_TIMEOUT_US */
+#define ULTRASONIC_OUT_OF_RANGE						0xFFFF
+
+/* ultrasonic ranging states */
+#define ULTRASONIC_SUCCESS							1
+#define ULTRASONIC_BUSY								0
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+#if ULTRASONICS_USED_COUNT != 1
+
+/*
+ * [Struct Name]: ST_UltrasonicConfig
+ * [Struct Description]: contains ultrasonic's configuration
+ */
+typedef struct
+{
+	/* the trigger pin of the ultrasonic */
+	uint8_t triggerPin;
+
+	/* the mux channel the echo pin is connected to,
+	 * used only if ULTRASONIC_MUX_ENABLED = 1 */
+	uint8_t muxChannel;
+
+}ST_UltrasonicConfig;
+
+#endif /* ULTRASONICS_USED_COUNT != 1 */
 
 /*******************************************************************************
  *                           Function Prototypes                               *
  *******************************************************************************/
 
+#if ULTRASONICS_USED_COUNT == 1
+
 /*
  * [Function Name]: ULTRASONIC_init
  * [Function Description]: initializes the ultrasonic sensor
  * 						   1. Initialize the ICU driver.
- * 						   2. Setup the ICU call back function
+ * 						   2. Setup the ICU call back functions
  * 						   3. Setup the direction for the trigger pin.
  * [Args]:
  * [in]: void
@@ -52,24 +84,147 @@
  */
 void ULTRASONIC_init(void);
 
+/*
+ * [Function Name]: ULTRASONIC_setCallBack
+ * [Function Description]: sets the function called from the ICU interrupts
+ * 						   when a measurement is done
+ * [Args]:
+ * [in]: void (* volatile a_ptrToHandler)(uint16_t a_distanceMm)
+ * 		 pointer to callback function, gets the distance in mm
+ * 		 or ULTRASONIC_OUT_OF_RANGE
+ * [Return]: void
+ */
+void ULTRASONIC_setCallBack(void (* volatile a_ptrToHandler)(uint16_t a_distanceMm));
+
+/*
+ * [Function Name]: ULTRASONIC_startRanging
+ * [Function Description]: starts a measurement without waiting for it,
+ * 						   the trigger pulse and the echo timeout are timed by
+ * 						   the ICU compare events
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 ULTRASONIC_SUCCESS or ULTRASONIC_BUSY if a measurement is running
+ */
+uint8_t ULTRASONIC_startRanging(void);
+
+/*
+ * [Function Name]: ULTRASONIC_getDistanceMm
+ * [Function Description]: returns the distance of the last finished measurement
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 distance in mm or ULTRASONIC_OUT_OF_RANGE
+ */
+uint16_t ULTRASONIC_getDistanceMm(void);
+
 /*
  * [Function Name]: ULTRASONIC_readDistance
  * [Function Description]: 1. Send the trigger pulse
- * 						   2. Start the measurements by the ICU
+ * 						   2. Wait for the measurement, at most ULTRASONIC_ECHO_TIMEOUT_US
  * [Args]:
  * [in]: void
- * [Return]: void
+ * [Return]: uint16_t
+ * 			 distance in cm or ULTRASONIC_OUT_OF_RANGE
  */
 uint16_t ULTRASONIC_readDistance(void);
 
+#else
+
 /*
- * [Function Name]: ULTRASONIC_edgeProcessing
- * [Function Description]: 1. callback for the icu driver.
- * 						   2. calculates the high time for the echo signal
+ * [Function Name]: ULTRASONIC_init
+ * [Function Description]: initializes the ultrasonic sensors
+ * 						   1. Initialize the ICU driver.
+ * 						   2. Setup the ICU call back functions
+ * 						   3. Setup the direction for the trigger and mux pins.
+ * [Args]:
+ * [in]: const ST_UltrasonicConfig * a_ultrasonics
+ * 		 array of ultrasonics config structures to init
+ * [Return]: void
+ */
+void ULTRASONIC_init(const ST_UltrasonicConfig * a_ultrasonics);
+
+/*
+ * [Function Name]: ULTRASONIC_setCallBack
+ * [Function Description]: sets the function called from the ICU interrupts
+ * 						   when a measurement is done
+ * [Args]:
+ * [in]: void (* volatile a_ptrToHandler)(uint8_t a_ultrasonicIndex, uint16_t a_distanceMm)
+ * 		 pointer to callback function, gets the sensor index and the distance
+ * 		 in mm or ULTRASONIC_OUT_OF_RANGE
+ * [Return]: void
+ */
+void ULTRASONIC_setCallBack(void (* volatile a_ptrToHandler)(uint8_t a_ultrasonicIndex, uint16_t a_distanceMm));
+
+/*
+ * [Function Name]: ULTRASONIC_startRanging
+ * [Function Description]: starts a measurement without waiting for it,
+ * 						   the trigger pulse and the echo timeout are timed by
+ * 						   the ICU compare events
+ * [Args]:
+ * [in]: uint8_t a_ultrasonicIndex
+ * 		 sensor index, same index used in initializing the ultrasonics array
+ * [Return]: uint8_t
+ * 			 ULTRASONIC_SUCCESS or ULTRASONIC_BUSY if a measurement is running
+ */
+uint8_t ULTRASONIC_startRanging(uint8_t a_ultrasonicIndex);
+
+/*
+ * [Function Name]: ULTRASONIC_startRoundRobin
+ * [Function Description]: measures all sensors one after the other continuously,
+ * 						   with ULTRASONIC_ROUND_ROBIN_GAP_US between them.
+ * 						   Read the distances with ULTRASONIC_getDistanceMm()
+ * 						   or get them in the callback
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 ULTRASONIC_SUCCESS or ULTRASONIC_BUSY if a measurement is running
+ */
+uint8_t ULTRASONIC_startRoundRobin(void);
+
+/*
+ * [Function Name]: ULTRASONIC_stopRoundRobin
+ * [Function Description]: stops the round robin after the running measurement
  * [Args]:
  * [in]: void
  * [Return]: void
  */
-void ULTRASONIC_edgeProcessing(void);
+void ULTRASONIC_stopRoundRobin(void);
+
+/*
+ * [Function Name]: ULTRASONIC_getDistanceMm
+ * [Function Description]: returns the distance of the last finished measurement
+ * [Args]:
+ * [in]: uint8_t a_ultrasonicIndex
+ * 		 sensor index, same index used in initializing the ultrasonics array
+ * [Return]: uint16_t
+ * 			 distance in mm or ULTRASONIC_OUT_OF_RANGE
+ */
+uint16_t ULTRASONIC_getDistanceMm(uint8_t a_ultrasonicIndex);
+
+/*
+ * [Function Name]: ULTRASONIC_readDistance
+ * [Function Description]: 1. Send the trigger pulse
+ * 						   2. Wait for the measurement, at most ULTRASONIC_ECHO_TIMEOUT_US
+ * 						   if the round robin is running, the last distance is returned
+ * [Args]:
+ * [in]: uint8_t a_ultrasonicIndex
+ * 		 sensor index, same index used in initializing the ultrasonics array
+ * [Return]: uint16_t
+ * 			 distance in cm or ULTRASONIC_OUT_OF_RANGE
+ */
+uint16_t ULTRASONIC_readDistance(uint8_t a_ultrasonicIndex);
+
+#endif /* ULTRASONICS_USED_COUNT == 1 */
+
+/*
+ * [Function Name]: ULTRASONIC_isBusy
+ * [Function Description]: checks if a measurement or the round robin is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t ULTRASONIC_isBusy(void);
 
 #endif /* __ULTRASONIC_H__ */
@@ -88,5 +88,19 @@
 #define ENABLE_GLOBAL_INTERRUPT()  __asm__ __volatile__ ("sei" ::)
 #define DISABLE_GLOBAL_INTERRUPT()  __asm__ __volatile__ ("cli" ::)
 
+/* Critical sections, the status register (SREG at 0x5F in all supported mcus)
+ * is saved on enter and restored on exit, so they can be used with
+ * interrupts disabled or enabled */
+#define ENTER_CRITICAL_SECTION(sreg)  do { (sreg) = (*(volatile uint8_t*)(0x5F)); DISABLE_GLOBAL_INTERRUPT(); } while(0)
+#define EXIT_CRITICAL_SECTION(sreg)  ((*(volatile uint8_t*)(0x5F)) = (sreg))
+
+/* Constant tables stored in flash only, read directly by avr-gcc if it supports
+ * the __flash address space, otherwise they are normal constants */
+#ifdef __FLASH
+#define FLASH_CONST		const __flash
+#else
+#define FLASH_CONST		const
+#endif /* __FLASH */
+
 
 #endif /* __COMMON_H__*/
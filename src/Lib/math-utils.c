@@ -0,0 +1,60 @@
+/******************************************************************************
+ *
+ * Module: MATH UTILS
+ *
+ * File Name: math-utils.c
+ *
+ * Description: Source file for the integer math helpers shared by the drivers
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "math-utils.h"
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: MATH_squareRoot
+ * [Function Description]: calculates the integer square root bit by bit without
+ * 						   multiplications or divisions
+ * [Args]:
+ * [in]: uint32_t a_value
+ * 		 the value to get its square root
+ * [Return]: uint16_t
+ * 			 the square root rounded down
+ */
+uint16_t MATH_squareRoot(uint32_t a_value)
+{
+	uint32_t root = 0;
+	uint32_t bit = (uint32_t)1 << 30;
+
+	/* bit by bit, from the highest power of 4 not greater than the value */
+	while(bit > a_value)
+	{
+		bit >>= 2;
+	}
+
+	while(bit != 0)
+	{
+		if(a_value >= root + bit)
+		{
+			a_value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint16_t)root;
+}
@@ -0,0 +1,39 @@
+/******************************************************************************
+ *
+ * Module: MATH UTILS
+ *
+ * File Name: math-utils.h
+ *
+ * Description: Header file for the integer math helpers shared by the drivers
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __MATH_UTILS_H__
+#define __MATH_UTILS_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* For using std types */
+#include "types.h"
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: MATH_squareRoot
+ * [Function Description]: calculates the integer square root bit by bit without
+ * 						   multiplications or divisions
+ * [Args]:
+ * [in]: uint32_t a_value
+ * 		 the value to get its square root
+ * [Return]: uint16_t
+ * 			 the square root rounded down
+ */
+uint16_t MATH_squareRoot(uint32_t a_value);
+
+#endif /* __MATH_UTILS_H__ */
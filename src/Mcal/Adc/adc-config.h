@@ -20,4 +20,50 @@
 /* ADC Reference voltage */
 #define ADC_REF_VOLT_VALUE   							5
 
+/* if ADC_SLEEP_READ_ENABLED = 1, ADC_readChannelSleep() is supported, it converts
+ * in the adc noise reduction sleep mode using the POWER driver
+ */
+#define ADC_SLEEP_READ_ENABLED   						1
+
+/* if ADC_OVERSAMPLING_ENABLED = 1, the oversampling scan is supported, it converts
+ * a list of channels continuously from the adc interrupt, 4^n conversions are
+ * summed for each channel then shifted right by n to get n extra bits.
+ * Each conversion takes 13 adc clocks, i.e. 9615 conversions per second with
+ * the adc clock of 125KHz, so each channel is updated every
+ * (4^n * ADC_OVERSAMPLING_CHANNELS_COUNT) / 9615 seconds:
+ * n = 0 => 10 bits, 9615 results per second
+ * n = 1 => 11 bits, 2404 results per second
+ * n = 2 => 12 bits, 601 results per second
+ * n = 3 => 13 bits, 150 results per second
+ * (calculated for one channel, not measured). The extra bits are valid only
+ * if the input has noise of at least 1 lsb
+ */
+#define ADC_OVERSAMPLING_ENABLED   						1
+
+#if ADC_OVERSAMPLING_ENABLED == 1
+
+/* number of channels in the oversampling scan, from 1 to 8 */
+#define ADC_OVERSAMPLING_CHANNELS_COUNT   				2
+
+#endif /* ADC_OVERSAMPLING_ENABLED == 1 */
+
+/* if ADC_FAST_8_BIT_ENABLED = 1, ADC_readChannelFast8() and ADC_captureBurstFast8()
+ * are supported, they read the 8 most significant bits only, so the adc clock can
+ * be set up to 1MHz by ADC_setPrescaler(), i.e. 76.9K samples per second in a burst
+ */
+#define ADC_FAST_8_BIT_ENABLED   						1
+
+/* if ADC_WATCH_ENABLED = 1, the results of the adc interrupt (free running,
+ * auto trigger or oversampling scan) are compared with low and high thresholds
+ * in the interrupt, and a callback is called when a threshold is crossed
+ */
+#define ADC_WATCH_ENABLED   							1
+
+#if ADC_WATCH_ENABLED == 1
+
+/* number of watched channels, from 1 to 8 */
+#define ADC_WATCH_CHANNELS_COUNT   						2
+
+#endif /* ADC_WATCH_ENABLED == 1 */
+
 #endif /* __ADC_CONFIG_H__ */
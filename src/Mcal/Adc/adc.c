@@ -20,6 +20,53 @@
 /* For using mcu registers */
 #include "../Mcu/mcu.h"
 
+#if ADC_SLEEP_READ_ENABLED == 1
+
+/* For entering the adc noise reduction mode */
+#include "../Power/power.h"
+
+#endif /* ADC_SLEEP_READ_ENABLED == 1 */
+
+#if ADC_WATCH_ENABLED == 1
+
+/* For driving the shutdown pins */
+#include "../Dio/dio.h"
+
+#endif /* ADC_WATCH_ENABLED == 1 */
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: ADC_clearTriggerFlag
+ * [Function Description]: clears the interrupt flag of the auto trigger source if its
+ * 						   interrupt isn't enabled, as a conversion is triggered only on
+ * 						   the rising edge of the flag and no other isr clears it
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void ADC_clearTriggerFlag(void);
+
+#if ADC_WATCH_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_watchProcessing
+ * [Function Description]: called from the adc interrupt with each result, it compares the
+ * 						   result with the thresholds of the watched channels, drives the
+ * 						   shutdown pin and calls the callback when the state changes
+ * [Args]:
+ * [in]: uint8_t a_channelNum
+ * 		 the converted channel number
+ * [in]: uint16_t a_value
+ * 		 the result
+ * [Return]: void
+ */
+static void ADC_watchProcessing(uint8_t a_channelNum, uint16_t a_value);
+
+#endif /* ADC_WATCH_ENABLED == 1 */
+
 /*******************************************************************************
  *                         Global Variables                             	   *
  *******************************************************************************/
@@ -30,6 +77,57 @@ volatile uint16_t g_adcResult;
 /* pointer to the callback function */
 static void (* volatile g_adcInterruptHandler)(void) = NULL;
 
+#if ADC_SLEEP_READ_ENABLED == 1
+
+/* set while ADC_readChannelSleep() waits for its conversion, the isr stores
+ * the result in g_sleepConversionResult and clears it instead of calling the callback
+ */
+static volatile uint8_t g_isSleepConversionRunning = FALSE;
+static volatile uint16_t g_sleepConversionResult;
+
+#endif /* ADC_SLEEP_READ_ENABLED == 1 */
+
+#if ADC_OVERSAMPLING_ENABLED == 1
+
+#if ADC_OVERSAMPLING_CHANNELS_COUNT < 1 || ADC_OVERSAMPLING_CHANNELS_COUNT > 8
+#error "ADC_OVERSAMPLING_CHANNELS_COUNT must be from 1 to 8"
+#endif
+
+/* the channels of the oversampling scan */
+static ST_AdcOversamplingChannel g_oversamplingChannels[ADC_OVERSAMPLING_CHANNELS_COUNT];
+
+/* set while the oversampling scan is running */
+static volatile uint8_t g_isOversamplingRunning = FALSE;
+
+/* index of the channel being converted, its sum and number of conversions summed */
+static uint8_t g_oversamplingChannelIndex;
+static uint16_t g_oversamplingSum;
+static uint8_t g_oversamplingCount;
+
+/* last result of each channel and its state from ADC_RESULT_NONE, ADC_RESULT_NEW or ADC_RESULT_OLD */
+static volatile uint16_t g_oversamplingResults[ADC_OVERSAMPLING_CHANNELS_COUNT];
+static volatile uint8_t g_oversamplingResultsState[ADC_OVERSAMPLING_CHANNELS_COUNT];
+
+#endif /* ADC_OVERSAMPLING_ENABLED == 1 */
+
+#if ADC_WATCH_ENABLED == 1
+
+#if ADC_WATCH_CHANNELS_COUNT < 1 || ADC_WATCH_CHANNELS_COUNT > 8
+#error "ADC_WATCH_CHANNELS_COUNT must be from 1 to 8"
+#endif
+
+/* the watched channels and their states from EN_AdcWatchState */
+static ST_AdcWatch g_watches[ADC_WATCH_CHANNELS_COUNT];
+static volatile uint8_t g_watchesState[ADC_WATCH_CHANNELS_COUNT];
+
+/* set after ADC_watchInit() is called */
+static volatile uint8_t g_isWatchEnabled = FALSE;
+
+/* pointer to the watch callback function */
+static void (* volatile g_watchCallback)(uint8_t a_watchIndex, uint8_t a_state) = NULL;
+
+#endif /* ADC_WATCH_ENABLED == 1 */
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -116,6 +214,95 @@ uint16_t ADC_readChannelPolling(uint8_t a_channelPin)
 	return ADC_R;
 }
 
+#if ADC_SLEEP_READ_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_readChannelSleep
+ * [Function Description]: responsible for read analog data from a certain ADC channel
+ * 						   while the cpu sleeps in the adc noise reduction mode, so the
+ * 						   cpu and the io pins don't add noise to the result.
+ * 						   The cpu wakes up by the adc interrupt, the callback isn't called
+ * 						   for this conversion. The io clock is stopped during the conversion,
+ * 						   so timer 0, timer 1, uart and spi are paused. If another interrupt
+ * 						   wakes the cpu first, the conversion completes in idle mode.
+ * 						   It waits for a running interrupt conversion first, and it uses
+ * 						   ADC_readChannelPolling() if global interrupts are disabled or
+ * 						   the auto trigger source is enabled. It can't be used while the
+ * 						   oversampling scan is running
+ * [Args]:
+ * [in]: uint8_t a_channelPin
+ * 		 from PA0 to PA7
+ * 		 or, any other 5-bit value (differential input) look datasheet
+ * [Return]: uint16_t
+ * 			 the adc value, or ADC_READ_ERROR if the oversampling scan is running
+ */
+uint16_t ADC_readChannelSleep(uint8_t a_channelPin)
+{
+	uint8_t isInterruptEnabled;
+
+#if ADC_OVERSAMPLING_ENABLED == 1
+	/* the scan starts the next conversion from the isr after each result,
+	 * so the adc never becomes free for this conversion */
+	if(g_isOversamplingRunning == TRUE)
+	{
+		return ADC_READ_ERROR;
+	}
+#endif /* ADC_OVERSAMPLING_ENABLED == 1 */
+
+	/* the cpu can't be woken up, or the conversions aren't started manually */
+	if(BIT_IS_CLEAR(SREG_R, I_BIT) || BIT_IS_SET(ADCSRA_R, ADATE))
+	{
+		return ADC_readChannelPolling(a_channelPin);
+	}
+
+	/* wait for a running interrupt conversion to complete and call its callback,
+	 * the callback may start another conversion
+	 */
+	while(1)
+	{
+		DISABLE_GLOBAL_INTERRUPT();
+		if(BIT_IS_CLEAR(ADCSRA_R, ADSC) && (BIT_IS_CLEAR(ADCSRA_R, ADIF) || BIT_IS_CLEAR(ADCSRA_R, ADIE)))
+		{
+			break;
+		}
+		ENABLE_GLOBAL_INTERRUPT();
+	}
+
+	/* clear the flag of an old conversion without interrupt by write '1' to it */
+	SET_BIT(ADCSRA_R, ADIF);
+
+	/* modify the first 5 bits in ADMUX_R to match the channel number */
+	COPY_BITS(ADMUX_R, 0b00011111, GET_PIN_NO(a_channelPin), MUX0);
+
+	/* the adc interrupt is needed to wake the cpu */
+	isInterruptEnabled = BIT_IS_SET(ADCSRA_R, ADIE);
+	SET_BIT(ADCSRA_R, ADIE);
+	g_isSleepConversionRunning = TRUE;
+
+	/* the conversion starts when the mode is entered */
+	POWER_enterMode(POWER_MODE_ADC_NOISE_REDUCTION);
+
+	/* woken up by another interrupt, entering the adc noise reduction mode again
+	 * would start a new conversion if this one completes just before sleeping
+	 */
+	DISABLE_GLOBAL_INTERRUPT();
+	while(g_isSleepConversionRunning == TRUE)
+	{
+		POWER_idle();
+		DISABLE_GLOBAL_INTERRUPT();
+	}
+
+	if(!isInterruptEnabled)
+	{
+		CLEAR_BIT(ADCSRA_R, ADIE);
+	}
+	ENABLE_GLOBAL_INTERRUPT();
+
+	return g_sleepConversionResult;
+}
+
+#endif /* ADC_SLEEP_READ_ENABLED == 1 */
+
 /*
  * [Function Name]: ADC_readChannelPolling
  * [Function Description]: responsible for read analog data from a certain ADC channel
@@ -147,6 +334,23 @@ void ADC_readChannelInterrupt(uint8_t a_channelPin)
 	SET_BIT(ADCSRA_R, ADSC);
 }
 
+/*
+ * [Function Name]: ADC_selectChannel
+ * [Function Description]: selects the channel of the next conversion without starting it,
+ * 						   used with the auto trigger source, i.e. from the callback to
+ * 						   convert another channel on the next trigger
+ * [Args]:
+ * [in]: uint8_t a_channelPin
+ * 		 from PA0 to PA7
+ * 		 or, any other 5-bit value (differential input) look datasheet
+ * [Return]: void
+ */
+void ADC_selectChannel(uint8_t a_channelPin)
+{
+	/* modify the first 5 bits in ADMUX_R to match the channel number */
+	COPY_BITS(ADMUX_R, 0b00011111, GET_PIN_NO(a_channelPin), MUX0);
+}
+
 /*
  * [Function Name]: ADC_readChannelPolling
  * [Function Description]: used to assign the callback function when the adc interrupt occurs
@@ -166,7 +370,9 @@ void ADC_setCallBack(void (* volatile a_handler_Ptr)(void))
  * [Function Name]: ADC_enableAutoTriggerSource
  * [Function Description]: used to enable auto trigger source, ADC conversions occur when the selected source
  * 						   happens, you can return to the default settings of manually starting the conversion
- * 						   at any time by calling ADC_disableAutoTriggerSource, or re-init the adc
+ * 						   at any time by calling ADC_disableAutoTriggerSource, or re-init the adc.
+ * 						   With the adc interrupt on, the flag of the source is cleared in the adc
+ * 						   interrupt if its own interrupt is disabled, so it triggers again
  * [Args]:
  * [in]: ADC_AutoTriggerSource a_autoTriggerSource
  * 		 pointer to interrupt handler function
@@ -195,12 +401,513 @@ void ADC_disableAutoTriggerSource(void)
 	CLEAR_BIT(ADCSRA_R, ADATE);
 }
 
+/*
+ * [Function Name]: ADC_setPrescaler
+ * [Function Description]: changes the adc clock prescaler after init, i.e. to use a faster
+ * 						   clock for the 8-bit fast functions then return to the normal clock,
+ * 						   it mustn't be called while a conversion is running
+ * [Args]:
+ * [in]: EN_AdcPrescaler a_prescaler
+ * 		 adc prescaler clock value
+ * [Return]: void
+ */
+void ADC_setPrescaler(EN_AdcPrescaler a_prescaler)
+{
+	COPY_BITS(ADCSRA_R, 0b00000111, a_prescaler, ADPS0);
+}
+
+#if ADC_FAST_8_BIT_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_readChannelFast8
+ * [Function Description]: responsible for read the 8 most significant bits of a certain
+ * 						   ADC channel, the result is left adjusted so only ADCH is read.
+ * 						   It's a busy wait function same as ADC_readChannelPolling()
+ * [Args]:
+ * [in]: uint8_t a_channelPin
+ * 		 from PA0 to PA7
+ * 		 or, any other 5-bit value (differential input) look datasheet
+ * [Return]: uint8_t
+ * 			 the 8-bit adc value
+ */
+uint8_t ADC_readChannelFast8(uint8_t a_channelPin)
+{
+	uint8_t result, isInterruptEnabled = 0;
+
+	/* modify the first 5 bits in ADMUX_R to match the channel number
+	 * and left adjust the result, ADLAR = 1
+	 */
+	COPY_BITS(ADMUX_R, 0b00011111, GET_PIN_NO(a_channelPin), MUX0);
+	SET_BIT(ADMUX_R, ADLAR);
+
+	/* check if the interrupt is enabled to disable it temporarly */
+	if(BIT_IS_SET(ADCSRA_R, ADIE))
+	{
+		isInterruptEnabled = 1;
+		CLEAR_BIT(ADCSRA_R, ADIE);
+	}
+
+	/* Start conversion write '1' to ADSC */
+	SET_BIT(ADCSRA_R, ADSC);
+
+	/* Wait for conversion to complete, ADIF becomes 1 */
+	while(BIT_IS_CLEAR(ADCSRA_R, ADIF));
+
+	/* Clear ADIF by write '1' to it */
+	SET_BIT(ADCSRA_R, ADIF);
+
+	/* the 8 most significant bits */
+	result = ADCH_R;
+
+	/* return to the right adjusted result used by the other functions */
+	CLEAR_BIT(ADMUX_R, ADLAR);
+
+	/* re-enable the interrupt if it was enabled before calling the function */
+	if(isInterruptEnabled)
+	{
+		SET_BIT(ADCSRA_R, ADIE);
+	}
+
+	return result;
+}
+
+/*
+ * [Function Name]: ADC_captureBurstFast8
+ * [Function Description]: captures a burst of 8-bit samples from a certain ADC channel in the
+ * 						   free running mode, a sample is taken every 13 adc clocks.
+ * 						   It's a busy wait function, it returns when the buffer is full.
+ * 						   Interrupts that take longer than one conversion make
+ * 						   samples get lost, so they can be disabled during the burst.
+ * 						   The adc interrupt and the auto trigger source are disabled
+ * 						   temporarily
+ * [Args]:
+ * [in]: uint8_t a_channelPin
+ * 		 from PA0 to PA7
+ * 		 or, any other 5-bit value (differential input) look datasheet
+ * [out]: uint8_t * a_samples
+ * 		  array to store the samples in
+ * [in]: uint16_t a_samplesCount
+ * 		 number of samples to capture
+ * [Return]: void
+ */
+void ADC_captureBurstFast8(uint8_t a_channelPin, uint8_t * a_samples, uint16_t a_samplesCount)
+{
+	uint16_t loopCounter;
+	uint8_t adcsra = ADCSRA_R, sfior = SFIOR_R;
+
+	if(a_samplesCount == 0)
+	{
+		return;
+	}
+
+	/* modify the first 5 bits in ADMUX_R to match the channel number
+	 * and left adjust the result, ADLAR = 1
+	 */
+	COPY_BITS(ADMUX_R, 0b00011111, GET_PIN_NO(a_channelPin), MUX0);
+	SET_BIT(ADMUX_R, ADLAR);
+
+	/* disable the interrupt, select the free running mode and start the first conversion */
+	CLEAR_BIT(ADCSRA_R, ADIE);
+	COPY_BITS(SFIOR_R, 0b00000111, ADC_ATC_FREE_RUNNING_MODE, ADTS0);
+	SET_BIT(ADCSRA_R, ADATE);
+	SET_BIT(ADCSRA_R, ADSC);
+
+	for(loopCounter = 0; loopCounter < a_samplesCount; loopCounter ++)
+	{
+		/* Wait for conversion to complete, then clear ADIF by write '1' to it,
+		 * the next conversion is already running
+		 */
+		while(BIT_IS_CLEAR(ADCSRA_R, ADIF));
+		SET_BIT(ADCSRA_R, ADIF);
+
+		a_samples[loopCounter] = ADCH_R;
+	}
+
+	/* stop the free running mode and drop the last running conversion */
+	CLEAR_BIT(ADCSRA_R, ADATE);
+	while(BIT_IS_SET(ADCSRA_R, ADSC));
+	SET_BIT(ADCSRA_R, ADIF);
+
+	/* return to the right adjusted result and the previous trigger settings */
+	CLEAR_BIT(ADMUX_R, ADLAR);
+	COPY_BITS(SFIOR_R, 0b00000111, sfior >> ADTS0, ADTS0);
+	COPY_BITS(ADCSRA_R, 0b00000001, BIT_IS_SET(adcsra, ADATE) ? 1 : 0, ADATE);
+	COPY_BITS(ADCSRA_R, 0b00000001, BIT_IS_SET(adcsra, ADIE) ? 1 : 0, ADIE);
+}
+
+#endif /* ADC_FAST_8_BIT_ENABLED == 1 */
+
+#if ADC_OVERSAMPLING_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_oversamplingStart
+ * [Function Description]: starts converting the channels continuously from the adc interrupt,
+ * 						   the channels are converted in their order and each channel is
+ * 						   converted 4^n times before moving to the next one.
+ * 						   Global interrupts must be enabled, and the other read functions
+ * 						   and the auto trigger source mustn't be used till
+ * 						   ADC_oversamplingStop() is called, ADC_readChannelSleep()
+ * 						   returns ADC_READ_ERROR meanwhile
+ * [Args]:
+ * [in]: const ST_AdcOversamplingChannel * a_channels
+ * 		 array of ADC_OVERSAMPLING_CHANNELS_COUNT channels
+ * [Return]: void
+ */
+void ADC_oversamplingStart(const ST_AdcOversamplingChannel * a_channels)
+{
+	uint8_t loopCounter;
+
+	ADC_oversamplingStop();
+
+	for(loopCounter = 0; loopCounter < ADC_OVERSAMPLING_CHANNELS_COUNT; loopCounter ++)
+	{
+		g_oversamplingChannels[loopCounter] = a_channels[loopCounter];
+		if(g_oversamplingChannels[loopCounter].extraBits > ADC_OVERSAMPLING_MAX_EXTRA_BITS)
+		{
+			g_oversamplingChannels[loopCounter].extraBits = ADC_OVERSAMPLING_MAX_EXTRA_BITS;
+		}
+		g_oversamplingResultsState[loopCounter] = ADC_RESULT_NONE;
+	}
+
+	g_oversamplingChannelIndex = 0;
+	g_oversamplingSum = 0;
+	g_oversamplingCount = 0;
+	g_isOversamplingRunning = TRUE;
+
+	/* modify the first 5 bits in ADMUX_R to match the first channel number */
+	COPY_BITS(ADMUX_R, 0b00011111, GET_PIN_NO(g_oversamplingChannels[0].channelPin), MUX0);
+
+	/* enable the interrupt and start the first conversion */
+	SET_BIT(ADCSRA_R, ADIE);
+	SET_BIT(ADCSRA_R, ADSC);
+}
+
+/*
+ * [Function Name]: ADC_oversamplingStop
+ * [Function Description]: stops the oversampling scan after the running conversion,
+ * 						   the last results can still be read
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void ADC_oversamplingStop(void)
+{
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+
+	if(g_isOversamplingRunning == TRUE)
+	{
+		g_isOversamplingRunning = FALSE;
+
+		/* wait for the running conversion and drop it, so it doesn't call the callback */
+		while(BIT_IS_SET(ADCSRA_R, ADSC));
+		SET_BIT(ADCSRA_R, ADIF);
+	}
+
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: ADC_oversamplingGetResult
+ * [Function Description]: gets the last oversampled result of a channel, from 0 to
+ * 						   ADC_OVERSAMPLED_MAXIMUM_VALUE(extraBits) of the channel
+ * [Args]:
+ * [in]: uint8_t a_channelIndex
+ * 		 index of the channel in the channels array
+ * [out]: uint16_t * a_result
+ * 		  pointer to store the result in
+ * [Return]: uint8_t
+ * 			 ADC_RESULT_NEW if it wasn't read before, ADC_RESULT_OLD if it was read before,
+ * 			 or ADC_RESULT_NONE if there is no result yet or the index is out of the array
+ */
+uint8_t ADC_oversamplingGetResult(uint8_t a_channelIndex, uint16_t * a_result)
+{
+	uint8_t state;
+	uint8_t sreg;
+
+	if(a_channelIndex >= ADC_OVERSAMPLING_CHANNELS_COUNT)
+	{
+		return ADC_RESULT_NONE;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+	state = g_oversamplingResultsState[a_channelIndex];
+	if(state != ADC_RESULT_NONE)
+	{
+		*a_result = g_oversamplingResults[a_channelIndex];
+		g_oversamplingResultsState[a_channelIndex] = ADC_RESULT_OLD;
+	}
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return state;
+}
+
+#endif /* ADC_OVERSAMPLING_ENABLED == 1 */
+
+#if ADC_WATCH_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_watchInit
+ * [Function Description]: starts watching the channels, each result of the adc interrupt
+ * 						   of a watched channel is compared with its thresholds and the
+ * 						   callback is called from the interrupt when its state changes.
+ * 						   The shutdown pins are initialized as outputs at their inactive level
+ * [Args]:
+ * [in]: const ST_AdcWatch * a_watches
+ * 		 array of ADC_WATCH_CHANNELS_COUNT watched channels
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_watchIndex, uint8_t a_state)
+ * 		 function called with the index of the channel and its new state
+ * 		 from EN_AdcWatchState, can be NULL
+ * [Return]: void
+ */
+void ADC_watchInit(const ST_AdcWatch * a_watches, void (* volatile a_ptrToCallback)(uint8_t a_watchIndex, uint8_t a_state))
+{
+	uint8_t loopCounter;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+
+	for(loopCounter = 0; loopCounter < ADC_WATCH_CHANNELS_COUNT; loopCounter ++)
+	{
+		g_watches[loopCounter] = a_watches[loopCounter];
+		g_watchesState[loopCounter] = ADC_WATCH_IN_RANGE;
+
+		if(g_watches[loopCounter].shutdownPin != ADC_WATCH_NO_PIN)
+		{
+			/* the inactive level is written first, or the pin would be driven
+			 * low when it becomes an output */
+			DIO_writePin(g_watches[loopCounter].shutdownPin, (g_watches[loopCounter].shutdownLevel == HIGH) ? LOW : HIGH);
+			DIO_pinInit(g_watches[loopCounter].shutdownPin, PIN_OUTPUT);
+		}
+	}
+	g_watchCallback = a_ptrToCallback;
+	g_isWatchEnabled = TRUE;
+
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: ADC_watchGetState
+ * [Function Description]: gets the state of a watched channel
+ * [Args]:
+ * [in]: uint8_t a_watchIndex
+ * 		 index of the channel in the watched channels array
+ * [Return]: uint8_t
+ * 			 the state from EN_AdcWatchState
+ */
+uint8_t ADC_watchGetState(uint8_t a_watchIndex)
+{
+	if(a_watchIndex >= ADC_WATCH_CHANNELS_COUNT)
+	{
+		return ADC_WATCH_IN_RANGE;
+	}
+	return g_watchesState[a_watchIndex];
+}
+
+/*
+ * [Function Name]: ADC_watchProcessing
+ * [Function Description]: called from the adc interrupt with each result, it compares the
+ * 						   result with the thresholds of the watched channels, drives the
+ * 						   shutdown pin and calls the callback when the state changes
+ * [Args]:
+ * [in]: uint8_t a_channelNum
+ * 		 the converted channel number
+ * [in]: uint16_t a_value
+ * 		 the result
+ * [Return]: void
+ */
+static void ADC_watchProcessing(uint8_t a_channelNum, uint16_t a_value)
+{
+	uint8_t loopCounter, state;
+	ST_AdcWatch * watch;
+
+	for(loopCounter = 0; loopCounter < ADC_WATCH_CHANNELS_COUNT; loopCounter ++)
+	{
+		watch = &g_watches[loopCounter];
+		if(GET_PIN_NO(watch->channelPin) != a_channelNum)
+		{
+			continue;
+		}
+
+		state = g_watchesState[loopCounter];
+		switch(state)
+		{
+		case ADC_WATCH_ABOVE_HIGH:
+			if(a_value + watch->hysteresis < watch->highThreshold)
+			{
+				state = ADC_WATCH_IN_RANGE;
+			}
+			break;
+		case ADC_WATCH_BELOW_LOW:
+			if(a_value > watch->lowThreshold + watch->hysteresis)
+			{
+				state = ADC_WATCH_IN_RANGE;
+			}
+			break;
+		default:
+			break;
+		}
+
+		/* a value can cross from one side to the other directly */
+		if(state == ADC_WATCH_IN_RANGE)
+		{
+			if(a_value > watch->highThreshold)
+			{
+				state = ADC_WATCH_ABOVE_HIGH;
+			}
+			else if(a_value < watch->lowThreshold)
+			{
+				state = ADC_WATCH_BELOW_LOW;
+			}
+		}
+
+		if(state == g_watchesState[loopCounter])
+		{
+			continue;
+		}
+		g_watchesState[loopCounter] = state;
+
+		/* shut down first, the callback may take longer */
+		if(state != ADC_WATCH_IN_RANGE && watch->shutdownPin != ADC_WATCH_NO_PIN)
+		{
+			DIO_writePin(watch->shutdownPin, watch->shutdownLevel);
+		}
+
+		if(g_watchCallback != NULL)
+		{
+			(*g_watchCallback)(loopCounter, state);
+		}
+	}
+}
+
+#endif /* ADC_WATCH_ENABLED == 1 */
+
+/*
+ * [Function Name]: ADC_clearTriggerFlag
+ * [Function Description]: clears the interrupt flag of the auto trigger source if its
+ * 						   interrupt isn't enabled, as a conversion is triggered only on
+ * 						   the rising edge of the flag and no other isr clears it
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void ADC_clearTriggerFlag(void)
+{
+	/* the flags are cleared by writing 1 */
+	switch((SFIOR_R >> ADTS0) & 0b00000111)
+	{
+	case ADC_ATC_FREE_EXT_INT_0:
+		if(BIT_IS_CLEAR(GICR_R, INT0))
+		{
+			GIFR_R = SELECT_BIT(INTF0);
+		}
+		break;
+	case ADC_ATC_FREE_TIMER_0_CTC:
+		if(BIT_IS_CLEAR(TIMSK_R, OCIE0))
+		{
+			TIFR_R = SELECT_BIT(OCF0);
+		}
+		break;
+	case ADC_ATC_FREE_TIMER_0_OVF:
+		if(BIT_IS_CLEAR(TIMSK_R, TOIE0))
+		{
+			TIFR_R = SELECT_BIT(TOV0);
+		}
+		break;
+	case ADC_ATC_FREE_TIMER_1_CTCB:
+		if(BIT_IS_CLEAR(TIMSK_R, OCIE1B))
+		{
+			TIFR_R = SELECT_BIT(OCF1B);
+		}
+		break;
+	case ADC_ATC_FREE_TIMER_1_OVF:
+		if(BIT_IS_CLEAR(TIMSK_R, TOIE1))
+		{
+			TIFR_R = SELECT_BIT(TOV1);
+		}
+		break;
+	case ADC_ATC_FREE_TIMER_1_ICU:
+		if(BIT_IS_CLEAR(TIMSK_R, TICIE1))
+		{
+			TIFR_R = SELECT_BIT(ICF1);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
 /* ADC ISR */
 ISR(ADC_vect)
 {
+	/* re-arm the auto trigger source for the next conversion */
+	if(BIT_IS_SET(ADCSRA_R, ADATE))
+	{
+		ADC_clearTriggerFlag();
+	}
+
+#if ADC_SLEEP_READ_ENABLED == 1
+	/* the conversion of ADC_readChannelSleep() */
+	if(g_isSleepConversionRunning == TRUE)
+	{
+		g_sleepConversionResult = ADC_R;
+		g_isSleepConversionRunning = FALSE;
+		return;
+	}
+#endif /* ADC_SLEEP_READ_ENABLED == 1 */
+
+#if ADC_OVERSAMPLING_ENABLED == 1
+	if(g_isOversamplingRunning == TRUE)
+	{
+		g_oversamplingSum += ADC_R;
+		g_oversamplingCount ++;
+
+		/* 4^n conversions are summed, the sum of 64 conversions fits in 16 bits */
+		if(g_oversamplingCount == (1 << (g_oversamplingChannels[g_oversamplingChannelIndex].extraBits << 1)))
+		{
+			g_oversamplingResults[g_oversamplingChannelIndex] = \
+					g_oversamplingSum >> g_oversamplingChannels[g_oversamplingChannelIndex].extraBits;
+			g_oversamplingResultsState[g_oversamplingChannelIndex] = ADC_RESULT_NEW;
+
+#if ADC_WATCH_ENABLED == 1
+			if(g_isWatchEnabled == TRUE)
+			{
+				ADC_watchProcessing(GET_PIN_NO(g_oversamplingChannels[g_oversamplingChannelIndex].channelPin), \
+						g_oversamplingResults[g_oversamplingChannelIndex]);
+			}
+#endif /* ADC_WATCH_ENABLED == 1 */
+
+			g_oversamplingSum = 0;
+			g_oversamplingCount = 0;
+
+			/* move to the next channel */
+			g_oversamplingChannelIndex ++;
+			if(g_oversamplingChannelIndex == ADC_OVERSAMPLING_CHANNELS_COUNT)
+			{
+				g_oversamplingChannelIndex = 0;
+			}
+			COPY_BITS(ADMUX_R, 0b00011111, \
+					GET_PIN_NO(g_oversamplingChannels[g_oversamplingChannelIndex].channelPin), MUX0);
+		}
+
+		/* start the next conversion */
+		SET_BIT(ADCSRA_R, ADSC);
+		return;
+	}
+#endif /* ADC_OVERSAMPLING_ENABLED == 1 */
+
 	/* Read ADC Data after conversion complete */
 	g_adcResult = ADC_R;
 
+#if ADC_WATCH_ENABLED == 1
+	/* the mux holds the channel of the completed conversion till it's changed */
+	if(g_isWatchEnabled == TRUE)
+	{
+		ADC_watchProcessing(ADMUX_R & 0b00011111, g_adcResult);
+	}
+#endif /* ADC_WATCH_ENABLED == 1 */
+
 	/* excute the callback function if not null */
 	if(g_adcInterruptHandler != NULL)
 	{
@@ -33,6 +33,39 @@
 /* maximum value of the 10-bit adc */
 #define ADC_MAXIMUM_VALUE    							1023
 
+#if ADC_SLEEP_READ_ENABLED == 1
+
+/* returned from ADC_readChannelSleep() while the oversampling scan is running */
+#define ADC_READ_ERROR    								0xFFFF
+
+#endif /* ADC_SLEEP_READ_ENABLED == 1 */
+
+#if ADC_OVERSAMPLING_ENABLED == 1
+
+/* maximum number of extra bits of the oversampling */
+#define ADC_OVERSAMPLING_MAX_EXTRA_BITS    				3
+
+/* returned from ADC_oversamplingGetResult() */
+#define ADC_RESULT_NONE    								0
+#define ADC_RESULT_NEW    								1
+#define ADC_RESULT_OLD    								2
+
+#endif /* ADC_OVERSAMPLING_ENABLED == 1 */
+
+#if ADC_WATCH_ENABLED == 1
+
+/* used as the shutdown pin of a watched channel that doesn't drive a pin */
+#define ADC_WATCH_NO_PIN    							0xFF
+
+#endif /* ADC_WATCH_ENABLED == 1 */
+
+/*******************************************************************************
+ *                                Macros                                       *
+ *******************************************************************************/
+
+/* maximum value of an oversampled result with the passed extra bits */
+#define ADC_OVERSAMPLED_MAXIMUM_VALUE(extraBits)		((uint16_t)ADC_MAXIMUM_VALUE << (extraBits))
+
 /*******************************************************************************
  *                             External Variables                              *
  *******************************************************************************/
@@ -65,7 +98,8 @@ typedef enum
 /*
  * [Enum Name]: EN_AdcPrescaler
  * [Enum Description]: contains adc prescaler clock options used to operate the adc,
- * 					   ADC must operate in range 50-200Khz
+ * 					   ADC must operate in range 50-200Khz for the full 10-bit resolution,
+ * 					   up to 1MHz is acceptable for the 8-bit fast functions
  */
 typedef enum
 {
@@ -120,6 +154,78 @@ typedef struct
 	EN_AdcInterruptMode a_interruptMode;
 }ST_AdcConfig;
 
+#if ADC_OVERSAMPLING_ENABLED == 1
+
+/*
+ * [Struct Name]: ST_AdcOversamplingChannel
+ * [Struct Description]: contains a channel in the oversampling scan
+ */
+typedef struct
+{
+	/* from PA0 to PA7, or any other 5-bit value (differential input) look datasheet */
+	uint8_t channelPin;
+
+	/* extra bits n from 0 to ADC_OVERSAMPLING_MAX_EXTRA_BITS, 4^n conversions are summed */
+	uint8_t extraBits;
+
+}ST_AdcOversamplingChannel;
+
+#endif /* ADC_OVERSAMPLING_ENABLED == 1 */
+
+#if ADC_WATCH_ENABLED == 1
+
+/*
+ * [Enum Name]: EN_AdcWatchState
+ * [Enum Description]: contains the states of a watched channel, the state changes
+ * 					   are the events passed to the watch callback
+ */
+typedef enum
+{
+	/* the value is between the thresholds */
+	ADC_WATCH_IN_RANGE,
+
+	/* the value went above the high threshold */
+	ADC_WATCH_ABOVE_HIGH,
+
+	/* the value went below the low threshold */
+	ADC_WATCH_BELOW_LOW
+}EN_AdcWatchState;
+
+/*
+ * [Struct Name]: ST_AdcWatch
+ * [Struct Description]: contains the thresholds of a watched channel, they are compared
+ * 						 with the results in the same units, i.e. oversampled results
+ * 						 in the oversampling scan
+ */
+typedef struct
+{
+	/* from PA0 to PA7 */
+	uint8_t channelPin;
+
+	/* the state becomes ADC_WATCH_BELOW_LOW when the value < lowThreshold */
+	uint16_t lowThreshold;
+
+	/* the state becomes ADC_WATCH_ABOVE_HIGH when the value > highThreshold */
+	uint16_t highThreshold;
+
+	/* the state returns to ADC_WATCH_IN_RANGE when the value < highThreshold - hysteresis
+	 * or > lowThreshold + hysteresis
+	 */
+	uint16_t hysteresis;
+
+	/* pin written to shutdownLevel from the interrupt when the value goes out of
+	 * range before calling the callback, it's not released when the value returns
+	 * to the range. ADC_WATCH_NO_PIN if not used
+	 */
+	uint8_t shutdownPin;
+
+	/* HIGH or LOW */
+	uint8_t shutdownLevel;
+
+}ST_AdcWatch;
+
+#endif /* ADC_WATCH_ENABLED == 1 */
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
@@ -152,6 +258,32 @@ void ADC_init(const ST_AdcConfig * a_adcConfig);
  */
 uint16_t ADC_readChannelPolling(uint8_t a_channelPin);
 
+#if ADC_SLEEP_READ_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_readChannelSleep
+ * [Function Description]: responsible for read analog data from a certain ADC channel
+ * 						   while the cpu sleeps in the adc noise reduction mode, so the
+ * 						   cpu and the io pins don't add noise to the result.
+ * 						   The cpu wakes up by the adc interrupt, the callback isn't called
+ * 						   for this conversion. The io clock is stopped during the conversion,
+ * 						   so timer 0, timer 1, uart and spi are paused. If another interrupt
+ * 						   wakes the cpu first, the conversion completes in idle mode.
+ * 						   It waits for a running interrupt conversion first, and it uses
+ * 						   ADC_readChannelPolling() if global interrupts are disabled or
+ * 						   the auto trigger source is enabled. It can't be used while the
+ * 						   oversampling scan is running
+ * [Args]:
+ * [in]: uint8_t a_channelPin
+ * 		 from PA0 to PA7
+ * 		 or, any other 5-bit value (differential input) look datasheet
+ * [Return]: uint16_t
+ * 			 the adc value, or ADC_READ_ERROR if the oversampling scan is running
+ */
+uint16_t ADC_readChannelSleep(uint8_t a_channelPin);
+
+#endif /* ADC_SLEEP_READ_ENABLED == 1 */
+
 /*
  * [Function Name]: ADC_readChannelPolling
  * [Function Description]: responsible for read analog data from a certain ADC channel
@@ -171,6 +303,19 @@ uint16_t ADC_readChannelPolling(uint8_t a_channelPin);
  */
 void ADC_readChannelInterrupt(uint8_t a_channelPin);
 
+/*
+ * [Function Name]: ADC_selectChannel
+ * [Function Description]: selects the channel of the next conversion without starting it,
+ * 						   used with the auto trigger source, i.e. from the callback to
+ * 						   convert another channel on the next trigger
+ * [Args]:
+ * [in]: uint8_t a_channelPin
+ * 		 from PA0 to PA7
+ * 		 or, any other 5-bit value (differential input) look datasheet
+ * [Return]: void
+ */
+void ADC_selectChannel(uint8_t a_channelPin);
+
 /*
  * [Function Name]: ADC_readChannelPolling
  * [Function Description]: used to assign the callback function when the adc interrupt occurs
@@ -187,7 +332,9 @@ void ADC_setCallBack(void (* volatile a_handler_Ptr)(void));
  * [Function Name]: ADC_enableAutoTriggerSource
  * [Function Description]: used to enable auto trigger source, ADC conversions occur when the selected source
  * 						   happens, you can return to the default settings of manually starting the conversion
- * 						   at any time by calling ADC_disableAutoTriggerSource, or re-init the adc
+ * 						   at any time by calling ADC_disableAutoTriggerSource, or re-init the adc.
+ * 						   With the adc interrupt on, the flag of the source is cleared in the adc
+ * 						   interrupt if its own interrupt is disabled, so it triggers again
  * [Args]:
  * [in]: EN_AdcAutoTriggerSource a_autoTriggerSource
  * 		 pointer to interrupt handler function
@@ -205,4 +352,131 @@ void ADC_enableAutoTriggerSource(EN_AdcAutoTriggerSource a_autoTriggerSource);
  */
 void ADC_disableAutoTriggerSource(void);
 
+/*
+ * [Function Name]: ADC_setPrescaler
+ * [Function Description]: changes the adc clock prescaler after init, i.e. to use a faster
+ * 						   clock for the 8-bit fast functions then return to the normal clock,
+ * 						   it mustn't be called while a conversion is running
+ * [Args]:
+ * [in]: EN_AdcPrescaler a_prescaler
+ * 		 adc prescaler clock value
+ * [Return]: void
+ */
+void ADC_setPrescaler(EN_AdcPrescaler a_prescaler);
+
+#if ADC_FAST_8_BIT_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_readChannelFast8
+ * [Function Description]: responsible for read the 8 most significant bits of a certain
+ * 						   ADC channel, the result is left adjusted so only ADCH is read.
+ * 						   It's a busy wait function same as ADC_readChannelPolling()
+ * [Args]:
+ * [in]: uint8_t a_channelPin
+ * 		 from PA0 to PA7
+ * 		 or, any other 5-bit value (differential input) look datasheet
+ * [Return]: uint8_t
+ * 			 the 8-bit adc value
+ */
+uint8_t ADC_readChannelFast8(uint8_t a_channelPin);
+
+/*
+ * [Function Name]: ADC_captureBurstFast8
+ * [Function Description]: captures a burst of 8-bit samples from a certain ADC channel in the
+ * 						   free running mode, a sample is taken every 13 adc clocks.
+ * 						   It's a busy wait function, it returns when the buffer is full.
+ * 						   Interrupts that take longer than one conversion make
+ * 						   samples get lost, so they can be disabled during the burst.
+ * 						   The adc interrupt and the auto trigger source are disabled
+ * 						   temporarily
+ * [Args]:
+ * [in]: uint8_t a_channelPin
+ * 		 from PA0 to PA7
+ * 		 or, any other 5-bit value (differential input) look datasheet
+ * [out]: uint8_t * a_samples
+ * 		  array to store the samples in
+ * [in]: uint16_t a_samplesCount
+ * 		 number of samples to capture
+ * [Return]: void
+ */
+void ADC_captureBurstFast8(uint8_t a_channelPin, uint8_t * a_samples, uint16_t a_samplesCount);
+
+#endif /* ADC_FAST_8_BIT_ENABLED == 1 */
+
+#if ADC_OVERSAMPLING_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_oversamplingStart
+ * [Function Description]: starts converting the channels continuously from the adc interrupt,
+ * 						   the channels are converted in their order and each channel is
+ * 						   converted 4^n times before moving to the next one.
+ * 						   Global interrupts must be enabled, and the other read functions
+ * 						   and the auto trigger source mustn't be used till
+ * 						   ADC_oversamplingStop() is called, ADC_readChannelSleep()
+ * 						   returns ADC_READ_ERROR meanwhile
+ * [Args]:
+ * [in]: const ST_AdcOversamplingChannel * a_channels
+ * 		 array of ADC_OVERSAMPLING_CHANNELS_COUNT channels
+ * [Return]: void
+ */
+void ADC_oversamplingStart(const ST_AdcOversamplingChannel * a_channels);
+
+/*
+ * [Function Name]: ADC_oversamplingStop
+ * [Function Description]: stops the oversampling scan after the running conversion,
+ * 						   the last results can still be read
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void ADC_oversamplingStop(void);
+
+/*
+ * [Function Name]: ADC_oversamplingGetResult
+ * [Function Description]: gets the last oversampled result of a channel, from 0 to
+ * 						   ADC_OVERSAMPLED_MAXIMUM_VALUE(extraBits) of the channel
+ * [Args]:
+ * [in]: uint8_t a_channelIndex
+ * 		 index of the channel in the channels array
+ * [out]: uint16_t * a_result
+ * 		  pointer to store the result in
+ * [Return]: uint8_t
+ * 			 ADC_RESULT_NEW if it wasn't read before, ADC_RESULT_OLD if it was read before,
+ * 			 or ADC_RESULT_NONE if there is no result yet or the index is out of the array
+ */
+uint8_t ADC_oversamplingGetResult(uint8_t a_channelIndex, uint16_t * a_result);
+
+#endif /* ADC_OVERSAMPLING_ENABLED == 1 */
+
+#if ADC_WATCH_ENABLED == 1
+
+/*
+ * [Function Name]: ADC_watchInit
+ * [Function Description]: starts watching the channels, each result of the adc interrupt
+ * 						   of a watched channel is compared with its thresholds and the
+ * 						   callback is called from the interrupt when its state changes.
+ * 						   The shutdown pins are initialized as outputs at their inactive level
+ * [Args]:
+ * [in]: const ST_AdcWatch * a_watches
+ * 		 array of ADC_WATCH_CHANNELS_COUNT watched channels
+ * [in]: void (* volatile a_ptrToCallback)(uint8_t a_watchIndex, uint8_t a_state)
+ * 		 function called with the index of the channel and its new state
+ * 		 from EN_AdcWatchState, can be NULL
+ * [Return]: void
+ */
+void ADC_watchInit(const ST_AdcWatch * a_watches, void (* volatile a_ptrToCallback)(uint8_t a_watchIndex, uint8_t a_state));
+
+/*
+ * [Function Name]: ADC_watchGetState
+ * [Function Description]: gets the state of a watched channel
+ * [Args]:
+ * [in]: uint8_t a_watchIndex
+ * 		 index of the channel in the watched channels array
+ * [Return]: uint8_t
+ * 			 the state from EN_AdcWatchState
+ */
+uint8_t ADC_watchGetState(uint8_t a_watchIndex);
+
+#endif /* ADC_WATCH_ENABLED == 1 */
+
 #endif /* __ADC_H__ */
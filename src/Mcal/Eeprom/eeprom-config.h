@@ -0,0 +1,49 @@
+/******************************************************************************
+ *
+ * Module: EEPROM
+ *
+ * File Name: eeprom-config.h
+ *
+ * Description: Config file for the internal EEPROM driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __EEPROM_CONFIG_H__
+#define __EEPROM_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* number of write requests the queue can hold,
+ * must be a power of 2 and not greater than 128
+ */
+#define EEPROM_WRITE_QUEUE_SIZE				4
+
+/* if EEPROM_RECORD_STORE_ENABLED = 1, the record store is available,
+ * it keeps one record of EEPROM_RECORD_SIZE bytes, i.e. a counter, and
+ * writes each update to the next of EEPROM_RECORD_SLOTS_COUNT slots so
+ * the wear is spread over all of them
+ */
+#define EEPROM_RECORD_STORE_ENABLED			1
+
+#if EEPROM_RECORD_STORE_ENABLED == 1
+
+/* the first address of the record store, it uses
+ * EEPROM_RECORD_SLOTS_COUNT * (EEPROM_RECORD_SIZE + 1) bytes
+ */
+#define EEPROM_RECORD_START_ADDRESS			0x0100
+
+/* size of the record in bytes */
+#define EEPROM_RECORD_SIZE					4
+
+/* number of slots, from 2 to 128, each one lasts the rated
+ * write cycles of the eeprom (100,000)
+ */
+#define EEPROM_RECORD_SLOTS_COUNT			16
+
+#endif /* EEPROM_RECORD_STORE_ENABLED == 1 */
+
+#endif /* __EEPROM_CONFIG_H__ */
@@ -0,0 +1,517 @@
+/******************************************************************************
+ *
+ * Module: EEPROM
+ *
+ * File Name: eeprom.c
+ *
+ * Description: Source file for the internal EEPROM driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "eeprom.h"
+
+/* include mcu header file */
+#include "../Mcu/mcu.h"
+
+#if (EEPROM_WRITE_QUEUE_SIZE & (EEPROM_WRITE_QUEUE_SIZE - 1)) != 0 || EEPROM_WRITE_QUEUE_SIZE > 128
+#error "EEPROM_WRITE_QUEUE_SIZE must be a power of 2 and not greater than 128"
+#endif
+
+#if EEPROM_RECORD_STORE_ENABLED == 1
+
+#if EEPROM_RECORD_SLOTS_COUNT < 2 || EEPROM_RECORD_SLOTS_COUNT > 128
+#error "EEPROM_RECORD_SLOTS_COUNT must be from 2 to 128"
+#endif
+
+#if EEPROM_RECORD_START_ADDRESS + EEPROM_RECORD_SLOTS_COUNT * (EEPROM_RECORD_SIZE + 1) > EEPROM_SIZE
+#error "The record store doesn't fit in the eeprom"
+#endif
+
+/* a record write queues the data and the sequence number */
+#if EEPROM_WRITE_QUEUE_SIZE < 4
+#error "EEPROM_RECORD_STORE_ENABLED requires EEPROM_WRITE_QUEUE_SIZE >= 4"
+#endif
+
+#endif /* EEPROM_RECORD_STORE_ENABLED == 1 */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#if EEPROM_RECORD_STORE_ENABLED == 1
+
+/* each slot holds the sequence number then the record */
+#define EEPROM_RECORD_SLOT_SIZE				(EEPROM_RECORD_SIZE + 1)
+
+/* address of a slot */
+#define EEPROM_RECORD_SLOT_ADDRESS(slot)	(EEPROM_RECORD_START_ADDRESS + (uint16_t)(slot) * EEPROM_RECORD_SLOT_SIZE)
+
+/* value of the erased eeprom bytes */
+#define EEPROM_ERASED_VALUE					0xFF
+
+#endif /* EEPROM_RECORD_STORE_ENABLED == 1 */
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+/*
+ * [Struct Name]: ST_EepromWriteRequest
+ * [Struct Description]: contains a queued write request
+ */
+typedef struct
+{
+	/* address to write to */
+	uint16_t address;
+
+	/* data to write */
+	const uint8_t * data;
+
+	/* number of bytes */
+	uint16_t length;
+
+	/* function called when all the bytes are written, can be NULL */
+	void (* volatile callBack)(void);
+
+}ST_EepromWriteRequest;
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* ring buffer of the queued write requests, the request at the tail is running */
+static ST_EepromWriteRequest g_writeQueue[EEPROM_WRITE_QUEUE_SIZE];
+static volatile uint8_t g_writeQueueHead = 0;
+static volatile uint8_t g_writeQueueTail = 0;
+
+/* index of the next byte of the running request */
+static uint16_t g_writeIndex = 0;
+
+#if EEPROM_RECORD_STORE_ENABLED == 1
+
+/* the latest record, it's the data source of the running record write */
+static uint8_t g_record[EEPROM_RECORD_SIZE];
+
+/* slot and sequence number of the latest record */
+static uint8_t g_recordSlot = 0;
+static uint8_t g_recordSequence = EEPROM_ERASED_VALUE;
+
+/* TRUE if no record is written yet */
+static uint8_t g_recordIsEmpty = TRUE;
+
+/* TRUE while a record write is queued */
+static volatile uint8_t g_recordIsWriting = FALSE;
+
+/* called when the running record write is done */
+static void (* volatile g_recordCallBack)(void) = NULL;
+
+#endif /* EEPROM_RECORD_STORE_ENABLED == 1 */
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: EEPROM_readByte
+ * [Function Description]: reads a byte, no write must be running
+ * [Args]:
+ * [in]: uint16_t a_address
+ * 		 address to read from
+ * [Return]: uint8_t
+ * 			 the byte
+ */
+static uint8_t EEPROM_readByte(uint16_t a_address);
+
+/*
+ * [Function Name]: EEPROM_queueWrite
+ * [Function Description]: adds a request to the write queue and enables the
+ * 						   eeprom ready interrupt, must be called with interrupts disabled
+ * [Args]:
+ * [in]: uint16_t a_address
+ * 		 address to write to
+ * [in]: const uint8_t * a_data
+ * 		 data to write
+ * [in]: uint16_t a_length
+ * 		 number of bytes
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called when done, can be NULL
+ * [Return]: void
+ */
+static void EEPROM_queueWrite(uint16_t a_address, const uint8_t * a_data, uint16_t a_length, void (* volatile a_ptrToCallback)(void));
+
+/*
+ * [Function Name]: EEPROM_getFreeRequestsCount
+ * [Function Description]: returns number of requests that can be queued now
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 number of free places in the queue
+ */
+static uint8_t EEPROM_getFreeRequestsCount(void);
+
+#if EEPROM_RECORD_STORE_ENABLED == 1
+
+/*
+ * [Function Name]: EEPROM_recordWriteDone
+ * [Function Description]: callback of the sequence number write of a record
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void EEPROM_recordWriteDone(void);
+
+#endif /* EEPROM_RECORD_STORE_ENABLED == 1 */
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: EEPROM_read
+ * [Function Description]: reads a block from the eeprom, the queued bytes that
+ * 						   are not written yet are read with their old values
+ * [Args]:
+ * [in]: uint16_t a_address
+ * 		 address to read from
+ * [out]: uint8_t * a_data
+ * 		  array to store the data in
+ * [in]: uint16_t a_length
+ * 		 number of bytes to read
+ * [Return]: uint8_t
+ * 			 EEPROM_SUCCESS or EEPROM_ERROR if the block is out of the eeprom
+ */
+uint8_t EEPROM_read(uint16_t a_address, uint8_t * a_data, uint16_t a_length)
+{
+	uint16_t index;
+	uint8_t isWriting;
+	uint8_t sreg;
+
+	if(a_data == NULL || (uint32_t)a_address + a_length > EEPROM_SIZE)
+	{
+		return EEPROM_ERROR;
+	}
+
+	for(index = 0; index < a_length; index ++)
+	{
+		/* wait for the running write with interrupts enabled,
+		 * then read before the interrupt starts another one */
+		do
+		{
+			ENTER_CRITICAL_SECTION(sreg);
+			isWriting = BIT_IS_SET(EECR_R, EEWE);
+			if(!isWriting)
+			{
+				a_data[index] = EEPROM_readByte(a_address + index);
+			}
+			EXIT_CRITICAL_SECTION(sreg);
+		}while(isWriting);
+	}
+
+	return EEPROM_SUCCESS;
+}
+
+/*
+ * [Function Name]: EEPROM_write
+ * [Function Description]: queues a block to be written, the bytes are written one per
+ * 						   eeprom ready interrupt and the bytes that already hold the
+ * 						   same value are skipped. The callback is called when all the
+ * 						   bytes are written, global interrupts must be enabled
+ * [Args]:
+ * [in]: uint16_t a_address
+ * 		 address to write to
+ * [in]: const uint8_t * a_data
+ * 		 data to write, it must stay valid till the callback
+ * [in]: uint16_t a_length
+ * 		 number of bytes, greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called from the eeprom interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 EEPROM_SUCCESS if queued, EEPROM_BUSY if the queue is full or
+ * 			 EEPROM_ERROR if the block is out of the eeprom
+ */
+uint8_t EEPROM_write(uint16_t a_address, const uint8_t * a_data, uint16_t a_length, void (* volatile a_ptrToCallback)(void))
+{
+	uint8_t sreg;
+
+	if(a_data == NULL || a_length == 0 || (uint32_t)a_address + a_length > EEPROM_SIZE)
+	{
+		return EEPROM_ERROR;
+	}
+
+	/* writes may be queued from the main loop and from callbacks */
+	ENTER_CRITICAL_SECTION(sreg);
+	if(EEPROM_getFreeRequestsCount() == 0)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return EEPROM_BUSY;
+	}
+	EEPROM_queueWrite(a_address, a_data, a_length, a_ptrToCallback);
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return EEPROM_SUCCESS;
+}
+
+/*
+ * [Function Name]: EEPROM_isBusy
+ * [Function Description]: checks if there are queued writes
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t EEPROM_isBusy(void)
+{
+	return (g_writeQueueHead != g_writeQueueTail);
+}
+
+#if EEPROM_RECORD_STORE_ENABLED == 1
+
+/*
+ * [Function Name]: EEPROM_recordInit
+ * [Function Description]: finds the latest record in the slots and loads it
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void EEPROM_recordInit(void)
+{
+	uint8_t slot;
+	uint8_t sequence, nextSequence;
+	uint8_t firstSequence;
+
+	EEPROM_read(EEPROM_RECORD_SLOT_ADDRESS(0), &firstSequence, 1);
+	sequence = firstSequence;
+
+	/* each write goes to the next slot with the next sequence number,
+	 * so the latest slot is the one not followed by its next number */
+	for(slot = 0; slot < EEPROM_RECORD_SLOTS_COUNT - 1; slot ++)
+	{
+		EEPROM_read(EEPROM_RECORD_SLOT_ADDRESS(slot + 1), &nextSequence, 1);
+		if(nextSequence != (uint8_t)(sequence + 1))
+		{
+			break;
+		}
+		sequence = nextSequence;
+	}
+
+	g_recordSlot = slot;
+	g_recordSequence = sequence;
+
+	/* only the erased store has equal sequence numbers in the first two slots */
+	EEPROM_read(EEPROM_RECORD_SLOT_ADDRESS(1), &nextSequence, 1);
+	g_recordIsEmpty = (firstSequence == EEPROM_ERASED_VALUE && nextSequence == EEPROM_ERASED_VALUE);
+
+	EEPROM_read(EEPROM_RECORD_SLOT_ADDRESS(g_recordSlot) + 1, g_record, EEPROM_RECORD_SIZE);
+}
+
+/*
+ * [Function Name]: EEPROM_recordRead
+ * [Function Description]: gets the latest record, including a record that is
+ * 						   being written
+ * [Args]:
+ * [out]: uint8_t * a_data
+ * 		  array of EEPROM_RECORD_SIZE bytes to store the record in
+ * [Return]: uint8_t
+ * 			 EEPROM_SUCCESS or EEPROM_ERROR if no record is written yet
+ */
+uint8_t EEPROM_recordRead(uint8_t * a_data)
+{
+	uint8_t index;
+
+	if(g_recordIsEmpty == TRUE)
+	{
+		return EEPROM_ERROR;
+	}
+
+	for(index = 0; index < EEPROM_RECORD_SIZE; index ++)
+	{
+		a_data[index] = g_record[index];
+	}
+
+	return EEPROM_SUCCESS;
+}
+
+/*
+ * [Function Name]: EEPROM_recordWrite
+ * [Function Description]: queues writing the record to the next slot, the data is
+ * 						   written first then the slot sequence number, so the previous
+ * 						   record stays the latest if the power is lost during the write
+ * [Args]:
+ * [in]: const uint8_t * a_data
+ * 		 array of EEPROM_RECORD_SIZE bytes, it's copied so it can be changed directly
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called from the eeprom interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 EEPROM_SUCCESS if queued or EEPROM_BUSY if the queue is full
+ * 			 or the previous record write is running
+ */
+uint8_t EEPROM_recordWrite(const uint8_t * a_data, void (* volatile a_ptrToCallback)(void))
+{
+	uint8_t index;
+	uint16_t slotAddress;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	if(g_recordIsWriting == TRUE || EEPROM_getFreeRequestsCount() < 2)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return EEPROM_BUSY;
+	}
+
+	for(index = 0; index < EEPROM_RECORD_SIZE; index ++)
+	{
+		g_record[index] = a_data[index];
+	}
+
+	g_recordSlot = (g_recordSlot + 1) % EEPROM_RECORD_SLOTS_COUNT;
+	g_recordSequence ++;
+	g_recordIsEmpty = FALSE;
+	g_recordIsWriting = TRUE;
+	g_recordCallBack = a_ptrToCallback;
+
+	slotAddress = EEPROM_RECORD_SLOT_ADDRESS(g_recordSlot);
+	EEPROM_queueWrite(slotAddress + 1, g_record, EEPROM_RECORD_SIZE, NULL);
+	EEPROM_queueWrite(slotAddress, &g_recordSequence, 1, EEPROM_recordWriteDone);
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return EEPROM_SUCCESS;
+}
+
+#endif /* EEPROM_RECORD_STORE_ENABLED == 1 */
+
+/*
+ * [Function Name]: EEPROM_readByte
+ * [Function Description]: reads a byte, no write must be running
+ * [Args]:
+ * [in]: uint16_t a_address
+ * 		 address to read from
+ * [Return]: uint8_t
+ * 			 the byte
+ */
+static uint8_t EEPROM_readByte(uint16_t a_address)
+{
+	EEAR_R = a_address;
+	SET_BIT(EECR_R, EERE);
+
+	return EEDR_R;
+}
+
+/*
+ * [Function Name]: EEPROM_queueWrite
+ * [Function Description]: adds a request to the write queue and enables the
+ * 						   eeprom ready interrupt, must be called with interrupts disabled
+ * [Args]:
+ * [in]: uint16_t a_address
+ * 		 address to write to
+ * [in]: const uint8_t * a_data
+ * 		 data to write
+ * [in]: uint16_t a_length
+ * 		 number of bytes
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called when done, can be NULL
+ * [Return]: void
+ */
+static void EEPROM_queueWrite(uint16_t a_address, const uint8_t * a_data, uint16_t a_length, void (* volatile a_ptrToCallback)(void))
+{
+	ST_EepromWriteRequest * request = &g_writeQueue[g_writeQueueHead];
+
+	request->address = a_address;
+	request->data = a_data;
+	request->length = a_length;
+	request->callBack = a_ptrToCallback;
+	g_writeQueueHead = (g_writeQueueHead + 1) & (EEPROM_WRITE_QUEUE_SIZE - 1);
+
+	/* the interrupt fires as long as no write is running */
+	SET_BIT(EECR_R, EERIE);
+}
+
+/*
+ * [Function Name]: EEPROM_getFreeRequestsCount
+ * [Function Description]: returns number of requests that can be queued now
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 number of free places in the queue
+ */
+static uint8_t EEPROM_getFreeRequestsCount(void)
+{
+	return (EEPROM_WRITE_QUEUE_SIZE - 1) - \
+			((g_writeQueueHead - g_writeQueueTail) & (EEPROM_WRITE_QUEUE_SIZE - 1));
+}
+
+#if EEPROM_RECORD_STORE_ENABLED == 1
+
+/*
+ * [Function Name]: EEPROM_recordWriteDone
+ * [Function Description]: callback of the sequence number write of a record
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void EEPROM_recordWriteDone(void)
+{
+	g_recordIsWriting = FALSE;
+
+	if(g_recordCallBack != NULL)
+	{
+		(*g_recordCallBack)();
+	}
+}
+
+#endif /* EEPROM_RECORD_STORE_ENABLED == 1 */
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(EE_RDY_vect)
+{
+	ST_EepromWriteRequest * request;
+	void (* callBack)(void);
+	uint16_t address;
+	uint8_t data;
+
+	while(g_writeQueueHead != g_writeQueueTail)
+	{
+		request = &g_writeQueue[g_writeQueueTail];
+
+		while(g_writeIndex < request->length)
+		{
+			address = request->address + g_writeIndex;
+			data = request->data[g_writeIndex];
+			g_writeIndex ++;
+
+			/* skip the bytes that hold the same value, it saves time and wear */
+			if(EEPROM_readByte(address) != data)
+			{
+				EEAR_R = address;
+				EEDR_R = data;
+
+				/* EEWE must be set within 4 cycles after EEMWE */
+				SET_BIT(EECR_R, EEMWE);
+				SET_BIT(EECR_R, EEWE);
+				return;
+			}
+		}
+
+		/* the last write is done, the interrupt fires when it ends */
+		callBack = request->callBack;
+		g_writeIndex = 0;
+		g_writeQueueTail = (g_writeQueueTail + 1) & (EEPROM_WRITE_QUEUE_SIZE - 1);
+
+		/* the callback may queue more requests */
+		if(callBack != NULL)
+		{
+			(*callBack)();
+		}
+	}
+
+	CLEAR_BIT(EECR_R, EERIE);
+}
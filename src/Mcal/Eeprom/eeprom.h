@@ -0,0 +1,132 @@
+/******************************************************************************
+ *
+ * Module: EEPROM
+ *
+ * File Name: eeprom.h
+ *
+ * Description: Header file for the internal EEPROM driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __EEPROM_H__
+#define __EEPROM_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module config file */
+#include "eeprom-config.h"
+
+/* for using std types */
+#include "../../Lib/types.h"
+
+/* For using common defines and macros */
+#include "../../Lib/common.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* results of the eeprom functions */
+#define EEPROM_SUCCESS						1
+#define EEPROM_ERROR						0
+
+/* returned if the write queue is full or a record write is running */
+#define EEPROM_BUSY							2
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: EEPROM_read
+ * [Function Description]: reads a block from the eeprom, the queued bytes that
+ * 						   are not written yet are read with their old values
+ * [Args]:
+ * [in]: uint16_t a_address
+ * 		 address to read from
+ * [out]: uint8_t * a_data
+ * 		  array to store the data in
+ * [in]: uint16_t a_length
+ * 		 number of bytes to read
+ * [Return]: uint8_t
+ * 			 EEPROM_SUCCESS or EEPROM_ERROR if the block is out of the eeprom
+ */
+uint8_t EEPROM_read(uint16_t a_address, uint8_t * a_data, uint16_t a_length);
+
+/*
+ * [Function Name]: EEPROM_write
+ * [Function Description]: queues a block to be written, the bytes are written one per
+ * 						   eeprom ready interrupt and the bytes that already hold the
+ * 						   same value are skipped. The callback is called when all the
+ * 						   bytes are written, global interrupts must be enabled
+ * [Args]:
+ * [in]: uint16_t a_address
+ * 		 address to write to
+ * [in]: const uint8_t * a_data
+ * 		 data to write, it must stay valid till the callback
+ * [in]: uint16_t a_length
+ * 		 number of bytes, greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called from the eeprom interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 EEPROM_SUCCESS if queued, EEPROM_BUSY if the queue is full or
+ * 			 EEPROM_ERROR if the block is out of the eeprom
+ */
+uint8_t EEPROM_write(uint16_t a_address, const uint8_t * a_data, uint16_t a_length, void (* volatile a_ptrToCallback)(void));
+
+/*
+ * [Function Name]: EEPROM_isBusy
+ * [Function Description]: checks if there are queued writes
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t EEPROM_isBusy(void);
+
+#if EEPROM_RECORD_STORE_ENABLED == 1
+
+/*
+ * [Function Name]: EEPROM_recordInit
+ * [Function Description]: finds the latest record in the slots and loads it
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void EEPROM_recordInit(void);
+
+/*
+ * [Function Name]: EEPROM_recordRead
+ * [Function Description]: gets the latest record, including a record that is
+ * 						   being written
+ * [Args]:
+ * [out]: uint8_t * a_data
+ * 		  array of EEPROM_RECORD_SIZE bytes to store the record in
+ * [Return]: uint8_t
+ * 			 EEPROM_SUCCESS or EEPROM_ERROR if no record is written yet
+ */
+uint8_t EEPROM_recordRead(uint8_t * a_data);
+
+/*
+ * [Function Name]: EEPROM_recordWrite
+ * [Function Description]: queues writing the record to the next slot, the data is
+ * 						   written first then the slot sequence number, so the previous
+ * 						   record stays the latest if the power is lost during the write
+ * [Args]:
+ * [in]: const uint8_t * a_data
+ * 		 array of EEPROM_RECORD_SIZE bytes, it's copied so it can be changed directly
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called from the eeprom interrupt when done, can be NULL
+ * [Return]: uint8_t
+ * 			 EEPROM_SUCCESS if queued or EEPROM_BUSY if the queue is full
+ * 			 or the previous record write is running
+ */
+uint8_t EEPROM_recordWrite(const uint8_t * a_data, void (* volatile a_ptrToCallback)(void));
+
+#endif /* EEPROM_RECORD_STORE_ENABLED == 1 */
+
+#endif /* __EEPROM_H__ */
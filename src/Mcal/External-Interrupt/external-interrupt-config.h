@@ -0,0 +1,34 @@
+/******************************************************************************
+ *
+ * Module: External Interrupt
+ *
+ * File Name: external-interrupt-config.h
+ *
+ * Description: Config file for the AVR External Interrupt driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __EXTERNAL_INTERRUPT_CONFIG_H__
+#define __EXTERNAL_INTERRUPT_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* if EXT_INTx_DEFERRED = 1, the ISR of INTx only pushes the event with its
+ * timestamp to the events queue, and the handler is called later from the
+ * main loop by EXT_INT_dispatch(),
+ * if EXT_INTx_DEFERRED = 0, the handler is called directly from the ISR
+ */
+#define EXT_INT0_DEFERRED						0
+#define EXT_INT1_DEFERRED						0
+#define EXT_INT2_DEFERRED						0
+
+/* number of events the events queue can hold,
+ * must be a power of 2 and not greater than 128
+ */
+#define EXT_INT_QUEUE_SIZE						16
+
+#endif /* __EXTERNAL_INTERRUPT_CONFIG_H__ */
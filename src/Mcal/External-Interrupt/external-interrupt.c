@@ -23,6 +23,60 @@
 /* For using Dio module */
 #include "../Dio/dio.h"
 
+#if EXT_INT_DEFERRED_ENABLED
+
+#if (EXT_INT_QUEUE_SIZE & (EXT_INT_QUEUE_SIZE - 1)) != 0 || EXT_INT_QUEUE_SIZE > 128
+#error "EXT_INT_QUEUE_SIZE must be a power of 2 and not greater than 128"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* sources of the queued events */
+#define EXT_INT_SOURCE_INT0				0
+#define EXT_INT_SOURCE_INT1				1
+#define EXT_INT_SOURCE_INT2				2
+
+/* pushes an event to the events queue, used by the ISRs only.
+ * Timer 1 is read first to be as close as possible to the event,
+ * the ISRs don't nest so there's one producer at a time */
+#define EXT_INT_QUEUE_PUSH(eventSource)											\
+{																				\
+	uint16_t timestamp = TCNT1_R;												\
+	uint8_t head = g_eventsQueueHead;											\
+	uint8_t nextHead = (head + 1) & (EXT_INT_QUEUE_SIZE - 1);					\
+	if(nextHead == g_eventsQueueTail)											\
+	{																			\
+		g_droppedEventsCount ++;												\
+	}																			\
+	else																		\
+	{																			\
+		g_eventsQueue[head].source = (eventSource);								\
+		g_eventsQueue[head].timestamp = timestamp;								\
+		g_eventsQueueHead = nextHead;											\
+	}																			\
+}
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+/*
+ * [Struct Name]: ST_ExtIntEvent
+ * [Struct Description]: contains an event stored in the events queue
+ */
+typedef struct
+{
+	/* the interrupt that occurred */
+	uint8_t source;
+
+	/* timer 1 count when the interrupt occurred */
+	uint16_t timestamp;
+}ST_ExtIntEvent;
+
+#endif /* EXT_INT_DEFERRED_ENABLED */
+
 /*******************************************************************************
  *                            Global Variables		                           *
  *******************************************************************************/
@@ -31,6 +85,25 @@ static void (* volatile g_int0Handler_ptr)(void) = NULL;
 static void (* volatile g_int1Handler_ptr)(void) = NULL;
 static void (* volatile g_int2Handler_ptr)(void) = NULL;
 
+#if EXT_INT_DEFERRED_ENABLED
+
+/* events queue, filled by the deferred ISRs and emptied by EXT_INT_dispatch() */
+static ST_ExtIntEvent g_eventsQueue[EXT_INT_QUEUE_SIZE];
+
+/* index of the next event to write, modified only in the ISRs */
+static volatile uint8_t g_eventsQueueHead = 0;
+
+/* index of the next event to dispatch, modified only in EXT_INT_dispatch() */
+static volatile uint8_t g_eventsQueueTail = 0;
+
+/* number of events dropped because the queue was full */
+static volatile uint16_t g_droppedEventsCount = 0;
+
+/* timestamp of the event being dispatched */
+static uint16_t g_dispatchedEventTimestamp = 0;
+
+#endif /* EXT_INT_DEFERRED_ENABLED */
+
 /*******************************************************************************
  *                          Functions Definition	                           *
  *******************************************************************************/
@@ -141,6 +214,98 @@ uint8_t EXT_INT_disable(uint8_t a_pin)
 	return EXT_INT_SUCCESS;
 }
 
+#if EXT_INT_DEFERRED_ENABLED
+
+/*
+ * [Function Name]: EXT_INT_dispatch
+ * [Function Description]: calls the handlers of the deferred interrupts queued
+ * 						   since the last call, in the same order they occurred.
+ * 						   Must be called periodically from the main loop
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 number of dispatched events
+ */
+uint8_t EXT_INT_dispatch(void)
+{
+	uint8_t tail = g_eventsQueueTail;
+	uint8_t dispatchedCount = 0;
+	uint8_t source;
+	void (* handler_ptr)(void);
+
+	/* only events queued before the call are dispatched, so a fast interrupt
+	 * can't keep the main loop here forever */
+	uint8_t head = g_eventsQueueHead;
+
+	while(tail != head)
+	{
+		source = g_eventsQueue[tail].source;
+		g_dispatchedEventTimestamp = g_eventsQueue[tail].timestamp;
+
+		/* free the slot before calling the handler */
+		tail = (tail + 1) & (EXT_INT_QUEUE_SIZE - 1);
+		g_eventsQueueTail = tail;
+
+		if(source == EXT_INT_SOURCE_INT0)
+		{
+			handler_ptr = g_int0Handler_ptr;
+		}
+		else if(source == EXT_INT_SOURCE_INT1)
+		{
+			handler_ptr = g_int1Handler_ptr;
+		}
+		else
+		{
+			handler_ptr = g_int2Handler_ptr;
+		}
+
+		if(handler_ptr != NULL)
+		{
+			(*handler_ptr)();
+		}
+		dispatchedCount ++;
+	}
+	return dispatchedCount;
+}
+
+/*
+ * [Function Name]: EXT_INT_getEventTimestamp
+ * [Function Description]: returns the timestamp of the event being dispatched,
+ * 						   to be called from the handlers of deferred interrupts
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 timer 1 count when the interrupt occurred
+ */
+uint16_t EXT_INT_getEventTimestamp(void)
+{
+	return g_dispatchedEventTimestamp;
+}
+
+/*
+ * [Function Name]: EXT_INT_getDroppedEventsCount
+ * [Function Description]: returns number of events dropped because the
+ * 						   events queue was full
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 number of dropped events
+ */
+uint16_t EXT_INT_getDroppedEventsCount(void)
+{
+	uint16_t droppedEventsCount;
+	uint8_t sreg;
+
+	/* 16-bit value modified by the ISRs */
+	ENTER_CRITICAL_SECTION(sreg);
+	droppedEventsCount = g_droppedEventsCount;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return droppedEventsCount;
+}
+
+#endif /* EXT_INT_DEFERRED_ENABLED */
+
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
  *******************************************************************************/
@@ -148,26 +313,53 @@ uint8_t EXT_INT_disable(uint8_t a_pin)
 /* ISR for INT 0 */
 ISR(INT0_vect)
 {
+#if EXT_INT0_DEFERRED == 1
+
+	/* the handler is called later by EXT_INT_dispatch() */
+	EXT_INT_QUEUE_PUSH(EXT_INT_SOURCE_INT0);
+
+#else
+
 	if(g_int0Handler_ptr != NULL)
 	{
 		(*g_int0Handler_ptr)();
 	}
+
+#endif /* EXT_INT0_DEFERRED == 1 */
 }
 
 /* ISR for INT 1 */
 ISR(INT1_vect)
 {
+#if EXT_INT1_DEFERRED == 1
+
+	/* the handler is called later by EXT_INT_dispatch() */
+	EXT_INT_QUEUE_PUSH(EXT_INT_SOURCE_INT1);
+
+#else
+
 	if(g_int1Handler_ptr != NULL)
 	{
 		(*g_int1Handler_ptr)();
 	}
+
+#endif /* EXT_INT1_DEFERRED == 1 */
 }
 
 /* ISR for INT 2 */
 ISR(INT2_vect)
 {
+#if EXT_INT2_DEFERRED == 1
+
+	/* the handler is called later by EXT_INT_dispatch() */
+	EXT_INT_QUEUE_PUSH(EXT_INT_SOURCE_INT2);
+
+#else
+
 	if(g_int2Handler_ptr != NULL)
 	{
 		(*g_int2Handler_ptr)();
 	}
+
+#endif /* EXT_INT2_DEFERRED == 1 */
 }
@@ -17,6 +17,9 @@
  *                                Includes	                                   *
  *******************************************************************************/
 
+/* module config file */
+#include "external-interrupt-config.h"
+
 /* For using std types */
 #include "../../Lib/types.h"
 
@@ -36,6 +39,9 @@
 #define EXT_INT1_MODES_NO 		4
 #define EXT_INT2_MODES_NO 		2
 
+/* TRUE if any of the interrupts is deferred to EXT_INT_dispatch() */
+#define EXT_INT_DEFERRED_ENABLED	(EXT_INT0_DEFERRED == 1 || EXT_INT1_DEFERRED == 1 || EXT_INT2_DEFERRED == 1)
+
 /*******************************************************************************
  *                             Types Declaration                               *
  *******************************************************************************/
@@ -89,4 +95,42 @@ uint8_t EXT_INT_enable(uint8_t a_pin, EXT_INT_Modes a_mode, void (* volatile a_h
  */
 uint8_t EXT_INT_disable(uint8_t a_pin);
 
+#if EXT_INT_DEFERRED_ENABLED
+
+/*
+ * [Function Name]: EXT_INT_dispatch
+ * [Function Description]: calls the handlers of the deferred interrupts queued
+ * 						   since the last call, in the same order they occurred.
+ * 						   Must be called periodically from the main loop
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 number of dispatched events
+ */
+uint8_t EXT_INT_dispatch(void);
+
+/*
+ * [Function Name]: EXT_INT_getEventTimestamp
+ * [Function Description]: returns the timestamp of the event being dispatched,
+ * 						   to be called from the handlers of deferred interrupts
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 timer 1 count when the interrupt occurred
+ */
+uint16_t EXT_INT_getEventTimestamp(void);
+
+/*
+ * [Function Name]: EXT_INT_getDroppedEventsCount
+ * [Function Description]: returns number of events dropped because the
+ * 						   events queue was full
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 number of dropped events
+ */
+uint16_t EXT_INT_getDroppedEventsCount(void);
+
+#endif /* EXT_INT_DEFERRED_ENABLED */
+
 #endif /* __EXTERNAL_INTERRUPT_H__ */
@@ -0,0 +1,69 @@
+/******************************************************************************
+ *
+ * Module: ICU
+ *
+ * File Name: icu-config.h
+ *
+ * Description: Config file for the AVR ICU driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __ICU_CONFIG_H__
+#define __ICU_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* if ICU_TIMESTAMP_EXTENSION_ENABLED = 1, the icu driver owns the timer 1
+ * overflow interrupt and counts overflows to extend the 16-bit timer 1
+ * count to 32-bit timestamps, this is required by the capture buffer modes.
+ * Note that TIMER_1_OVF mode of the TIMER driver is not available then
+ * if ICU_TIMESTAMP_EXTENSION_ENABLED = 0, only ICU_CALLBACK_MODE is supported
+ */
+#define ICU_TIMESTAMP_EXTENSION_ENABLED				1
+
+/* number of captures the capture ring buffer can hold,
+ * must be a power of 2 and not greater than 128
+ */
+#define ICU_CAPTURE_BUFFER_SIZE						16
+
+/* number of signal cycles averaged in each result of ICU_MEASURE_MODE */
+#define ICU_MEASURE_CYCLES_COUNT					4
+
+/* time in ms without any edge after which the measured signal is reported
+ * as stopped in ICU_MEASURE_MODE, max 65535
+ */
+#define ICU_MEASURE_TIMEOUT_MS						500
+
+/* if ICU_MEASURE_AUTO_PRESCALER_ENABLED = 1, ICU_MEASURE_MODE switches the
+ * timer 1 prescaler when the measured period leaves the range below
+ */
+#define ICU_MEASURE_AUTO_PRESCALER_ENABLED			1
+
+/* periods shorter than this (in timer ticks) switch to a smaller prescaler
+ * to get a better resolution
+ */
+#define ICU_MEASURE_MIN_PERIOD_TICKS				1000UL
+
+/* periods longer than this (in timer ticks) switch to a bigger prescaler
+ * to keep the sum of ICU_MEASURE_CYCLES_COUNT periods within 32-bit,
+ * must be greater than 8 * ICU_MEASURE_MIN_PERIOD_TICKS
+ */
+#define ICU_MEASURE_MAX_PERIOD_TICKS				0x00FFFFFFUL
+
+/* if ICU_COMPARE_SCHEDULER_ENABLED = 1, the icu driver owns the timer 1
+ * compare B interrupt and provides one-shot compare events on the icu
+ * time base, see Icu_scheduleCompare().
+ * Note that PWM channel 1B can't be used then
+ */
+#define ICU_COMPARE_SCHEDULER_ENABLED				1
+
+/* Define F_CPU if not defined to calculate time correctly */
+#ifndef F_CPU
+#define F_CPU 										1000000UL
+#endif /* F_CPU */
+
+#endif /* __ICU_CONFIG_H__ */
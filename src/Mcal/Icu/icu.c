@@ -23,6 +23,79 @@
 /* For using DIO module */
 #include "../Dio/dio.h"
 
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+
+#if (ICU_CAPTURE_BUFFER_SIZE & (ICU_CAPTURE_BUFFER_SIZE - 1)) != 0 || ICU_CAPTURE_BUFFER_SIZE > 128
+#error "ICU_CAPTURE_BUFFER_SIZE must be a power of 2 and not greater than 128"
+#endif
+
+#if ICU_MEASURE_MAX_PERIOD_TICKS <= 8 * ICU_MEASURE_MIN_PERIOD_TICKS
+#error "ICU_MEASURE_MAX_PERIOD_TICKS must be greater than 8 * ICU_MEASURE_MIN_PERIOD_TICKS"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* states of ICU_MEASURE_MODE */
+#define ICU_MEASURE_WAIT_FIRST_RISING			0
+#define ICU_MEASURE_WAIT_FALLING				1
+#define ICU_MEASURE_WAIT_RISING					2
+
+/* converts ICU_MEASURE_TIMEOUT_MS to timer ticks for a prescaler divider */
+#define ICU_MEASURE_TIMEOUT_TICKS(divider)		\
+		((((uint32_t)F_CPU / 1000UL) * ICU_MEASURE_TIMEOUT_MS) / (divider))
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: extendCaptureValue
+ * [Function Description]: extends a 16-bit timer 1 value to a 32-bit timestamp.
+ * 						   If timer 1 overflowed but the overflow interrupt
+ * 						   isn't serviced yet (TOV1 is still set), the overflow
+ * 						   belongs to the value only if it's in the lower half
+ * 						   of the timer range, i.e. it was taken after the overflow.
+ * 						   Must be called with interrupts disabled
+ * [Args]:
+ * [in]: uint16_t a_value
+ * 		 timer 1 value, TCNT1 or ICR1
+ * [Return]: uint32_t
+ * 			 the 32-bit timestamp
+ */
+static uint32_t extendCaptureValue(uint16_t a_value);
+
+/*
+ * [Function Name]: measureProcessEdge
+ * [Function Description]: processes a captured edge in ICU_MEASURE_MODE,
+ * 						   accumulates period and high time of each complete cycle
+ * 						   and publishes the sums every ICU_MEASURE_CYCLES_COUNT cycles.
+ * 						   Called from the capture ISR
+ * [Args]:
+ * [in]: uint32_t a_timestamp
+ * 		 timestamp of the edge
+ * [in]: uint8_t a_edge
+ * 		 the captured edge, ICU_RISING_EDGE or ICU_FALLING_EDGE
+ * [Return]: void
+ */
+static void measureProcessEdge(uint32_t a_timestamp, uint8_t a_edge);
+
+/*
+ * [Function Name]: measurePublish
+ * [Function Description]: publishes the measure sums and status to Icu_measure(),
+ * 						   the sequence number is odd while writing so the reader
+ * 						   can detect a torn read and retry, no locks are needed.
+ * 						   Called from ISRs only
+ * [Args]:
+ * [in]: uint8_t a_status
+ * 		 ICU_MEASURE_VALID or ICU_MEASURE_STOPPED
+ * [Return]: void
+ */
+static void measurePublish(uint8_t a_status);
+
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 1 */
+
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
@@ -30,6 +103,61 @@
 /* Global variables to hold the address of the call back function in the application */
 static void (* volatile g_callBackPtr)(void) = NULL;
 
+#if ICU_COMPARE_SCHEDULER_ENABLED == 1
+
+/* Global variables to hold the address of the compare call back function */
+static void (* volatile g_compareCallBackPtr)(void) = NULL;
+
+#endif /* ICU_COMPARE_SCHEDULER_ENABLED == 1 */
+
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+
+/* current capture mode */
+static volatile EN_IcuCaptureMode g_captureMode = ICU_CALLBACK_MODE;
+
+/* number of timer 1 overflows, the upper 16-bit of the 32-bit timestamps */
+static volatile uint16_t g_overflowsCount = 0;
+
+/* capture ring buffer, filled by the capture ISR and emptied by Icu_readCapture() */
+static ST_IcuCapture g_captureBuffer[ICU_CAPTURE_BUFFER_SIZE];
+
+/* index of the next capture to write, modified only in the capture ISR */
+static volatile uint8_t g_captureBufferHead = 0;
+
+/* index of the next capture to read, modified only in Icu_readCapture() */
+static volatile uint8_t g_captureBufferTail = 0;
+
+/* number of captures dropped because the buffer was full */
+static volatile uint16_t g_droppedCapturesCount = 0;
+
+/* dividers of the icu prescalers, indexed by EN_IcuPrescaler */
+static const uint16_t g_prescalerDividers[] = {0, 1, 8, 64, 256, 1024};
+
+/* ICU_MEASURE_TIMEOUT_MS in timer ticks, indexed by EN_IcuPrescaler */
+static const uint32_t g_measureTimeoutTicks[] = {
+		0,
+		ICU_MEASURE_TIMEOUT_TICKS(1),
+		ICU_MEASURE_TIMEOUT_TICKS(8),
+		ICU_MEASURE_TIMEOUT_TICKS(64),
+		ICU_MEASURE_TIMEOUT_TICKS(256),
+		ICU_MEASURE_TIMEOUT_TICKS(1024)
+};
+
+/* ICU_MEASURE_MODE working variables, used only inside the ISRs */
+static uint8_t g_measureState = ICU_MEASURE_WAIT_FIRST_RISING;
+static uint8_t g_measuredCycles = 0;
+static EN_IcuPrescaler g_measurePrescaler = NO_CLOCK;
+static uint32_t g_measureRisingTimestamp, g_measureFallingTimestamp, g_measureLastEdgeTimestamp;
+static uint32_t g_measurePeriodTicksSum, g_measureHighTicksSum;
+
+/* ICU_MEASURE_MODE published results, written by the ISRs, read by Icu_measure() */
+static volatile uint8_t g_measureSequence = 0;
+static volatile uint8_t g_measureStatus = ICU_MEASURE_NOT_READY;
+static volatile EN_IcuPrescaler g_publishedPrescaler = NO_CLOCK;
+static volatile uint32_t g_publishedPeriodTicksSum, g_publishedHighTicksSum;
+
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 1 */
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -71,6 +199,37 @@ void Icu_init(const ST_IcuConfig * a_icuConfig)
 	 */
 	COPY_BITS(TCCR1B_R, 0b00000111, a_icuConfig->prescaler, CS10);
 
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+
+	/* reset the capture buffer and the overflows count */
+	g_captureMode = a_icuConfig->captureMode;
+	g_captureBufferHead = 0;
+	g_captureBufferTail = 0;
+	g_droppedCapturesCount = 0;
+	g_overflowsCount = 0;
+
+	/* reset the measurement, it always starts with a rising edge */
+	g_measureState = ICU_MEASURE_WAIT_FIRST_RISING;
+	g_measuredCycles = 0;
+	g_measurePrescaler = a_icuConfig->prescaler;
+	g_measureLastEdgeTimestamp = 0;
+	g_measurePeriodTicksSum = 0;
+	g_measureHighTicksSum = 0;
+	g_measureStatus = ICU_MEASURE_NOT_READY;
+	if(g_captureMode == ICU_MEASURE_MODE)
+	{
+		SET_BIT(TCCR1B_R, ICES1);
+	}
+
+	/* clear any old overflow or capture flags, writing the flags directly
+	 * to avoid clearing other pending flags in TIFR */
+	TIFR_R = SELECT_BIT(TOV1) | SELECT_BIT(ICF1);
+
+	/* Enable the overflow interrupt to count timer 1 overflows */
+	TIMSK_R |= (1<<TOIE1);
+
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 1 */
+
 	/* Enable the Input Capture interrupt to generate an interrupt when edge is detected on ICP1/PD6 pin */
 	TIMSK_R |= (1<<TICIE1);
 
@@ -104,6 +263,10 @@ void Icu_setEdgeDetectionType(EN_IcuEdgeType a_edgeType)
 	 * insert the required edge type in ICES1 bit in TCCR1B Register
 	 */
 	COPY_BITS(TCCR1B_R, 0b00000001, a_edgeType, ICES1);
+
+	/* changing the edge may set ICF1, so clear it, writing the flag directly
+	 * to avoid clearing other pending flags in TIFR */
+	TIFR_R = SELECT_BIT(ICF1);
 }
 
 /*
@@ -139,6 +302,8 @@ uint16_t Icu_getInputCaptureValue(void)
 /*
  * [Function Name]: Icu_clearTimerValue
  * [Function Description]: clears timer 1 value to start counting from 0
+ * 						   Note that it makes timestamps taken before and after
+ * 						   calling it incomparable
  * [Args]:
  * [in]: void
  * [Return]: void
@@ -165,14 +330,399 @@ void Icu_deInit(void)
 
 	/* Disable the Input Capture interrupt */
 	TIMSK_R &= SELECT_INV_BIT(TICIE1);
+
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+
+	/* Disable the overflow interrupt */
+	TIMSK_R &= SELECT_INV_BIT(TOIE1);
+
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 1 */
+
+#if ICU_COMPARE_SCHEDULER_ENABLED == 1
+
+	/* Disable the compare B interrupt */
+	TIMSK_R &= SELECT_INV_BIT(OCIE1B);
+
+#endif /* ICU_COMPARE_SCHEDULER_ENABLED == 1 */
+}
+
+#if ICU_COMPARE_SCHEDULER_ENABLED == 1
+
+/*
+ * [Function Name]: Icu_setCompareCallBack
+ * [Function Description]: sets the function called when a scheduled compare event occurs
+ * [Args]:
+ * [in]: void(* volatile a_ptrToHandler)(void)
+ * 		 pointer to callback function
+ * [Return]: void
+ */
+void Icu_setCompareCallBack(void(* volatile a_ptrToHandler)(void))
+{
+	g_compareCallBackPtr = a_ptrToHandler;
 }
 
+/*
+ * [Function Name]: Icu_scheduleCompare
+ * [Function Description]: schedules a one-shot compare event after a number of
+ * 						   timer 1 ticks from now, the compare callback is called
+ * 						   from the compare interrupt then. Scheduling again replaces
+ * 						   the pending event, it can be called from the callbacks.
+ * 						   a_ticks must cover the few cycles needed to set the compare,
+ * 						   i.e. 2 or more ticks with prescaler 8 or bigger
+ * [Args]:
+ * [in]: uint16_t a_ticks
+ * 		 timer 1 ticks till the compare event
+ * [Return]: void
+ */
+void Icu_scheduleCompare(uint16_t a_ticks)
+{
+	uint8_t sreg;
+
+	/* 16-bit registers share the TEMP register with the ISRs */
+	ENTER_CRITICAL_SECTION(sreg);
+	OCR1B_R = TCNT1_R + a_ticks;
+
+	/* clear an old compare flag, writing the flag directly
+	 * to avoid clearing other pending flags in TIFR */
+	TIFR_R = SELECT_BIT(OCF1B);
+	TIMSK_R |= SELECT_BIT(OCIE1B);
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: Icu_cancelCompare
+ * [Function Description]: cancels the pending compare event if any
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void Icu_cancelCompare(void)
+{
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	TIMSK_R &= SELECT_INV_BIT(OCIE1B);
+	TIFR_R = SELECT_BIT(OCF1B);
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+#endif /* ICU_COMPARE_SCHEDULER_ENABLED == 1 */
+
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+
+/*
+ * [Function Name]: Icu_getTimestamp
+ * [Function Description]: returns the current timer 1 count extended to 32-bit
+ * 						   with the number of timer 1 overflows, same time base
+ * 						   as the timestamps of the capture buffer
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 current 32-bit timestamp
+ */
+uint32_t Icu_getTimestamp(void)
+{
+	uint32_t timestamp;
+	uint8_t sreg;
+
+	/* the overflows count and TOV1 must be read with TCNT1 atomically */
+	ENTER_CRITICAL_SECTION(sreg);
+	timestamp = extendCaptureValue(TCNT1_R);
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return timestamp;
+}
+
+/*
+ * [Function Name]: Icu_readCapture
+ * [Function Description]: reads the oldest capture from the capture ring buffer
+ * 						   used with ICU_BUFFER_MODE or ICU_BUFFER_BOTH_EDGES_MODE.
+ * 						   It can be called from the main loop while the ICU
+ * 						   interrupt is filling the buffer
+ * [Args]:
+ * [out]: ST_IcuCapture * a_capture
+ * 		  pointer to store the capture in
+ * [Return]: uint8_t
+ * 			 ICU_CAPTURE_READ or ICU_CAPTURE_BUFFER_EMPTY
+ */
+uint8_t Icu_readCapture(ST_IcuCapture * a_capture)
+{
+	uint8_t tail = g_captureBufferTail;
+
+	if(tail == g_captureBufferHead)
+	{
+		return ICU_CAPTURE_BUFFER_EMPTY;
+	}
+
+	/* the ISR doesn't write to the tail slot till the tail is advanced */
+	*a_capture = g_captureBuffer[tail];
+	g_captureBufferTail = (tail + 1) & (ICU_CAPTURE_BUFFER_SIZE - 1);
+
+	return ICU_CAPTURE_READ;
+}
+
+/*
+ * [Function Name]: Icu_getCapturesCount
+ * [Function Description]: returns number of captures waiting in the capture ring buffer
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 number of captures available to read
+ */
+uint8_t Icu_getCapturesCount(void)
+{
+	return (g_captureBufferHead - g_captureBufferTail) & (ICU_CAPTURE_BUFFER_SIZE - 1);
+}
+
+/*
+ * [Function Name]: Icu_getDroppedCapturesCount
+ * [Function Description]: returns number of captures dropped because the
+ * 						   capture ring buffer was full
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 number of dropped captures since Icu_init()
+ */
+uint16_t Icu_getDroppedCapturesCount(void)
+{
+	uint16_t count;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	count = g_droppedCapturesCount;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return count;
+}
+
+/*
+ * [Function Name]: Icu_measure
+ * [Function Description]: gets the latest measurement of ICU_MEASURE_MODE.
+ * 						   The ICU interrupt alternates the edges and publishes
+ * 						   the sums of each ICU_MEASURE_CYCLES_COUNT cycles without
+ * 						   locks, the conversion to time and frequency is made
+ * 						   here in the caller context
+ * [Args]:
+ * [out]: ST_IcuMeasurement * a_measurement
+ * 		  pointer to store the measurement in, filled only if ICU_MEASURE_VALID
+ * [Return]: uint8_t
+ * 			 ICU_MEASURE_VALID, ICU_MEASURE_STOPPED if no edges for ICU_MEASURE_TIMEOUT_MS
+ * 			 or ICU_MEASURE_NOT_READY if the first cycles aren't measured yet
+ */
+uint8_t Icu_measure(ST_IcuMeasurement * a_measurement)
+{
+	uint8_t sequence, status;
+	EN_IcuPrescaler prescaler;
+	uint32_t periodTicksSum, highTicksSum, divider;
+
+	/* copy the published results, retry if an ISR published new ones meanwhile */
+	do
+	{
+		sequence = g_measureSequence;
+		status = g_measureStatus;
+		prescaler = g_publishedPrescaler;
+		periodTicksSum = g_publishedPeriodTicksSum;
+		highTicksSum = g_publishedHighTicksSum;
+	}while((sequence & 1) || sequence != g_measureSequence);
+
+	if(status != ICU_MEASURE_VALID)
+	{
+		return status;
+	}
+
+	divider = g_prescalerDividers[prescaler];
+
+	/* time = ticks * divider / F_CPU, averaged over the measured cycles */
+	a_measurement->periodUs = (uint32_t)(((uint64_t)periodTicksSum * divider * 1000000UL) / \
+			((uint64_t)F_CPU * ICU_MEASURE_CYCLES_COUNT));
+	a_measurement->highTimeUs = (uint32_t)(((uint64_t)highTicksSum * divider * 1000000UL) / \
+			((uint64_t)F_CPU * ICU_MEASURE_CYCLES_COUNT));
+
+	/* frequency = F_CPU / (average period ticks * divider) */
+	a_measurement->frequencyCentiHz = (uint32_t)(((uint64_t)F_CPU * 100UL * ICU_MEASURE_CYCLES_COUNT) / \
+			((uint64_t)periodTicksSum * divider));
+
+	a_measurement->dutyCycleCentiPercent = (uint16_t)(((uint64_t)highTicksSum * 10000UL) / periodTicksSum);
+	a_measurement->prescaler = prescaler;
+
+	return ICU_MEASURE_VALID;
+}
+
+/*
+ * [Function Name]: extendCaptureValue
+ * [Function Description]: extends a 16-bit timer 1 value to a 32-bit timestamp.
+ * 						   If timer 1 overflowed but the overflow interrupt
+ * 						   isn't serviced yet (TOV1 is still set), the overflow
+ * 						   belongs to the value only if it's in the lower half
+ * 						   of the timer range, i.e. it was taken after the overflow.
+ * 						   Must be called with interrupts disabled
+ * [Args]:
+ * [in]: uint16_t a_value
+ * 		 timer 1 value, TCNT1 or ICR1
+ * [Return]: uint32_t
+ * 			 the 32-bit timestamp
+ */
+static uint32_t extendCaptureValue(uint16_t a_value)
+{
+	uint16_t overflowsCount = g_overflowsCount;
+
+	if(BIT_IS_SET(TIFR_R, TOV1) && a_value < 0x8000)
+	{
+		overflowsCount ++;
+	}
+
+	return ((uint32_t)overflowsCount << 16) | a_value;
+}
+
+/*
+ * [Function Name]: measureProcessEdge
+ * [Function Description]: processes a captured edge in ICU_MEASURE_MODE,
+ * 						   accumulates period and high time of each complete cycle
+ * 						   and publishes the sums every ICU_MEASURE_CYCLES_COUNT cycles.
+ * 						   Called from the capture ISR
+ * [Args]:
+ * [in]: uint32_t a_timestamp
+ * 		 timestamp of the edge
+ * [in]: uint8_t a_edge
+ * 		 the captured edge, ICU_RISING_EDGE or ICU_FALLING_EDGE
+ * [Return]: void
+ */
+static void measureProcessEdge(uint32_t a_timestamp, uint8_t a_edge)
+{
+#if ICU_MEASURE_AUTO_PRESCALER_ENABLED == 1
+	uint32_t averagePeriodTicks;
+	EN_IcuPrescaler prescaler;
+#endif /* ICU_MEASURE_AUTO_PRESCALER_ENABLED == 1 */
+
+	g_measureLastEdgeTimestamp = a_timestamp;
+
+	if(a_edge == ICU_RISING_EDGE)
+	{
+		/* a complete cycle is measured if rising, falling and rising edges are captured */
+		if(g_measureState == ICU_MEASURE_WAIT_RISING)
+		{
+			g_measurePeriodTicksSum += a_timestamp - g_measureRisingTimestamp;
+			g_measureHighTicksSum += g_measureFallingTimestamp - g_measureRisingTimestamp;
+			g_measuredCycles ++;
+
+			if(g_measuredCycles == ICU_MEASURE_CYCLES_COUNT)
+			{
+				measurePublish(ICU_MEASURE_VALID);
+
+#if ICU_MEASURE_AUTO_PRESCALER_ENABLED == 1
+
+				/* switch the prescaler if the period is out of range */
+				averagePeriodTicks = g_measurePeriodTicksSum / ICU_MEASURE_CYCLES_COUNT;
+				prescaler = g_measurePrescaler;
+				if(averagePeriodTicks < ICU_MEASURE_MIN_PERIOD_TICKS && prescaler > ICU_PRESCALER_1)
+				{
+					prescaler --;
+				}
+				else if(averagePeriodTicks > ICU_MEASURE_MAX_PERIOD_TICKS && prescaler < ICU_PRESCALER_1024)
+				{
+					prescaler ++;
+				}
+
+#endif /* ICU_MEASURE_AUTO_PRESCALER_ENABLED == 1 */
+
+				g_measuredCycles = 0;
+				g_measurePeriodTicksSum = 0;
+				g_measureHighTicksSum = 0;
+
+#if ICU_MEASURE_AUTO_PRESCALER_ENABLED == 1
+
+				if(prescaler != g_measurePrescaler)
+				{
+					/* timestamps of different prescalers can't be compared,
+					 * so start again from the next rising edge */
+					COPY_BITS(TCCR1B_R, 0b00000111, prescaler, CS10);
+					g_measurePrescaler = prescaler;
+					g_measureState = ICU_MEASURE_WAIT_FIRST_RISING;
+					return;
+				}
+
+#endif /* ICU_MEASURE_AUTO_PRESCALER_ENABLED == 1 */
+			}
+		}
+		g_measureRisingTimestamp = a_timestamp;
+		g_measureState = ICU_MEASURE_WAIT_FALLING;
+	}
+	else if(g_measureState == ICU_MEASURE_WAIT_FALLING)
+	{
+		g_measureFallingTimestamp = a_timestamp;
+		g_measureState = ICU_MEASURE_WAIT_RISING;
+	}
+}
+
+/*
+ * [Function Name]: measurePublish
+ * [Function Description]: publishes the measure sums and status to Icu_measure(),
+ * 						   the sequence number is odd while writing so the reader
+ * 						   can detect a torn read and retry, no locks are needed.
+ * 						   Called from ISRs only
+ * [Args]:
+ * [in]: uint8_t a_status
+ * 		 ICU_MEASURE_VALID or ICU_MEASURE_STOPPED
+ * [Return]: void
+ */
+static void measurePublish(uint8_t a_status)
+{
+	g_measureSequence ++;
+	g_measureStatus = a_status;
+	g_publishedPrescaler = g_measurePrescaler;
+	g_publishedPeriodTicksSum = g_measurePeriodTicksSum;
+	g_publishedHighTicksSum = g_measureHighTicksSum;
+	g_measureSequence ++;
+}
+
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 1 */
+
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
  *******************************************************************************/
 
 ISR(TIMER1_CAPT_vect)
 {
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+
+	uint8_t head, nextHead;
+
+	if(g_captureMode == ICU_MEASURE_MODE)
+	{
+		measureProcessEdge(extendCaptureValue(ICR1_R), GET_BIT(TCCR1B_R, ICES1));
+
+		/* wait for the opposite edge, ICF1 must be cleared after changing ICES1 */
+		TOGGLE_BIT(TCCR1B_R, ICES1);
+		TIFR_R = SELECT_BIT(ICF1);
+	}
+	else if(g_captureMode != ICU_CALLBACK_MODE)
+	{
+		head = g_captureBufferHead;
+		nextHead = (head + 1) & (ICU_CAPTURE_BUFFER_SIZE - 1);
+
+		if(nextHead == g_captureBufferTail)
+		{
+			/* buffer is full, drop the capture */
+			g_droppedCapturesCount ++;
+		}
+		else
+		{
+			/* store the captured edge and the extended capture value */
+			g_captureBuffer[head].edge = GET_BIT(TCCR1B_R, ICES1);
+			g_captureBuffer[head].timestamp = extendCaptureValue(ICR1_R);
+			g_captureBufferHead = nextHead;
+		}
+
+		if(g_captureMode == ICU_BUFFER_BOTH_EDGES_MODE)
+		{
+			/* wait for the opposite edge, ICF1 must be cleared after changing ICES1 */
+			TOGGLE_BIT(TCCR1B_R, ICES1);
+			TIFR_R = SELECT_BIT(ICF1);
+		}
+	}
+
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 1 */
+
 	if(g_callBackPtr != NULL)
 	{
 		/* Call the Call Back function in the application after the edge is detected */
@@ -180,3 +730,42 @@ ISR(TIMER1_CAPT_vect)
 	}
 }
 
+
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+
+ISR(TIMER1_OVF_vect)
+{
+	/* count timer 1 overflows to extend the timestamps */
+	g_overflowsCount ++;
+
+	/* report a stopped signal if no edges are captured within the timeout */
+	if(g_captureMode == ICU_MEASURE_MODE && g_measureStatus != ICU_MEASURE_STOPPED)
+	{
+		if(((uint32_t)g_overflowsCount << 16) - g_measureLastEdgeTimestamp > \
+				g_measureTimeoutTicks[g_measurePrescaler])
+		{
+			g_measuredCycles = 0;
+			g_measurePeriodTicksSum = 0;
+			g_measureHighTicksSum = 0;
+			g_measureState = ICU_MEASURE_WAIT_FIRST_RISING;
+			measurePublish(ICU_MEASURE_STOPPED);
+		}
+	}
+}
+
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 1 */
+
+#if ICU_COMPARE_SCHEDULER_ENABLED == 1
+
+ISR(TIMER1_COMPB_vect)
+{
+	/* compare events are one-shot, the callback may schedule the next one */
+	TIMSK_R &= SELECT_INV_BIT(OCIE1B);
+
+	if(g_compareCallBackPtr != NULL)
+	{
+		(*g_compareCallBackPtr)();
+	}
+}
+
+#endif /* ICU_COMPARE_SCHEDULER_ENABLED == 1 */
@@ -17,12 +17,28 @@
  *                                Includes	                                   *
  *******************************************************************************/
 
+/* module config file */
+#include "icu-config.h"
+
 /* For using std types */
 #include "../../Lib/types.h"
 
 /* For using common defines and macros */
 #include "../../Lib/common.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* returned from Icu_readCapture() */
+#define ICU_CAPTURE_READ						1
+#define ICU_CAPTURE_BUFFER_EMPTY				0
+
+/* returned from Icu_measure() */
+#define ICU_MEASURE_VALID						2
+#define ICU_MEASURE_STOPPED						1
+#define ICU_MEASURE_NOT_READY					0
+
 /*******************************************************************************
  *                         Types Declaration                                   *
  *******************************************************************************/
@@ -61,6 +77,28 @@ typedef enum
 	ICU_NOISE_CANCELER_ENABLE
 }EN_IcuNoiseCanceler;
 
+/*
+ * [Enum Name]: EN_IcuCaptureMode
+ * [Enum Description]: contains ICU capture modes
+ * 					   ICU_CALLBACK_MODE => the callback must read the capture
+ * 					   value before the next edge overwrites it.
+ * 					   ICU_BUFFER_MODE => every capture is stored with its edge
+ * 					   and a 32-bit timestamp in the capture ring buffer.
+ * 					   ICU_BUFFER_BOTH_EDGES_MODE => same as ICU_BUFFER_MODE, but the
+ * 					   edge detection is toggled after each capture.
+ * 					   ICU_MEASURE_MODE => edges are alternated automatically to
+ * 					   measure period and high time, read them with Icu_measure().
+ * 					   All modes except ICU_CALLBACK_MODE require
+ * 					   ICU_TIMESTAMP_EXTENSION_ENABLED = 1
+ */
+typedef enum
+{
+	ICU_CALLBACK_MODE,
+	ICU_BUFFER_MODE,
+	ICU_BUFFER_BOTH_EDGES_MODE,
+	ICU_MEASURE_MODE
+}EN_IcuCaptureMode;
+
 /*
  * [Enum Name]: ST_IcuConfig
  * [Enum Description]: contains ICU config
@@ -69,8 +107,47 @@ typedef struct
 {
 	EN_IcuPrescaler prescaler;
 	EN_IcuEdgeType edge;
+
+	/* capture mode, ICU_CALLBACK_MODE if not set */
+	EN_IcuCaptureMode captureMode;
 }ST_IcuConfig;
 
+/*
+ * [Struct Name]: ST_IcuCapture
+ * [Struct Description]: contains a capture stored in the capture ring buffer
+ */
+typedef struct
+{
+	/* the edge that was captured */
+	EN_IcuEdgeType edge;
+
+	/* timer 1 count extended to 32-bit by counting timer 1 overflows */
+	uint32_t timestamp;
+}ST_IcuCapture;
+
+/*
+ * [Struct Name]: ST_IcuMeasurement
+ * [Struct Description]: contains the signal measurement of ICU_MEASURE_MODE,
+ * 						 averaged over ICU_MEASURE_CYCLES_COUNT cycles
+ */
+typedef struct
+{
+	/* period of the signal in us */
+	uint32_t periodUs;
+
+	/* high time of the signal in us */
+	uint32_t highTimeUs;
+
+	/* frequency of the signal in 0.01 Hz */
+	uint32_t frequencyCentiHz;
+
+	/* duty cycle of the signal in 0.01 % */
+	uint16_t dutyCycleCentiPercent;
+
+	/* prescaler used in the measurement */
+	EN_IcuPrescaler prescaler;
+}ST_IcuMeasurement;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
@@ -147,4 +224,109 @@ void Icu_clearTimerValue(void);
  */
 void Icu_deInit(void);
 
+#if ICU_COMPARE_SCHEDULER_ENABLED == 1
+
+/*
+ * [Function Name]: Icu_setCompareCallBack
+ * [Function Description]: sets the function called when a scheduled compare event occurs
+ * [Args]:
+ * [in]: void(* volatile a_ptrToHandler)(void)
+ * 		 pointer to callback function
+ * [Return]: void
+ */
+void Icu_setCompareCallBack(void(* volatile a_ptrToHandler)(void));
+
+/*
+ * [Function Name]: Icu_scheduleCompare
+ * [Function Description]: schedules a one-shot compare event after a number of
+ * 						   timer 1 ticks from now, the compare callback is called
+ * 						   from the compare interrupt then. Scheduling again replaces
+ * 						   the pending event, it can be called from the callbacks.
+ * 						   a_ticks must cover the few cycles needed to set the compare,
+ * 						   i.e. 2 or more ticks with prescaler 8 or bigger
+ * [Args]:
+ * [in]: uint16_t a_ticks
+ * 		 timer 1 ticks till the compare event
+ * [Return]: void
+ */
+void Icu_scheduleCompare(uint16_t a_ticks);
+
+/*
+ * [Function Name]: Icu_cancelCompare
+ * [Function Description]: cancels the pending compare event if any
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void Icu_cancelCompare(void);
+
+#endif /* ICU_COMPARE_SCHEDULER_ENABLED == 1 */
+
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 1
+
+/*
+ * [Function Name]: Icu_getTimestamp
+ * [Function Description]: returns the current timer 1 count extended to 32-bit
+ * 						   with the number of timer 1 overflows, same time base
+ * 						   as the timestamps of the capture buffer
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 current 32-bit timestamp
+ */
+uint32_t Icu_getTimestamp(void);
+
+/*
+ * [Function Name]: Icu_readCapture
+ * [Function Description]: reads the oldest capture from the capture ring buffer
+ * 						   used with ICU_BUFFER_MODE or ICU_BUFFER_BOTH_EDGES_MODE.
+ * 						   It can be called from the main loop while the ICU
+ * 						   interrupt is filling the buffer
+ * [Args]:
+ * [out]: ST_IcuCapture * a_capture
+ * 		  pointer to store the capture in
+ * [Return]: uint8_t
+ * 			 ICU_CAPTURE_READ or ICU_CAPTURE_BUFFER_EMPTY
+ */
+uint8_t Icu_readCapture(ST_IcuCapture * a_capture);
+
+/*
+ * [Function Name]: Icu_getCapturesCount
+ * [Function Description]: returns number of captures waiting in the capture ring buffer
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 number of captures available to read
+ */
+uint8_t Icu_getCapturesCount(void);
+
+/*
+ * [Function Name]: Icu_getDroppedCapturesCount
+ * [Function Description]: returns number of captures dropped because the
+ * 						   capture ring buffer was full
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 number of dropped captures since Icu_init()
+ */
+uint16_t Icu_getDroppedCapturesCount(void);
+
+/*
+ * [Function Name]: Icu_measure
+ * [Function Description]: gets the latest measurement of ICU_MEASURE_MODE.
+ * 						   The ICU interrupt alternates the edges and publishes
+ * 						   the sums of each ICU_MEASURE_CYCLES_COUNT cycles without
+ * 						   locks, the conversion to time and frequency is made
+ * 						   here in the caller context
+ * [Args]:
+ * [out]: ST_IcuMeasurement * a_measurement
+ * 		  pointer to store the measurement in, filled only if ICU_MEASURE_VALID
+ * [Return]: uint8_t
+ * 			 ICU_MEASURE_VALID, ICU_MEASURE_STOPPED if no edges for ICU_MEASURE_TIMEOUT_MS
+ * 			 or ICU_MEASURE_NOT_READY if the first cycles aren't measured yet
+ */
+uint8_t Icu_measure(ST_IcuMeasurement * a_measurement);
+
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 1 */
+
 #endif /* __ICU_H__ */
@@ -5,6 +5,7 @@
 
 /** General **/
 #define SFIOR_R 	(*(volatile uint8_t*)(0x50))
+#define SREG_R 		(*(volatile uint8_t*)(0x5F))
 
 /** DIO **/
 /* DDRx Registers */
@@ -79,6 +80,20 @@
 #define SPSR_R 		(*(volatile uint8_t*)(0x2E))
 #define SPDR_R 		(*(volatile uint8_t*)(0x2F))
 
+/** TWI **/
+#define TWBR_R 		(*(volatile uint8_t*)(0x20))
+#define TWSR_R 		(*(volatile uint8_t*)(0x21))
+#define TWAR_R 		(*(volatile uint8_t*)(0x22))
+#define TWDR_R 		(*(volatile uint8_t*)(0x23))
+#define TWCR_R 		(*(volatile uint8_t*)(0x56))
+
+/** EEPROM **/
+#define EEARL_R 	(*(volatile uint8_t*)(0x3E))
+#define EEARH_R 	(*(volatile uint8_t*)(0x3F))
+#define EEAR_R 		(*(volatile uint16_t*)(0x3E))
+#define EEDR_R 		(*(volatile uint8_t*)(0x3D))
+#define EECR_R 		(*(volatile uint8_t*)(0x3C))
+
 /* start address of PORTx = PORTA address */
 #define PORT_START_LOC		(0x3B)
 /* start address of DDRx = DDRA address */
@@ -90,6 +105,9 @@
 
 /** Register bits **/
 
+/* SREG */
+#define I_BIT			7
+
 /* SFIOR */
 #define PSR10			0
 #define PSR2			1
@@ -99,6 +117,12 @@
 #define ADTS1			6
 #define ADTS2			7
 
+/* MCUCR sleep bits */
+#define SM0				4
+#define SM1				5
+#define SM2				6
+#define SE				7
+
 /* External Interrupts */
 #define ISC00			0
 #define ISC01			1
@@ -275,6 +299,38 @@
 #define WCOL			6
 #define SPIF			7
 
+/** TWI **/
+
+/* TWCR */
+#define TWIE			0
+#define TWEN			2
+#define TWWC			3
+#define TWSTO			4
+#define TWSTA			5
+#define TWEA			6
+#define TWINT			7
+
+/* TWSR */
+#define TWPS0			0
+#define TWPS1			1
+
+/* TWAR */
+#define TWGCE			0
+
+#define TWI_SCL_PIN		PC0
+#define TWI_SDA_PIN		PC1
+
+/** EEPROM **/
+
+/* EECR */
+#define EERE			0
+#define EEWE			1
+#define EEMWE			2
+#define EERIE			3
+
+/* EEPROM size in bytes */
+#define EEPROM_SIZE		1024
+
 /* Vector Table */
 
 /* External Interrupt Request 0 */
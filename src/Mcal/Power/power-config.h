@@ -0,0 +1,26 @@
+/******************************************************************************
+ *
+ * Module: POWER
+ *
+ * File Name: power-config.h
+ *
+ * Description: Config file for the AVR sleep modes driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __POWER_CONFIG_H__
+#define __POWER_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* if POWER_STATS_ENABLED = 1, the number of times each sleep mode is entered
+ * is counted, and the time spent in it if a time source is set by
+ * POWER_setTimeSource()
+ */
+#define POWER_STATS_ENABLED						1
+
+#endif /* __POWER_CONFIG_H__ */
@@ -0,0 +1,276 @@
+/******************************************************************************
+ *
+ * Module: POWER
+ *
+ * File Name: power.c
+ *
+ * Description: Source file for the AVR sleep modes driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "power.h"
+
+/* For using mcu registers */
+#include "../Mcu/mcu.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* masks of the MCUCR sleep mode bits and the clock select bits of the timers */
+#define POWER_SLEEP_MODE_MASK				(SELECT_BIT(SM0) | SELECT_BIT(SM1) | SELECT_BIT(SM2))
+#define POWER_TIMER_0_CLOCK_MASK			(SELECT_BIT(CS00) | SELECT_BIT(CS01) | SELECT_BIT(CS02))
+#define POWER_TIMER_1_CLOCK_MASK			(SELECT_BIT(CS10) | SELECT_BIT(CS11) | SELECT_BIT(CS12))
+#define POWER_TIMER_2_CLOCK_MASK			(SELECT_BIT(CS20) | SELECT_BIT(CS21) | SELECT_BIT(CS22))
+
+/* masks of the update busy flags of the asynchronous timer 2 */
+#define POWER_TIMER_2_UPDATE_BUSY_MASK		(SELECT_BIT(TCR2UB) | SELECT_BIT(OCR2UB) | SELECT_BIT(TCN2UB))
+
+/*******************************************************************************
+ *                      	   Global Variables		                           *
+ *******************************************************************************/
+
+#if POWER_STATS_ENABLED == 1
+
+/* statistics of each mode */
+static ST_PowerModeStats g_modesStats[POWER_MODES_COUNT];
+
+/* function returning the time, NULL if the time isn't measured */
+static uint32_t (* volatile g_ptrToTimeSource)(void) = NULL;
+
+#endif /* POWER_STATS_ENABLED == 1 */
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: POWER_idle
+ * [Function Description]: enters the idle sleep mode till any interrupt wakes the cpu,
+ * 						   the timers and the other peripherals keep running.
+ * 						   It must be called with global interrupts disabled, they are
+ * 						   enabled right before the sleep instruction, so an interrupt
+ * 						   that comes after checking the sleep condition can't be missed.
+ * 						   Global interrupts are enabled on return
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void POWER_idle(void)
+{
+	POWER_enterMode(POWER_MODE_IDLE);
+}
+
+/*
+ * [Function Name]: POWER_enterMode
+ * [Function Description]: enters the passed sleep mode till an interrupt wakes the cpu without
+ * 						   checking the enabled peripherals, it must be called with global
+ * 						   interrupts disabled, same as POWER_idle()
+ * [Args]:
+ * [in]: EN_PowerMode a_mode
+ * 		 the sleep mode
+ * [Return]: void
+ */
+void POWER_enterMode(EN_PowerMode a_mode)
+{
+	/* select the mode and enable sleep */
+	MCUCR_R = (MCUCR_R & ~POWER_SLEEP_MODE_MASK) | (a_mode << SM0) | SELECT_BIT(SE);
+
+	/* the instruction after sei is always executed before any pending interrupt */
+	__asm__ __volatile__ ("sei" "\n\t" "sleep" ::);
+
+	/* disable sleep to avoid entering it by mistake */
+	CLEAR_BIT(MCUCR_R, SE);
+}
+
+/*
+ * [Function Name]: POWER_getAllowedMode
+ * [Function Description]: gets the deepest sleep mode that keeps the enabled peripherals
+ * 						   working and can be woken by the enabled interrupts:
+ * 						   - uart, spi, twi, eeprom write, timer 0, timer 1, synchronous
+ * 						     timer 2 or INT0 / INT1 on an edge => idle
+ * 						   - adc converting with its interrupt enabled => adc noise reduction
+ * 						   - asynchronous timer 2 running => power save
+ * 						   - INT2 or INT0 / INT1 on low level => power down
+ * 						   - no wake up source => idle
+ * [Args]:
+ * [in]: void
+ * [Return]: EN_PowerMode
+ * 			 the deepest allowed mode
+ */
+EN_PowerMode POWER_getAllowedMode(void)
+{
+	uint8_t isTimer2Running = ((TCCR2_R & POWER_TIMER_2_CLOCK_MASK) != 0);
+
+	/* peripherals that need the io clock */
+	if(BIT_IS_SET(UCSRB_R, RXEN) || BIT_IS_SET(UCSRB_R, TXEN) ||
+			BIT_IS_SET(SPCR_R, SPE) ||
+			BIT_IS_SET(TWCR_R, TWEN) ||
+			BIT_IS_SET(EECR_R, EERIE) ||
+			(TCCR0_R & POWER_TIMER_0_CLOCK_MASK) != 0 ||
+			(TCCR1B_R & POWER_TIMER_1_CLOCK_MASK) != 0 ||
+			(isTimer2Running && !BIT_IS_SET(ASSR_R, AS2)))
+	{
+		return POWER_MODE_IDLE;
+	}
+
+	/* INT0 and INT1 edges are detected only with the io clock */
+	if((BIT_IS_SET(GICR_R, INT0) && (MCUCR_R & (SELECT_BIT(ISC00) | SELECT_BIT(ISC01))) != 0) ||
+			(BIT_IS_SET(GICR_R, INT1) && (MCUCR_R & (SELECT_BIT(ISC10) | SELECT_BIT(ISC11))) != 0))
+	{
+		return POWER_MODE_IDLE;
+	}
+
+	/* a running conversion, the mode starts a conversion if the adc is enabled, so it's
+	 * selected only when converting and its interrupt is needed to wake the cpu
+	 */
+	if(BIT_IS_SET(ADCSRA_R, ADEN) && (BIT_IS_SET(ADCSRA_R, ADSC) || BIT_IS_SET(ADCSRA_R, ADATE)))
+	{
+		if(BIT_IS_SET(ADCSRA_R, ADIE))
+		{
+			return POWER_MODE_ADC_NOISE_REDUCTION;
+		}
+		return POWER_MODE_IDLE;
+	}
+
+	if(isTimer2Running)
+	{
+		return POWER_MODE_POWER_SAVE;
+	}
+
+	/* the remaining interrupts that can wake the cpu from power down */
+	if(BIT_IS_SET(GICR_R, INT0) || BIT_IS_SET(GICR_R, INT1) || BIT_IS_SET(GICR_R, INT2))
+	{
+		return POWER_MODE_POWER_DOWN;
+	}
+
+	/* no wake up source, an interrupt not checked here can wake the cpu from idle */
+	return POWER_MODE_IDLE;
+}
+
+/*
+ * [Function Name]: POWER_sleep
+ * [Function Description]: enters the deepest allowed sleep mode till an enabled interrupt
+ * 						   wakes the cpu. It's called when there is nothing to do, with
+ * 						   global interrupts disabled, same as POWER_idle().
+ * 						   Global interrupts are enabled on return
+ * [Args]:
+ * [in]: void
+ * [Return]: EN_PowerMode
+ * 			 the mode that was entered
+ */
+EN_PowerMode POWER_sleep(void)
+{
+	EN_PowerMode mode = POWER_getAllowedMode();
+
+#if POWER_STATS_ENABLED == 1
+	uint32_t (* ptrToTimeSource)(void) = g_ptrToTimeSource;
+	uint32_t startTime = 0, sleepTime = 0;
+	uint8_t sreg;
+
+	if(ptrToTimeSource != NULL)
+	{
+		startTime = ptrToTimeSource();
+	}
+#endif /* POWER_STATS_ENABLED == 1 */
+
+	if(mode == POWER_MODE_POWER_SAVE)
+	{
+		/* if power save is entered again within one TOSC1 cycle of a timer 2
+		 * wake up, the timer 2 interrupt never comes, so a register is written
+		 * and its update in the asynchronous clock domain is waited, which
+		 * takes at least one TOSC1 cycle. OCR2 keeps its value
+		 */
+		OCR2_R = OCR2_R;
+		while((ASSR_R & POWER_TIMER_2_UPDATE_BUSY_MASK) != 0);
+	}
+
+	POWER_enterMode(mode);
+
+#if POWER_STATS_ENABLED == 1
+	if(ptrToTimeSource != NULL)
+	{
+		sleepTime = ptrToTimeSource() - startTime;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+	g_modesStats[mode].entriesCount ++;
+	g_modesStats[mode].time += sleepTime;
+	EXIT_CRITICAL_SECTION(sreg);
+#endif /* POWER_STATS_ENABLED == 1 */
+
+	return mode;
+}
+
+#if POWER_STATS_ENABLED == 1
+
+/*
+ * [Function Name]: POWER_setTimeSource
+ * [Function Description]: sets the function used to measure the time spent in each mode,
+ * 						   it's called with global interrupts disabled before sleeping
+ * 						   and from the main code after waking up. The time is only
+ * 						   correct in the modes that keep the source running, i.e. a timer
+ * 						   keeps the cpu in idle mode
+ * [Args]:
+ * [in]: uint32_t (* a_ptrToTimeSource)(void)
+ * 		 function returning a free running time in any unit, NULL to stop measuring the time
+ * [Return]: void
+ */
+void POWER_setTimeSource(uint32_t (* a_ptrToTimeSource)(void))
+{
+	g_ptrToTimeSource = a_ptrToTimeSource;
+}
+
+/*
+ * [Function Name]: POWER_getModeStats
+ * [Function Description]: gets the statistics of a sleep mode
+ * [Args]:
+ * [in]: EN_PowerMode a_mode
+ * 		 the sleep mode
+ * [out]: ST_PowerModeStats * a_stats
+ * 		  struct to store the statistics in
+ * [Return]: void
+ */
+void POWER_getModeStats(EN_PowerMode a_mode, ST_PowerModeStats * a_stats)
+{
+	uint8_t sreg;
+
+	if(a_mode >= POWER_MODES_COUNT)
+	{
+		return;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+	*a_stats = g_modesStats[a_mode];
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: POWER_resetStats
+ * [Function Description]: clears the statistics of all modes
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void POWER_resetStats(void)
+{
+	uint8_t loopCounter;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	for(loopCounter = 0; loopCounter < POWER_MODES_COUNT; loopCounter ++)
+	{
+		g_modesStats[loopCounter].entriesCount = 0;
+		g_modesStats[loopCounter].time = 0;
+	}
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+#endif /* POWER_STATS_ENABLED == 1 */
@@ -0,0 +1,177 @@
+/******************************************************************************
+ *
+ * Module: POWER
+ *
+ * File Name: power.h
+ *
+ * Description: Header file for the AVR sleep modes driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __POWER_H__
+#define __POWER_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module config file */
+#include "power-config.h"
+
+/* For using std types */
+#include "../../Lib/types.h"
+
+/* For using common defines and macros */
+#include "../../Lib/common.h"
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+/*
+ * [Enum Name]: EN_PowerMode
+ * [Enum Description]: contains the sleep modes from the lightest to the deepest,
+ * 					   the values are the SM2:0 bits of each mode
+ */
+typedef enum
+{
+	/* the cpu is stopped, all peripherals keep running, any interrupt wakes it */
+	POWER_MODE_IDLE,
+
+	/* the io clock is stopped too, the adc and the asynchronous timer 2 keep running */
+	POWER_MODE_ADC_NOISE_REDUCTION,
+
+	/* all clocks are stopped, only INT2, INT0 and INT1 low level and twi
+	 * address match wake the cpu, the watchdog resets it
+	 */
+	POWER_MODE_POWER_DOWN,
+
+	/* same as power down, but the asynchronous timer 2 keeps running */
+	POWER_MODE_POWER_SAVE,
+
+	/* number of the modes */
+	POWER_MODES_COUNT
+
+}EN_PowerMode;
+
+#if POWER_STATS_ENABLED == 1
+
+/*
+ * [Struct Name]: ST_PowerModeStats
+ * [Struct Description]: contains the statistics of a sleep mode since the start
+ * 						 or the last POWER_resetStats()
+ */
+typedef struct
+{
+	/* number of times the mode is entered */
+	uint32_t entriesCount;
+
+	/* time spent in the mode in the units of the time source, 0 if no time source is set */
+	uint32_t time;
+
+}ST_PowerModeStats;
+
+#endif /* POWER_STATS_ENABLED == 1 */
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: POWER_idle
+ * [Function Description]: enters the idle sleep mode till any interrupt wakes the cpu,
+ * 						   the timers and the other peripherals keep running.
+ * 						   It must be called with global interrupts disabled, they are
+ * 						   enabled right before the sleep instruction, so an interrupt
+ * 						   that comes after checking the sleep condition can't be missed.
+ * 						   Global interrupts are enabled on return
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void POWER_idle(void);
+
+/*
+ * [Function Name]: POWER_enterMode
+ * [Function Description]: enters the passed sleep mode till an interrupt wakes the cpu without
+ * 						   checking the enabled peripherals, it must be called with global
+ * 						   interrupts disabled, same as POWER_idle()
+ * [Args]:
+ * [in]: EN_PowerMode a_mode
+ * 		 the sleep mode
+ * [Return]: void
+ */
+void POWER_enterMode(EN_PowerMode a_mode);
+
+/*
+ * [Function Name]: POWER_getAllowedMode
+ * [Function Description]: gets the deepest sleep mode that keeps the enabled peripherals
+ * 						   working and can be woken by the enabled interrupts:
+ * 						   - uart, spi, twi, eeprom write, timer 0, timer 1, synchronous
+ * 						     timer 2 or INT0 / INT1 on an edge => idle
+ * 						   - adc converting with its interrupt enabled => adc noise reduction
+ * 						   - asynchronous timer 2 running => power save
+ * 						   - INT2 or INT0 / INT1 on low level => power down
+ * 						   - no wake up source => idle
+ * [Args]:
+ * [in]: void
+ * [Return]: EN_PowerMode
+ * 			 the deepest allowed mode
+ */
+EN_PowerMode POWER_getAllowedMode(void);
+
+/*
+ * [Function Name]: POWER_sleep
+ * [Function Description]: enters the deepest allowed sleep mode till an enabled interrupt
+ * 						   wakes the cpu. It's called when there is nothing to do, with
+ * 						   global interrupts disabled, same as POWER_idle().
+ * 						   Global interrupts are enabled on return
+ * [Args]:
+ * [in]: void
+ * [Return]: EN_PowerMode
+ * 			 the mode that was entered
+ */
+EN_PowerMode POWER_sleep(void);
+
+#if POWER_STATS_ENABLED == 1
+
+/*
+ * [Function Name]: POWER_setTimeSource
+ * [Function Description]: sets the function used to measure the time spent in each mode,
+ * 						   it's called with global interrupts disabled before sleeping
+ * 						   and from the main code after waking up. The time is only
+ * 						   correct in the modes that keep the source running, i.e. a timer
+ * 						   keeps the cpu in idle mode
+ * [Args]:
+ * [in]: uint32_t (* a_ptrToTimeSource)(void)
+ * 		 function returning a free running time in any unit, NULL to stop measuring the time
+ * [Return]: void
+ */
+void POWER_setTimeSource(uint32_t (* a_ptrToTimeSource)(void));
+
+/*
+ * [Function Name]: POWER_getModeStats
+ * [Function Description]: gets the statistics of a sleep mode
+ * [Args]:
+ * [in]: EN_PowerMode a_mode
+ * 		 the sleep mode
+ * [out]: ST_PowerModeStats * a_stats
+ * 		  struct to store the statistics in
+ * [Return]: void
+ */
+void POWER_getModeStats(EN_PowerMode a_mode, ST_PowerModeStats * a_stats);
+
+/*
+ * [Function Name]: POWER_resetStats
+ * [Function Description]: clears the statistics of all modes
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void POWER_resetStats(void);
+
+#endif /* POWER_STATS_ENABLED == 1 */
+
+#endif /* __POWER_H__ */
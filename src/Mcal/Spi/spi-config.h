@@ -27,6 +27,49 @@
  */
 #define SPI_RECEIVE_STRING_TILL			'\r'
 
+/* if SPI_TRANSFER_ENGINE_ENABLED = 1, SPI_transfer() is available to transfer
+ * blocks in the background from the spi interrupt (master only),
+ * the interrupt callback is called only when no transfer is running
+ */
+#define SPI_TRANSFER_ENGINE_ENABLED		1
+
+/* if SPI_TRANSACTION_QUEUE_ENABLED = 1, transactions of several devices,
+ * each with its own chip select pin and settings, can be queued and run
+ * back to back from the spi interrupt, requires SPI_TRANSFER_ENGINE_ENABLED = 1
+ */
+#define SPI_TRANSACTION_QUEUE_ENABLED	1
+
+/* number of transactions the queue can hold,
+ * must be a power of 2 and not greater than 128
+ */
+#define SPI_TRANSACTION_QUEUE_SIZE		8
+
+/* if SPI_SLAVE_ENGINE_ENABLED = 1, the slave engine is available, the spi
+ * interrupt fills a receive ring buffer and loads SPDR from a transmit ring
+ * buffer or from a registers map, see SPI_slaveStartStream() and
+ * SPI_slaveStartRegistersMap(). The master must leave a gap between bytes
+ * long enough for the spi interrupt to load the next byte
+ */
+#define SPI_SLAVE_ENGINE_ENABLED		1
+
+/* size of the slave receive and transmit ring buffers,
+ * must be a power of 2 and not greater than 128
+ */
+#define SPI_SLAVE_RX_BUFFER_SIZE		32
+#define SPI_SLAVE_TX_BUFFER_SIZE		32
+
+/* if SPI_SLAVE_FRAMING_ENABLED = 1, the frames are detected by the edges of
+ * the SS signal, which must be connected to SPI_SLAVE_FRAMING_PIN as well.
+ * It's required by the registers map mode to know the address byte.
+ * It's disabled by default as INT0 and INT1 are used by the encoder
+ */
+#define SPI_SLAVE_FRAMING_ENABLED		0
+
+/* external interrupt pin connected to SS, it must support EXT_INT_ANY_CHANGE
+ * (INT0 or INT1 pin) and must not be deferred
+ */
+#define SPI_SLAVE_FRAMING_PIN			PD3
+
 /* Define F_CPU if not defined to calculate spi clock correctly */
 #ifndef F_CPU
 #define F_CPU 							1000000UL
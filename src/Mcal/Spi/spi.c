@@ -23,6 +23,46 @@
 /* For using DIO module */
 #include "../Dio/dio.h"
 
+#if SPI_SLAVE_ENGINE_ENABLED == 1 && SPI_SLAVE_FRAMING_ENABLED == 1
+
+/* For using the framing interrupt */
+#include "../External-Interrupt/external-interrupt.h"
+
+#endif /* SPI_SLAVE_ENGINE_ENABLED == 1 && SPI_SLAVE_FRAMING_ENABLED == 1 */
+
+#if SPI_TRANSACTION_QUEUE_ENABLED == 1
+
+#if SPI_TRANSFER_ENGINE_ENABLED == 0
+#error "SPI_TRANSACTION_QUEUE_ENABLED requires SPI_TRANSFER_ENGINE_ENABLED = 1"
+#endif
+
+#if (SPI_TRANSACTION_QUEUE_SIZE & (SPI_TRANSACTION_QUEUE_SIZE - 1)) != 0 || SPI_TRANSACTION_QUEUE_SIZE > 128
+#error "SPI_TRANSACTION_QUEUE_SIZE must be a power of 2 and not greater than 128"
+#endif
+
+#endif /* SPI_TRANSACTION_QUEUE_ENABLED == 1 */
+
+#if SPI_SLAVE_ENGINE_ENABLED == 1
+
+#if (SPI_SLAVE_RX_BUFFER_SIZE & (SPI_SLAVE_RX_BUFFER_SIZE - 1)) != 0 || SPI_SLAVE_RX_BUFFER_SIZE > 128
+#error "SPI_SLAVE_RX_BUFFER_SIZE must be a power of 2 and not greater than 128"
+#endif
+
+#if (SPI_SLAVE_TX_BUFFER_SIZE & (SPI_SLAVE_TX_BUFFER_SIZE - 1)) != 0 || SPI_SLAVE_TX_BUFFER_SIZE > 128
+#error "SPI_SLAVE_TX_BUFFER_SIZE must be a power of 2 and not greater than 128"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* slave engine modes */
+#define SPI_SLAVE_STOPPED				0
+#define SPI_SLAVE_STREAM				1
+#define SPI_SLAVE_REGISTERS_MAP			2
+
+#endif /* SPI_SLAVE_ENGINE_ENABLED == 1 */
+
 /*******************************************************************************
  *                            Global Variables	                               *
  *******************************************************************************/
@@ -30,6 +70,163 @@
 /* pointer to spi interrupt handler */
 static void (* volatile g_spiPtrToHandler)(void) = NULL;
 
+#if SPI_TRANSFER_ENGINE_ENABLED == 1
+
+/* running transfer data, modified by SPI_transfer() when no transfer is
+ * running and by the spi interrupt otherwise */
+static const uint8_t * g_transferTxPtr = NULL;
+static uint8_t * g_transferRxPtr = NULL;
+static uint16_t g_transferRemaining = 0;
+static void (* volatile g_transferCallbackPtr)(void) = NULL;
+
+/* TRUE while a transfer is running */
+static volatile uint8_t g_transferActive = FALSE;
+
+/* TRUE if the spi interrupt was enabled before the transfer */
+static uint8_t g_transferInterruptWasEnabled = FALSE;
+
+#endif /* SPI_TRANSFER_ENGINE_ENABLED == 1 */
+
+#if SPI_TRANSACTION_QUEUE_ENABLED == 1
+
+/* queued transactions, modified with interrupts disabled only */
+static ST_SpiTransaction * g_transactionsQueue[SPI_TRANSACTION_QUEUE_SIZE];
+static uint8_t g_transactionsQueueHead = 0;
+static uint8_t g_transactionsQueueTail = 0;
+
+/* the running transaction, NULL if the queue is idle */
+static ST_SpiTransaction * volatile g_currentTransaction = NULL;
+
+/* the device whose chip select is low, NULL if none */
+static const ST_SpiDevice * g_selectedDevice = NULL;
+
+#endif /* SPI_TRANSACTION_QUEUE_ENABLED == 1 */
+
+#if SPI_SLAVE_ENGINE_ENABLED == 1
+
+/* current slave engine mode */
+static volatile uint8_t g_slaveMode = SPI_SLAVE_STOPPED;
+
+/* receive ring buffer, filled by the spi interrupt and emptied by SPI_slaveReadByte() */
+static uint8_t g_slaveRxBuffer[SPI_SLAVE_RX_BUFFER_SIZE];
+static volatile uint8_t g_slaveRxHead = 0;
+static volatile uint8_t g_slaveRxTail = 0;
+
+/* transmit ring buffer, filled by SPI_slaveWriteByte() and emptied by the spi interrupt */
+static uint8_t g_slaveTxBuffer[SPI_SLAVE_TX_BUFFER_SIZE];
+static volatile uint8_t g_slaveTxHead = 0;
+static volatile uint8_t g_slaveTxTail = 0;
+
+/* number of received bytes dropped because the receive buffer was full */
+static volatile uint16_t g_slaveOverrunsCount = 0;
+
+/* registers map mode data */
+static volatile uint8_t * g_slaveRegisters = NULL;
+static uint8_t g_slaveRegistersSize = 0;
+static uint8_t g_slaveRegisterAddress = 0;
+static uint8_t g_slaveRegisterWrite = FALSE;
+
+/* TRUE if the next received byte is the address byte of a frame */
+static volatile uint8_t g_slaveAddressPending = TRUE;
+
+#if SPI_SLAVE_FRAMING_ENABLED == 1
+
+/* pointer to the end of frame callback */
+static void (* volatile g_slaveFramePtrToHandler)(void) = NULL;
+
+#endif /* SPI_SLAVE_FRAMING_ENABLED == 1 */
+
+#endif /* SPI_SLAVE_ENGINE_ENABLED == 1 */
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+#if SPI_SLAVE_ENGINE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_slaveStart
+ * [Function Description]: resets the slave engine buffers and starts it in the given mode
+ * [Args]:
+ * [in]: uint8_t a_mode
+ * 		 SPI_SLAVE_STREAM or SPI_SLAVE_REGISTERS_MAP
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_ERROR
+ */
+static uint8_t SPI_slaveStart(uint8_t a_mode);
+
+/*
+ * [Function Name]: SPI_slaveByteProcessing
+ * [Function Description]: called from the spi interrupt in slave engine modes, loads
+ * 						   the next byte to send to SPDR first then stores the received one
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_slaveByteProcessing(void);
+
+#if SPI_SLAVE_FRAMING_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_slaveFramingProcessing
+ * [Function Description]: callback of the framing interrupt, starts a frame on the
+ * 						   SS falling edge and ends it on the SS rising edge
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_slaveFramingProcessing(void);
+
+#endif /* SPI_SLAVE_FRAMING_ENABLED == 1 */
+
+#endif /* SPI_SLAVE_ENGINE_ENABLED == 1 */
+
+#if SPI_TRANSFER_ENGINE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_startTransfer
+ * [Function Description]: starts a transfer of the interrupt driven engine
+ * [Args]:
+ * [in]: const uint8_t * a_txData
+ * 		 data to send, or NULL to send SPI_DEFAULT_DATA_VALUE
+ * [out]: uint8_t * a_rxData
+ * 		  array to store the received data, or NULL to discard it
+ * [in]: uint16_t a_length
+ * 		 number of bytes to transfer, greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called when the transfer is done, can be NULL
+ * [Return]: void
+ */
+static void SPI_startTransfer(const uint8_t * a_txData, uint8_t * a_rxData, uint16_t a_length, void (* volatile a_ptrToCallback)(void));
+
+#endif /* SPI_TRANSFER_ENGINE_ENABLED == 1 */
+
+#if SPI_TRANSACTION_QUEUE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_startNextTransaction
+ * [Function Description]: starts the next queued transaction if any, applies the
+ * 						   device settings if they changed and selects the device.
+ * 						   Must be called with interrupts disabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_startNextTransaction(void);
+
+/*
+ * [Function Name]: SPI_transactionDone
+ * [Function Description]: called from the spi interrupt when the transfer of the running
+ * 						   transaction is done, releases the chip select if not held,
+ * 						   calls the transaction callback then starts the next one
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_transactionDone(void);
+
+#endif /* SPI_TRANSACTION_QUEUE_ENABLED == 1 */
+
 /*******************************************************************************
  *                          Functions Definition	                           *
  *******************************************************************************/
@@ -313,6 +510,640 @@ void SPI_receiveString(uint8_t * a_str, uint8_t a_maxSize)
 	*a_str = '\0';
 }
 
+/*
+ * [Function Name]: SPI_transferBlocking
+ * [Function Description]: transfers a block in full duplex using busy wait.
+ * 						   The next byte is written to SPDR right after SPIF is set,
+ * 						   before storing the received byte, so the bus is kept
+ * 						   busy even at SPI_CLOCK_2.
+ * 						   It will not generate interrupt even if spi interrupt is enabled
+ * [Args]:
+ * [in]: const uint8_t * a_txData
+ * 		 data to send, or NULL to send SPI_DEFAULT_DATA_VALUE
+ * [out]: uint8_t * a_rxData
+ * 		  array to store the received data, or NULL to discard it
+ * [in]: uint16_t a_length
+ * 		 number of bytes to transfer
+ * [Return]: void
+ */
+void SPI_transferBlocking(const uint8_t * a_txData, uint8_t * a_rxData, uint16_t a_length)
+{
+	uint8_t nextData, receivedData;
+	boolean interruptEnabled = FALSE;
+
+	if(a_length == 0)
+	{
+		return;
+	}
+
+	/* check if the spi interrput is enabled */
+	if(BIT_IS_SET(SPCR_R, SPIE))
+	{
+		/* disable it temporarely */
+		CLEAR_BIT(SPCR_R, SPIE);
+		interruptEnabled = TRUE;
+	}
+
+	/* send the first byte */
+	SPDR_R = (a_txData != NULL) ? *a_txData++ : SPI_DEFAULT_DATA_VALUE;
+
+	while(-- a_length)
+	{
+		/* prepare the next byte while the current one is shifted */
+		nextData = (a_txData != NULL) ? *a_txData++ : SPI_DEFAULT_DATA_VALUE;
+
+		while(BIT_IS_CLEAR(SPSR_R ,SPIF));
+
+		/* the receive buffer is double buffered, so the next byte can be
+		 * written first, then the received byte is read */
+		SPDR_R = nextData;
+		receivedData = SPDR_R;
+		if(a_rxData != NULL)
+		{
+			*a_rxData++ = receivedData;
+		}
+	}
+
+	/* receive the last byte */
+	while(BIT_IS_CLEAR(SPSR_R ,SPIF));
+	receivedData = SPDR_R;
+	if(a_rxData != NULL)
+	{
+		*a_rxData = receivedData;
+	}
+
+	/* re-enable spi enterrupt if it was enabled before entering the function */
+	if(interruptEnabled == TRUE)
+	{
+		SET_BIT(SPCR_R, SPIE);
+	}
+}
+
+#if SPI_TRANSFER_ENGINE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_transfer
+ * [Function Description]: starts a full duplex block transfer driven by the spi interrupt
+ * 						   and returns immediately, the callback is called from the
+ * 						   interrupt when all bytes are transferred.
+ * 						   The buffers must stay valid till then, and the spi
+ * 						   must not be used by other functions meanwhile (master only)
+ * [Args]:
+ * [in]: const uint8_t * a_txData
+ * 		 data to send, or NULL to send SPI_DEFAULT_DATA_VALUE
+ * [out]: uint8_t * a_rxData
+ * 		  array to store the received data, or NULL to discard it
+ * [in]: uint16_t a_length
+ * 		 number of bytes to transfer, must be greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called when the transfer is done, can be NULL
+ * [Return]: uint8_t
+ * 			 SPI_TRANSFER_STARTED or SPI_TRANSFER_REJECTED if a transfer
+ * 			 is running or a_length is 0
+ */
+uint8_t SPI_transfer(const uint8_t * a_txData, uint8_t * a_rxData, uint16_t a_length, void (* volatile a_ptrToCallback)(void))
+{
+	if(g_transferActive == TRUE || a_length == 0)
+	{
+		return SPI_TRANSFER_REJECTED;
+	}
+
+#if SPI_TRANSACTION_QUEUE_ENABLED == 1
+
+	/* the bus belongs to the queue till it's idle */
+	if(g_currentTransaction != NULL || g_selectedDevice != NULL)
+	{
+		return SPI_TRANSFER_REJECTED;
+	}
+
+#endif /* SPI_TRANSACTION_QUEUE_ENABLED == 1 */
+
+	SPI_startTransfer(a_txData, a_rxData, a_length, a_ptrToCallback);
+
+	return SPI_TRANSFER_STARTED;
+}
+
+/*
+ * [Function Name]: SPI_isBusy
+ * [Function Description]: checks if a transfer started by SPI_transfer() is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t SPI_isBusy(void)
+{
+	return g_transferActive;
+}
+
+/*
+ * [Function Name]: SPI_startTransfer
+ * [Function Description]: starts a transfer of the interrupt driven engine
+ * [Args]:
+ * [in]: const uint8_t * a_txData
+ * 		 data to send, or NULL to send SPI_DEFAULT_DATA_VALUE
+ * [out]: uint8_t * a_rxData
+ * 		  array to store the received data, or NULL to discard it
+ * [in]: uint16_t a_length
+ * 		 number of bytes to transfer, greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called when the transfer is done, can be NULL
+ * [Return]: void
+ */
+static void SPI_startTransfer(const uint8_t * a_txData, uint8_t * a_rxData, uint16_t a_length, void (* volatile a_ptrToCallback)(void))
+{
+	g_transferTxPtr = a_txData;
+	g_transferRxPtr = a_rxData;
+	g_transferRemaining = a_length;
+	g_transferCallbackPtr = a_ptrToCallback;
+	g_transferInterruptWasEnabled = GET_BIT(SPCR_R, SPIE);
+	g_transferActive = TRUE;
+
+	/* reading SPSR then writing SPDR clears any old SPIF,
+	 * then the interrupt fires when the first byte is transferred */
+	(void)SPSR_R;
+	SPDR_R = (a_txData != NULL) ? *g_transferTxPtr++ : SPI_DEFAULT_DATA_VALUE;
+	SET_BIT(SPCR_R, SPIE);
+}
+
+#endif /* SPI_TRANSFER_ENGINE_ENABLED == 1 */
+
+#if SPI_TRANSACTION_QUEUE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_initDevice
+ * [Function Description]: initializes the chip select pin of a device as output high,
+ * 						   SPI_initMaster() must be called first
+ * [Args]:
+ * [in]: const ST_SpiDevice * a_device
+ * 		 the device to initialize
+ * [Return]: void
+ */
+void SPI_initDevice(const ST_SpiDevice * a_device)
+{
+	DIO_writePin(a_device->csPin, HIGH);
+	DIO_pinInit(a_device->csPin, PIN_OUTPUT);
+}
+
+/*
+ * [Function Name]: SPI_queueTransaction
+ * [Function Description]: adds a transaction to the queue, the transactions run
+ * 						   back to back from the spi interrupt in the order they
+ * 						   are queued. The spi settings are changed only when the
+ * 						   device settings differ from the previous transaction.
+ * 						   It can be called from callbacks of other transactions
+ * [Args]:
+ * [in]: ST_SpiTransaction * a_transaction
+ * 		 the transaction to queue, it must stay valid till it's done
+ * [Return]: uint8_t
+ * 			 SPI_TRANSACTION_QUEUED, SPI_TRANSACTION_QUEUE_FULL or SPI_TRANSACTION_INVALID
+ * 			 if the transaction or its device is NULL or its length is 0
+ */
+uint8_t SPI_queueTransaction(ST_SpiTransaction * a_transaction)
+{
+	uint8_t nextHead;
+	uint8_t sreg;
+
+	/* a 0 length would be clocked as 65536 bytes by the interrupt */
+	if(a_transaction == NULL || a_transaction->device == NULL || a_transaction->length == 0)
+	{
+		return SPI_TRANSACTION_INVALID;
+	}
+
+	/* transactions may be queued from the main loop and from callbacks */
+	ENTER_CRITICAL_SECTION(sreg);
+
+	nextHead = (g_transactionsQueueHead + 1) & (SPI_TRANSACTION_QUEUE_SIZE - 1);
+	if(nextHead == g_transactionsQueueTail)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return SPI_TRANSACTION_QUEUE_FULL;
+	}
+
+	a_transaction->isDone = FALSE;
+	g_transactionsQueue[g_transactionsQueueHead] = a_transaction;
+	g_transactionsQueueHead = nextHead;
+
+	/* start the queue if idle, otherwise the interrupt starts it */
+	if(g_currentTransaction == NULL)
+	{
+		SPI_startNextTransaction();
+	}
+
+	EXIT_CRITICAL_SECTION(sreg);
+	return SPI_TRANSACTION_QUEUED;
+}
+
+/*
+ * [Function Name]: SPI_getFreeTransactionsCount
+ * [Function Description]: returns number of transactions that can be queued now,
+ * 						   used with interrupts disabled to queue a group of
+ * 						   transactions that must run together
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 number of free places in the queue
+ */
+uint8_t SPI_getFreeTransactionsCount(void)
+{
+	return (SPI_TRANSACTION_QUEUE_SIZE - 1) - \
+			((g_transactionsQueueHead - g_transactionsQueueTail) & (SPI_TRANSACTION_QUEUE_SIZE - 1));
+}
+
+/*
+ * [Function Name]: SPI_startNextTransaction
+ * [Function Description]: starts the next queued transaction if any, applies the
+ * 						   device settings if they changed and selects the device.
+ * 						   Must be called with interrupts disabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_startNextTransaction(void)
+{
+	ST_SpiTransaction * transaction;
+	const ST_SpiDevice * device;
+	uint8_t spcr;
+
+	if(g_transactionsQueueHead == g_transactionsQueueTail)
+	{
+		g_currentTransaction = NULL;
+		return;
+	}
+
+	transaction = g_transactionsQueue[g_transactionsQueueTail];
+	g_transactionsQueueTail = (g_transactionsQueueTail + 1) & (SPI_TRANSACTION_QUEUE_SIZE - 1);
+	device = transaction->device;
+
+	/* release a held device if another device is next */
+	if(g_selectedDevice != NULL && g_selectedDevice != device)
+	{
+		DIO_writePin(g_selectedDevice->csPin, HIGH);
+		g_selectedDevice = NULL;
+	}
+
+	/* apply the device settings only if they differ from the current ones */
+	spcr = (SPCR_R & (uint8_t)~(SELECT_BIT(DORD) | SELECT_BIT(CPOL) | SELECT_BIT(CPHA) | SELECT_BIT(SPR1) | SELECT_BIT(SPR0)))
+			| ((device->dataOrder & 0x01) << DORD)
+			| ((device->dataMode & 0x03) << CPHA)
+			| ((device->clockRate & 0x03) << SPR0);
+	if(spcr != SPCR_R)
+	{
+		SPCR_R = spcr;
+	}
+	if(GET_BIT(SPSR_R, SPI2X) != GET_BIT(device->clockRate, 2))
+	{
+		TOGGLE_BIT(SPSR_R, SPI2X);
+	}
+
+	/* select the device after its clock polarity is set */
+	if(g_selectedDevice == NULL)
+	{
+		DIO_writePin(device->csPin, LOW);
+		g_selectedDevice = device;
+	}
+
+	g_currentTransaction = transaction;
+	SPI_startTransfer(transaction->txData, transaction->rxData, transaction->length, SPI_transactionDone);
+}
+
+/*
+ * [Function Name]: SPI_transactionDone
+ * [Function Description]: called from the spi interrupt when the transfer of the running
+ * 						   transaction is done, releases the chip select if not held,
+ * 						   calls the transaction callback then starts the next one
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_transactionDone(void)
+{
+	ST_SpiTransaction * transaction = g_currentTransaction;
+
+	if(transaction->holdChipSelect == FALSE)
+	{
+		DIO_writePin(transaction->device->csPin, HIGH);
+		g_selectedDevice = NULL;
+	}
+	transaction->isDone = TRUE;
+
+	/* the callback may queue more transactions, they start below */
+	if(transaction->callBack != NULL)
+	{
+		(*transaction->callBack)();
+	}
+
+	SPI_startNextTransaction();
+}
+
+#endif /* SPI_TRANSACTION_QUEUE_ENABLED == 1 */
+
+#if SPI_SLAVE_ENGINE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_slaveStartStream
+ * [Function Description]: starts the slave engine in stream mode, each received byte
+ * 						   is stored in the receive ring buffer and each sent byte is
+ * 						   taken from the transmit ring buffer, or SPI_DEFAULT_DATA_VALUE
+ * 						   if it's empty. SPI_initSlave() must be called first
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_ERROR if SPI_SLAVE_FRAMING_PIN
+ * 			 doesn't support the framing interrupt
+ */
+uint8_t SPI_slaveStartStream(void)
+{
+	return SPI_slaveStart(SPI_SLAVE_STREAM);
+}
+
+/*
+ * [Function Name]: SPI_slaveStartRegistersMap
+ * [Function Description]: starts the slave engine in registers map mode.
+ * 						   The first byte of each frame is the address, bit 7 is
+ * 						   SPI_SLAVE_WRITE_FLAG. The next bytes of the frame are written
+ * 						   to the registers starting from the address, or the registers
+ * 						   starting from the address are sent if it's a read.
+ * 						   Requires SPI_SLAVE_FRAMING_ENABLED = 1, SPI_initSlave() must
+ * 						   be called first
+ * [Args]:
+ * [in]: volatile uint8_t * a_registers
+ * 		 the registers array, it must stay valid while the engine runs
+ * [in]: uint8_t a_size
+ * 		 number of registers, not greater than 128
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_ERROR if SPI_SLAVE_FRAMING_PIN
+ * 			 doesn't support the framing interrupt
+ */
+uint8_t SPI_slaveStartRegistersMap(volatile uint8_t * a_registers, uint8_t a_size)
+{
+#if SPI_SLAVE_FRAMING_ENABLED == 1
+
+	g_slaveRegisters = a_registers;
+	g_slaveRegistersSize = a_size;
+	return SPI_slaveStart(SPI_SLAVE_REGISTERS_MAP);
+
+#else
+
+	/* the address byte can't be known without framing */
+	return SPI_SLAVE_ERROR;
+
+#endif /* SPI_SLAVE_FRAMING_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: SPI_slaveStop
+ * [Function Description]: stops the slave engine
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SPI_slaveStop(void)
+{
+	CLEAR_BIT(SPCR_R, SPIE);
+	g_slaveMode = SPI_SLAVE_STOPPED;
+
+#if SPI_SLAVE_FRAMING_ENABLED == 1
+	EXT_INT_disable(SPI_SLAVE_FRAMING_PIN);
+#endif /* SPI_SLAVE_FRAMING_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: SPI_slaveReadByte
+ * [Function Description]: reads the oldest byte of the receive ring buffer (stream mode)
+ * [Args]:
+ * [out]: uint8_t * a_data
+ * 		  pointer to store the byte in
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_BUFFER_EMPTY
+ */
+uint8_t SPI_slaveReadByte(uint8_t * a_data)
+{
+	uint8_t tail = g_slaveRxTail;
+
+	if(tail == g_slaveRxHead)
+	{
+		return SPI_SLAVE_BUFFER_EMPTY;
+	}
+
+	/* the interrupt doesn't write to the tail slot till the tail is advanced */
+	*a_data = g_slaveRxBuffer[tail];
+	g_slaveRxTail = (tail + 1) & (SPI_SLAVE_RX_BUFFER_SIZE - 1);
+
+	return SPI_SLAVE_SUCCESS;
+}
+
+/*
+ * [Function Name]: SPI_slaveWriteByte
+ * [Function Description]: adds a byte to the transmit ring buffer (stream mode),
+ * 						   it's sent in one of the next bytes the master clocks
+ * [Args]:
+ * [in]: uint8_t a_data
+ * 		 byte to send
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_BUFFER_FULL
+ */
+uint8_t SPI_slaveWriteByte(uint8_t a_data)
+{
+	uint8_t head = g_slaveTxHead;
+	uint8_t nextHead = (head + 1) & (SPI_SLAVE_TX_BUFFER_SIZE - 1);
+
+	if(nextHead == g_slaveTxTail)
+	{
+		return SPI_SLAVE_BUFFER_FULL;
+	}
+
+	/* the interrupt doesn't read the head slot till the head is advanced */
+	g_slaveTxBuffer[head] = a_data;
+	g_slaveTxHead = nextHead;
+
+	return SPI_SLAVE_SUCCESS;
+}
+
+/*
+ * [Function Name]: SPI_slaveGetOverrunsCount
+ * [Function Description]: returns number of received bytes dropped because
+ * 						   the receive ring buffer was full
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 number of dropped bytes
+ */
+uint16_t SPI_slaveGetOverrunsCount(void)
+{
+	uint16_t overrunsCount;
+	uint8_t sreg;
+
+	/* 16-bit value modified by the interrupt */
+	ENTER_CRITICAL_SECTION(sreg);
+	overrunsCount = g_slaveOverrunsCount;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return overrunsCount;
+}
+
+#if SPI_SLAVE_FRAMING_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_slaveSetFrameCallback
+ * [Function Description]: sets the function called from the framing interrupt
+ * 						   at the end of each frame (SS rising edge)
+ * [Args]:
+ * [in]: void (* volatile a_ptrToHandler)(void)
+ * 		 pointer to the callback function
+ * [Return]: void
+ */
+void SPI_slaveSetFrameCallback(void (* volatile a_ptrToHandler)(void))
+{
+	g_slaveFramePtrToHandler = a_ptrToHandler;
+}
+
+#endif /* SPI_SLAVE_FRAMING_ENABLED == 1 */
+
+/*
+ * [Function Name]: SPI_slaveStart
+ * [Function Description]: resets the slave engine buffers and starts it in the given mode
+ * [Args]:
+ * [in]: uint8_t a_mode
+ * 		 SPI_SLAVE_STREAM or SPI_SLAVE_REGISTERS_MAP
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_ERROR
+ */
+static uint8_t SPI_slaveStart(uint8_t a_mode)
+{
+	CLEAR_BIT(SPCR_R, SPIE);
+
+	g_slaveRxHead = 0;
+	g_slaveRxTail = 0;
+	g_slaveTxHead = 0;
+	g_slaveTxTail = 0;
+	g_slaveOverrunsCount = 0;
+	g_slaveAddressPending = TRUE;
+	g_slaveMode = a_mode;
+
+#if SPI_SLAVE_FRAMING_ENABLED == 1
+
+	if(EXT_INT_enable(SPI_SLAVE_FRAMING_PIN, EXT_INT_ANY_CHANGE, SPI_slaveFramingProcessing) == EXT_INT_FAILURE)
+	{
+		g_slaveMode = SPI_SLAVE_STOPPED;
+		return SPI_SLAVE_ERROR;
+	}
+
+#endif /* SPI_SLAVE_FRAMING_ENABLED == 1 */
+
+	/* the first byte sent, clearing any old SPIF */
+	(void)SPSR_R;
+	SPDR_R = SPI_DEFAULT_DATA_VALUE;
+	SET_BIT(SPCR_R, SPIE);
+
+	return SPI_SLAVE_SUCCESS;
+}
+
+/*
+ * [Function Name]: SPI_slaveByteProcessing
+ * [Function Description]: called from the spi interrupt in slave engine modes, loads
+ * 						   the next byte to send to SPDR first then stores the received one
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_slaveByteProcessing(void)
+{
+	uint8_t receivedData = SPDR_R;
+	uint8_t index, nextIndex;
+
+	if(g_slaveMode == SPI_SLAVE_STREAM)
+	{
+		/* the master may clock the next byte any time, so load it first */
+		index = g_slaveTxTail;
+		if(index != g_slaveTxHead)
+		{
+			SPDR_R = g_slaveTxBuffer[index];
+			g_slaveTxTail = (index + 1) & (SPI_SLAVE_TX_BUFFER_SIZE - 1);
+		}
+		else
+		{
+			SPDR_R = SPI_DEFAULT_DATA_VALUE;
+		}
+
+		index = g_slaveRxHead;
+		nextIndex = (index + 1) & (SPI_SLAVE_RX_BUFFER_SIZE - 1);
+		if(nextIndex == g_slaveRxTail)
+		{
+			/* buffer is full, drop the byte */
+			g_slaveOverrunsCount ++;
+		}
+		else
+		{
+			g_slaveRxBuffer[index] = receivedData;
+			g_slaveRxHead = nextIndex;
+		}
+	}
+	else if(g_slaveAddressPending == TRUE)
+	{
+		/* first byte of the frame is the address */
+		g_slaveAddressPending = FALSE;
+		g_slaveRegisterAddress = receivedData & SPI_SLAVE_ADDRESS_MASK;
+		g_slaveRegisterWrite = (receivedData & SPI_SLAVE_WRITE_FLAG) ? TRUE : FALSE;
+
+		if(g_slaveRegisterWrite == FALSE)
+		{
+			SPDR_R = (g_slaveRegisterAddress < g_slaveRegistersSize) ? \
+					g_slaveRegisters[g_slaveRegisterAddress] : SPI_DEFAULT_DATA_VALUE;
+		}
+	}
+	else if(g_slaveRegisterWrite == TRUE)
+	{
+		if(g_slaveRegisterAddress < g_slaveRegistersSize)
+		{
+			g_slaveRegisters[g_slaveRegisterAddress] = receivedData;
+			g_slaveRegisterAddress ++;
+		}
+	}
+	else
+	{
+		/* the register at the address is sent, load the next one */
+		if(g_slaveRegisterAddress < g_slaveRegistersSize)
+		{
+			g_slaveRegisterAddress ++;
+		}
+		SPDR_R = (g_slaveRegisterAddress < g_slaveRegistersSize) ? \
+				g_slaveRegisters[g_slaveRegisterAddress] : SPI_DEFAULT_DATA_VALUE;
+	}
+}
+
+#if SPI_SLAVE_FRAMING_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_slaveFramingProcessing
+ * [Function Description]: callback of the framing interrupt, starts a frame on the
+ * 						   SS falling edge and ends it on the SS rising edge
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_slaveFramingProcessing(void)
+{
+	if(DIO_readPin(SPI_SLAVE_FRAMING_PIN) == LOW)
+	{
+		/* frame start, the next byte is the address in registers map mode */
+		g_slaveAddressPending = TRUE;
+		if(g_slaveMode == SPI_SLAVE_REGISTERS_MAP)
+		{
+			SPDR_R = SPI_DEFAULT_DATA_VALUE;
+		}
+	}
+	else if(g_slaveFramePtrToHandler != NULL)
+	{
+		/* frame end */
+		(*g_slaveFramePtrToHandler)();
+	}
+}
+
+#endif /* SPI_SLAVE_FRAMING_ENABLED == 1 */
+
+#endif /* SPI_SLAVE_ENGINE_ENABLED == 1 */
+
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
  *******************************************************************************/
@@ -320,6 +1151,55 @@ void SPI_receiveString(uint8_t * a_str, uint8_t a_maxSize)
 /* ISR for spi */
 ISR(SPI_STC_vect)
 {
+#if SPI_SLAVE_ENGINE_ENABLED == 1
+
+	if(g_slaveMode != SPI_SLAVE_STOPPED)
+	{
+		SPI_slaveByteProcessing();
+		return;
+	}
+
+#endif /* SPI_SLAVE_ENGINE_ENABLED == 1 */
+
+#if SPI_TRANSFER_ENGINE_ENABLED == 1
+
+	uint8_t receivedData;
+
+	if(g_transferActive == TRUE)
+	{
+		receivedData = SPDR_R;
+		g_transferRemaining --;
+
+		if(g_transferRemaining > 0)
+		{
+			/* keep the bus busy, send the next byte before storing the received one */
+			SPDR_R = (g_transferTxPtr != NULL) ? *g_transferTxPtr++ : SPI_DEFAULT_DATA_VALUE;
+		}
+
+		if(g_transferRxPtr != NULL)
+		{
+			*g_transferRxPtr++ = receivedData;
+		}
+
+		if(g_transferRemaining == 0)
+		{
+			/* restore the spi interrupt state of before the transfer */
+			if(g_transferInterruptWasEnabled == FALSE)
+			{
+				CLEAR_BIT(SPCR_R, SPIE);
+			}
+			g_transferActive = FALSE;
+
+			if(g_transferCallbackPtr != NULL)
+			{
+				(*g_transferCallbackPtr)();
+			}
+		}
+		return;
+	}
+
+#endif /* SPI_TRANSFER_ENGINE_ENABLED == 1 */
+
 	if(g_spiPtrToHandler != NULL)
 	{
 		(*g_spiPtrToHandler)();
@@ -26,6 +26,29 @@
 /* For using common defines and macros */
 #include "../../Lib/common.h"
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* returned from SPI_transfer() */
+#define SPI_TRANSFER_STARTED			1
+#define SPI_TRANSFER_REJECTED			0
+
+/* returned from SPI_queueTransaction() */
+#define SPI_TRANSACTION_QUEUED			1
+#define SPI_TRANSACTION_QUEUE_FULL		0
+#define SPI_TRANSACTION_INVALID			2
+
+/* returned from the slave engine functions */
+#define SPI_SLAVE_SUCCESS				1
+#define SPI_SLAVE_BUFFER_EMPTY			0
+#define SPI_SLAVE_BUFFER_FULL			0
+#define SPI_SLAVE_ERROR					0
+
+/* the address byte of the registers map mode, bit 7 selects write */
+#define SPI_SLAVE_WRITE_FLAG			0x80
+#define SPI_SLAVE_ADDRESS_MASK			0x7F
+
 /*******************************************************************************
  *                             Types Declaration                               *
  *******************************************************************************/
@@ -117,6 +140,63 @@ typedef struct
 
 }ST_SpiSlaveConfig;
 
+#if SPI_TRANSACTION_QUEUE_ENABLED == 1
+
+/*
+ * [Struct Name]: ST_SpiDevice
+ * [Struct Description]: contains the settings of a device on the spi bus,
+ * 						 applied before each of its transactions
+ */
+typedef struct
+{
+	/* chip select pin of the device, active low */
+	uint8_t csPin;
+
+	/* data mode, clock sampling options */
+	EN_SpiDataMode dataMode;
+
+	/* clock rate options */
+	EN_SpiClockRate clockRate;
+
+	/* data order MSB first or last */
+	EN_SpiDataOrder dataOrder;
+
+}ST_SpiDevice;
+
+/*
+ * [Struct Name]: ST_SpiTransaction
+ * [Struct Description]: contains a transaction to queue with SPI_queueTransaction(),
+ * 						 it must stay valid till it's done
+ */
+typedef struct
+{
+	/* the device to transfer with */
+	const ST_SpiDevice * device;
+
+	/* data to send, or NULL to send SPI_DEFAULT_DATA_VALUE */
+	const uint8_t * txData;
+
+	/* array to store the received data, or NULL to discard it */
+	uint8_t * rxData;
+
+	/* number of bytes to transfer, must be greater than 0 */
+	uint16_t length;
+
+	/* if TRUE, the chip select stays low after the transaction, so the next
+	 * transaction of the same device continues the same frame,
+	 * i.e. a command then its data */
+	uint8_t holdChipSelect;
+
+	/* function called from the spi interrupt when the transaction is done, can be NULL */
+	void (* volatile callBack)(void);
+
+	/* set to FALSE when queued and to TRUE when done */
+	volatile uint8_t isDone;
+
+}ST_SpiTransaction;
+
+#endif /* SPI_TRANSACTION_QUEUE_ENABLED == 1 */
+
 /*******************************************************************************
  *                           Function Prototypes                               *
  *******************************************************************************/
@@ -236,4 +316,197 @@ void SPI_sendString(const char * a_str);
  */
 void SPI_receiveString(uint8_t * a_str, uint8_t a_maxSize);
 
+/*
+ * [Function Name]: SPI_transferBlocking
+ * [Function Description]: transfers a block in full duplex using busy wait.
+ * 						   The next byte is written to SPDR right after SPIF is set,
+ * 						   before storing the received byte, so the bus is kept
+ * 						   busy even at SPI_CLOCK_2.
+ * 						   It will not generate interrupt even if spi interrupt is enabled
+ * [Args]:
+ * [in]: const uint8_t * a_txData
+ * 		 data to send, or NULL to send SPI_DEFAULT_DATA_VALUE
+ * [out]: uint8_t * a_rxData
+ * 		  array to store the received data, or NULL to discard it
+ * [in]: uint16_t a_length
+ * 		 number of bytes to transfer
+ * [Return]: void
+ */
+void SPI_transferBlocking(const uint8_t * a_txData, uint8_t * a_rxData, uint16_t a_length);
+
+#if SPI_TRANSFER_ENGINE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_transfer
+ * [Function Description]: starts a full duplex block transfer driven by the spi interrupt
+ * 						   and returns immediately, the callback is called from the
+ * 						   interrupt when all bytes are transferred.
+ * 						   The buffers must stay valid till then, and the spi
+ * 						   must not be used by other functions meanwhile (master only)
+ * [Args]:
+ * [in]: const uint8_t * a_txData
+ * 		 data to send, or NULL to send SPI_DEFAULT_DATA_VALUE
+ * [out]: uint8_t * a_rxData
+ * 		  array to store the received data, or NULL to discard it
+ * [in]: uint16_t a_length
+ * 		 number of bytes to transfer, must be greater than 0
+ * [in]: void (* volatile a_ptrToCallback)(void)
+ * 		 function called when the transfer is done, can be NULL
+ * [Return]: uint8_t
+ * 			 SPI_TRANSFER_STARTED or SPI_TRANSFER_REJECTED if a transfer
+ * 			 is running or a_length is 0
+ */
+uint8_t SPI_transfer(const uint8_t * a_txData, uint8_t * a_rxData, uint16_t a_length, void (* volatile a_ptrToCallback)(void));
+
+/*
+ * [Function Name]: SPI_isBusy
+ * [Function Description]: checks if a transfer started by SPI_transfer() is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t SPI_isBusy(void);
+
+#endif /* SPI_TRANSFER_ENGINE_ENABLED == 1 */
+
+#if SPI_TRANSACTION_QUEUE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_initDevice
+ * [Function Description]: initializes the chip select pin of a device as output high,
+ * 						   SPI_initMaster() must be called first
+ * [Args]:
+ * [in]: const ST_SpiDevice * a_device
+ * 		 the device to initialize
+ * [Return]: void
+ */
+void SPI_initDevice(const ST_SpiDevice * a_device);
+
+/*
+ * [Function Name]: SPI_queueTransaction
+ * [Function Description]: adds a transaction to the queue, the transactions run
+ * 						   back to back from the spi interrupt in the order they
+ * 						   are queued. The spi settings are changed only when the
+ * 						   device settings differ from the previous transaction.
+ * 						   It can be called from callbacks of other transactions
+ * [Args]:
+ * [in]: ST_SpiTransaction * a_transaction
+ * 		 the transaction to queue, it must stay valid till it's done
+ * [Return]: uint8_t
+ * 			 SPI_TRANSACTION_QUEUED, SPI_TRANSACTION_QUEUE_FULL or SPI_TRANSACTION_INVALID
+ * 			 if the transaction or its device is NULL or its length is 0
+ */
+uint8_t SPI_queueTransaction(ST_SpiTransaction * a_transaction);
+
+/*
+ * [Function Name]: SPI_getFreeTransactionsCount
+ * [Function Description]: returns number of transactions that can be queued now,
+ * 						   used with interrupts disabled to queue a group of
+ * 						   transactions that must run together
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 number of free places in the queue
+ */
+uint8_t SPI_getFreeTransactionsCount(void);
+
+#endif /* SPI_TRANSACTION_QUEUE_ENABLED == 1 */
+
+#if SPI_SLAVE_ENGINE_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_slaveStartStream
+ * [Function Description]: starts the slave engine in stream mode, each received byte
+ * 						   is stored in the receive ring buffer and each sent byte is
+ * 						   taken from the transmit ring buffer, or SPI_DEFAULT_DATA_VALUE
+ * 						   if it's empty. SPI_initSlave() must be called first
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_ERROR if SPI_SLAVE_FRAMING_PIN
+ * 			 doesn't support the framing interrupt
+ */
+uint8_t SPI_slaveStartStream(void);
+
+/*
+ * [Function Name]: SPI_slaveStartRegistersMap
+ * [Function Description]: starts the slave engine in registers map mode.
+ * 						   The first byte of each frame is the address, bit 7 is
+ * 						   SPI_SLAVE_WRITE_FLAG. The next bytes of the frame are written
+ * 						   to the registers starting from the address, or the registers
+ * 						   starting from the address are sent if it's a read.
+ * 						   Requires SPI_SLAVE_FRAMING_ENABLED = 1, SPI_initSlave() must
+ * 						   be called first
+ * [Args]:
+ * [in]: volatile uint8_t * a_registers
+ * 		 the registers array, it must stay valid while the engine runs
+ * [in]: uint8_t a_size
+ * 		 number of registers, not greater than 128
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_ERROR if SPI_SLAVE_FRAMING_PIN
+ * 			 doesn't support the framing interrupt
+ */
+uint8_t SPI_slaveStartRegistersMap(volatile uint8_t * a_registers, uint8_t a_size);
+
+/*
+ * [Function Name]: SPI_slaveStop
+ * [Function Description]: stops the slave engine
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SPI_slaveStop(void);
+
+/*
+ * [Function Name]: SPI_slaveReadByte
+ * [Function Description]: reads the oldest byte of the receive ring buffer (stream mode)
+ * [Args]:
+ * [out]: uint8_t * a_data
+ * 		  pointer to store the byte in
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_BUFFER_EMPTY
+ */
+uint8_t SPI_slaveReadByte(uint8_t * a_data);
+
+/*
+ * [Function Name]: SPI_slaveWriteByte
+ * [Function Description]: adds a byte to the transmit ring buffer (stream mode),
+ * 						   it's sent in one of the next bytes the master clocks
+ * [Args]:
+ * [in]: uint8_t a_data
+ * 		 byte to send
+ * [Return]: uint8_t
+ * 			 SPI_SLAVE_SUCCESS or SPI_SLAVE_BUFFER_FULL
+ */
+uint8_t SPI_slaveWriteByte(uint8_t a_data);
+
+/*
+ * [Function Name]: SPI_slaveGetOverrunsCount
+ * [Function Description]: returns number of received bytes dropped because
+ * 						   the receive ring buffer was full
+ * [Args]:
+ * [in]: void
+ * [Return]: uint16_t
+ * 			 number of dropped bytes
+ */
+uint16_t SPI_slaveGetOverrunsCount(void);
+
+#if SPI_SLAVE_FRAMING_ENABLED == 1
+
+/*
+ * [Function Name]: SPI_slaveSetFrameCallback
+ * [Function Description]: sets the function called from the framing interrupt
+ * 						   at the end of each frame (SS rising edge)
+ * [Args]:
+ * [in]: void (* volatile a_ptrToHandler)(void)
+ * 		 pointer to the callback function
+ * [Return]: void
+ */
+void SPI_slaveSetFrameCallback(void (* volatile a_ptrToHandler)(void));
+
+#endif /* SPI_SLAVE_FRAMING_ENABLED == 1 */
+
+#endif /* SPI_SLAVE_ENGINE_ENABLED == 1 */
+
 #endif /* __SPI_H__ */
@@ -60,7 +60,9 @@ static void (* volatile g_timerInterruptHandler[TIMERS_COUNT_SUPPORTED])(void);
 
 /* store the value of overflow start to init the TCNTx register with it in the begining of every ISR */
 static uint8_t g_timer0_ovf_start, g_timer2_ovf_start;
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 0
 static uint16_t g_timer1_ovf_start = 0;
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 0 */
 
 /* store the prescalers after init to use them when TIMER_start() is called*/
 static uint8_t g_timers_init_prescaler[TIMERS_COUNT_SUPPORTED] = { 0 };
@@ -79,7 +81,9 @@ static uint8_t g_timers_init_prescaler[TIMERS_COUNT_SUPPORTED] = { 0 };
  * 						   low F_CPU, because the ISR may take more time
  * 						   than that of the small ticks count so an interrupt is lost,
  * 						   Also avoid ticks = 1 in ovf mode, because it prevents interrupt
- * 						   in the following clock cycle
+ * 						   in the following clock cycle.
+ * 						   In ctc modes, the compare interrupt is enabled only if the handler
+ * 						   isn't NULL, i.e. to toggle an OCx pin without using the cpu
  * [Args]:
  * [in]: TIMER_config* a_timerConfig
  * 		 pointer to a struct containing the config for the timer
@@ -138,8 +142,13 @@ uint8_t TIMER_init(TIMER_config* a_timerConfig){
 				SET_BIT(TCCR0_R, COM00);
 			}
 
-			/* enable timer0 comp interrupt */
-			SET_BIT(TIMSK_R, OCIE0);
+			/* enable timer0 comp interrupt, only if there is a handler
+			 * so toggling OC0 alone doesn't use the cpu */
+			if (a_timerConfig->ptrToHandler != NULL) {
+				SET_BIT(TIMSK_R, OCIE0);
+			} else {
+				CLEAR_BIT(TIMSK_R, OCIE0);
+			}
 			break;
 		default:
 			return TIMER_ERROR;
@@ -152,6 +161,8 @@ uint8_t TIMER_init(TIMER_config* a_timerConfig){
 		case TIMER_1:
 			switch (a_timerConfig->mode) {
 
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 0
+			/* not available if the ICU driver owns timer 1 overflow interrupt */
 			case TIMER_1_OVF:
 				/* set start value of the timer to be equal 65536 - ticks per interrupt */
 				g_timer1_ovf_start = TIMER_1_MAX_COUNT + 1 - ticksPerIteration(a_timerConfig->timer, \
@@ -173,6 +184,7 @@ uint8_t TIMER_init(TIMER_config* a_timerConfig){
 				/* enable timer1 ovf interrupt */
 				SET_BIT(TIMSK_R, TOIE1);
 				break;
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 0 */
 			case TIMER_1_CTC:
 			case TIMER_1_CTC_TOGGLE_OC1A:
 			case TIMER_1_CTC_TOGGLE_OC1B:
@@ -194,8 +206,13 @@ uint8_t TIMER_init(TIMER_config* a_timerConfig){
 				TCCR1A_R = SELECT_BIT(FOC1A) | SELECT_BIT(FOC1B);
 				TCCR1B_R = SELECT_BIT(WGM12);
 
-				/* enable timer1 compA interrupt */
-				SET_BIT(TIMSK_R, OCIE1A);
+				/* enable timer1 compA interrupt, only if there is a handler
+				 * so toggling OC1A / OC1B alone doesn't use the cpu */
+				if (a_timerConfig->ptrToHandler != NULL) {
+					SET_BIT(TIMSK_R, OCIE1A);
+				} else {
+					CLEAR_BIT(TIMSK_R, OCIE1A);
+				}
 
 				/* enable OC1A if mode is TIMER_1_CTC_TOGGLE_OC1A  */
 				if (a_timerConfig->mode == TIMER_1_CTC_TOGGLE_OC1A) {
@@ -272,8 +289,13 @@ uint8_t TIMER_init(TIMER_config* a_timerConfig){
 						SET_BIT(TCCR2_R, COM20);
 					}
 
-					/* enable timer0 comp interrupt */
-					SET_BIT(TIMSK_R, OCIE2);
+					/* enable timer2 comp interrupt, only if there is a handler
+					 * so toggling OC2 alone doesn't use the cpu */
+					if (a_timerConfig->ptrToHandler != NULL) {
+						SET_BIT(TIMSK_R, OCIE2);
+					} else {
+						CLEAR_BIT(TIMSK_R, OCIE2);
+					}
 					break;
 				default:
 					return TIMER_ERROR;
@@ -345,6 +367,57 @@ uint8_t TIMER_stop(uint8_t a_timer){
 	return TIMER_SUCCESS;
 }
 
+/*
+ * [Function Name]: TIMER_setCtcTicks
+ * [Function Description]: changes the period of a timer initialized in a ctc mode without
+ * 						   stopping it, the handler is called on every compare match after
+ * 						   it. It's fast enough to be called from the timer handler to set
+ * 						   the next period, the timer is cleared on the compare match so the
+ * 						   new period starts from it
+ * [Args]:
+ * [in]: uint8_t a_timer
+ * 		 timer to change its period
+ * [in]: uint16_t a_ticks
+ * 		 ticks of the period, from 1 to 256 for TIMER_0 and TIMER_2
+ * [Return]: uint8_t
+ * 			 TIMER_SUCCESS or TIMER_ERROR
+ */
+uint8_t TIMER_setCtcTicks(uint8_t a_timer, uint16_t a_ticks)
+{
+	if(a_ticks == 0)
+	{
+		return TIMER_ERROR;
+	}
+	switch(a_timer)
+	{
+	case TIMER_0:
+		if(a_ticks > TIMER_0_MAX_COUNT + 1)
+		{
+			return TIMER_ERROR;
+		}
+		OCR0_R = a_ticks - 1;
+		break;
+	case TIMER_1:
+		OCR1A_R = a_ticks - 1;
+		break;
+	case TIMER_2:
+		if(a_ticks > TIMER_2_MAX_COUNT + 1)
+		{
+			return TIMER_ERROR;
+		}
+		OCR2_R = a_ticks - 1;
+		break;
+	default:
+		return TIMER_ERROR;
+	}
+
+	/* one compare match per handler call */
+	g_timersInterruptCount[a_timer] = 1;
+	g_timersInterruptActualCount[a_timer] = 1;
+
+	return TIMER_SUCCESS;
+}
+
 /*
  * [Function Name]: TIMER_read
  * [Function Description]: gets the value of the current count of a timer
@@ -570,6 +643,8 @@ ISR(TIMER2_OVF_vect) {
 	}
 }
 
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 0
+
 /* ISR for timer 1 OVF */
 ISR(TIMER1_OVF_vect) {
 	TCNT1_R = g_timer1_ovf_start;
@@ -581,6 +656,8 @@ ISR(TIMER1_OVF_vect) {
 	}
 }
 
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 0 */
+
 /* ISR for timer 1A CTC */
 ISR(TIMER1_COMPA_vect) {
 	if (g_timersInterruptActualCount[TIMER_1] == g_timersInterruptCount[TIMER_1]) {
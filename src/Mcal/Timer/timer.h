@@ -26,6 +26,9 @@
 /* For using common defines and macros */
 #include "../../Lib/common.h"
 
+/* For checking whether timer 1 overflow interrupt is owned by the ICU driver */
+#include "../Icu/icu-config.h"
+
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
@@ -155,11 +158,18 @@ typedef enum
 /*
  * [Enum Name]: TIMER_1_modes
  * [Enum Description]: contains timer 1 available moods
+ * 					   TIMER_1_OVF is not available if ICU_TIMESTAMP_EXTENSION_ENABLED = 1
+ * 					   in icu-config.h, as the ICU driver owns timer 1 overflow interrupt,
+ * 					   so using it fails at compile time instead of in TIMER_init()
  */
 typedef enum
 {
+#if ICU_TIMESTAMP_EXTENSION_ENABLED == 0
 	TIMER_1_OVF = 0x10,
 	TIMER_1_CTC,
+#else
+	TIMER_1_CTC = 0x11,
+#endif /* ICU_TIMESTAMP_EXTENSION_ENABLED == 0 */
 	TIMER_1_CTC_TOGGLE_OC1A,
 	TIMER_1_CTC_TOGGLE_OC1B,
 	TIMER_1_CTC_TOGGLE_OC1A_OC1B
@@ -242,7 +252,9 @@ typedef struct
 	 */
 	uint32_t ticks;
 
-	/* pointer to interrupt handler function */
+	/* pointer to interrupt handler function,
+	 * can be NULL in ctc modes to run the timer without interrupts
+	 */
 	void (* volatile ptrToHandler)(void);
 }TIMER_config;
 
@@ -260,7 +272,9 @@ typedef struct
  * 						   low F_CPU, because the ISR may take more time
  * 						   than that of the small ticks count so an interrupt is lost,
  * 						   Also avoid ticks = 1 in ovf mode, because it prevents interrupt
- * 						   in the following clock cycle
+ * 						   in the following clock cycle.
+ * 						   In ctc modes, the compare interrupt is enabled only if the handler
+ * 						   isn't NULL, i.e. to toggle an OCx pin without using the cpu
  * [Args]:
  * [in]: TIMER_config* a_timerConfig
  * 		 pointer to a struct containing the config for the timer
@@ -292,6 +306,23 @@ uint8_t TIMER_start(uint8_t a_timer);
  */
 uint8_t TIMER_stop(uint8_t a_timer);
 
+/*
+ * [Function Name]: TIMER_setCtcTicks
+ * [Function Description]: changes the period of a timer initialized in a ctc mode without
+ * 						   stopping it, the handler is called on every compare match after
+ * 						   it. It's fast enough to be called from the timer handler to set
+ * 						   the next period, the timer is cleared on the compare match so the
+ * 						   new period starts from it
+ * [Args]:
+ * [in]: uint8_t a_timer
+ * 		 timer to change its period
+ * [in]: uint16_t a_ticks
+ * 		 ticks of the period, from 1 to 256 for TIMER_0 and TIMER_2
+ * [Return]: uint8_t
+ * 			 TIMER_SUCCESS or TIMER_ERROR
+ */
+uint8_t TIMER_setCtcTicks(uint8_t a_timer, uint16_t a_ticks);
+
 /*
  * [Function Name]: TIMER_read
  * [Function Description]: gets the value of the current count of a timer
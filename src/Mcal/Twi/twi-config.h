@@ -0,0 +1,41 @@
+/******************************************************************************
+ *
+ * Module: TWI
+ *
+ * File Name: twi-config.h
+ *
+ * Description: Config file for the TWI (I2C) master driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __TWI_CONFIG_H__
+#define __TWI_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* the scl frequency in Hz, the bit rate and the prescaler
+ * are calculated from it and F_CPU, it must be at most F_CPU / 16.
+ * 50KHz fits the default F_CPU of 1MHz, 100KHz or 400KHz need a faster clock
+ */
+#define TWI_SCL_FREQUENCY				50000UL
+
+/* number of transactions the queue can hold,
+ * must be a power of 2 and not greater than 128
+ */
+#define TWI_TRANSACTION_QUEUE_SIZE		8
+
+/* if TWI_INTERNAL_PULL_UPS_ENABLED = 1, the internal pull ups of scl and sda
+ * are enabled, they are weak so external pull ups are still recommended
+ */
+#define TWI_INTERNAL_PULL_UPS_ENABLED	0
+
+/* Define F_CPU if not defined to calculate twi bit rate correctly */
+#ifndef F_CPU
+#define F_CPU 							1000000UL
+#endif /* F_CPU */
+
+#endif /* __TWI_CONFIG_H__ */
@@ -0,0 +1,528 @@
+/******************************************************************************
+ *
+ * Module: TWI
+ *
+ * File Name: twi.c
+ *
+ * Description: Source file for the TWI (I2C) master driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "twi.h"
+
+/* include mcu header file */
+#include "../Mcu/mcu.h"
+
+/* For using dio functions for the bus recovery */
+#include "../Dio/dio.h"
+
+#if (TWI_TRANSACTION_QUEUE_SIZE & (TWI_TRANSACTION_QUEUE_SIZE - 1)) != 0 || TWI_TRANSACTION_QUEUE_SIZE > 128
+#error "TWI_TRANSACTION_QUEUE_SIZE must be a power of 2 and not greater than 128"
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* scl frequency = F_CPU / (16 + 2 * TWBR * 4 ^ TWPS) */
+#define TWI_BIT_RATE_DIVISOR			(((F_CPU / TWI_SCL_FREQUENCY) - 16) / 2)
+
+/* the divisor is checked first, it underflows if the frequency is too high */
+#if (F_CPU / TWI_SCL_FREQUENCY) < 16
+#error "TWI_SCL_FREQUENCY is too high for F_CPU, it must be at most F_CPU / 16"
+#elif TWI_BIT_RATE_DIVISOR <= 255
+#define TWI_PRESCALER					0
+#define TWI_BIT_RATE					TWI_BIT_RATE_DIVISOR
+#elif (TWI_BIT_RATE_DIVISOR / 4) <= 255
+#define TWI_PRESCALER					1
+#define TWI_BIT_RATE					(TWI_BIT_RATE_DIVISOR / 4)
+#elif (TWI_BIT_RATE_DIVISOR / 16) <= 255
+#define TWI_PRESCALER					2
+#define TWI_BIT_RATE					(TWI_BIT_RATE_DIVISOR / 16)
+#elif (TWI_BIT_RATE_DIVISOR / 64) <= 255
+#define TWI_PRESCALER					3
+#define TWI_BIT_RATE					(TWI_BIT_RATE_DIVISOR / 64)
+#else
+#error "TWI_SCL_FREQUENCY is too low for F_CPU"
+#endif
+
+/* status codes of the master modes, TWSR with the prescaler bits masked */
+#define TWI_STATUS_MASK					0xF8
+#define TWI_STATUS_BUS_ERROR			0x00
+#define TWI_STATUS_START				0x08
+#define TWI_STATUS_REPEATED_START		0x10
+#define TWI_STATUS_SLA_W_ACK			0x18
+#define TWI_STATUS_SLA_W_NACK			0x20
+#define TWI_STATUS_DATA_SENT_ACK		0x28
+#define TWI_STATUS_DATA_SENT_NACK		0x30
+#define TWI_STATUS_ARBITRATION_LOST		0x38
+#define TWI_STATUS_SLA_R_ACK			0x40
+#define TWI_STATUS_SLA_R_NACK			0x48
+#define TWI_STATUS_DATA_RECEIVED_ACK	0x50
+#define TWI_STATUS_DATA_RECEIVED_NACK	0x58
+
+/* read/write bit of the address byte */
+#define TWI_WRITE						0
+#define TWI_READ						1
+
+/* TWCR values, writing TWINT = 1 clears the flag and starts the next step */
+#define TWI_CONTROL_START				(SELECT_BIT(TWINT) | SELECT_BIT(TWSTA) | SELECT_BIT(TWEN) | SELECT_BIT(TWIE))
+#define TWI_CONTROL_STOP				(SELECT_BIT(TWINT) | SELECT_BIT(TWSTO) | SELECT_BIT(TWEN) | SELECT_BIT(TWIE))
+#define TWI_CONTROL_NEXT				(SELECT_BIT(TWINT) | SELECT_BIT(TWEN) | SELECT_BIT(TWIE))
+#define TWI_CONTROL_NEXT_ACK			(SELECT_BIT(TWINT) | SELECT_BIT(TWEA) | SELECT_BIT(TWEN) | SELECT_BIT(TWIE))
+
+/* loops of the bus recovery delay, about half a bit time or more */
+#define TWI_RECOVERY_DELAY_LOOPS		((F_CPU / (TWI_SCL_FREQUENCY * 8UL)) + 1)
+
+/* a slave releases sda after at most 9 clocks (8 data bits and ack) */
+#define TWI_RECOVERY_CLOCKS				9
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* ring buffer of the queued transactions */
+static ST_TwiTransaction * g_transactionsQueue[TWI_TRANSACTION_QUEUE_SIZE];
+static uint8_t g_transactionsQueueHead = 0;
+static volatile uint8_t g_transactionsQueueTail = 0;
+
+/* the running transaction, NULL if idle */
+static ST_TwiTransaction * volatile g_currentTransaction = NULL;
+
+/* index of the next byte to write or read in the running transaction */
+static uint16_t g_dataIndex = 0;
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: TWI_startNextTransaction
+ * [Function Description]: starts the next queued transaction if any by sending a start,
+ * 						   must be called with interrupts disabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void TWI_startNextTransaction(void);
+
+/*
+ * [Function Name]: TWI_transactionDone
+ * [Function Description]: sends a stop, sets the result of the running transaction,
+ * 						   calls its callback then starts the next one
+ * [Args]:
+ * [in]: uint8_t a_result
+ * 		 result of the transaction from EN_TwiResult
+ * [Return]: void
+ */
+static void TWI_transactionDone(uint8_t a_result);
+
+/*
+ * [Function Name]: TWI_releaseBus
+ * [Function Description]: clocks scl till sda is released then generates a stop,
+ * 						   the twi must be disabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void TWI_releaseBus(void);
+
+/*
+ * [Function Name]: TWI_recoveryDelay
+ * [Function Description]: busy waits about half a bit time
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void TWI_recoveryDelay(void);
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: TWI_init
+ * [Function Description]: initializes the twi as master with the bit rate of
+ * 						   TWI_SCL_FREQUENCY, the bus is recovered first if a
+ * 						   slave holds sda low
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void TWI_init(void)
+{
+	TWCR_R = 0;
+
+	g_transactionsQueueHead = 0;
+	g_transactionsQueueTail = 0;
+	g_currentTransaction = NULL;
+
+	TWI_releaseBus();
+
+	TWBR_R = TWI_BIT_RATE;
+	COPY_BITS(TWSR_R, 0x03, TWI_PRESCALER, TWPS0);
+
+	/* the twi overrides the pins directions, the port bits control the pull ups */
+	TWCR_R = SELECT_BIT(TWEN) | SELECT_BIT(TWIE);
+}
+
+/*
+ * [Function Name]: TWI_deInit
+ * [Function Description]: disables the twi, the queued transactions are dropped
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void TWI_deInit(void)
+{
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	TWCR_R = 0;
+	g_transactionsQueueHead = 0;
+	g_transactionsQueueTail = 0;
+	g_currentTransaction = NULL;
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: TWI_queueTransaction
+ * [Function Description]: adds a transaction to the queue, the transactions run
+ * 						   back to back from the twi interrupt in the order they
+ * 						   are queued. A transaction with no data only checks
+ * 						   if the slave acknowledges its address.
+ * 						   It can be called from callbacks of other transactions
+ * [Args]:
+ * [in]: ST_TwiTransaction * a_transaction
+ * 		 the transaction to queue
+ * [Return]: uint8_t
+ * 			 TWI_TRANSACTION_QUEUED or TWI_TRANSACTION_QUEUE_FULL
+ */
+uint8_t TWI_queueTransaction(ST_TwiTransaction * a_transaction)
+{
+	uint8_t nextHead;
+	uint8_t sreg;
+
+	/* transactions may be queued from the main loop and from callbacks */
+	ENTER_CRITICAL_SECTION(sreg);
+
+	nextHead = (g_transactionsQueueHead + 1) & (TWI_TRANSACTION_QUEUE_SIZE - 1);
+	if(nextHead == g_transactionsQueueTail)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return TWI_TRANSACTION_QUEUE_FULL;
+	}
+
+	a_transaction->result = TWI_RESULT_PENDING;
+	g_transactionsQueue[g_transactionsQueueHead] = a_transaction;
+	g_transactionsQueueHead = nextHead;
+
+	/* start the queue if idle, otherwise the interrupt starts it */
+	if(g_currentTransaction == NULL)
+	{
+		TWI_startNextTransaction();
+	}
+
+	EXIT_CRITICAL_SECTION(sreg);
+	return TWI_TRANSACTION_QUEUED;
+}
+
+/*
+ * [Function Name]: TWI_transferBlocking
+ * [Function Description]: writes then reads from a slave and waits till it's done,
+ * 						   the transfer goes through the queue, so global
+ * 						   interrupts must be enabled
+ * [Args]:
+ * [in]: uint8_t a_address
+ * 		 7-bit address of the slave
+ * [in]: const uint8_t * a_writeData
+ * 		 data to write, can be NULL if a_writeLength = 0
+ * [in]: uint16_t a_writeLength
+ * 		 number of bytes to write
+ * [out]: uint8_t * a_readData
+ * 		  array to store the read data, can be NULL if a_readLength = 0
+ * [in]: uint16_t a_readLength
+ * 		 number of bytes to read
+ * [Return]: uint8_t
+ * 			 result of the transfer from EN_TwiResult
+ */
+uint8_t TWI_transferBlocking(uint8_t a_address, const uint8_t * a_writeData, uint16_t a_writeLength,
+		uint8_t * a_readData, uint16_t a_readLength)
+{
+	ST_TwiTransaction transaction;
+
+	transaction.address = a_address;
+	transaction.writeData = a_writeData;
+	transaction.writeLength = a_writeLength;
+	transaction.readData = a_readData;
+	transaction.readLength = a_readLength;
+	transaction.callBack = NULL;
+
+	/* wait for a place in the queue */
+	while(TWI_queueTransaction(&transaction) == TWI_TRANSACTION_QUEUE_FULL);
+
+	while(transaction.result == TWI_RESULT_PENDING);
+
+	return transaction.result;
+}
+
+/*
+ * [Function Name]: TWI_isBusy
+ * [Function Description]: checks if a transaction is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t TWI_isBusy(void)
+{
+	return (g_currentTransaction != NULL);
+}
+
+/*
+ * [Function Name]: TWI_recoverBus
+ * [Function Description]: ends the running transaction with TWI_RESULT_BUS_ERROR,
+ * 						   clocks scl till the slave releases sda then generates
+ * 						   a stop and restarts the queue. Used if a transaction
+ * 						   doesn't end, i.e. a slave was reset in the middle of a read
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void TWI_recoverBus(void)
+{
+	ST_TwiTransaction * transaction;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+
+	TWCR_R = 0;
+	TWI_releaseBus();
+	TWCR_R = SELECT_BIT(TWEN) | SELECT_BIT(TWIE);
+
+	transaction = g_currentTransaction;
+	g_currentTransaction = NULL;
+	if(transaction != NULL)
+	{
+		transaction->result = TWI_RESULT_BUS_ERROR;
+		if(transaction->callBack != NULL)
+		{
+			(*transaction->callBack)();
+		}
+	}
+
+	if(g_currentTransaction == NULL)
+	{
+		TWI_startNextTransaction();
+	}
+
+	EXIT_CRITICAL_SECTION(sreg);
+}
+
+/*
+ * [Function Name]: TWI_startNextTransaction
+ * [Function Description]: starts the next queued transaction if any by sending a start,
+ * 						   must be called with interrupts disabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void TWI_startNextTransaction(void)
+{
+	if(g_transactionsQueueHead == g_transactionsQueueTail)
+	{
+		g_currentTransaction = NULL;
+		return;
+	}
+
+	g_currentTransaction = g_transactionsQueue[g_transactionsQueueTail];
+	g_transactionsQueueTail = (g_transactionsQueueTail + 1) & (TWI_TRANSACTION_QUEUE_SIZE - 1);
+	g_dataIndex = 0;
+
+	/* wait for the stop of the previous transaction, it takes a bit time */
+	while(BIT_IS_SET(TWCR_R, TWSTO));
+
+	TWCR_R = TWI_CONTROL_START;
+}
+
+/*
+ * [Function Name]: TWI_transactionDone
+ * [Function Description]: sends a stop, sets the result of the running transaction,
+ * 						   calls its callback then starts the next one
+ * [Args]:
+ * [in]: uint8_t a_result
+ * 		 result of the transaction from EN_TwiResult
+ * [Return]: void
+ */
+static void TWI_transactionDone(uint8_t a_result)
+{
+	ST_TwiTransaction * transaction = g_currentTransaction;
+
+	TWCR_R = TWI_CONTROL_STOP;
+
+	g_currentTransaction = NULL;
+	transaction->result = a_result;
+
+	/* the callback may queue more transactions, the first one starts from it */
+	if(transaction->callBack != NULL)
+	{
+		(*transaction->callBack)();
+	}
+
+	if(g_currentTransaction == NULL)
+	{
+		TWI_startNextTransaction();
+	}
+}
+
+/*
+ * [Function Name]: TWI_releaseBus
+ * [Function Description]: clocks scl till sda is released then generates a stop,
+ * 						   the twi must be disabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void TWI_releaseBus(void)
+{
+	uint8_t loopCounter;
+
+	/* the lines are driven as open drain, released = input, low = output low */
+	DIO_writePin(TWI_SCL_PIN, LOW);
+	DIO_writePin(TWI_SDA_PIN, LOW);
+	DIO_pinInit(TWI_SCL_PIN, PIN_INPUT);
+	DIO_pinInit(TWI_SDA_PIN, PIN_INPUT);
+	TWI_recoveryDelay();
+
+	for(loopCounter = 0; loopCounter < TWI_RECOVERY_CLOCKS && DIO_readPin(TWI_SDA_PIN) == LOW; loopCounter ++)
+	{
+		DIO_pinInit(TWI_SCL_PIN, PIN_OUTPUT);
+		TWI_recoveryDelay();
+		DIO_pinInit(TWI_SCL_PIN, PIN_INPUT);
+		TWI_recoveryDelay();
+	}
+
+	/* stop: sda rises while scl is high */
+	DIO_pinInit(TWI_SCL_PIN, PIN_OUTPUT);
+	DIO_pinInit(TWI_SDA_PIN, PIN_OUTPUT);
+	TWI_recoveryDelay();
+	DIO_pinInit(TWI_SCL_PIN, PIN_INPUT);
+	TWI_recoveryDelay();
+	DIO_pinInit(TWI_SDA_PIN, PIN_INPUT);
+	TWI_recoveryDelay();
+
+#if TWI_INTERNAL_PULL_UPS_ENABLED == 1
+	DIO_controlPinInternalPull(TWI_SCL_PIN, DIO_PULL_UP);
+	DIO_controlPinInternalPull(TWI_SDA_PIN, DIO_PULL_UP);
+#endif /* TWI_INTERNAL_PULL_UPS_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: TWI_recoveryDelay
+ * [Function Description]: busy waits about half a bit time
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void TWI_recoveryDelay(void)
+{
+	volatile uint16_t loopCounter;
+
+	for(loopCounter = 0; loopCounter < TWI_RECOVERY_DELAY_LOOPS; loopCounter ++);
+}
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(TWI_vect)
+{
+	ST_TwiTransaction * transaction = g_currentTransaction;
+
+	/* an interrupt with no transaction, i.e. after TWI_recoverBus() */
+	if(transaction == NULL)
+	{
+		TWCR_R = TWI_CONTROL_STOP;
+		return;
+	}
+
+	switch(TWSR_R & TWI_STATUS_MASK)
+	{
+	case TWI_STATUS_START:
+	case TWI_STATUS_REPEATED_START:
+		g_dataIndex = 0;
+		/* the read phase follows the repeated start */
+		if((TWSR_R & TWI_STATUS_MASK) == TWI_STATUS_REPEATED_START
+				|| (transaction->writeLength == 0 && transaction->readLength > 0))
+		{
+			TWDR_R = (transaction->address << 1) | TWI_READ;
+		}
+		else
+		{
+			TWDR_R = (transaction->address << 1) | TWI_WRITE;
+		}
+		TWCR_R = TWI_CONTROL_NEXT;
+		break;
+
+	case TWI_STATUS_SLA_W_ACK:
+	case TWI_STATUS_DATA_SENT_ACK:
+		if(g_dataIndex < transaction->writeLength)
+		{
+			TWDR_R = transaction->writeData[g_dataIndex++];
+			TWCR_R = TWI_CONTROL_NEXT;
+		}
+		else if(transaction->readLength > 0)
+		{
+			/* the bus is kept, so no other master can take it between the phases */
+			TWCR_R = TWI_CONTROL_START;
+		}
+		else
+		{
+			TWI_transactionDone(TWI_RESULT_SUCCESS);
+		}
+		break;
+
+	case TWI_STATUS_SLA_W_NACK:
+	case TWI_STATUS_SLA_R_NACK:
+		TWI_transactionDone(TWI_RESULT_ADDRESS_NACK);
+		break;
+
+	case TWI_STATUS_DATA_SENT_NACK:
+		TWI_transactionDone(TWI_RESULT_DATA_NACK);
+		break;
+
+	case TWI_STATUS_ARBITRATION_LOST:
+		/* restart the transaction when the bus is free */
+		g_dataIndex = 0;
+		TWCR_R = TWI_CONTROL_START;
+		break;
+
+	case TWI_STATUS_SLA_R_ACK:
+		/* the last byte is not acknowledged to end the read */
+		TWCR_R = (transaction->readLength > 1) ? TWI_CONTROL_NEXT_ACK : TWI_CONTROL_NEXT;
+		break;
+
+	case TWI_STATUS_DATA_RECEIVED_ACK:
+		transaction->readData[g_dataIndex++] = TWDR_R;
+		TWCR_R = (g_dataIndex < transaction->readLength - 1) ? TWI_CONTROL_NEXT_ACK : TWI_CONTROL_NEXT;
+		break;
+
+	case TWI_STATUS_DATA_RECEIVED_NACK:
+		transaction->readData[g_dataIndex] = TWDR_R;
+		TWI_transactionDone(TWI_RESULT_SUCCESS);
+		break;
+
+	case TWI_STATUS_BUS_ERROR:
+	default:
+		/* illegal start or stop, TWSTO releases the lines without sending a stop */
+		TWI_transactionDone(TWI_RESULT_BUS_ERROR);
+		break;
+	}
+}
@@ -0,0 +1,168 @@
+/******************************************************************************
+ *
+ * Module: TWI
+ *
+ * File Name: twi.h
+ *
+ * Description: Header file for the TWI (I2C) master driver
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __TWI_H__
+#define __TWI_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module config file */
+#include "twi-config.h"
+
+/* for using std types */
+#include "../../Lib/types.h"
+
+/* For using common defines and macros */
+#include "../../Lib/common.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* returned from TWI_queueTransaction() */
+#define TWI_TRANSACTION_QUEUED			1
+#define TWI_TRANSACTION_QUEUE_FULL		0
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+/*
+ * [Enum Name]: EN_TwiResult
+ * [Enum Description]: contains the results of a transaction
+ */
+typedef enum
+{
+	TWI_RESULT_PENDING,
+	TWI_RESULT_SUCCESS,
+	TWI_RESULT_ADDRESS_NACK,
+	TWI_RESULT_DATA_NACK,
+	TWI_RESULT_BUS_ERROR
+}EN_TwiResult;
+
+/*
+ * [Struct Name]: ST_TwiTransaction
+ * [Struct Description]: contains a transaction, the data is written first then
+ * 						 a repeated start reads the data, any of them can be empty.
+ * 						 It must stay valid till it's done
+ */
+typedef struct
+{
+	/* 7-bit address of the slave */
+	uint8_t address;
+
+	/* data to write, can be NULL if writeLength = 0 */
+	const uint8_t * writeData;
+
+	/* number of bytes to write */
+	uint16_t writeLength;
+
+	/* array to store the read data, can be NULL if readLength = 0 */
+	uint8_t * readData;
+
+	/* number of bytes to read */
+	uint16_t readLength;
+
+	/* function called from the twi interrupt when the transaction is done, can be NULL */
+	void (* volatile callBack)(void);
+
+	/* set to TWI_RESULT_PENDING when queued, then to the result from EN_TwiResult */
+	volatile uint8_t result;
+
+}ST_TwiTransaction;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: TWI_init
+ * [Function Description]: initializes the twi as master with the bit rate of
+ * 						   TWI_SCL_FREQUENCY, the bus is recovered first if a
+ * 						   slave holds sda low
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void TWI_init(void);
+
+/*
+ * [Function Name]: TWI_deInit
+ * [Function Description]: disables the twi, the queued transactions are dropped
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void TWI_deInit(void);
+
+/*
+ * [Function Name]: TWI_queueTransaction
+ * [Function Description]: adds a transaction to the queue, the transactions run
+ * 						   back to back from the twi interrupt in the order they
+ * 						   are queued. A transaction with no data only checks
+ * 						   if the slave acknowledges its address.
+ * 						   It can be called from callbacks of other transactions
+ * [Args]:
+ * [in]: ST_TwiTransaction * a_transaction
+ * 		 the transaction to queue
+ * [Return]: uint8_t
+ * 			 TWI_TRANSACTION_QUEUED or TWI_TRANSACTION_QUEUE_FULL
+ */
+uint8_t TWI_queueTransaction(ST_TwiTransaction * a_transaction);
+
+/*
+ * [Function Name]: TWI_transferBlocking
+ * [Function Description]: writes then reads from a slave and waits till it's done,
+ * 						   the transfer goes through the queue, so global
+ * 						   interrupts must be enabled
+ * [Args]:
+ * [in]: uint8_t a_address
+ * 		 7-bit address of the slave
+ * [in]: const uint8_t * a_writeData
+ * 		 data to write, can be NULL if a_writeLength = 0
+ * [in]: uint16_t a_writeLength
+ * 		 number of bytes to write
+ * [out]: uint8_t * a_readData
+ * 		  array to store the read data, can be NULL if a_readLength = 0
+ * [in]: uint16_t a_readLength
+ * 		 number of bytes to read
+ * [Return]: uint8_t
+ * 			 result of the transfer from EN_TwiResult
+ */
+uint8_t TWI_transferBlocking(uint8_t a_address, const uint8_t * a_writeData, uint16_t a_writeLength,
+		uint8_t * a_readData, uint16_t a_readLength);
+
+/*
+ * [Function Name]: TWI_isBusy
+ * [Function Description]: checks if a transaction is running
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if busy, FALSE otherwise
+ */
+uint8_t TWI_isBusy(void);
+
+/*
+ * [Function Name]: TWI_recoverBus
+ * [Function Description]: ends the running transaction with TWI_RESULT_BUS_ERROR,
+ * 						   clocks scl till the slave releases sda then generates
+ * 						   a stop and restarts the queue. Used if a transaction
+ * 						   doesn't end, i.e. a slave was reset in the middle of a read
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void TWI_recoverBus(void);
+
+#endif /* __TWI_H__ */
@@ -0,0 +1,53 @@
+/******************************************************************************
+ *
+ * Module: SCHEDULER
+ *
+ * File Name: scheduler-config.h
+ *
+ * Description: Config file for the cooperative tasks SCHEDULER
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __SCHEDULER_CONFIG_H__
+#define __SCHEDULER_CONFIG_H__
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* number of tasks in the tasks table passed to SCHEDULER_init(), from 1 to 254 */
+#define SCHEDULER_TASKS_COUNT						4
+
+/* the timer used for the scheduler tick, its mode and prescaler, see timer.h.
+ * The mode must be a ctc mode, the timer count is used to measure the
+ * execution time of the tasks so it mustn't be used by any other module.
+ * The prescaler must divide the cpu clocks of one tick, i.e. 8 at 1MHz
+ * or 64 at 16MHz for a 1 ms tick
+ */
+#define SCHEDULER_TIMER								TIMER_0
+#define SCHEDULER_TIMER_MODE						TIMER_0_CTC
+#define SCHEDULER_TIMER_PRESCALER					TIMER_0_PRESCALER_8
+
+/* the division value of SCHEDULER_TIMER_PRESCALER */
+#define SCHEDULER_PRESCALER_VALUE					8
+
+/* the tick period in ms, the tasks periods and phases are in ticks.
+ * The timer counts in one tick must fit in the timer, i.e. 256
+ * counts for TIMER_0 or TIMER_2
+ */
+#define SCHEDULER_TICK_MS							1
+
+/* if SCHEDULER_IDLE_SLEEP_ENABLED = 1, the cpu enters the deepest allowed sleep
+ * mode when there are no ready tasks till the next interrupt, the tick timer
+ * keeps it in idle mode unless it's the asynchronous timer 2
+ */
+#define SCHEDULER_IDLE_SLEEP_ENABLED				1
+
+/* making sure F_CPU is defined */
+#ifndef F_CPU
+#define F_CPU										1000000UL
+#endif /* F_CPU */
+
+#endif /* __SCHEDULER_CONFIG_H__ */
@@ -0,0 +1,457 @@
+/******************************************************************************
+ *
+ * Module: SCHEDULER
+ *
+ * File Name: scheduler.c
+ *
+ * Description: Source file for the cooperative tasks SCHEDULER
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module header file */
+#include "scheduler.h"
+
+/* For using the tick timer */
+#include "../../Mcal/Timer/timer.h"
+
+#if SCHEDULER_IDLE_SLEEP_ENABLED == 1
+
+/* For entering the sleep modes */
+#include "../../Mcal/Power/power.h"
+
+#endif /* SCHEDULER_IDLE_SLEEP_ENABLED == 1 */
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#if SCHEDULER_TASKS_COUNT < 1 || SCHEDULER_TASKS_COUNT > 254
+#error "SCHEDULER_TASKS_COUNT must be from 1 to 254"
+#endif
+
+#if SCHEDULER_TICK_COUNTS < 1
+#error "SCHEDULER_TICK_MS is too small for the selected prescaler"
+#endif
+
+#if ((F_CPU / 1000UL * SCHEDULER_TICK_MS) % SCHEDULER_PRESCALER_VALUE) != 0
+#error "SCHEDULER_PRESCALER_VALUE must divide the cpu clocks of one tick, or the tick is shorter than SCHEDULER_TICK_MS"
+#endif
+
+#if SCHEDULER_TIMER == TIMER_1
+#if SCHEDULER_TICK_COUNTS > (TIMER_1_MAX_COUNT + 1)
+#error "SCHEDULER_TICK_MS is too large for the selected prescaler"
+#endif
+#else
+#if SCHEDULER_TICK_COUNTS > (TIMER_0_MAX_COUNT + 1)
+#error "SCHEDULER_TICK_MS is too large for the selected prescaler"
+#endif
+#endif /* SCHEDULER_TIMER == TIMER_1 */
+
+/* value of g_runningTask when no task is running */
+#define SCHEDULER_NO_TASK					0xFF
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: SCHEDULER_tickProcessing
+ * [Function Description]: called from the timer interrupt every tick, it releases
+ * 						   the tasks whose period has elapsed and counts the overruns
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SCHEDULER_tickProcessing(void);
+
+/*
+ * [Function Name]: SCHEDULER_getReadyTask
+ * [Function Description]: finds the ready task with the highest priority
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 index of the task or SCHEDULER_NO_TASK if no task is ready
+ */
+static uint8_t SCHEDULER_getReadyTask(void);
+
+/*
+ * [Function Name]: SCHEDULER_getCounts
+ * [Function Description]: gets the timer counts since SCHEDULER_start(), used
+ * 						   to measure the execution time of the tasks
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 number of timer counts
+ */
+static uint32_t SCHEDULER_getCounts(void);
+
+/*******************************************************************************
+ *                      	   Global Variables		                           *
+ *******************************************************************************/
+
+/* the tasks table */
+static ST_SchedulerTask g_tasks[SCHEDULER_TASKS_COUNT];
+
+/* ticks till the next release of each task */
+static uint16_t g_ticksToRelease[SCHEDULER_TASKS_COUNT];
+
+/* set when the task is released and cleared when it starts running */
+static volatile uint8_t g_isTaskReady[SCHEDULER_TASKS_COUNT];
+
+/* index of the running task or SCHEDULER_NO_TASK */
+static volatile uint8_t g_runningTask = SCHEDULER_NO_TASK;
+
+/* ticks since SCHEDULER_start() */
+static volatile uint32_t g_ticks = 0;
+
+/* statistics of each task, the execution times are in timer counts */
+static uint32_t g_runsCount[SCHEDULER_TASKS_COUNT];
+static volatile uint16_t g_overrunsCount[SCHEDULER_TASKS_COUNT];
+static uint32_t g_wcetCounts[SCHEDULER_TASKS_COUNT];
+static uint32_t g_busyCounts[SCHEDULER_TASKS_COUNT];
+
+/* timer counts at the start of the statistics window */
+static uint32_t g_statsStartCounts = 0;
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: SCHEDULER_init
+ * [Function Description]: copies the tasks table and initializes the tick timer,
+ * 						   the ticks don't start till SCHEDULER_start() is called
+ * [Args]:
+ * [in]: const ST_SchedulerTask * a_tasks
+ * 		 array of SCHEDULER_TASKS_COUNT tasks
+ * [Return]: void
+ */
+void SCHEDULER_init(const ST_SchedulerTask * a_tasks)
+{
+	uint8_t loopCounter;
+	TIMER_config timerConfig = {
+			SCHEDULER_TIMER,
+			SCHEDULER_TIMER_MODE,
+			SCHEDULER_TIMER_PRESCALER,
+			SCHEDULER_TICK_COUNTS,
+			SCHEDULER_tickProcessing
+	};
+
+	for(loopCounter = 0; loopCounter < SCHEDULER_TASKS_COUNT; loopCounter ++)
+	{
+		g_tasks[loopCounter] = a_tasks[loopCounter];
+		g_isTaskReady[loopCounter] = FALSE;
+	}
+	g_runningTask = SCHEDULER_NO_TASK;
+
+	TIMER_init(&timerConfig);
+
+#if SCHEDULER_IDLE_SLEEP_ENABLED == 1 && POWER_STATS_ENABLED == 1
+	/* the sleep times are counted in the scheduler timer counts */
+	POWER_setTimeSource(SCHEDULER_getCounts);
+#endif /* SCHEDULER_IDLE_SLEEP_ENABLED == 1 && POWER_STATS_ENABLED == 1 */
+}
+
+/*
+ * [Function Name]: SCHEDULER_start
+ * [Function Description]: resets the ticks and the statistics and starts the tick
+ * 						   timer, the tasks with 0 phase are ready directly.
+ * 						   The ticks run from the timer interrupt, so global
+ * 						   interrupts must be enabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SCHEDULER_start(void)
+{
+	uint8_t loopCounter;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+
+	g_ticks = 0;
+	for(loopCounter = 0; loopCounter < SCHEDULER_TASKS_COUNT; loopCounter ++)
+	{
+		if(g_tasks[loopCounter].task == NULL || g_tasks[loopCounter].periodTicks == 0)
+		{
+			/* the task is never released */
+			g_isTaskReady[loopCounter] = FALSE;
+			g_ticksToRelease[loopCounter] = 0;
+		}
+		else if(g_tasks[loopCounter].phaseTicks == 0)
+		{
+			g_isTaskReady[loopCounter] = TRUE;
+			g_ticksToRelease[loopCounter] = g_tasks[loopCounter].periodTicks;
+		}
+		else
+		{
+			g_isTaskReady[loopCounter] = FALSE;
+			g_ticksToRelease[loopCounter] = g_tasks[loopCounter].phaseTicks;
+		}
+	}
+
+	TIMER_start(SCHEDULER_TIMER);
+
+	EXIT_CRITICAL_SECTION(sreg);
+
+	SCHEDULER_resetStats();
+}
+
+/*
+ * [Function Name]: SCHEDULER_stop
+ * [Function Description]: stops the tick timer, the ready tasks still run
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SCHEDULER_stop(void)
+{
+	TIMER_stop(SCHEDULER_TIMER);
+}
+
+/*
+ * [Function Name]: SCHEDULER_dispatch
+ * [Function Description]: runs the ready task with the highest priority to completion
+ * 						   and updates its statistics. If no task is ready, the cpu
+ * 						   enters the deepest allowed sleep mode till the next interrupt if
+ * 						   SCHEDULER_IDLE_SLEEP_ENABLED = 1.
+ * 						   It's called from the main loop instead of the application code
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SCHEDULER_dispatch(void)
+{
+	uint8_t taskIndex;
+	uint32_t startCounts, executionCounts;
+	uint8_t sreg;
+
+	taskIndex = SCHEDULER_getReadyTask();
+
+	if(taskIndex == SCHEDULER_NO_TASK)
+	{
+#if SCHEDULER_IDLE_SLEEP_ENABLED == 1
+		/* check again with the interrupts disabled, so a release after the
+		 * check can't be missed till the next interrupt
+		 */
+		DISABLE_GLOBAL_INTERRUPT();
+		if(SCHEDULER_getReadyTask() == SCHEDULER_NO_TASK)
+		{
+			POWER_sleep();
+		}
+		else
+		{
+			ENABLE_GLOBAL_INTERRUPT();
+		}
+#endif /* SCHEDULER_IDLE_SLEEP_ENABLED == 1 */
+		return;
+	}
+
+	/* a release from now on is an overrun */
+	ENTER_CRITICAL_SECTION(sreg);
+	g_isTaskReady[taskIndex] = FALSE;
+	g_runningTask = taskIndex;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	startCounts = SCHEDULER_getCounts();
+	g_tasks[taskIndex].task();
+	executionCounts = SCHEDULER_getCounts() - startCounts;
+
+	g_runningTask = SCHEDULER_NO_TASK;
+
+	g_runsCount[taskIndex] ++;
+	g_busyCounts[taskIndex] += executionCounts;
+	if(executionCounts > g_wcetCounts[taskIndex])
+	{
+		g_wcetCounts[taskIndex] = executionCounts;
+	}
+}
+
+/*
+ * [Function Name]: SCHEDULER_getTicks
+ * [Function Description]: gets the ticks since SCHEDULER_start()
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 number of ticks
+ */
+uint32_t SCHEDULER_getTicks(void)
+{
+	uint32_t ticks;
+	uint8_t sreg;
+
+	ENTER_CRITICAL_SECTION(sreg);
+	ticks = g_ticks;
+	EXIT_CRITICAL_SECTION(sreg);
+
+	return ticks;
+}
+
+/*
+ * [Function Name]: SCHEDULER_getTaskStats
+ * [Function Description]: gets the statistics of a task, the utilization is calculated
+ * 						   over the time since the statistics were reset, which must be
+ * 						   less than 2^32 timer counts, i.e. about 4.7 hours with the
+ * 						   default config at 16MHz, so reset them periodically
+ * [Args]:
+ * [in]: uint8_t a_taskIndex
+ * 		 index of the task in the tasks table
+ * [out]: ST_SchedulerTaskStats * a_stats
+ * 		  struct to store the statistics in
+ * [Return]: uint8_t
+ * 			 SCHEDULER_SUCCESS or SCHEDULER_ERROR if the index is out of the table
+ */
+uint8_t SCHEDULER_getTaskStats(uint8_t a_taskIndex, ST_SchedulerTaskStats * a_stats)
+{
+	uint32_t windowCounts;
+	uint8_t sreg;
+
+	if(a_taskIndex >= SCHEDULER_TASKS_COUNT)
+	{
+		return SCHEDULER_ERROR;
+	}
+
+	windowCounts = SCHEDULER_getCounts() - g_statsStartCounts;
+
+	a_stats->runsCount = g_runsCount[a_taskIndex];
+
+	ENTER_CRITICAL_SECTION(sreg);
+	a_stats->overrunsCount = g_overrunsCount[a_taskIndex];
+	EXIT_CRITICAL_SECTION(sreg);
+
+	a_stats->wcetUs = SCHEDULER_COUNTS_TO_US(g_wcetCounts[a_taskIndex]);
+
+	if(windowCounts == 0)
+	{
+		a_stats->utilization = 0;
+	}
+	else
+	{
+		a_stats->utilization = (uint16_t)(((uint64_t)g_busyCounts[a_taskIndex] * 1000UL) / windowCounts);
+	}
+
+	return SCHEDULER_SUCCESS;
+}
+
+/*
+ * [Function Name]: SCHEDULER_resetStats
+ * [Function Description]: clears the statistics of all tasks and starts a new
+ * 						   utilization measuring window
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SCHEDULER_resetStats(void)
+{
+	uint8_t loopCounter;
+	uint8_t sreg;
+
+	for(loopCounter = 0; loopCounter < SCHEDULER_TASKS_COUNT; loopCounter ++)
+	{
+		g_runsCount[loopCounter] = 0;
+		g_wcetCounts[loopCounter] = 0;
+		g_busyCounts[loopCounter] = 0;
+
+		ENTER_CRITICAL_SECTION(sreg);
+		g_overrunsCount[loopCounter] = 0;
+		EXIT_CRITICAL_SECTION(sreg);
+	}
+
+	g_statsStartCounts = SCHEDULER_getCounts();
+}
+
+/*
+ * [Function Name]: SCHEDULER_tickProcessing
+ * [Function Description]: called from the timer interrupt every tick, it releases
+ * 						   the tasks whose period has elapsed and counts the overruns
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SCHEDULER_tickProcessing(void)
+{
+	uint8_t loopCounter;
+
+	g_ticks ++;
+
+	for(loopCounter = 0; loopCounter < SCHEDULER_TASKS_COUNT; loopCounter ++)
+	{
+		if(g_ticksToRelease[loopCounter] == 0)
+		{
+			/* the task isn't used */
+			continue;
+		}
+
+		g_ticksToRelease[loopCounter] --;
+		if(g_ticksToRelease[loopCounter] == 0)
+		{
+			g_ticksToRelease[loopCounter] = g_tasks[loopCounter].periodTicks;
+
+			/* the previous release didn't finish yet */
+			if(g_isTaskReady[loopCounter] == TRUE || g_runningTask == loopCounter)
+			{
+				if(g_overrunsCount[loopCounter] != 0xFFFF)
+				{
+					g_overrunsCount[loopCounter] ++;
+				}
+			}
+
+			g_isTaskReady[loopCounter] = TRUE;
+		}
+	}
+}
+
+/*
+ * [Function Name]: SCHEDULER_getReadyTask
+ * [Function Description]: finds the ready task with the highest priority
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 index of the task or SCHEDULER_NO_TASK if no task is ready
+ */
+static uint8_t SCHEDULER_getReadyTask(void)
+{
+	uint8_t loopCounter;
+	uint8_t taskIndex = SCHEDULER_NO_TASK;
+
+	for(loopCounter = 0; loopCounter < SCHEDULER_TASKS_COUNT; loopCounter ++)
+	{
+		if(g_isTaskReady[loopCounter] == TRUE && (taskIndex == SCHEDULER_NO_TASK || \
+				g_tasks[loopCounter].priority < g_tasks[taskIndex].priority))
+		{
+			taskIndex = loopCounter;
+		}
+	}
+
+	return taskIndex;
+}
+
+/*
+ * [Function Name]: SCHEDULER_getCounts
+ * [Function Description]: gets the timer counts since SCHEDULER_start(), used
+ * 						   to measure the execution time of the tasks
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 number of timer counts
+ */
+static uint32_t SCHEDULER_getCounts(void)
+{
+	uint32_t ticks;
+	uint16_t counts;
+
+	/* read again if a tick came while reading the timer */
+	do
+	{
+		ticks = SCHEDULER_getTicks();
+		counts = TIMER_read(SCHEDULER_TIMER);
+	}while(ticks != SCHEDULER_getTicks());
+
+	return ticks * SCHEDULER_TICK_COUNTS + counts;
+}
@@ -0,0 +1,186 @@
+/******************************************************************************
+ *
+ * Module: SCHEDULER
+ *
+ * File Name: scheduler.h
+ *
+ * Description: Header file for the cooperative tasks SCHEDULER
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* module config file */
+#include "scheduler-config.h"
+
+/* for using std types */
+#include "../../Lib/types.h"
+
+/* For using common defines and macros */
+#include "../../Lib/common.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* results of the scheduler functions */
+#define SCHEDULER_SUCCESS						1
+#define SCHEDULER_ERROR							0
+
+/* timer counts in one tick */
+#define SCHEDULER_TICK_COUNTS					(F_CPU / 1000UL * SCHEDULER_TICK_MS / SCHEDULER_PRESCALER_VALUE)
+
+/*******************************************************************************
+ *                                Macros                                       *
+ *******************************************************************************/
+
+/* converts a time in ms to scheduler ticks, to be used for the tasks periods and phases */
+#define SCHEDULER_MS_TO_TICKS(time)				((uint16_t)((time) / SCHEDULER_TICK_MS))
+
+/* converts scheduler timer counts to us, i.e. the sleep times counted by the POWER driver */
+#define SCHEDULER_COUNTS_TO_US(counts)			((uint32_t)(((uint64_t)(counts) * SCHEDULER_PRESCALER_VALUE * 1000000UL) / F_CPU))
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+/*
+ * [Struct Name]: ST_SchedulerTask
+ * [Struct Description]: contains a task in the tasks table, the task function
+ * 						 must return quickly without busy waiting, as the other
+ * 						 tasks run only when it returns
+ */
+typedef struct
+{
+	/* function of the task, NULL if the task isn't used */
+	void (* task)(void);
+
+	/* ticks between the releases of the task, greater than 0 */
+	uint16_t periodTicks;
+
+	/* ticks from SCHEDULER_start() till the first release */
+	uint16_t phaseTicks;
+
+	/* 0 is the highest priority, tasks with the same priority
+	 * run in their order in the table
+	 */
+	uint8_t priority;
+
+}ST_SchedulerTask;
+
+/*
+ * [Struct Name]: ST_SchedulerTaskStats
+ * [Struct Description]: contains the statistics of a task since SCHEDULER_start()
+ * 						 or the last SCHEDULER_resetStats()
+ */
+typedef struct
+{
+	/* number of times the task ran */
+	uint32_t runsCount;
+
+	/* number of releases that came while the task was still ready or running,
+	 * i.e. the task didn't finish before its next release
+	 */
+	uint16_t overrunsCount;
+
+	/* worst case execution time in us, including the interrupts that came while running */
+	uint32_t wcetUs;
+
+	/* cpu utilization of the task in per mille (0 to 1000) */
+	uint16_t utilization;
+
+}ST_SchedulerTaskStats;
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: SCHEDULER_init
+ * [Function Description]: copies the tasks table and initializes the tick timer,
+ * 						   the ticks don't start till SCHEDULER_start() is called
+ * [Args]:
+ * [in]: const ST_SchedulerTask * a_tasks
+ * 		 array of SCHEDULER_TASKS_COUNT tasks
+ * [Return]: void
+ */
+void SCHEDULER_init(const ST_SchedulerTask * a_tasks);
+
+/*
+ * [Function Name]: SCHEDULER_start
+ * [Function Description]: resets the ticks and the statistics and starts the tick
+ * 						   timer, the tasks with 0 phase are ready directly.
+ * 						   The ticks run from the timer interrupt, so global
+ * 						   interrupts must be enabled
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SCHEDULER_start(void);
+
+/*
+ * [Function Name]: SCHEDULER_stop
+ * [Function Description]: stops the tick timer, the ready tasks still run
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SCHEDULER_stop(void);
+
+/*
+ * [Function Name]: SCHEDULER_dispatch
+ * [Function Description]: runs the ready task with the highest priority to completion
+ * 						   and updates its statistics. If no task is ready, the cpu
+ * 						   enters the deepest allowed sleep mode till the next interrupt if
+ * 						   SCHEDULER_IDLE_SLEEP_ENABLED = 1.
+ * 						   It's called from the main loop instead of the application code
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SCHEDULER_dispatch(void);
+
+/*
+ * [Function Name]: SCHEDULER_getTicks
+ * [Function Description]: gets the ticks since SCHEDULER_start()
+ * [Args]:
+ * [in]: void
+ * [Return]: uint32_t
+ * 			 number of ticks
+ */
+uint32_t SCHEDULER_getTicks(void);
+
+/*
+ * [Function Name]: SCHEDULER_getTaskStats
+ * [Function Description]: gets the statistics of a task, the utilization is calculated
+ * 						   over the time since the statistics were reset, which must be
+ * 						   less than 2^32 timer counts, i.e. about 4.7 hours with the
+ * 						   default config at 16MHz, so reset them periodically
+ * [Args]:
+ * [in]: uint8_t a_taskIndex
+ * 		 index of the task in the tasks table
+ * [out]: ST_SchedulerTaskStats * a_stats
+ * 		  struct to store the statistics in
+ * [Return]: uint8_t
+ * 			 SCHEDULER_SUCCESS or SCHEDULER_ERROR if the index is out of the table
+ */
+uint8_t SCHEDULER_getTaskStats(uint8_t a_taskIndex, ST_SchedulerTaskStats * a_stats);
+
+/*
+ * [Function Name]: SCHEDULER_resetStats
+ * [Function Description]: clears the statistics of all tasks and starts a new
+ * 						   utilization measuring window
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void SCHEDULER_resetStats(void);
+
+#endif /* __SCHEDULER_H__ */
@@ -0,0 +1,245 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: host-mcu.c
+ *
+ * Description: Register file and interrupts of the host tests
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+#include "host-test.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* number of devices models a test can add */
+#define HOST_DEVICES_COUNT			4
+
+/* interrupts delivered in one HOST_runInterrupts() call before failing the test,
+ * i.e. a test transfers a few KB at most with one interrupt per byte */
+#define HOST_MAX_INTERRUPTS			100000UL
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+volatile uint8_t g_hostRegisters[HOST_REGISTERS_COUNT];
+
+unsigned int g_testsCount = 0;
+unsigned int g_testFailuresCount = 0;
+
+/* the added devices models */
+static const ST_HostDevice * g_devices[HOST_DEVICES_COUNT];
+static uint8_t g_devicesCount = 0;
+
+/* TRUE while an interrupt service routine runs, no other one is delivered */
+static uint8_t g_isInInterrupt = FALSE;
+
+/* TRUE while the models are updated, their register accesses don't update them again */
+static uint8_t g_isUpdating = FALSE;
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: HOST_updateDevices
+ * [Function Description]: runs the update of all the devices models
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void HOST_updateDevices(void);
+
+/*******************************************************************************
+ *                          Functions Definition	                           *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: HOST_accessRegister
+ * [Function Description]: runs the devices models then returns the register
+ * [Args]:
+ * [in]: uint8_t a_address
+ * 		 io space address of the register
+ * [Return]: volatile uint8_t *
+ * 			 pointer to the register
+ */
+volatile uint8_t * HOST_accessRegister(uint8_t a_address)
+{
+	HOST_updateDevices();
+
+	return &g_hostRegisters[a_address];
+}
+
+/*
+ * [Function Name]: HOST_addDevice
+ * [Function Description]: adds a device model, up to HOST_DEVICES_COUNT
+ * [Args]:
+ * [in]: const ST_HostDevice * a_device
+ * 		 the device, it must stay valid
+ * [Return]: void
+ */
+void HOST_addDevice(const ST_HostDevice * a_device)
+{
+	if(g_devicesCount == HOST_DEVICES_COUNT)
+	{
+		printf("host: more than %d devices\n", HOST_DEVICES_COUNT);
+		exit(EXIT_FAILURE);
+	}
+
+	g_devices[g_devicesCount++] = a_device;
+}
+
+/*
+ * [Function Name]: HOST_reset
+ * [Function Description]: removes the devices and clears the registers,
+ * 						   the global interrupts are disabled like after a reset
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void HOST_reset(void)
+{
+	uint8_t address;
+
+	for(address = 0; address < HOST_REGISTERS_COUNT; address ++)
+	{
+		g_hostRegisters[address] = 0;
+	}
+
+	g_devicesCount = 0;
+	g_isInInterrupt = FALSE;
+}
+
+/*
+ * [Function Name]: HOST_enableGlobalInterrupt
+ * [Function Description]: sets the I bit and delivers the pending interrupts
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void HOST_enableGlobalInterrupt(void)
+{
+	SET_BIT(g_hostRegisters[0x5F], I_BIT);
+	HOST_runInterrupts();
+}
+
+/*
+ * [Function Name]: HOST_disableGlobalInterrupt
+ * [Function Description]: clears the I bit
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void HOST_disableGlobalInterrupt(void)
+{
+	CLEAR_BIT(g_hostRegisters[0x5F], I_BIT);
+}
+
+/*
+ * [Function Name]: HOST_restoreStatus
+ * [Function Description]: restores SREG saved on entering a critical section
+ * 						   and delivers the pending interrupts if they are enabled
+ * [Args]:
+ * [in]: uint8_t a_sreg
+ * 		 the saved status register
+ * [Return]: void
+ */
+void HOST_restoreStatus(uint8_t a_sreg)
+{
+	g_hostRegisters[0x5F] = a_sreg;
+	HOST_runInterrupts();
+}
+
+/*
+ * [Function Name]: HOST_runInterrupts
+ * [Function Description]: delivers the pending interrupts till none is pending,
+ * 						   nothing is delivered from an interrupt or while the
+ * 						   global interrupts are disabled. The test fails if an
+ * 						   interrupt keeps firing, i.e. its flag is never cleared
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void HOST_runInterrupts(void)
+{
+	uint32_t interruptsCount;
+	uint8_t index;
+	const ST_HostDevice * device;
+
+	if(g_isInInterrupt == TRUE)
+	{
+		return;
+	}
+
+	for(interruptsCount = 0; interruptsCount < HOST_MAX_INTERRUPTS; interruptsCount ++)
+	{
+		HOST_updateDevices();
+
+		if(BIT_IS_CLEAR(g_hostRegisters[0x5F], I_BIT))
+		{
+			return;
+		}
+
+		/* the lower index has the higher priority, like the vectors */
+		device = NULL;
+		for(index = 0; index < g_devicesCount; index ++)
+		{
+			if(g_devices[index]->isInterruptPending != NULL && (*g_devices[index]->isInterruptPending)())
+			{
+				device = g_devices[index];
+				break;
+			}
+		}
+
+		if(device == NULL)
+		{
+			return;
+		}
+
+		/* the I bit is cleared while the routine runs and set by its return */
+		g_isInInterrupt = TRUE;
+		CLEAR_BIT(g_hostRegisters[0x5F], I_BIT);
+		(*device->isr)();
+		SET_BIT(g_hostRegisters[0x5F], I_BIT);
+		g_isInInterrupt = FALSE;
+	}
+
+	printf("host: an interrupt fired %lu times in a row, is its flag cleared?\n", HOST_MAX_INTERRUPTS);
+	exit(EXIT_FAILURE);
+}
+
+/*
+ * [Function Name]: HOST_updateDevices
+ * [Function Description]: runs the update of all the devices models
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void HOST_updateDevices(void)
+{
+	uint8_t index;
+
+	if(g_isUpdating == TRUE)
+	{
+		return;
+	}
+
+	g_isUpdating = TRUE;
+	for(index = 0; index < g_devicesCount; index ++)
+	{
+		if(g_devices[index]->update != NULL)
+		{
+			(*g_devices[index]->update)();
+		}
+	}
+	g_isUpdating = FALSE;
+}
@@ -0,0 +1,346 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: host-mcu.h
+ *
+ * Description: Included before each source of the host tests, it replaces the
+ * 				registers, the types and the interrupt macros of the mcu so the
+ * 				drivers are built and run on the host unchanged
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __HOST_MCU_H__
+#define __HOST_MCU_H__
+
+/*******************************************************************************
+ *                                 Types                                       *
+ *******************************************************************************/
+
+/* same widths as avr-gcc, types.h uses long for 32 bits which is 64 bits on the host.
+ * They match the libc types so the test files can include the libc headers.
+ * int is still 32 bits, so the 16 bit int overflows of the avr are not caught
+ */
+#define __TYPES_H__
+
+typedef unsigned char boolean;
+typedef signed char int8_t;
+typedef unsigned char uint8_t;
+typedef signed short int16_t;
+typedef unsigned short uint16_t;
+typedef signed int int32_t;
+typedef unsigned int uint32_t;
+typedef signed long int int64_t;
+typedef unsigned long int uint64_t;
+typedef float float32_t;
+typedef double float64_t;
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+/* the common and mcu headers are included first, their include guards keep the
+ * definitions replaced below when the drivers include them */
+#include "Lib/common.h"
+#include "Mcal/Mcu/Mcus/atmega32.h"
+#include "Mcal/Mcu/avr-common.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* number of registers in the io space, i.e. SREG is the last one */
+#define HOST_REGISTERS_COUNT	0x60
+
+/* registers of the host register file, each access runs the devices
+ * models first so a register reads the effect of the previous writes */
+#define HOST_REGISTER8(address)		((volatile uint8_t *)HOST_accessRegister(address))
+#define HOST_REGISTER16(address)	((volatile uint16_t *)HOST_accessRegister(address))
+
+/* direct access for the devices models, it doesn't run them */
+#define HOST_REGISTER(address)		(g_hostRegisters[(address)])
+
+/* the mcu registers are moved to the host register file */
+
+/** General **/
+#undef SFIOR_R
+#define SFIOR_R			(*HOST_REGISTER8(0x50))
+#undef SREG_R
+#define SREG_R			(*HOST_REGISTER8(0x5F))
+
+/** DIO **/
+#undef DDRA_R
+#define DDRA_R			(*HOST_REGISTER8(0x3A))
+#undef DDRB_R
+#define DDRB_R			(*HOST_REGISTER8(0x37))
+#undef DDRC_R
+#define DDRC_R			(*HOST_REGISTER8(0x34))
+#undef DDRD_R
+#define DDRD_R			(*HOST_REGISTER8(0x31))
+#undef PORTA_R
+#define PORTA_R			(*HOST_REGISTER8(0x3B))
+#undef PORTB_R
+#define PORTB_R			(*HOST_REGISTER8(0x38))
+#undef PORTC_R
+#define PORTC_R			(*HOST_REGISTER8(0x35))
+#undef PORTD_R
+#define PORTD_R			(*HOST_REGISTER8(0x32))
+#undef PINA_R
+#define PINA_R			(*HOST_REGISTER8(0x39))
+#undef PINB_R
+#define PINB_R			(*HOST_REGISTER8(0x36))
+#undef PINC_R
+#define PINC_R			(*HOST_REGISTER8(0x33))
+#undef PIND_R
+#define PIND_R			(*HOST_REGISTER8(0x30))
+
+/** External Interrupts **/
+#undef MCUCR_R
+#define MCUCR_R			(*HOST_REGISTER8(0x55))
+#undef MCUCSR_R
+#define MCUCSR_R		(*HOST_REGISTER8(0x54))
+#undef GICR_R
+#define GICR_R			(*HOST_REGISTER8(0x5B))
+#undef GIFR_R
+#define GIFR_R			(*HOST_REGISTER8(0x5A))
+
+/** Timers **/
+#undef TCCR0_R
+#define TCCR0_R			(*HOST_REGISTER8(0x53))
+#undef TCNT0_R
+#define TCNT0_R			(*HOST_REGISTER8(0x52))
+#undef OCR0_R
+#define OCR0_R			(*HOST_REGISTER8(0x5C))
+#undef TIMSK_R
+#define TIMSK_R			(*HOST_REGISTER8(0x59))
+#undef TIFR_R
+#define TIFR_R			(*HOST_REGISTER8(0x58))
+#undef TCCR1A_R
+#define TCCR1A_R		(*HOST_REGISTER8(0x4F))
+#undef TCCR1B_R
+#define TCCR1B_R		(*HOST_REGISTER8(0x4E))
+#undef TCNT1L_R
+#define TCNT1L_R		(*HOST_REGISTER8(0x4C))
+#undef TCNT1H_R
+#define TCNT1H_R		(*HOST_REGISTER8(0x4D))
+#undef TCNT1_R
+#define TCNT1_R			(*HOST_REGISTER16(0x4C))
+#undef OCR1AL_R
+#define OCR1AL_R		(*HOST_REGISTER8(0x4A))
+#undef OCR1AH_R
+#define OCR1AH_R		(*HOST_REGISTER8(0x4B))
+#undef OCR1A_R
+#define OCR1A_R			(*HOST_REGISTER16(0x4A))
+#undef OCR1BL_R
+#define OCR1BL_R		(*HOST_REGISTER8(0x48))
+#undef OCR1BH_R
+#define OCR1BH_R		(*HOST_REGISTER8(0x49))
+#undef OCR1B_R
+#define OCR1B_R			(*HOST_REGISTER16(0x48))
+#undef ICR1L_R
+#define ICR1L_R			(*HOST_REGISTER8(0x46))
+#undef ICR1H_R
+#define ICR1H_R			(*HOST_REGISTER8(0x47))
+#undef ICR1_R
+#define ICR1_R			(*HOST_REGISTER16(0x46))
+#undef TCCR2_R
+#define TCCR2_R			(*HOST_REGISTER8(0x45))
+#undef TCNT2_R
+#define TCNT2_R			(*HOST_REGISTER8(0x44))
+#undef OCR2_R
+#define OCR2_R			(*HOST_REGISTER8(0x43))
+#undef ASSR_R
+#define ASSR_R			(*HOST_REGISTER8(0x42))
+
+/** WATCH DOG **/
+#undef WDTCR_R
+#define WDTCR_R			(*HOST_REGISTER8(0x41))
+
+/** ADC **/
+#undef ADMUX_R
+#define ADMUX_R			(*HOST_REGISTER8(0x27))
+#undef ADCSRA_R
+#define ADCSRA_R		(*HOST_REGISTER8(0x26))
+#undef ADCH_R
+#define ADCH_R			(*HOST_REGISTER8(0x25))
+#undef ADCL_R
+#define ADCL_R			(*HOST_REGISTER8(0x24))
+#undef ADC_R
+#define ADC_R			(*HOST_REGISTER16(0x24))
+
+/** USART **/
+#undef UDR_R
+#define UDR_R			(*HOST_REGISTER8(0x2C))
+#undef UCSRA_R
+#define UCSRA_R			(*HOST_REGISTER8(0x2B))
+#undef UCSRB_R
+#define UCSRB_R			(*HOST_REGISTER8(0x2A))
+#undef UCSRC_R
+#define UCSRC_R			(*HOST_REGISTER8(0x40))
+#undef UBRRL_R
+#define UBRRL_R			(*HOST_REGISTER8(0x29))
+#undef UBRRH_R
+#define UBRRH_R			(*HOST_REGISTER8(0x40))
+
+/** SPI **/
+#undef SPCR_R
+#define SPCR_R			(*HOST_REGISTER8(0x2D))
+#undef SPSR_R
+#define SPSR_R			(*HOST_REGISTER8(0x2E))
+#undef SPDR_R
+#define SPDR_R			(*HOST_REGISTER8(0x2F))
+
+/** TWI **/
+#undef TWBR_R
+#define TWBR_R			(*HOST_REGISTER8(0x20))
+#undef TWSR_R
+#define TWSR_R			(*HOST_REGISTER8(0x21))
+#undef TWAR_R
+#define TWAR_R			(*HOST_REGISTER8(0x22))
+#undef TWDR_R
+#define TWDR_R			(*HOST_REGISTER8(0x23))
+#undef TWCR_R
+#define TWCR_R			(*HOST_REGISTER8(0x56))
+
+/** EEPROM **/
+#undef EEARL_R
+#define EEARL_R			(*HOST_REGISTER8(0x3E))
+#undef EEARH_R
+#define EEARH_R			(*HOST_REGISTER8(0x3F))
+#undef EEAR_R
+#define EEAR_R			(*HOST_REGISTER16(0x3E))
+#undef EEDR_R
+#define EEDR_R			(*HOST_REGISTER8(0x3D))
+#undef EECR_R
+#define EECR_R			(*HOST_REGISTER8(0x3C))
+
+/* start addresses of the ports registers used by the dio driver */
+#undef PORT_START_LOC
+#define PORT_START_LOC		((unsigned long)&g_hostRegisters[0x3B])
+#undef DDR_START_LOC
+#define DDR_START_LOC		((unsigned long)&g_hostRegisters[0x3A])
+#undef PIN_START_LOC
+#define PIN_START_LOC		((unsigned long)&g_hostRegisters[0x39])
+
+/* global interrupts, the pending interrupts are delivered when they are enabled */
+#undef ENABLE_GLOBAL_INTERRUPT
+#define ENABLE_GLOBAL_INTERRUPT()	HOST_enableGlobalInterrupt()
+#undef DISABLE_GLOBAL_INTERRUPT
+#define DISABLE_GLOBAL_INTERRUPT()	HOST_disableGlobalInterrupt()
+
+/* critical sections, exiting one delivers the pending interrupts if it enables them,
+ * i.e. an interrupt requested inside the section runs right after it like on the mcu */
+#undef ENTER_CRITICAL_SECTION
+#define ENTER_CRITICAL_SECTION(sreg)  do { (sreg) = HOST_REGISTER(0x5F); HOST_disableGlobalInterrupt(); } while(0)
+#undef EXIT_CRITICAL_SECTION
+#define EXIT_CRITICAL_SECTION(sreg)  HOST_restoreStatus(sreg)
+
+/*******************************************************************************
+ *                             Types Declaration                               *
+ *******************************************************************************/
+
+/*
+ * [Struct Name]: ST_HostDevice
+ * [Struct Description]: model of a peripheral, the interrupt is delivered
+ * 						 while it's pending and the global interrupts are enabled
+ */
+typedef struct
+{
+	/* applies the effects of the registers writes, called before each register
+	 * access and before delivering the interrupts, can be NULL */
+	void (* update)(void);
+
+	/* checks if the interrupt is requested, can be NULL if there is no interrupt */
+	uint8_t (* isInterruptPending)(void);
+
+	/* the interrupt service routine */
+	void (* isr)(void);
+
+}ST_HostDevice;
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* the register file, indexed by the io space addresses */
+extern volatile uint8_t g_hostRegisters[HOST_REGISTERS_COUNT];
+
+/*******************************************************************************
+ *                           Function Prototypes                               *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: HOST_accessRegister
+ * [Function Description]: runs the devices models then returns the register
+ * [Args]:
+ * [in]: uint8_t a_address
+ * 		 io space address of the register
+ * [Return]: volatile uint8_t *
+ * 			 pointer to the register
+ */
+volatile uint8_t * HOST_accessRegister(uint8_t a_address);
+
+/*
+ * [Function Name]: HOST_addDevice
+ * [Function Description]: adds a device model, up to HOST_DEVICES_COUNT
+ * [Args]:
+ * [in]: const ST_HostDevice * a_device
+ * 		 the device, it must stay valid
+ * [Return]: void
+ */
+void HOST_addDevice(const ST_HostDevice * a_device);
+
+/*
+ * [Function Name]: HOST_reset
+ * [Function Description]: removes the devices and clears the registers,
+ * 						   the global interrupts are disabled like after a reset
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void HOST_reset(void);
+
+/*
+ * [Function Name]: HOST_enableGlobalInterrupt
+ * [Function Description]: sets the I bit and delivers the pending interrupts
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void HOST_enableGlobalInterrupt(void);
+
+/*
+ * [Function Name]: HOST_disableGlobalInterrupt
+ * [Function Description]: clears the I bit
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void HOST_disableGlobalInterrupt(void);
+
+/*
+ * [Function Name]: HOST_restoreStatus
+ * [Function Description]: restores SREG saved on entering a critical section
+ * 						   and delivers the pending interrupts if they are enabled
+ * [Args]:
+ * [in]: uint8_t a_sreg
+ * 		 the saved status register
+ * [Return]: void
+ */
+void HOST_restoreStatus(uint8_t a_sreg);
+
+/*
+ * [Function Name]: HOST_runInterrupts
+ * [Function Description]: delivers the pending interrupts till none is pending,
+ * 						   nothing is delivered from an interrupt or while the
+ * 						   global interrupts are disabled. The test fails if an
+ * 						   interrupt keeps firing, i.e. its flag is never cleared
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+void HOST_runInterrupts(void);
+
+#endif /* __HOST_MCU_H__ */
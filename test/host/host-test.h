@@ -0,0 +1,75 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: host-test.h
+ *
+ * Description: Checks and the runner of the host tests
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+#ifndef __HOST_TEST_H__
+#define __HOST_TEST_H__
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ *                                 Macros                                      *
+ *******************************************************************************/
+
+/* fails the running test if the condition is false, the test goes on */
+#define TEST_CHECK(condition) \
+	do { \
+		if(!(condition)) \
+		{ \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			g_testFailuresCount ++; \
+		} \
+	} while(0)
+
+/* fails the running test if the values are not equal, both are printed */
+#define TEST_CHECK_EQUAL(expected, actual) \
+	do { \
+		long long expectedValue = (long long)(expected); \
+		long long actualValue = (long long)(actual); \
+		if(expectedValue != actualValue) \
+		{ \
+			printf("%s:%d: %s is %lld, expected %s = %lld\n", __FILE__, __LINE__, \
+					#actual, actualValue, #expected, expectedValue); \
+			g_testFailuresCount ++; \
+		} \
+	} while(0)
+
+/* runs a test function and prints its name if it fails */
+#define TEST_RUN(test) \
+	do { \
+		unsigned int failuresCount = g_testFailuresCount; \
+		test(); \
+		g_testsCount ++; \
+		if(g_testFailuresCount != failuresCount) \
+		{ \
+			printf("FAILED %s\n", #test); \
+		} \
+	} while(0)
+
+/* prints the summary, the exit code of the test program */
+#define TEST_END() \
+	(printf("%s: %u tests, %u failed checks\n", __FILE__, g_testsCount, g_testFailuresCount), \
+			(g_testFailuresCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* counters of the test program, defined in host-mcu.c */
+extern unsigned int g_testsCount;
+extern unsigned int g_testFailuresCount;
+
+#endif /* __HOST_TEST_H__ */
@@ -0,0 +1,453 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test-dc-motor.c
+ *
+ * Description: Tests of the DC motor speed controller against a model of the
+ * 				motor and of the duty cycle ramps, the pwm, external interrupt
+ * 				and adc drivers are replaced by fakes that record the outputs
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+#include "host-test.h"
+
+#include "Hal/Dc-Motor/dc-motor.h"
+#include "Mcal/Pwm/pwm.h"
+#include "Mcal/External-Interrupt/external-interrupt.h"
+#include "Mcal/Adc/adc.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* io space address of PORTC, the bridge inputs of the motors */
+#define PORTC_ADDRESS					0x35
+
+/* the tested motor */
+#define MOTOR							0
+
+/* speed of the motor model at 100% duty cycle and its time constant */
+#define MOTOR_RPM_PER_PERCENT			40
+#define MOTOR_TIME_CONSTANT_MS			100
+
+/* rpm * ms of one tach pulse */
+#define MOTOR_RPM_MS_PER_PULSE			(60000UL / DCMOTOR_TACH_PULSES_PER_REV)
+
+/* the settled speed error, two steps of the measured speed resolution */
+#define RPM_TOLERANCE					30
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* the motors, the enable pins are the pwm pins of timer 1 */
+static const ST_DCMOTOR g_motors[DCMOTORS_USED_COUNT] = {
+		{PC0, PC1, PD4, PD2, PA1},
+		{PC2, PC3, PD5, PD3, PA2},
+};
+
+/* duty cycle of each pwm pin, indexed by the pin number */
+static uint8_t g_pwmDuty[PD7 + 1];
+
+/* tach handler of each external interrupt pin */
+static void (* volatile g_tachHandlers[PD7 + 1])(void);
+
+/* speed of the motor model in rpm with 8 fraction bits, positive for forward */
+static int32_t g_motorRpmQ8;
+
+/* rpm * ms accumulated since the last tach pulse with 8 fraction bits */
+static uint32_t g_tachAccumulatorQ8;
+
+volatile uint16_t g_adcResult;
+
+/*******************************************************************************
+ *                                  Fakes                                      *
+ *******************************************************************************/
+
+uint8_t PWM_enable(uint8_t a_pin, uint8_t a_dutyCycle)
+{
+	if((a_pin != PD4 && a_pin != PD5) || a_dutyCycle > 100)
+	{
+		return PWM_ERROR;
+	}
+
+	g_pwmDuty[a_pin] = a_dutyCycle;
+	return PWM_SUCCESS;
+}
+
+uint8_t PWM_disable(uint8_t a_pin)
+{
+	if(a_pin != PD4 && a_pin != PD5)
+	{
+		return PWM_ERROR;
+	}
+
+	g_pwmDuty[a_pin] = 0;
+	return PWM_SUCCESS;
+}
+
+uint8_t EXT_INT_enable(uint8_t a_pin, EXT_INT_Modes a_mode, void (* volatile a_handler_Ptr)(void))
+{
+	(void)a_mode;
+
+	g_tachHandlers[a_pin] = a_handler_Ptr;
+	return EXT_INT_SUCCESS;
+}
+
+void ADC_selectChannel(uint8_t a_channelPin)
+{
+	(void)a_channelPin;
+}
+
+void ADC_setCallBack(void (* volatile a_handler_Ptr)(void))
+{
+	(void)a_handler_Ptr;
+}
+
+void ADC_enableAutoTriggerSource(EN_AdcAutoTriggerSource a_autoTriggerSource)
+{
+	(void)a_autoTriggerSource;
+}
+
+void ADC_disableAutoTriggerSource(void)
+{
+}
+
+/*******************************************************************************
+ *                               Motor Model                                   *
+ *******************************************************************************/
+
+/* the duty cycle of the tested motor, negative if the bridge drives it in reverse */
+static int16_t getDriveDuty(void)
+{
+	uint8_t port = HOST_REGISTER(PORTC_ADDRESS);
+
+	if(BIT_IS_SET(port, 0) && BIT_IS_CLEAR(port, 1))
+	{
+		return g_pwmDuty[PD4];
+	}
+	if(BIT_IS_CLEAR(port, 0) && BIT_IS_SET(port, 1))
+	{
+		return -(int16_t)g_pwmDuty[PD4];
+	}
+	return 0;
+}
+
+/*
+ * [Function Name]: runMotor
+ * [Function Description]: runs the first order motor model and sends its tach
+ * 						   pulses, the controller is updated every control period
+ * [Args]:
+ * [in]: uint16_t a_periods
+ * 		 number of control periods to run
+ * [Return]: void
+ */
+static void runMotor(uint16_t a_periods)
+{
+	uint16_t milliSecond;
+	int32_t steadyRpmQ8;
+	uint32_t speedQ8;
+
+	while(a_periods-- > 0)
+	{
+		for(milliSecond = 0; milliSecond < DCMOTOR_CONTROL_PERIOD_MS; milliSecond ++)
+		{
+			steadyRpmQ8 = ((int32_t)getDriveDuty() * MOTOR_RPM_PER_PERCENT) << 8;
+			g_motorRpmQ8 += (steadyRpmQ8 - g_motorRpmQ8) / MOTOR_TIME_CONSTANT_MS;
+
+			/* the tach counts the pulses of both directions */
+			speedQ8 = (g_motorRpmQ8 < 0) ? -g_motorRpmQ8 : g_motorRpmQ8;
+			g_tachAccumulatorQ8 += speedQ8;
+			while(g_tachAccumulatorQ8 >= (MOTOR_RPM_MS_PER_PULSE << 8))
+			{
+				g_tachAccumulatorQ8 -= (MOTOR_RPM_MS_PER_PULSE << 8);
+				(*g_tachHandlers[PD2])();
+			}
+		}
+
+		DCMOTOR_speedControlUpdate();
+	}
+}
+
+/*******************************************************************************
+ *                                 Helpers                                     *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: setUp
+ * [Function Description]: stops the motor model and initializes the motors
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void setUp(void)
+{
+	uint8_t pin;
+
+	HOST_reset();
+
+	for(pin = 0; pin <= PD7; pin ++)
+	{
+		g_pwmDuty[pin] = 0;
+		g_tachHandlers[pin] = NULL;
+	}
+	g_motorRpmQ8 = 0;
+	g_tachAccumulatorQ8 = 0;
+
+	DCMOTOR_init(g_motors);
+	ENABLE_GLOBAL_INTERRUPT();
+}
+
+/*
+ * [Function Name]: runTillSettled
+ * [Function Description]: runs the motor till the measured speed stays within
+ * 						   RPM_TOLERANCE of the target for 10 periods
+ * [Args]:
+ * [in]: uint16_t a_targetRpm
+ * 		 the target speed
+ * [in]: uint16_t a_maxPeriods
+ * 		 periods to give up after
+ * [Return]: uint16_t
+ * 			 periods till the speed settled, a_maxPeriods if it didn't
+ */
+static uint16_t runTillSettled(uint16_t a_targetRpm, uint16_t a_maxPeriods)
+{
+	uint16_t periods;
+	uint8_t settledPeriods = 0;
+	int32_t error;
+
+	for(periods = 0; periods < a_maxPeriods && settledPeriods < 10; periods ++)
+	{
+		runMotor(1);
+
+		error = (int32_t)DCMOTOR_getSpeedRpm(MOTOR) - a_targetRpm;
+		settledPeriods = (error <= RPM_TOLERANCE && error >= -RPM_TOLERANCE) ? settledPeriods + 1 : 0;
+	}
+
+	return periods;
+}
+
+/*******************************************************************************
+ *                                  Tests                                      *
+ *******************************************************************************/
+
+static void test_settlesAtTarget(void)
+{
+	uint16_t periods;
+
+	setUp();
+	DCMOTOR_setSpeedRpm(MOTOR, 2000);
+
+	/* 2 seconds */
+	periods = runTillSettled(2000, 100);
+	TEST_CHECK(periods < 100);
+
+	/* it stays there */
+	runMotor(100);
+	TEST_CHECK(DCMOTOR_getSpeedRpm(MOTOR) >= 2000 - RPM_TOLERANCE && DCMOTOR_getSpeedRpm(MOTOR) <= 2000 + RPM_TOLERANCE);
+	TEST_CHECK(g_motorRpmQ8 > 0);
+
+	/* the other motor isn't driven */
+	TEST_CHECK_EQUAL(0, g_pwmDuty[PD5]);
+}
+
+static void test_dutyStepLimited(void)
+{
+	uint8_t previousDuty = 0;
+	uint8_t maxDuty = 0;
+	uint16_t period;
+
+	setUp();
+	DCMOTOR_setSpeedRpm(MOTOR, 3000);
+
+	for(period = 0; period < 150; period ++)
+	{
+		runMotor(1);
+
+		TEST_CHECK(g_pwmDuty[PD4] <= previousDuty + DCMOTOR_MAX_DUTY_STEP);
+		TEST_CHECK(g_pwmDuty[PD4] + DCMOTOR_MAX_DUTY_STEP >= previousDuty);
+		previousDuty = g_pwmDuty[PD4];
+		if(g_pwmDuty[PD4] > maxDuty)
+		{
+			maxDuty = g_pwmDuty[PD4];
+		}
+
+		/* the target drops in the middle */
+		if(period == 100)
+		{
+			DCMOTOR_setSpeedRpm(MOTOR, 500);
+		}
+	}
+
+	/* the duty cycle reached the one of the target speed without jumping */
+	TEST_CHECK(maxDuty >= 3000 / MOTOR_RPM_PER_PERCENT);
+}
+
+static void test_antiWindup(void)
+{
+	uint16_t periods;
+
+	setUp();
+
+	/* faster than the motor can go, the output is saturated */
+	DCMOTOR_setSpeedRpm(MOTOR, 6000);
+	runMotor(250);
+	TEST_CHECK_EQUAL(100, g_pwmDuty[PD4]);
+
+	/* the integral didn't wind up, so the speed drops without a long delay */
+	DCMOTOR_setSpeedRpm(MOTOR, 2000);
+	periods = runTillSettled(2000, 100);
+	TEST_CHECK(periods < 100);
+}
+
+static void test_reverse(void)
+{
+	uint16_t periods;
+
+	setUp();
+	DCMOTOR_setSpeedRpm(MOTOR, 1500);
+	runTillSettled(1500, 100);
+
+	/* reversing starts again from 0 duty cycle */
+	DCMOTOR_setSpeedRpm(MOTOR, -1500);
+	TEST_CHECK_EQUAL(0, g_pwmDuty[PD4]);
+	TEST_CHECK_EQUAL(0x02, HOST_REGISTER(PORTC_ADDRESS) & 0x03);
+
+	runMotor(50);
+	periods = runTillSettled(1500, 150);
+	TEST_CHECK(periods < 150);
+	TEST_CHECK(g_motorRpmQ8 < 0);
+
+	DCMOTOR_setSpeedRpm(MOTOR, 0);
+	TEST_CHECK_EQUAL(0, g_pwmDuty[PD4]);
+	TEST_CHECK_EQUAL(0x00, HOST_REGISTER(PORTC_ADDRESS) & 0x03);
+}
+
+static void test_rampTrapezoid(void)
+{
+	uint16_t tick;
+	int16_t expected;
+	uint8_t previousDuty = 0;
+
+	setUp();
+
+	/* 80% at 40%/s takes 2 seconds, i.e. 200 ticks */
+	DCMOTOR_moveTo(MOTOR, 80, 40);
+	for(tick = 1; tick <= 200; tick ++)
+	{
+		TEST_CHECK(!DCMOTOR_isTargetReached(MOTOR));
+		DCMOTOR_rampTick();
+
+		/* the duty cycle rises linearly, rounded to percents */
+		expected = (80 * tick + 100) / 200;
+		TEST_CHECK(g_pwmDuty[PD4] >= expected - 1 && g_pwmDuty[PD4] <= expected + 1);
+		TEST_CHECK(g_pwmDuty[PD4] >= previousDuty);
+		previousDuty = g_pwmDuty[PD4];
+		TEST_CHECK_EQUAL(0x01, HOST_REGISTER(PORTC_ADDRESS) & 0x03);
+	}
+
+	TEST_CHECK(DCMOTOR_isTargetReached(MOTOR));
+	TEST_CHECK_EQUAL(80, g_pwmDuty[PD4]);
+
+	/* the ramp is done, the ticks don't change the output */
+	DCMOTOR_rampTick();
+	TEST_CHECK_EQUAL(80, g_pwmDuty[PD4]);
+
+	/* 0 acceleration changes the duty cycle in one tick */
+	DCMOTOR_moveTo(MOTOR, 30, 0);
+	DCMOTOR_rampTick();
+	TEST_CHECK(DCMOTOR_isTargetReached(MOTOR));
+	TEST_CHECK_EQUAL(30, g_pwmDuty[PD4]);
+}
+
+static void test_rampReverseDeadTime(void)
+{
+	uint16_t tick;
+	uint16_t coastTicks = 0;
+	uint16_t firstReverseTick = 0;
+	uint8_t pins;
+
+	setUp();
+	DCMOTOR_moveTo(MOTOR, 80, 0);
+	DCMOTOR_rampTick();
+
+	/* 80% down to 0 then up to -50% at 100%/s, 0.8 and 0.5 seconds */
+	DCMOTOR_moveTo(MOTOR, -50, 100);
+	for(tick = 1; tick <= 200 && !DCMOTOR_isTargetReached(MOTOR); tick ++)
+	{
+		DCMOTOR_rampTick();
+		pins = HOST_REGISTER(PORTC_ADDRESS) & 0x03;
+
+		if(tick < 80)
+		{
+			TEST_CHECK_EQUAL(0x01, pins);
+		}
+		else if(pins == 0x00)
+		{
+			/* coasting, the reverse voltage isn't applied yet */
+			TEST_CHECK_EQUAL(0, firstReverseTick);
+			TEST_CHECK_EQUAL(0, g_pwmDuty[PD4]);
+			coastTicks ++;
+		}
+		else
+		{
+			TEST_CHECK_EQUAL(0x02, pins);
+			if(firstReverseTick == 0)
+			{
+				firstReverseTick = tick;
+			}
+		}
+	}
+
+	/* the ramp down ends at tick 80, then the dead time passes */
+	TEST_CHECK_EQUAL(80 + DCMOTOR_DEAD_TIME_MS / DCMOTOR_RAMP_TICK_MS + 1, firstReverseTick);
+	TEST_CHECK_EQUAL(1 + DCMOTOR_DEAD_TIME_MS / DCMOTOR_RAMP_TICK_MS, coastTicks);
+	TEST_CHECK_EQUAL(firstReverseTick + 49, tick - 1);
+	TEST_CHECK(DCMOTOR_isTargetReached(MOTOR));
+	TEST_CHECK_EQUAL(50, g_pwmDuty[PD4]);
+	TEST_CHECK_EQUAL(0x02, HOST_REGISTER(PORTC_ADDRESS) & 0x03);
+}
+
+static void test_brake(void)
+{
+	setUp();
+	DCMOTOR_moveTo(MOTOR, 60, 50);
+	DCMOTOR_rampTick();
+	DCMOTOR_rampTick();
+
+	/* braking cancels the ramp and shorts the motor */
+	DCMOTOR_brake(MOTOR);
+	TEST_CHECK(DCMOTOR_isTargetReached(MOTOR));
+	TEST_CHECK_EQUAL(0x03, HOST_REGISTER(PORTC_ADDRESS) & 0x03);
+	TEST_CHECK_EQUAL(100, g_pwmDuty[PD4]);
+
+	DCMOTOR_rampTick();
+	TEST_CHECK_EQUAL(0x03, HOST_REGISTER(PORTC_ADDRESS) & 0x03);
+	TEST_CHECK_EQUAL(100, g_pwmDuty[PD4]);
+
+	/* a ramp after braking starts from 0 */
+	DCMOTOR_moveTo(MOTOR, 20, 100);
+	DCMOTOR_rampTick();
+	TEST_CHECK_EQUAL(0x01, HOST_REGISTER(PORTC_ADDRESS) & 0x03);
+	TEST_CHECK_EQUAL(1, g_pwmDuty[PD4]);
+}
+
+int main(void)
+{
+	TEST_RUN(test_settlesAtTarget);
+	TEST_RUN(test_dutyStepLimited);
+	TEST_RUN(test_antiWindup);
+	TEST_RUN(test_reverse);
+	TEST_RUN(test_rampTrapezoid);
+	TEST_RUN(test_rampReverseDeadTime);
+	TEST_RUN(test_brake);
+
+	return TEST_END();
+}
@@ -0,0 +1,424 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test-eeprom.c
+ *
+ * Description: Tests of the EEPROM write queue and the record chain recovery
+ * 				after a reset or a power loss, against a model of the eeprom
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+#include <string.h>
+
+#include "host-test.h"
+
+#include "Mcal/Eeprom/eeprom.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* io space addresses of the eeprom registers */
+#define EECR_ADDRESS					0x3C
+#define EEDR_ADDRESS					0x3D
+#define EEARL_ADDRESS					0x3E
+#define EEARH_ADDRESS					0x3F
+
+/* register accesses a byte write takes */
+#define EEPROM_WRITE_ACCESSES			3
+
+/* no limit of the written bytes */
+#define EEPROM_NO_WRITE_LIMIT			0xFFFF
+
+/* polls of a test before it gives up on the writes */
+#define MAX_POLLS						1000
+
+/* records the tests write, enough to wrap the sequence numbers */
+#define RECORDS_COUNT					300
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* the eeprom memory and its state */
+static uint8_t g_memory[EEPROM_SIZE];
+static uint8_t g_writeAccesses;
+static uint16_t g_writeAddress;
+static uint8_t g_writeData;
+static uint8_t g_isMasterWriteEnableSeen;
+
+/* bytes written before the power is lost, the next writes are not done */
+static uint16_t g_writeLimit;
+
+/* eeprom events */
+static uint16_t g_writesCount;
+static uint16_t g_violationsCount;
+
+/* number of the called record callbacks */
+static uint16_t g_callbacksCount;
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/* the eeprom ready interrupt of the driver */
+void EE_RDY_vect(void);
+
+static void EEPROM_update(void);
+
+static uint8_t EEPROM_isInterruptPending(void);
+
+static const ST_HostDevice g_eeprom = {EEPROM_update, EEPROM_isInterruptPending, EE_RDY_vect};
+
+/*******************************************************************************
+ *                              Eeprom Model                                   *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: EEPROM_update
+ * [Function Description]: runs the reads at once, a write ends after a few
+ * 						   register accesses then clears EEWE
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void EEPROM_update(void)
+{
+	uint16_t address = HOST_REGISTER(EEARL_ADDRESS) | ((uint16_t)HOST_REGISTER(EEARH_ADDRESS) << 8);
+
+	if(g_writeAccesses > 0)
+	{
+		/* the cpu must not read or start a write while a write runs */
+		if(BIT_IS_SET(HOST_REGISTER(EECR_ADDRESS), EERE))
+		{
+			CLEAR_BIT(HOST_REGISTER(EECR_ADDRESS), EERE);
+			g_violationsCount ++;
+		}
+
+		if(--g_writeAccesses == 0)
+		{
+			if(g_writesCount < g_writeLimit)
+			{
+				g_memory[g_writeAddress] = g_writeData;
+				g_writesCount ++;
+			}
+			CLEAR_BIT(HOST_REGISTER(EECR_ADDRESS), EEWE);
+		}
+		return;
+	}
+
+	if(BIT_IS_SET(HOST_REGISTER(EECR_ADDRESS), EEWE))
+	{
+		/* EEWE starts a write only while EEMWE is set, the address and data are latched */
+		if(BIT_IS_SET(HOST_REGISTER(EECR_ADDRESS), EEMWE) && address < EEPROM_SIZE)
+		{
+			g_writeAddress = address;
+			g_writeData = HOST_REGISTER(EEDR_ADDRESS);
+			g_writeAccesses = EEPROM_WRITE_ACCESSES;
+		}
+		else
+		{
+			CLEAR_BIT(HOST_REGISTER(EECR_ADDRESS), EEWE);
+			g_violationsCount ++;
+		}
+		CLEAR_BIT(HOST_REGISTER(EECR_ADDRESS), EEMWE);
+		g_isMasterWriteEnableSeen = FALSE;
+		return;
+	}
+
+	if(BIT_IS_SET(HOST_REGISTER(EECR_ADDRESS), EERE))
+	{
+		HOST_REGISTER(EEDR_ADDRESS) = (address < EEPROM_SIZE) ? g_memory[address] : 0xFF;
+		CLEAR_BIT(HOST_REGISTER(EECR_ADDRESS), EERE);
+	}
+
+	/* EEMWE is cleared by the hardware after 4 cycles, i.e. it's left for the next access only */
+	if(BIT_IS_SET(HOST_REGISTER(EECR_ADDRESS), EEMWE) && g_isMasterWriteEnableSeen == FALSE)
+	{
+		g_isMasterWriteEnableSeen = TRUE;
+	}
+	else
+	{
+		CLEAR_BIT(HOST_REGISTER(EECR_ADDRESS), EEMWE);
+		g_isMasterWriteEnableSeen = FALSE;
+	}
+}
+
+/*
+ * [Function Name]: EEPROM_isInterruptPending
+ * [Function Description]: the eeprom ready interrupt fires while no write runs
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if pending, FALSE otherwise
+ */
+static uint8_t EEPROM_isInterruptPending(void)
+{
+	return BIT_IS_SET(HOST_REGISTER(EECR_ADDRESS), EERIE) && BIT_IS_CLEAR(HOST_REGISTER(EECR_ADDRESS), EEWE);
+}
+
+/*******************************************************************************
+ *                                 Helpers                                     *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: powerUp
+ * [Function Description]: resets the mcu and loads the latest record, the
+ * 						   eeprom keeps its data
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void powerUp(void)
+{
+	HOST_reset();
+	HOST_addDevice(&g_eeprom);
+
+	g_writeAccesses = 0;
+	g_isMasterWriteEnableSeen = FALSE;
+	g_writeLimit = EEPROM_NO_WRITE_LIMIT;
+
+	ENABLE_GLOBAL_INTERRUPT();
+	EEPROM_recordInit();
+}
+
+/*
+ * [Function Name]: setUp
+ * [Function Description]: erases the eeprom then powers up
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void setUp(void)
+{
+	memset(g_memory, 0xFF, sizeof(g_memory));
+	g_writesCount = 0;
+	g_violationsCount = 0;
+	g_callbacksCount = 0;
+
+	powerUp();
+}
+
+/*
+ * [Function Name]: waitWrites
+ * [Function Description]: runs the eeprom till the queued writes are done
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void waitWrites(void)
+{
+	uint16_t polls;
+
+	for(polls = 0; EEPROM_isBusy() && polls < MAX_POLLS; polls ++)
+	{
+		HOST_runInterrupts();
+	}
+
+	TEST_CHECK(!EEPROM_isBusy());
+}
+
+/* the test record of a number, no byte is erased */
+static void makeRecord(uint16_t a_number, uint8_t * a_record)
+{
+	uint8_t index;
+
+	for(index = 0; index < EEPROM_RECORD_SIZE; index ++)
+	{
+		a_record[index] = (uint8_t)(a_number * 3 + index) % 0xFF;
+	}
+}
+
+static void recordDone(void)
+{
+	g_callbacksCount ++;
+}
+
+/*
+ * [Function Name]: writeRecord
+ * [Function Description]: writes the test record of a number and waits for it
+ * [Args]:
+ * [in]: uint16_t a_number
+ * 		 number of the record
+ * [Return]: void
+ */
+static void writeRecord(uint16_t a_number)
+{
+	uint8_t record[EEPROM_RECORD_SIZE];
+
+	makeRecord(a_number, record);
+	TEST_CHECK_EQUAL(EEPROM_SUCCESS, EEPROM_recordWrite(record, recordDone));
+	waitWrites();
+}
+
+/* checks that the latest record is the test record of a number */
+static void checkRecord(uint16_t a_number)
+{
+	uint8_t expected[EEPROM_RECORD_SIZE];
+	uint8_t record[EEPROM_RECORD_SIZE];
+
+	makeRecord(a_number, expected);
+	TEST_CHECK_EQUAL(EEPROM_SUCCESS, EEPROM_recordRead(record));
+	TEST_CHECK(memcmp(expected, record, EEPROM_RECORD_SIZE) == 0);
+}
+
+/*******************************************************************************
+ *                                  Tests                                      *
+ *******************************************************************************/
+
+static void test_readWrite(void)
+{
+	const uint8_t data[] = {0x11, 0x22, 0x33, 0x44, 0x55};
+	uint8_t buffer[sizeof(data)];
+
+	setUp();
+
+	TEST_CHECK_EQUAL(EEPROM_SUCCESS, EEPROM_write(EEPROM_SIZE - sizeof(data), data, sizeof(data), NULL));
+	waitWrites();
+	TEST_CHECK_EQUAL(sizeof(data), g_writesCount);
+
+	TEST_CHECK_EQUAL(EEPROM_SUCCESS, EEPROM_read(EEPROM_SIZE - sizeof(data), buffer, sizeof(buffer)));
+	TEST_CHECK(memcmp(data, buffer, sizeof(data)) == 0);
+
+	/* the block must be inside the eeprom */
+	TEST_CHECK_EQUAL(EEPROM_ERROR, EEPROM_write(EEPROM_SIZE - 1, data, 2, NULL));
+	TEST_CHECK_EQUAL(EEPROM_ERROR, EEPROM_read(EEPROM_SIZE - 1, buffer, 2));
+	TEST_CHECK_EQUAL(0, g_violationsCount);
+}
+
+static void test_equalBytesSkipped(void)
+{
+	const uint8_t data[] = {0x11, 0x22, 0x33, 0x44};
+	const uint8_t changedData[] = {0x11, 0x22, 0x00, 0x44};
+
+	setUp();
+	EEPROM_write(0x10, data, sizeof(data), NULL);
+	waitWrites();
+
+	g_writesCount = 0;
+	EEPROM_write(0x10, data, sizeof(data), NULL);
+	waitWrites();
+	TEST_CHECK_EQUAL(0, g_writesCount);
+
+	EEPROM_write(0x10, changedData, sizeof(changedData), NULL);
+	waitWrites();
+	TEST_CHECK_EQUAL(1, g_writesCount);
+	TEST_CHECK_EQUAL(0x00, g_memory[0x12]);
+}
+
+static void test_erasedStore(void)
+{
+	uint8_t record[EEPROM_RECORD_SIZE];
+
+	setUp();
+	TEST_CHECK_EQUAL(EEPROM_ERROR, EEPROM_recordRead(record));
+
+	/* the first record goes to the second slot, the chain starts at the erased first slot */
+	writeRecord(0);
+	checkRecord(0);
+
+	powerUp();
+	checkRecord(0);
+}
+
+static void test_recordChainRecovery(void)
+{
+	uint16_t number;
+
+	setUp();
+
+	/* the slots are reused many times and the sequence numbers wrap */
+	for(number = 0; number < RECORDS_COUNT; number ++)
+	{
+		writeRecord(number);
+		checkRecord(number);
+
+		if(number % 7 == 0)
+		{
+			powerUp();
+			checkRecord(number);
+		}
+	}
+
+	TEST_CHECK_EQUAL(RECORDS_COUNT, g_callbacksCount);
+	TEST_CHECK_EQUAL(0, g_violationsCount);
+}
+
+static void test_busyWhileWriting(void)
+{
+	uint8_t record[EEPROM_RECORD_SIZE];
+
+	setUp();
+	makeRecord(1, record);
+
+	/* the first byte is written by the interrupt, the rest wait */
+	TEST_CHECK_EQUAL(EEPROM_SUCCESS, EEPROM_recordWrite(record, NULL));
+	TEST_CHECK_EQUAL(EEPROM_BUSY, EEPROM_recordWrite(record, NULL));
+
+	/* the record being written is the latest one */
+	checkRecord(1);
+	waitWrites();
+
+	powerUp();
+	checkRecord(1);
+}
+
+static void test_powerLossDuringWrite(void)
+{
+	uint8_t record[EEPROM_RECORD_SIZE];
+	uint16_t limit;
+	uint16_t number;
+
+	/* the record takes EEPROM_RECORD_SIZE data bytes then the sequence byte */
+	for(limit = 0; limit <= EEPROM_RECORD_SIZE; limit ++)
+	{
+		setUp();
+		for(number = 0; number < 20; number ++)
+		{
+			writeRecord(number);
+		}
+
+		g_writesCount = 0;
+		g_writeLimit = limit;
+		makeRecord(number, record);
+		EEPROM_recordWrite(record, NULL);
+		waitWrites();
+
+		/* the previous record is the latest one, the next write goes on from it */
+		powerUp();
+		checkRecord(number - 1);
+
+		writeRecord(number + 1);
+		powerUp();
+		checkRecord(number + 1);
+		TEST_CHECK_EQUAL(0, g_violationsCount);
+	}
+
+	/* the sequence byte is written last, then the record is the latest */
+	setUp();
+	writeRecord(0);
+	g_writesCount = 0;
+	g_writeLimit = EEPROM_RECORD_SIZE + 1;
+	writeRecord(1);
+	powerUp();
+	checkRecord(1);
+}
+
+int main(void)
+{
+	TEST_RUN(test_readWrite);
+	TEST_RUN(test_equalBytesSkipped);
+	TEST_RUN(test_erasedStore);
+	TEST_RUN(test_recordChainRecovery);
+	TEST_RUN(test_busyWhileWriting);
+	TEST_RUN(test_powerLossDuringWrite);
+
+	return TEST_END();
+}
@@ -0,0 +1,643 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test-nor-flash.c
+ *
+ * Description: Tests of the NOR flash log appends and the log recovery after
+ * 				a reset, against a model of a 25-series flash. The spi transaction
+ * 				queue is replaced by one that transfers a transaction per interrupt
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+#include <string.h>
+
+#include "host-test.h"
+
+#include "Hal/Nor-Flash/nor-flash.h"
+#include "Mcal/Spi/spi.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* the modeled flash, a 128KB W25X10 */
+#define FLASH_SIZE						0x20000UL
+#define FLASH_JEDEC_ID					0xEF3011UL
+
+/* status reads that find the flash busy after a program and an erase */
+#define FLASH_PROGRAM_POLLS				2
+#define FLASH_ERASE_POLLS				5
+
+/* no limit of the programmed bytes */
+#define FLASH_NO_PROGRAM_LIMIT			0xFFFF
+
+/* polls of a test before it gives up on an operation */
+#define MAX_POLLS						1000
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* the flash memory and its state */
+static uint8_t g_flash[FLASH_SIZE];
+static uint8_t g_isSelected;
+static uint8_t g_command;
+static uint16_t g_frameIndex;
+static uint32_t g_address;
+static uint8_t g_isWriteEnabled;
+static uint8_t g_busyPolls;
+
+/* data of the running page program, programmed when the chip select rises */
+static uint8_t g_programData[NOR_FLASH_PAGE_SIZE];
+static uint16_t g_programLength;
+
+/* bytes programmed by the next program, i.e. the power is lost in the middle of it */
+static uint16_t g_programLimit;
+
+/* flash events */
+static uint16_t g_programsCount;
+static uint16_t g_erasesCount;
+static uint16_t g_violationsCount;
+
+/* the spi transaction queue */
+static ST_SpiTransaction * g_spiQueue[SPI_TRANSACTION_QUEUE_SIZE];
+static uint8_t g_spiQueueHead;
+static uint8_t g_spiQueueTail;
+static ST_SpiTransaction * g_spiCurrentTransaction;
+
+/* results passed to the append callback */
+static uint8_t g_appendResult;
+static uint16_t g_appendCallbacksCount;
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+static uint8_t SPI_isInterruptPending(void);
+
+static void SPI_isr(void);
+
+static const ST_HostDevice g_spi = {NULL, SPI_isInterruptPending, SPI_isr};
+
+/*******************************************************************************
+ *                               Flash Model                                   *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: FLASH_transferByte
+ * [Function Description]: exchanges a byte with the flash, the first byte of
+ * 						   a frame is the command
+ * [Args]:
+ * [in]: uint8_t a_data
+ * 		 byte sent by the master
+ * [Return]: uint8_t
+ * 			 byte sent by the flash
+ */
+static uint8_t FLASH_transferByte(uint8_t a_data)
+{
+	uint16_t index;
+
+	if(g_isSelected == FALSE)
+	{
+		g_isSelected = TRUE;
+		g_command = a_data;
+		g_frameIndex = 1;
+		g_address = 0;
+		g_programLength = 0;
+
+		/* only the status can be read while a program or an erase runs */
+		if(g_busyPolls > 0 && g_command != 0x05)
+		{
+			g_violationsCount ++;
+		}
+		return 0xFF;
+	}
+
+	index = g_frameIndex++;
+
+	switch(g_command)
+	{
+	case 0x05:
+		return (g_busyPolls > 0 ? 0x01 : 0x00) | (g_isWriteEnabled << 1);
+
+	case 0x9F:
+		return (index <= 3) ? (uint8_t)(FLASH_JEDEC_ID >> (8 * (3 - index))) : 0xFF;
+
+	case 0x0B:
+	case 0x02:
+	case 0x20:
+		if(index <= 3)
+		{
+			g_address = (g_address << 8) | a_data;
+			return 0xFF;
+		}
+		if(g_command == 0x0B && index > 4)
+		{
+			return g_flash[g_address++ % FLASH_SIZE];
+		}
+		if(g_command == 0x02)
+		{
+			/* the page buffer wraps at the page end */
+			if(g_programLength == NOR_FLASH_PAGE_SIZE)
+			{
+				g_violationsCount ++;
+			}
+			else
+			{
+				g_programData[g_programLength++] = a_data;
+			}
+		}
+		return 0xFF;
+
+	default:
+		return 0xFF;
+	}
+}
+
+/*
+ * [Function Name]: FLASH_deselect
+ * [Function Description]: ends the frame, the programs and the erases start here
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void FLASH_deselect(void)
+{
+	uint32_t pageStart;
+	uint16_t index;
+
+	if(g_isSelected == FALSE)
+	{
+		return;
+	}
+	g_isSelected = FALSE;
+
+	switch(g_command)
+	{
+	case 0x06:
+		g_isWriteEnabled = TRUE;
+		break;
+
+	case 0x05:
+		if(g_busyPolls > 0)
+		{
+			g_busyPolls --;
+		}
+		break;
+
+	case 0x02:
+	case 0x20:
+		if(g_isWriteEnabled == FALSE || g_busyPolls > 0 || g_frameIndex < 4)
+		{
+			g_violationsCount ++;
+			break;
+		}
+
+		if(g_command == 0x02)
+		{
+			pageStart = g_address - (g_address % NOR_FLASH_PAGE_SIZE);
+			for(index = 0; index < g_programLength && index < g_programLimit; index ++)
+			{
+				/* programming only clears bits */
+				g_flash[pageStart + (g_address + index) % NOR_FLASH_PAGE_SIZE] &= g_programData[index];
+			}
+			g_programLimit = FLASH_NO_PROGRAM_LIMIT;
+			g_programsCount ++;
+			g_busyPolls = FLASH_PROGRAM_POLLS;
+		}
+		else
+		{
+			memset(&g_flash[g_address - (g_address % NOR_FLASH_SECTOR_SIZE)], 0xFF, NOR_FLASH_SECTOR_SIZE);
+			g_erasesCount ++;
+			g_busyPolls = FLASH_ERASE_POLLS;
+		}
+		g_isWriteEnabled = FALSE;
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*******************************************************************************
+ *                          Spi Transaction Queue                              *
+ *******************************************************************************/
+
+void SPI_initMaster(const ST_SpiMasterConfig * a_spiConfig)
+{
+	(void)a_spiConfig;
+}
+
+void SPI_initDevice(const ST_SpiDevice * a_device)
+{
+	(void)a_device;
+	FLASH_deselect();
+}
+
+uint8_t SPI_getFreeTransactionsCount(void)
+{
+	return (SPI_TRANSACTION_QUEUE_SIZE - 1) - \
+			((g_spiQueueHead - g_spiQueueTail) & (SPI_TRANSACTION_QUEUE_SIZE - 1));
+}
+
+/*
+ * [Function Name]: SPI_startNextTransaction
+ * [Function Description]: takes the next transaction from the queue like the
+ * 						   driver, it's transferred by the next interrupt
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_startNextTransaction(void)
+{
+	if(g_spiQueueHead == g_spiQueueTail)
+	{
+		g_spiCurrentTransaction = NULL;
+		return;
+	}
+
+	g_spiCurrentTransaction = g_spiQueue[g_spiQueueTail];
+	g_spiQueueTail = (g_spiQueueTail + 1) & (SPI_TRANSACTION_QUEUE_SIZE - 1);
+}
+
+uint8_t SPI_queueTransaction(ST_SpiTransaction * a_transaction)
+{
+	uint8_t nextHead;
+	uint8_t sreg;
+
+	if(a_transaction == NULL || a_transaction->device == NULL || a_transaction->length == 0)
+	{
+		return SPI_TRANSACTION_INVALID;
+	}
+
+	ENTER_CRITICAL_SECTION(sreg);
+
+	nextHead = (g_spiQueueHead + 1) & (SPI_TRANSACTION_QUEUE_SIZE - 1);
+	if(nextHead == g_spiQueueTail)
+	{
+		EXIT_CRITICAL_SECTION(sreg);
+		return SPI_TRANSACTION_QUEUE_FULL;
+	}
+
+	a_transaction->isDone = FALSE;
+	g_spiQueue[g_spiQueueHead] = a_transaction;
+	g_spiQueueHead = nextHead;
+
+	if(g_spiCurrentTransaction == NULL)
+	{
+		SPI_startNextTransaction();
+	}
+
+	EXIT_CRITICAL_SECTION(sreg);
+	return SPI_TRANSACTION_QUEUED;
+}
+
+static uint8_t SPI_isInterruptPending(void)
+{
+	return (g_spiCurrentTransaction != NULL);
+}
+
+/*
+ * [Function Name]: SPI_isr
+ * [Function Description]: transfers the whole running transaction, then ends it
+ * 						   like the driver does with its last byte
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void SPI_isr(void)
+{
+	ST_SpiTransaction * transaction = g_spiCurrentTransaction;
+	uint16_t index;
+	uint8_t data;
+
+	for(index = 0; index < transaction->length; index ++)
+	{
+		data = FLASH_transferByte((transaction->txData != NULL) ? transaction->txData[index] : SPI_DEFAULT_DATA_VALUE);
+		if(transaction->rxData != NULL)
+		{
+			transaction->rxData[index] = data;
+		}
+	}
+
+	if(transaction->holdChipSelect == FALSE)
+	{
+		FLASH_deselect();
+	}
+	transaction->isDone = TRUE;
+
+	if(transaction->callBack != NULL)
+	{
+		(*transaction->callBack)();
+	}
+
+	SPI_startNextTransaction();
+}
+
+/*******************************************************************************
+ *                                 Helpers                                     *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: powerUp
+ * [Function Description]: resets the mcu and initializes the driver, the flash
+ * 						   keeps its data
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void powerUp(void)
+{
+	HOST_reset();
+	HOST_addDevice(&g_spi);
+
+	g_spiQueueHead = 0;
+	g_spiQueueTail = 0;
+	g_spiCurrentTransaction = NULL;
+
+	g_isSelected = FALSE;
+	g_isWriteEnabled = FALSE;
+	g_busyPolls = 0;
+	g_programLimit = FLASH_NO_PROGRAM_LIMIT;
+
+	NOR_FLASH_init();
+	ENABLE_GLOBAL_INTERRUPT();
+}
+
+/*
+ * [Function Name]: setUp
+ * [Function Description]: erases the flash then powers up
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void setUp(void)
+{
+	memset(g_flash, 0xFF, sizeof(g_flash));
+	g_programsCount = 0;
+	g_erasesCount = 0;
+	g_violationsCount = 0;
+	g_appendCallbacksCount = 0;
+
+	powerUp();
+}
+
+/* the byte of the test data at a log offset */
+static uint8_t dataAt(uint32_t a_offset)
+{
+	return (uint8_t)(a_offset * 7 + (a_offset >> 8));
+}
+
+static void appendDone(uint8_t a_result)
+{
+	g_appendResult = a_result;
+	g_appendCallbacksCount ++;
+}
+
+/*
+ * [Function Name]: append
+ * [Function Description]: appends the test data of the log size offset and
+ * 						   polls the flash till it's done, like the application
+ * [Args]:
+ * [in]: uint16_t a_length
+ * 		 number of bytes
+ * [Return]: uint8_t
+ * 			 result of NOR_FLASH_logAppend() or of the callback
+ */
+static uint8_t append(uint16_t a_length)
+{
+	static uint8_t data[1024];
+	uint32_t offset = NOR_FLASH_logGetSize();
+	uint16_t index;
+	uint16_t polls;
+	uint8_t result;
+
+	for(index = 0; index < a_length; index ++)
+	{
+		data[index] = dataAt(offset + index);
+	}
+
+	g_appendCallbacksCount = 0;
+	result = NOR_FLASH_logAppend(data, a_length, appendDone);
+	if(result != NOR_FLASH_SUCCESS)
+	{
+		return result;
+	}
+
+	for(polls = 0; NOR_FLASH_isBusy() && polls < MAX_POLLS; polls ++)
+	{
+		NOR_FLASH_pollTick();
+	}
+
+	TEST_CHECK(!NOR_FLASH_isBusy());
+	TEST_CHECK_EQUAL(1, g_appendCallbacksCount);
+
+	return g_appendResult;
+}
+
+/* checks the test data of a range of the log */
+static void checkData(uint32_t a_offset, uint32_t a_length)
+{
+	uint32_t index;
+
+	for(index = a_offset; index < a_offset + a_length; index ++)
+	{
+		if(g_flash[NOR_FLASH_LOG_START_ADDRESS + index] != dataAt(index))
+		{
+			TEST_CHECK_EQUAL(dataAt(index), g_flash[NOR_FLASH_LOG_START_ADDRESS + index]);
+			return;
+		}
+	}
+}
+
+/* checks that a range of the flash is erased */
+static void checkErased(uint32_t a_address, uint32_t a_length)
+{
+	uint32_t index;
+
+	for(index = a_address; index < a_address + a_length; index ++)
+	{
+		if(g_flash[index] != 0xFF)
+		{
+			TEST_CHECK_EQUAL(0xFF, g_flash[index]);
+			return;
+		}
+	}
+}
+
+/*******************************************************************************
+ *                                  Tests                                      *
+ *******************************************************************************/
+
+static void test_jedecId(void)
+{
+	setUp();
+
+	TEST_CHECK_EQUAL(FLASH_JEDEC_ID, NOR_FLASH_readJedecId());
+	TEST_CHECK(!NOR_FLASH_isBusy());
+}
+
+static void test_appendAcrossPagesAndSectors(void)
+{
+	uint8_t record;
+
+	setUp();
+	TEST_CHECK_EQUAL(NOR_FLASH_SUCCESS, NOR_FLASH_logInit());
+	TEST_CHECK_EQUAL(0, NOR_FLASH_logGetSize());
+
+	/* records not aligned to the pages, the log enters the second sector */
+	for(record = 0; record < 40; record ++)
+	{
+		TEST_CHECK_EQUAL(NOR_FLASH_SUCCESS, append(130));
+	}
+
+	TEST_CHECK_EQUAL(40 * 130, NOR_FLASH_logGetSize());
+	checkData(0, 40 * 130);
+	checkErased(NOR_FLASH_LOG_START_ADDRESS + 40 * 130, NOR_FLASH_LOG_SIZE - 40 * 130);
+	TEST_CHECK_EQUAL(2, g_erasesCount);
+	TEST_CHECK_EQUAL(0, g_violationsCount);
+}
+
+static void test_recoveryResumesAtNextPage(void)
+{
+	uint8_t record;
+
+	setUp();
+	NOR_FLASH_logInit();
+	for(record = 0; record < 40; record ++)
+	{
+		append(130);
+	}
+
+	/* the rest of the last used page is skipped after a reset */
+	powerUp();
+	TEST_CHECK_EQUAL(NOR_FLASH_SUCCESS, NOR_FLASH_logInit());
+	TEST_CHECK_EQUAL(21 * NOR_FLASH_PAGE_SIZE, NOR_FLASH_logGetSize());
+
+	TEST_CHECK_EQUAL(NOR_FLASH_SUCCESS, append(10));
+	checkData(0, 40 * 130);
+	checkErased(NOR_FLASH_LOG_START_ADDRESS + 40 * 130, 21 * NOR_FLASH_PAGE_SIZE - 40 * 130);
+	checkData(21 * NOR_FLASH_PAGE_SIZE, 10);
+
+	/* the sector of the log end was erased before the reset */
+	TEST_CHECK_EQUAL(2, g_erasesCount);
+	TEST_CHECK_EQUAL(0, g_violationsCount);
+}
+
+static void test_recoveryAtSectorEnd(void)
+{
+	uint8_t page;
+
+	setUp();
+	NOR_FLASH_logInit();
+	for(page = 0; page < NOR_FLASH_SECTOR_SIZE / NOR_FLASH_PAGE_SIZE; page ++)
+	{
+		append(NOR_FLASH_PAGE_SIZE);
+	}
+	TEST_CHECK_EQUAL(1, g_erasesCount);
+
+	/* data of an old log in a page of the next sector the search doesn't read,
+	 * it's erased before the sector is used */
+	g_flash[NOR_FLASH_LOG_START_ADDRESS + NOR_FLASH_SECTOR_SIZE + 5 * NOR_FLASH_PAGE_SIZE] = 0x00;
+
+	powerUp();
+	NOR_FLASH_logInit();
+	TEST_CHECK_EQUAL(NOR_FLASH_SECTOR_SIZE, NOR_FLASH_logGetSize());
+
+	TEST_CHECK_EQUAL(NOR_FLASH_SUCCESS, append(200));
+	TEST_CHECK_EQUAL(2, g_erasesCount);
+	checkData(0, NOR_FLASH_SECTOR_SIZE + 200);
+	checkErased(NOR_FLASH_LOG_START_ADDRESS + NOR_FLASH_SECTOR_SIZE + 200, NOR_FLASH_SECTOR_SIZE - 200);
+}
+
+static void test_recoveryAfterTornProgram(void)
+{
+	uint8_t record;
+
+	setUp();
+	NOR_FLASH_logInit();
+	for(record = 0; record < 5; record ++)
+	{
+		append(NOR_FLASH_PAGE_SIZE);
+	}
+
+	/* the power is lost after 3 bytes of the next page are programmed */
+	g_programLimit = 3;
+	append(100);
+
+	powerUp();
+	NOR_FLASH_logInit();
+	TEST_CHECK_EQUAL(6 * NOR_FLASH_PAGE_SIZE, NOR_FLASH_logGetSize());
+
+	TEST_CHECK_EQUAL(NOR_FLASH_SUCCESS, append(20));
+	checkData(0, 5 * NOR_FLASH_PAGE_SIZE + 3);
+	checkErased(NOR_FLASH_LOG_START_ADDRESS + 5 * NOR_FLASH_PAGE_SIZE + 3, NOR_FLASH_PAGE_SIZE - 3);
+	checkData(6 * NOR_FLASH_PAGE_SIZE, 20);
+}
+
+static void test_recoveryOfEmptyAndFullLog(void)
+{
+	uint16_t page;
+
+	setUp();
+	TEST_CHECK_EQUAL(NOR_FLASH_SUCCESS, NOR_FLASH_logInit());
+	TEST_CHECK_EQUAL(0, NOR_FLASH_logGetSize());
+
+	/* a single used byte */
+	append(1);
+	powerUp();
+	NOR_FLASH_logInit();
+	TEST_CHECK_EQUAL(NOR_FLASH_PAGE_SIZE, NOR_FLASH_logGetSize());
+
+	for(page = 1; page < NOR_FLASH_LOG_SIZE / NOR_FLASH_PAGE_SIZE; page ++)
+	{
+		append(NOR_FLASH_PAGE_SIZE);
+	}
+	TEST_CHECK_EQUAL(NOR_FLASH_LOG_SIZE, NOR_FLASH_logGetSize());
+	TEST_CHECK_EQUAL(NOR_FLASH_LOG_FULL, append(1));
+
+	powerUp();
+	NOR_FLASH_logInit();
+	TEST_CHECK_EQUAL(NOR_FLASH_LOG_SIZE, NOR_FLASH_logGetSize());
+	TEST_CHECK_EQUAL(NOR_FLASH_LOG_FULL, append(1));
+	TEST_CHECK_EQUAL(NOR_FLASH_LOG_SIZE / NOR_FLASH_SECTOR_SIZE, g_erasesCount);
+	TEST_CHECK_EQUAL(0, g_violationsCount);
+}
+
+static void test_logClear(void)
+{
+	setUp();
+	NOR_FLASH_logInit();
+	append(1000);
+
+	TEST_CHECK_EQUAL(NOR_FLASH_SUCCESS, NOR_FLASH_logClear());
+	TEST_CHECK_EQUAL(0, NOR_FLASH_logGetSize());
+	checkErased(NOR_FLASH_LOG_START_ADDRESS, NOR_FLASH_LOG_SIZE);
+
+	/* the log sectors are erased already, the appends program only */
+	g_erasesCount = 0;
+	append(300);
+	TEST_CHECK_EQUAL(0, g_erasesCount);
+	checkData(0, 300);
+	TEST_CHECK_EQUAL(0, g_violationsCount);
+}
+
+int main(void)
+{
+	TEST_RUN(test_jedecId);
+	TEST_RUN(test_appendAcrossPagesAndSectors);
+	TEST_RUN(test_recoveryResumesAtNextPage);
+	TEST_RUN(test_recoveryAtSectorEnd);
+	TEST_RUN(test_recoveryAfterTornProgram);
+	TEST_RUN(test_recoveryOfEmptyAndFullLog);
+	TEST_RUN(test_logClear);
+
+	return TEST_END();
+}
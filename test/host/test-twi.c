@@ -0,0 +1,523 @@
+/******************************************************************************
+ *
+ * Module: Host Tests
+ *
+ * File Name: test-twi.c
+ *
+ * Description: Tests of the TWI master state machine against a model of the
+ * 				bus and a memory slave, i.e. a 24C02 eeprom
+ *
+ * Author: Kirollos Ashraf
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                Includes	                                   *
+ *******************************************************************************/
+
+#include "host-test.h"
+
+#include "Mcal/Twi/twi.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* address of the modeled slave, the other addresses are not acknowledged */
+#define SLAVE_ADDRESS				0x50
+
+/* states of the bus model */
+#define BUS_IDLE					0
+#define BUS_ADDRESS					1
+#define BUS_WRITE					2
+#define BUS_READ					3
+#define BUS_WAIT_STOP				4
+
+/* io space addresses of the twi registers */
+#define TWSR_ADDRESS				0x21
+#define TWDR_ADDRESS				0x23
+#define TWCR_ADDRESS				0x56
+
+/* io space address of PINC, the twi pins are PC0 and PC1 */
+#define PINC_ADDRESS				0x33
+
+/*******************************************************************************
+ *                     		   Global Variables	                       	       *
+ *******************************************************************************/
+
+/* memory of the slave, the first written byte of a transfer sets the pointer */
+static uint8_t g_slaveMemory[256];
+static uint8_t g_slavePointer;
+static uint8_t g_isPointerWritten;
+
+/* state of the bus and the TWINT flag, the flag is kept here and cleared in TWCR
+ * when a command is taken, so the next TWINT written by the driver is a new command */
+static uint8_t g_busState;
+static uint8_t g_isFlagSet;
+
+/* injected faults */
+static uint8_t g_isSlaveWriteProtected;
+static uint8_t g_isSlaveStalled;
+static uint8_t g_arbitrationLossesCount;
+static uint8_t g_isBusErrorForced;
+
+/* bus events */
+static uint16_t g_startsCount;
+static uint16_t g_stopsCount;
+static uint16_t g_readAcksCount;
+static uint16_t g_readNacksCount;
+static uint16_t g_protocolErrorsCount;
+
+/* order of the called callbacks */
+static uint8_t g_callbacksOrder[16];
+static uint8_t g_callbacksCount;
+
+/*******************************************************************************
+ *                      Static Functions Prototypes	                           *
+ *******************************************************************************/
+
+/* the twi interrupt of the driver */
+void TWI_vect(void);
+
+static void BUS_update(void);
+
+static uint8_t BUS_isInterruptPending(void);
+
+static const ST_HostDevice g_bus = {BUS_update, BUS_isInterruptPending, TWI_vect};
+
+/*******************************************************************************
+ *                               Bus Model                                     *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: BUS_update
+ * [Function Description]: runs the command written to TWCR, the transfer ends
+ * 						   at once and sets the status and the flag
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void BUS_update(void)
+{
+	uint8_t control = HOST_REGISTER(TWCR_ADDRESS);
+	uint8_t data;
+	uint8_t status;
+
+	if(BIT_IS_CLEAR(control, TWEN))
+	{
+		g_busState = BUS_IDLE;
+		g_isFlagSet = FALSE;
+		return;
+	}
+
+	if(BIT_IS_CLEAR(control, TWINT))
+	{
+		return;
+	}
+
+	CLEAR_BIT(HOST_REGISTER(TWCR_ADDRESS), TWINT);
+	g_isFlagSet = FALSE;
+
+	/* a slave reset in the middle of a transfer, the bus never moves again */
+	if(g_isSlaveStalled == TRUE)
+	{
+		return;
+	}
+
+	if(BIT_IS_SET(control, TWSTO))
+	{
+		/* the stop ends at once, TWSTO is cleared and there is no interrupt */
+		CLEAR_BIT(HOST_REGISTER(TWCR_ADDRESS), TWSTO);
+		g_busState = BUS_IDLE;
+		g_stopsCount ++;
+		return;
+	}
+
+	if(BIT_IS_SET(control, TWSTA))
+	{
+		status = (g_busState == BUS_IDLE) ? 0x08 : 0x10;
+		g_busState = BUS_ADDRESS;
+		g_startsCount ++;
+	}
+	else if(g_busState == BUS_ADDRESS)
+	{
+		data = HOST_REGISTER(TWDR_ADDRESS);
+		if(g_arbitrationLossesCount > 0)
+		{
+			/* another master took the bus, it's released when that master is done */
+			g_arbitrationLossesCount --;
+			status = 0x38;
+			g_busState = BUS_IDLE;
+		}
+		else if((data >> 1) != SLAVE_ADDRESS)
+		{
+			status = (data & 1) ? 0x48 : 0x20;
+			g_busState = BUS_WAIT_STOP;
+		}
+		else if(data & 1)
+		{
+			status = 0x40;
+			g_busState = BUS_READ;
+		}
+		else
+		{
+			status = 0x18;
+			g_isPointerWritten = FALSE;
+			g_busState = BUS_WRITE;
+		}
+	}
+	else if(g_busState == BUS_WRITE)
+	{
+		data = HOST_REGISTER(TWDR_ADDRESS);
+		if(g_isPointerWritten == FALSE)
+		{
+			g_slavePointer = data;
+			g_isPointerWritten = TRUE;
+			status = 0x28;
+		}
+		else if(g_isSlaveWriteProtected == TRUE)
+		{
+			status = 0x30;
+		}
+		else
+		{
+			g_slaveMemory[g_slavePointer++] = data;
+			status = 0x28;
+		}
+	}
+	else if(g_busState == BUS_READ)
+	{
+		HOST_REGISTER(TWDR_ADDRESS) = g_slaveMemory[g_slavePointer++];
+		if(BIT_IS_SET(control, TWEA))
+		{
+			status = 0x50;
+			g_readAcksCount ++;
+		}
+		else
+		{
+			/* the slave releases the bus after the not acknowledged byte */
+			status = 0x58;
+			g_readNacksCount ++;
+			g_busState = BUS_WAIT_STOP;
+		}
+	}
+	else
+	{
+		/* a transfer with no start or after the end of a read */
+		status = 0x00;
+		g_protocolErrorsCount ++;
+	}
+
+	if(g_isBusErrorForced == TRUE)
+	{
+		g_isBusErrorForced = FALSE;
+		status = 0x00;
+		g_busState = BUS_IDLE;
+	}
+
+	HOST_REGISTER(TWSR_ADDRESS) = (HOST_REGISTER(TWSR_ADDRESS) & 0x07) | status;
+	g_isFlagSet = TRUE;
+}
+
+/*
+ * [Function Name]: BUS_isInterruptPending
+ * [Function Description]: checks if the flag is set and the interrupt enabled
+ * [Args]:
+ * [in]: void
+ * [Return]: uint8_t
+ * 			 TRUE if pending
+ */
+static uint8_t BUS_isInterruptPending(void)
+{
+	return (g_isFlagSet == TRUE && BIT_IS_SET(HOST_REGISTER(TWCR_ADDRESS), TWIE));
+}
+
+/*******************************************************************************
+ *                                 Helpers                                     *
+ *******************************************************************************/
+
+/*
+ * [Function Name]: setUp
+ * [Function Description]: resets the models and initializes the driver
+ * [Args]:
+ * [in]: void
+ * [Return]: void
+ */
+static void setUp(void)
+{
+	uint16_t index;
+
+	HOST_reset();
+	HOST_addDevice(&g_bus);
+
+	for(index = 0; index < sizeof(g_slaveMemory); index ++)
+	{
+		g_slaveMemory[index] = (uint8_t)index;
+	}
+	g_slavePointer = 0;
+	g_busState = BUS_IDLE;
+	g_isFlagSet = FALSE;
+	g_isSlaveWriteProtected = FALSE;
+	g_isSlaveStalled = FALSE;
+	g_arbitrationLossesCount = 0;
+	g_isBusErrorForced = FALSE;
+	g_startsCount = 0;
+	g_stopsCount = 0;
+	g_readAcksCount = 0;
+	g_readNacksCount = 0;
+	g_protocolErrorsCount = 0;
+	g_callbacksCount = 0;
+
+	/* scl and sda are released by the slaves */
+	HOST_REGISTER(PINC_ADDRESS) = SELECT_BIT(GET_PIN_NO(TWI_SCL_PIN)) | SELECT_BIT(GET_PIN_NO(TWI_SDA_PIN));
+
+	TWI_init();
+	ENABLE_GLOBAL_INTERRUPT();
+}
+
+/* fills a transaction */
+static void setTransaction(ST_TwiTransaction * a_transaction, uint8_t a_address,
+		const uint8_t * a_writeData, uint16_t a_writeLength, uint8_t * a_readData, uint16_t a_readLength,
+		void (* a_callBack)(void))
+{
+	a_transaction->address = a_address;
+	a_transaction->writeData = a_writeData;
+	a_transaction->writeLength = a_writeLength;
+	a_transaction->readData = a_readData;
+	a_transaction->readLength = a_readLength;
+	a_transaction->callBack = a_callBack;
+}
+
+static void callback0(void) { g_callbacksOrder[g_callbacksCount++] = 0; }
+static void callback1(void) { g_callbacksOrder[g_callbacksCount++] = 1; }
+
+/* the transaction queued from the callback of another one */
+static ST_TwiTransaction g_chainedTransaction;
+static const uint8_t g_chainedData[2] = {0x80, 0xA5};
+
+static void callbackChain(void)
+{
+	g_callbacksOrder[g_callbacksCount++] = 2;
+	setTransaction(&g_chainedTransaction, SLAVE_ADDRESS, g_chainedData, 2, NULL, 0, callback1);
+	TWI_queueTransaction(&g_chainedTransaction);
+}
+
+/*******************************************************************************
+ *                                  Tests                                      *
+ *******************************************************************************/
+
+static void test_writeThenRead(void)
+{
+	const uint8_t writeData[4] = {0x10, 0xA1, 0xB2, 0xC3};
+	const uint8_t pointer = 0x10;
+	uint8_t readData[3] = {0};
+
+	setUp();
+
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, TWI_transferBlocking(SLAVE_ADDRESS, writeData, 4, NULL, 0));
+	TEST_CHECK_EQUAL(0xA1, g_slaveMemory[0x10]);
+	TEST_CHECK_EQUAL(0xC3, g_slaveMemory[0x12]);
+
+	/* the pointer write and the read are joined by a repeated start */
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, TWI_transferBlocking(SLAVE_ADDRESS, &pointer, 1, readData, 3));
+	TEST_CHECK_EQUAL(0xA1, readData[0]);
+	TEST_CHECK_EQUAL(0xB2, readData[1]);
+	TEST_CHECK_EQUAL(0xC3, readData[2]);
+	TEST_CHECK_EQUAL(3, g_startsCount);
+	TEST_CHECK_EQUAL(2, g_stopsCount);
+
+	/* all the read bytes but the last are acknowledged */
+	TEST_CHECK_EQUAL(2, g_readAcksCount);
+	TEST_CHECK_EQUAL(1, g_readNacksCount);
+	TEST_CHECK_EQUAL(0, g_protocolErrorsCount);
+	TEST_CHECK(!TWI_isBusy());
+}
+
+static void test_readOnly(void)
+{
+	uint8_t readData[2] = {0};
+
+	setUp();
+	g_slavePointer = 0x40;
+
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, TWI_transferBlocking(SLAVE_ADDRESS, NULL, 0, readData, 2));
+	TEST_CHECK_EQUAL(0x40, readData[0]);
+	TEST_CHECK_EQUAL(0x41, readData[1]);
+	TEST_CHECK_EQUAL(1, g_startsCount);
+
+	/* a single byte is not acknowledged at all */
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, TWI_transferBlocking(SLAVE_ADDRESS, NULL, 0, readData, 1));
+	TEST_CHECK_EQUAL(0x42, readData[0]);
+	TEST_CHECK_EQUAL(1, g_readAcksCount);
+	TEST_CHECK_EQUAL(2, g_readNacksCount);
+	TEST_CHECK_EQUAL(0, g_protocolErrorsCount);
+}
+
+static void test_addressNack(void)
+{
+	const uint8_t data = 0x00;
+	uint8_t readData;
+
+	setUp();
+
+	TEST_CHECK_EQUAL(TWI_RESULT_ADDRESS_NACK, TWI_transferBlocking(SLAVE_ADDRESS + 1, &data, 1, NULL, 0));
+	TEST_CHECK_EQUAL(TWI_RESULT_ADDRESS_NACK, TWI_transferBlocking(SLAVE_ADDRESS + 1, NULL, 0, &readData, 1));
+
+	/* a transaction with no data only checks the address */
+	TEST_CHECK_EQUAL(TWI_RESULT_ADDRESS_NACK, TWI_transferBlocking(SLAVE_ADDRESS + 1, NULL, 0, NULL, 0));
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, TWI_transferBlocking(SLAVE_ADDRESS, NULL, 0, NULL, 0));
+
+	TEST_CHECK_EQUAL(4, g_stopsCount);
+	TEST_CHECK_EQUAL(0, g_protocolErrorsCount);
+}
+
+static void test_dataNack(void)
+{
+	const uint8_t writeData[3] = {0x20, 0x55, 0x66};
+
+	setUp();
+	g_isSlaveWriteProtected = TRUE;
+
+	TEST_CHECK_EQUAL(TWI_RESULT_DATA_NACK, TWI_transferBlocking(SLAVE_ADDRESS, writeData, 3, NULL, 0));
+	TEST_CHECK_EQUAL(0x20, g_slaveMemory[0x20]);
+	TEST_CHECK_EQUAL(1, g_stopsCount);
+	TEST_CHECK(!TWI_isBusy());
+}
+
+static void test_queueFull(void)
+{
+	static ST_TwiTransaction transactions[TWI_TRANSACTION_QUEUE_SIZE + 1];
+	static const uint8_t writeData[2] = {0x90, 0x11};
+	uint8_t index;
+
+	setUp();
+
+	/* nothing runs till the interrupts are enabled, the running transaction
+	 * leaves the queue so one more than the free places is accepted */
+	DISABLE_GLOBAL_INTERRUPT();
+	for(index = 0; index < TWI_TRANSACTION_QUEUE_SIZE + 1; index ++)
+	{
+		setTransaction(&transactions[index], SLAVE_ADDRESS, writeData, 2, NULL, 0, NULL);
+		TEST_CHECK_EQUAL((index < TWI_TRANSACTION_QUEUE_SIZE) ? TWI_TRANSACTION_QUEUED : TWI_TRANSACTION_QUEUE_FULL,
+				TWI_queueTransaction(&transactions[index]));
+	}
+	TEST_CHECK(TWI_isBusy());
+	TEST_CHECK_EQUAL(TWI_RESULT_PENDING, transactions[0].result);
+
+	ENABLE_GLOBAL_INTERRUPT();
+
+	for(index = 0; index < TWI_TRANSACTION_QUEUE_SIZE; index ++)
+	{
+		TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, transactions[index].result);
+	}
+	TEST_CHECK_EQUAL(TWI_TRANSACTION_QUEUE_SIZE, g_stopsCount);
+	TEST_CHECK(!TWI_isBusy());
+}
+
+static void test_callbackQueue(void)
+{
+	static const uint8_t writeData[2] = {0x90, 0x11};
+	ST_TwiTransaction chainStart, queued0, queued1;
+
+	setUp();
+
+	DISABLE_GLOBAL_INTERRUPT();
+	setTransaction(&chainStart, SLAVE_ADDRESS, writeData, 1, NULL, 0, callbackChain);
+	setTransaction(&queued0, SLAVE_ADDRESS, writeData, 2, NULL, 0, callback0);
+	setTransaction(&queued1, SLAVE_ADDRESS, writeData, 2, NULL, 0, NULL);
+	TWI_queueTransaction(&chainStart);
+	TWI_queueTransaction(&queued0);
+	TWI_queueTransaction(&queued1);
+	ENABLE_GLOBAL_INTERRUPT();
+
+	/* the transaction queued from a callback runs after the queued ones */
+	TEST_CHECK_EQUAL(3, g_callbacksCount);
+	TEST_CHECK_EQUAL(2, g_callbacksOrder[0]);
+	TEST_CHECK_EQUAL(0, g_callbacksOrder[1]);
+	TEST_CHECK_EQUAL(1, g_callbacksOrder[2]);
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, queued1.result);
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, g_chainedTransaction.result);
+	TEST_CHECK_EQUAL(0xA5, g_slaveMemory[0x80]);
+	TEST_CHECK_EQUAL(4, g_stopsCount);
+	TEST_CHECK(!TWI_isBusy());
+}
+
+static void test_arbitrationLost(void)
+{
+	const uint8_t writeData[2] = {0x30, 0x77};
+
+	setUp();
+	g_arbitrationLossesCount = 2;
+
+	/* the transaction restarts till it wins the bus */
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, TWI_transferBlocking(SLAVE_ADDRESS, writeData, 2, NULL, 0));
+	TEST_CHECK_EQUAL(0x77, g_slaveMemory[0x30]);
+	TEST_CHECK_EQUAL(3, g_startsCount);
+	TEST_CHECK_EQUAL(1, g_stopsCount);
+}
+
+static void test_busError(void)
+{
+	const uint8_t writeData[2] = {0x31, 0x88};
+	ST_TwiTransaction failed, next;
+
+	setUp();
+
+	DISABLE_GLOBAL_INTERRUPT();
+	setTransaction(&failed, SLAVE_ADDRESS, writeData, 2, NULL, 0, NULL);
+	setTransaction(&next, SLAVE_ADDRESS, writeData, 2, NULL, 0, NULL);
+	TWI_queueTransaction(&failed);
+	TWI_queueTransaction(&next);
+	g_isBusErrorForced = TRUE;
+	ENABLE_GLOBAL_INTERRUPT();
+
+	/* the failed transaction doesn't block the queue */
+	TEST_CHECK_EQUAL(TWI_RESULT_BUS_ERROR, failed.result);
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, next.result);
+	TEST_CHECK_EQUAL(0x88, g_slaveMemory[0x31]);
+}
+
+static void test_recoverBus(void)
+{
+	const uint8_t pointer = 0x50;
+	uint8_t readData[4];
+	ST_TwiTransaction stuck, next;
+
+	setUp();
+
+	/* the slave stops in the middle of the read, i.e. it was reset */
+	g_isSlaveStalled = TRUE;
+	setTransaction(&stuck, SLAVE_ADDRESS, &pointer, 1, readData, 4, callback0);
+	setTransaction(&next, SLAVE_ADDRESS, &pointer, 1, readData, 2, callback1);
+	TWI_queueTransaction(&stuck);
+	TWI_queueTransaction(&next);
+	TEST_CHECK(TWI_isBusy());
+	TEST_CHECK_EQUAL(TWI_RESULT_PENDING, stuck.result);
+
+	g_isSlaveStalled = FALSE;
+	TWI_recoverBus();
+
+	TEST_CHECK_EQUAL(TWI_RESULT_BUS_ERROR, stuck.result);
+	TEST_CHECK_EQUAL(TWI_RESULT_SUCCESS, next.result);
+	TEST_CHECK_EQUAL(0x50, readData[0]);
+	TEST_CHECK_EQUAL(0x51, readData[1]);
+	TEST_CHECK_EQUAL(2, g_callbacksCount);
+	TEST_CHECK_EQUAL(0, g_callbacksOrder[0]);
+	TEST_CHECK_EQUAL(1, g_callbacksOrder[1]);
+	TEST_CHECK(!TWI_isBusy());
+}
+
+int main(void)
+{
+	TEST_RUN(test_writeThenRead);
+	TEST_RUN(test_readOnly);
+	TEST_RUN(test_addressNack);
+	TEST_RUN(test_dataNack);
+	TEST_RUN(test_queueFull);
+	TEST_RUN(test_callbackQueue);
+	TEST_RUN(test_arbitrationLost);
+	TEST_RUN(test_busError);
+	TEST_RUN(test_recoverBus);
+
+	return TEST_END();
+}